@@ -16,21 +16,18 @@
    for more details.
 */
 
-#define  _GNU_SOURCE   /* Must define this to get access to pthread_rwlock_t */
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <unistd.h>
-#include <pthread.h>
 #include <glob.h>
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
 #include <ert/util/time_t_vector.h>
-#include <ert/util/statistics.h>
+#include <ert/util/hash.h>
+#include <ert/util/stringlist.h>
 #include <ert/util/vector.h>
-#include <ert/util/arg_pack.h>
-#include <ert/util/thread_pool.h>
 
 #include <ert/config/config_parser.h>
 #include <ert/config/config_content.h>
@@ -39,11 +36,11 @@
 #include <ert/config/config_content_node.h>
 
 #include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_quantile.hpp>
 
 #define DEFAULT_NUM_INTERP  50
 #define SUMMARY_JOIN       ":"
 #define MIN_SIZE            10
-#define LOAD_THREADS         4
 
 
 typedef enum {
@@ -53,15 +50,6 @@ typedef enum {
 } format_type;
 
 
-typedef struct {
-  ecl_sum_type             * ecl_sum;
-  double_vector_type       * interp_data;
-  const time_t_vector_type * interp_time;
-  time_t                     start_time;
-  time_t                     end_time;
-} sum_case_type;
-
-
 /**
    Microscopic data structure representing one column of data;
    i.e. one ECLIPSE summary key and one accompanying quantile value.
@@ -81,15 +69,20 @@ typedef struct  {
 } output_type;
 
 
+/**
+   The ensemble does not hold the summary cases; the cases are only
+   listed, and then streamed through the ecl_sum_quantile engine which
+   accumulates the quantiles for all the output keys in one pass.
+*/
 
 typedef struct {
-  vector_type         * data;
-  time_t_vector_type  * interp_time;
-  int                   num_interp;
-  time_t                start_time;
-  time_t                end_time;
-  const ecl_sum_type  * refcase;     /* Pointer to an arbitrary ecl_sum instance in the ensemble - to have access to indexing functions. */
-  pthread_rwlock_t      rwlock;
+  stringlist_type       * cases;
+  time_t_vector_type    * interp_time;
+  int                     num_interp;
+  bool                    exact;
+  time_t                  start_time;
+  ecl_sum_type          * refcase;     /* The first case in the ensemble - to have access to indexing functions. */
+  ecl_sum_quantile_type * quantile;
 } ensemble_type;
 
 
@@ -121,84 +114,14 @@ static void quant_key_free__( void * qkey ) {
 
 /*****************************************************************/
 
-sum_case_type * sum_case_fread_alloc( const char * data_file , const time_t_vector_type * interp_time ) {
-  sum_case_type * sum_case = util_malloc( sizeof * sum_case );
-
-  sum_case->ecl_sum     = ecl_sum_fread_alloc_case( data_file , SUMMARY_JOIN );
-  sum_case->interp_data = double_vector_alloc(0 , 0);
-  sum_case->interp_time = interp_time;
-  sum_case->start_time  = ecl_sum_get_start_time( sum_case->ecl_sum );
-  sum_case->end_time    = ecl_sum_get_end_time( sum_case->ecl_sum );
-  return sum_case;
-}
-
-
-void sum_case_free( sum_case_type * sum_case) {
-  ecl_sum_free( sum_case->ecl_sum );
-  double_vector_free( sum_case->interp_data );
-  free( sum_case );
-}
-
-
-void sum_case_free__( void * sum_case) {
-  sum_case_free( (sum_case_type *) sum_case);
-}
-
-
-/*****************************************************************/
-
-
-void ensemble_add_case( ensemble_type * ensemble , const char * data_file ) {
-  sum_case_type * sum_case = sum_case_fread_alloc( data_file , ensemble->interp_time );
-
-  pthread_rwlock_wrlock( &ensemble->rwlock );
-  {
-    printf("Loading case: %s \n", data_file );
-    vector_append_owned_ref( ensemble->data , sum_case , sum_case_free__ );
-    if (ensemble->start_time > 0)
-      ensemble->start_time = util_time_t_min( ensemble->start_time , sum_case->start_time);
-    else
-      ensemble->start_time = ecl_sum_get_start_time( sum_case->ecl_sum );
-
-    ensemble->end_time   = util_time_t_max( ensemble->end_time   , sum_case->end_time);
-  }
-  pthread_rwlock_unlock( &ensemble->rwlock );
-
-}
-
-void * ensemble_add_case__( void * arg ) {
-  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
-  ensemble_type * ensemble = arg_pack_iget_ptr( arg , 0 );
-  const char * data_file   = arg_pack_iget_ptr( arg , 1 );
-  ensemble_add_case( ensemble , data_file );
-  arg_pack_free( arg_pack );
-  return NULL;
-}
-
-
-
-
-void ensemble_init_time_interp( ensemble_type * ensemble ) {
-  int i;
-  for (i = 0; i < ensemble->num_interp; i++)
-    time_t_vector_append( ensemble->interp_time , ensemble->start_time + i * (ensemble->end_time - ensemble->start_time) / (ensemble->num_interp - 1));
-}
-
-
-
 
-
-void ensemble_load_from_glob( ensemble_type * ensemble , const char * pattern , thread_pool_type * tp) {
+void ensemble_add_glob( ensemble_type * ensemble , const char * pattern ) {
   glob_t pglob;
   int    i;
   glob( pattern , GLOB_NOSORT , NULL , &pglob );
 
-  for (i=0; i < pglob.gl_pathc; i++) {
-    arg_pack_type * arg_pack = arg_pack_alloc( );
-    arg_pack_append_ptr( arg_pack , ensemble );
-    arg_pack_append_owned_ptr( arg_pack , util_alloc_string_copy( pglob.gl_pathv[i] ) , free );
-    thread_pool_add_job( tp , ensemble_add_case__ , arg_pack );
-  }
+  for (i=0; i < pglob.gl_pathc; i++)
+    stringlist_append_copy( ensemble->cases , pglob.gl_pathv[i] );
 
   globfree( &pglob );
 }
@@ -209,11 +132,12 @@ ensemble_type * ensemble_alloc( ) {
   ensemble_type * ensemble = util_malloc( sizeof * ensemble );
 
   ensemble->num_interp  = DEFAULT_NUM_INTERP;
+  ensemble->exact       = true;
   ensemble->start_time  = -1;
-  ensemble->end_time    = -1;
-  ensemble->data        = vector_alloc_new();
-  ensemble->interp_time = time_t_vector_alloc( 0 , -1 );
-  pthread_rwlock_init( &ensemble->rwlock , NULL );
+  ensemble->cases       = stringlist_alloc_new();
+  ensemble->interp_time = NULL;
+  ensemble->refcase     = NULL;
+  ensemble->quantile    = NULL;
   return ensemble;
 }
 
@@ -221,41 +145,43 @@ ensemble_type * ensemble_alloc( ) {
 void ensemble_init( ensemble_type * ensemble , config_content_type * config) {
 
   /*1 : Loading ensembles and settings from the config instance */
-  /*1a: Loading the eclipse summary cases. */
+  /*1a: Listing the eclipse summary cases. */
   {
-    thread_pool_type * tp = thread_pool_alloc( LOAD_THREADS , true );
-    {
-      int i,j;
-      if (config_content_has_item( config , "CASE_LIST")) {
-        const config_content_item_type * case_item = config_content_get_item( config , "CASE_LIST" );
-        for (j=0; j < config_content_item_get_size( case_item ); j++) {
-          const config_content_node_type * case_node = config_content_item_iget_node( case_item , j );
-          for (i=0; i < config_content_node_get_size( case_node ); i++) {
-            const char * case_glob = config_content_node_iget( case_node , i );
-            ensemble_load_from_glob( ensemble , case_glob , tp);
-          }
+    int i,j;
+    if (config_content_has_item( config , "CASE_LIST")) {
+      const config_content_item_type * case_item = config_content_get_item( config , "CASE_LIST" );
+      for (j=0; j < config_content_item_get_size( case_item ); j++) {
+        const config_content_node_type * case_node = config_content_item_iget_node( case_item , j );
+        for (i=0; i < config_content_node_get_size( case_node ); i++) {
+          const char * case_glob = config_content_node_iget( case_node , i );
+          ensemble_add_glob( ensemble , case_glob );
         }
       }
-
     }
-    thread_pool_join( tp );
-    thread_pool_free( tp );
   }
 
-  {
-    const sum_case_type * tmp = vector_iget_const( ensemble->data , 0 );
-    ensemble->refcase = tmp->ecl_sum;
-  }
+  if (stringlist_get_size( ensemble->cases ) < MIN_SIZE )
+    util_exit("Sorry - quantiles make no sense with with < %d realizations; should have ~> 100.\n" , MIN_SIZE);
 
   /*1b: Other config settings */
   if (config_content_has_item( config , "NUM_INTERP" ))
     ensemble->num_interp  = config_content_iget_as_int( config , "NUM_INTERP" , 0 , 0 );
 
+  if (config_content_has_item( config , "APPROXIMATE" ))
+    ensemble->exact = !config_content_iget_as_bool( config , "APPROXIMATE" , 0 , 0 );
+
 
   /*2: Remaining initialization */
-  ensemble_init_time_interp( ensemble );
-  if (vector_get_size( ensemble->data ) < MIN_SIZE )
-    util_exit("Sorry - quantiles make no sense with with < %d realizations; should have ~> 100.\n" , MIN_SIZE);
+  ensemble->interp_time = ecl_sum_quantile_alloc_interp_time( ensemble->cases , SUMMARY_JOIN , ensemble->num_interp );
+  if (ensemble->interp_time == NULL)
+    util_exit("Sorry - none of the cases could be loaded.\n");
+  ensemble->start_time = time_t_vector_iget( ensemble->interp_time , 0 );
+
+  for (int iens = 0; iens < stringlist_get_size( ensemble->cases ); iens++) {
+    ensemble->refcase = ecl_sum_fread_alloc_case( stringlist_iget( ensemble->cases , iens ) , SUMMARY_JOIN );
+    if (ensemble->refcase)
+      break;
+  }
 }
 
 const ecl_sum_type * ensemble_get_refcase( const ensemble_type * ensemble ) {
@@ -264,8 +190,16 @@ const ecl_sum_type * ensemble_get_refcase( const ensemble_type * ensemble ) {
 
 
 void ensemble_free( ensemble_type * ensemble ) {
-  vector_free( ensemble->data );
-  time_t_vector_free( ensemble->interp_time );
+  if (ensemble->quantile)
+    ecl_sum_quantile_free( ensemble->quantile );
+
+  if (ensemble->interp_time)
+    time_t_vector_free( ensemble->interp_time );
+
+  if (ensemble->refcase)
+    ecl_sum_free( ensemble->refcase );
+
+  stringlist_free( ensemble->cases );
   free( ensemble );
 }
 
@@ -623,82 +557,60 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
 
   printf("Creating output file: %s \n",output->file );
 
-
-  /*
-     Go through all the cases and check that they have this key;
-     exit if missing. Could also ignore the missing keys and just
-     continue; and even defer the checking to the inner loop.
-  */
-  for (column_nr = 0; column_nr < vector_get_size( output->keys ); column_nr++) {
+  for (column_nr = 0; column_nr < data_columns; column_nr++) {
     const quant_key_type * qkey = vector_iget( output->keys , column_nr );
-    {
-      bool OK = true;
+    for (row_nr = 0; row_nr < data_rows; row_nr++)
+      data[row_nr][column_nr] = ecl_sum_quantile_get( ensemble->quantile , qkey->sum_key , row_nr , qkey->quantile );
+  }
 
-      for (int iens = 0; iens < vector_get_size( ensemble->data ); iens++) {
-        const sum_case_type * sum_case = vector_iget_const( ensemble->data , iens );
+  output_save( output , ensemble , (const double **) data);
+  for (row_nr=0; row_nr < data_rows; row_nr++)
+    free( data[row_nr] );
+  free( data );
+}
 
-        if (!ecl_sum_has_general_var(sum_case->ecl_sum , qkey->sum_key)) {
-          OK = false;
-          fprintf(stderr,"** Sorry: the case:%s does not have the summary key:%s \n", ecl_sum_get_case( sum_case->ecl_sum ), qkey->sum_key);
-        }
-      }
 
-      if (!OK)
-        util_exit("Exiting due to missing summary vector(s).\n");
+/**
+   All the cases are streamed through the quantile engine once, with
+   the summary keys and quantiles from all the output files. A case
+   which can not be loaded, or which does not have all the keys, is
+   fatal.
+*/
+
+void ensemble_load_quantiles( ensemble_type * ensemble , hash_type * output_table ) {
+  stringlist_type    * keys      = stringlist_alloc_new();
+  double_vector_type * quantiles = double_vector_alloc( 0 , 0 );
+  {
+    hash_iter_type * iter = hash_iter_alloc( output_table );
+    while (!hash_iter_is_complete( iter )) {
+      const output_type * output = hash_iter_get_next_value( iter );
+      for (int i = 0; i < vector_get_size( output->keys ); i++) {
+        const quant_key_type * qkey = vector_iget_const( output->keys , i );
+        if (!stringlist_contains( keys , qkey->sum_key ))
+          stringlist_append_copy( keys , qkey->sum_key );
+        double_vector_append( quantiles , qkey->quantile );
+      }
     }
+    hash_iter_free( iter );
   }
 
-
-  /* The main loop - outer loop is running over time. */
+  ensemble->quantile = ecl_sum_quantile_alloc( keys , ensemble->interp_time , quantiles , ensemble->exact );
   {
-    /**
-       In the quite typical case that we are asking for several
-       quantiles of the quantity, i.e.
+    stringlist_type * failed_cases = stringlist_alloc_new();
+    ecl_sum_quantile_add_cases( ensemble->quantile , ensemble->cases , SUMMARY_JOIN , failed_cases );
 
-       WWCT:OP_1:0.10  WWCT:OP_1:0.50  WWCT:OP_1:0.90
-
-       the interp_data_cache construction will ensure that the
-       underlying ecl_sum object is only queried once; and also the
-       sorting will be performed once.
-    */
-
-    hash_type * interp_data_cache = hash_alloc();
-
-    for (row_nr = 0; row_nr < data_rows; row_nr++) {
-      time_t interp_time = time_t_vector_iget( ensemble->interp_time , row_nr);
-      for (column_nr = 0; column_nr < vector_get_size( output->keys ); column_nr++) {
-        const quant_key_type * qkey = vector_iget( output->keys , column_nr );
-        double_vector_type * interp_data;
-
-        /* Check if we have the vector in the cache table - if not create it. */
-        if (!hash_has_key( interp_data_cache , qkey->sum_key)) {
-          interp_data = double_vector_alloc(0 , 0);
-          hash_insert_hash_owned_ref( interp_data_cache , qkey->sum_key , interp_data , double_vector_free__);
-        }
-        interp_data = hash_get( interp_data_cache , qkey->sum_key );
+    for (int i = 0; i < stringlist_get_size( failed_cases ); i++)
+      fprintf(stderr,"** Sorry: the case:%s could not be loaded, or does not have all the summary keys.\n", stringlist_iget( failed_cases , i ));
 
-        /* Check if the vector has data - if not initialize it. */
-        if (double_vector_size( interp_data ) == 0) {
-          for (int iens = 0; iens < vector_get_size( ensemble->data ); iens++) {
-            const sum_case_type * sum_case = vector_iget_const( ensemble->data , iens );
+    if (stringlist_get_size( failed_cases ) > 0)
+      util_exit("Exiting due to missing summary vector(s).\n");
 
-            if ((interp_time >= sum_case->start_time) && (interp_time <= sum_case->end_time))  /* We allow the different simulations to have differing length */
-              double_vector_append( interp_data , ecl_sum_get_general_var_from_sim_time( sum_case->ecl_sum , interp_time , qkey->sum_key)) ;
-
-            double_vector_sort( interp_data );
-          }
-        }
-        data[row_nr][column_nr] = statistics_empirical_quantile__( interp_data , qkey->quantile );
-      }
-      hash_apply( interp_data_cache , double_vector_reset__ );
-    }
-    hash_free( interp_data_cache );
+    stringlist_free( failed_cases );
   }
 
-  output_save( output , ensemble , (const double **) data);
-  for (row_nr=0; row_nr < data_rows; row_nr++)
-    free( data[row_nr] );
-  free( data );
+  printf("Loaded %d cases \n", ecl_sum_quantile_get_size( ensemble->quantile ));
+  double_vector_free( quantiles );
+  stringlist_free( keys );
 }
 
 
@@ -706,11 +618,13 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
 void output_table_run( hash_type * output_table , ensemble_type * ensemble ) {
   hash_iter_type * iter = hash_iter_alloc( output_table);
 
+  ensemble_load_quantiles( ensemble , output_table );
   while (!hash_iter_is_complete( iter )) {
     const char * output_file     = hash_iter_get_next_key( iter );
     const output_type * output   = hash_get( output_table , output_file );
     output_run_line( output, ensemble );
   }
+  hash_iter_free( iter );
 }
 
 
@@ -723,6 +637,7 @@ void config_init( config_parser_type * config ) {
 
   config_add_schema_item( config , "CASE_LIST"      , true );
   config_add_key_value( config , "NUM_INTERP" , false , CONFIG_INT);
+  config_add_key_value( config , "APPROXIMATE" , false , CONFIG_BOOL);
 
   {
     config_schema_item_type * item;
@@ -746,7 +661,7 @@ void usage() {
   printf("files, it can then output quantiles of summary vectors over the time\n");
   printf("span of the simulation. The program is based on a simple configuration\n");
   printf("file which must be given as a commandline argument. The configuration\n");
-  printf("file only has three keywords:\n");
+  printf("file only has four keywords:\n");
   printf("\n");
   printf("\n");
   printf("   CASE_LIST   simulation*X/run*X/CASE*.DATA\n");
@@ -754,6 +669,7 @@ void usage() {
   printf("   OUTPUT      FILE1   S3GRAPH WWCT:OP_1:0.10  WWCT:OP_1:0.50   WOPR:OP_3\n");
   printf("   OUTPUT      FILE2   PLAIN   FOPT:0.10  FOPT:0.90  FGPT:0.10  FGPT:0.90   FWPT:0.10  FWPT:0.90\n");
   printf("   NUM_INTERP  100\n");
+  printf("   APPROXIMATE FALSE\n");
   printf("\n");
   printf("\n");
   printf("CASE_LIST: This keyword is used to give the path to ECLIPSE data files\n");
@@ -809,6 +725,12 @@ void usage() {
   printf("  between ECLIPSE report steps, the might therefore look a bit jagged\n");
   printf("  if NUM_INTERP is set too high. This keyword is optional.\n");
   printf("\n");
+  printf("APPROXIMATE: By default the quantiles are calculated exactly, which\n");
+  printf("  requires memory for all the interpolated values of all the cases.\n");
+  printf("  With APPROXIMATE TRUE the quantiles are instead estimated on the fly\n");
+  printf("  while the cases are loaded, and the memory usage does not grow with\n");
+  printf("  the number of cases. This keyword is optional.\n");
+  printf("\n");
   printf("All filenames in the configuration file will be interpreted relative to\n");
   printf("the location of the configuration file, i.e. irrespective of the current\n");
   printf("working directory when invoking the ecl_quantile program.\n\n");
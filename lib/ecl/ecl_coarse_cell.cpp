@@ -233,6 +233,13 @@ static void ecl_coarse_cell_sort( ecl_coarse_cell_type * coarse_cell ) {
   }
 }
 
+size_t ecl_coarse_cell_get_memory_usage( const ecl_coarse_cell_type * coarse_cell ) {
+  return sizeof * coarse_cell +
+    (int_vector_size( coarse_cell->cell_list ) +
+     int_vector_size( coarse_cell->active_cells ) +
+     int_vector_size( coarse_cell->active_values )) * sizeof(int);
+}
+
 int ecl_coarse_cell_get_size( const ecl_coarse_cell_type * coarse_cell) {
   return int_vector_size( coarse_cell->cell_list );
 }
@@ -288,6 +295,20 @@ const int * ecl_coarse_cell_get_box_ptr( const ecl_coarse_cell_type * coarse_cel
 
 /*****************************************************************/
 
+/*
+  Clears the active cells and active index of the coarse cell, must be
+  called before the active index is recalculated with
+  ecl_coarse_cell_update_index() after the ACTNUM of the grid has
+  changed.
+*/
+void ecl_coarse_cell_reset_active( ecl_coarse_cell_type * coarse_cell ) {
+  coarse_cell->active_index = -1;
+  coarse_cell->active_fracture_index = -1;
+  int_vector_reset( coarse_cell->active_cells );
+  int_vector_reset( coarse_cell->active_values );
+}
+
+
 void ecl_coarse_cell_update_index( ecl_coarse_cell_type * coarse_cell , int global_index , int * active_index , int * active_fracture_index , int active_value) {
   if (active_value & CELL_ACTIVE_MATRIX) {
     if (coarse_cell->active_index == -1) {
@@ -649,6 +649,33 @@ void ecl_file_close(ecl_file_type * ecl_file) {
 }
 
 
+/**
+   Estimate of the memory held by the ecl_file instance, in bytes. The
+   ECL_FILE_MEMORY_INDEX component is the index of the keywords in the
+   file, and ECL_FILE_MEMORY_DATA the keywords which have been loaded.
+*/
+
+size_t ecl_file_get_memory_usage( const ecl_file_type * ecl_file , ecl_file_memory_enum component) {
+  switch (component) {
+  case ECL_FILE_MEMORY_INDEX:
+    if (ecl_file->global_view)
+      return ecl_file_view_get_memory_usage( ecl_file->global_view );
+    return 0;
+  case ECL_FILE_MEMORY_DATA:
+    if (ecl_file->global_view)
+      return ecl_file_view_get_data_memory_usage( ecl_file->global_view );
+    return 0;
+  case ECL_FILE_MEMORY_TOTAL:
+    return sizeof * ecl_file +
+      ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_INDEX ) +
+      ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_DATA );
+  default:
+    util_abort("%s: invalid component:%d\n",__func__ , component);
+    return 0;
+  }
+}
+
+
 void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
     if (ecl_file->fortio != NULL) {
         fortio_fclose_stream(ecl_file->fortio);
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <ert/util/size_t_vector.hpp>
 #include <ert/util/util.h>
@@ -318,6 +319,20 @@ const char * ecl_file_kw_get_header( const ecl_file_kw_type * file_kw ) {
   return file_kw->header;
 }
 
+/*
+  The memory of the file_kw index entry itself, and of the keyword data
+  which has been loaded from file - if any.
+*/
+size_t ecl_file_kw_get_memory_usage( const ecl_file_kw_type * file_kw ) {
+  return sizeof * file_kw + strlen( file_kw->header ) + 1;
+}
+
+size_t ecl_file_kw_get_data_memory_usage( const ecl_file_kw_type * file_kw ) {
+  if (file_kw->kw)
+    return ecl_kw_get_memory_usage( file_kw->kw );
+  return 0;
+}
+
 int ecl_file_kw_get_size( const ecl_file_kw_type * file_kw ) {
   return file_kw->kw_size;
 }
@@ -29,6 +29,8 @@
 #include <ert/ecl/ecl_rsthead.hpp>
 #include <ert/ecl/ecl_type.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 struct ecl_file_view_struct {
   std::vector<ecl_file_kw_type *>   kw_list;
@@ -297,6 +299,42 @@ void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
   delete ecl_file_view;
 }
 
+/*
+  The index memory is the memory of the view itself and its child
+  views, and the ecl_file_kw instances if this view is the owner. The
+  data memory is the memory of the keywords which have been loaded; it
+  is only counted by the owner view to avoid counting keywords which
+  are shared between views twice.
+*/
+
+size_t ecl_file_view_get_memory_usage( const ecl_file_view_type * ecl_file_view ) {
+  size_t usage = sizeof * ecl_file_view;
+  usage += ecl::util::memory_usage( ecl_file_view->kw_list );
+  usage += ecl::util::memory_usage( ecl_file_view->kw_index );
+  usage += ecl::util::memory_usage( ecl_file_view->distinct_kw );
+  usage += ecl::util::memory_usage( ecl_file_view->child_list );
+
+  for (const auto& child_ptr : ecl_file_view->child_list)
+    usage += ecl_file_view_get_memory_usage( child_ptr );
+
+  if (ecl_file_view->owner) {
+    for (const auto& kw_ptr : ecl_file_view->kw_list)
+      usage += ecl_file_kw_get_memory_usage( kw_ptr );
+  }
+  return usage;
+}
+
+
+size_t ecl_file_view_get_data_memory_usage( const ecl_file_view_type * ecl_file_view ) {
+  size_t usage = 0;
+  if (ecl_file_view->owner) {
+    for (const auto& kw_ptr : ecl_file_view->kw_list)
+      usage += ecl_file_kw_get_data_memory_usage( kw_ptr );
+  }
+  return usage;
+}
+
+
 void ecl_file_view_free__( void * arg ) {
   ecl_file_view_type * ecl_file_view = ( ecl_file_view_type * ) arg;
   ecl_file_view_free( ecl_file_view );
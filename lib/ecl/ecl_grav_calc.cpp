@@ -109,6 +109,7 @@ double ecl_grav_phase_deltag( double utm_x ,
   }
 
   {
+    const double * center = ecl_grid_get_center_array( grid );
     int active_index;
     for (active_index = 0; active_index < ecl_grid_get_active_size( grid ); active_index++) {
       if (aquifern != NULL && aquifern[ active_index ] != 0)
@@ -120,7 +121,12 @@ double ecl_grav_phase_deltag( double utm_x ,
         mas1 = rho1[ active_index ] * porv1[active_index] * sat1[active_index];
         mas2 = rho2[ active_index ] * porv2[active_index] * sat2[active_index];
 
-        ecl_grid_get_xyz1A(grid , active_index , &xpos , &ypos , &zpos);
+        {
+          int global_index = ecl_grid_get_global_index1A( grid , active_index );
+          xpos = center[3*global_index];
+          ypos = center[3*global_index + 1];
+          zpos = center[3*global_index + 2];
+        }
         {
           double dist_x   = xpos - utm_x;
           double dist_y   = ypos - utm_y;
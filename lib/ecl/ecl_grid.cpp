@@ -20,11 +20,15 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <string>
+#include <stdexcept>
+#include <mutex>
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.hpp>
@@ -46,6 +50,9 @@
 #include <ert/ecl/grid_dims.hpp>
 #include <ert/ecl/nnc_info.hpp>
 
+#include "detail/util/memory_usage.hpp"
+#include "detail/util/mapped_file.hpp"
+
 
 /**
   this function implements functionality to load eclispe grid files,
@@ -558,15 +565,39 @@ static const int tetrahedron_permutations[2][12][3] = {{
 
 */
 
-typedef struct point_struct  point_type;
+/*
+  The cell corners are stored as cell_point_type, which is float when
+  the library is compiled with ERT_GRID_FLOAT_GEOMETRY and double
+  otherwise. All calculations are done with the double precision
+  point_type; a cell corner is converted when assigned to a point_type.
+
+  In single precision the corners are stored as offsets from the
+  per-grid geometry_origin, see ecl_grid_set_cell_corner().
+*/
+
+#ifdef ERT_GRID_FLOAT_GEOMETRY
+typedef float  ecl_coord_type;
+#else
+typedef double ecl_coord_type;
+#endif
 
+template <typename T>
 struct point_struct {
-    double x;
-    double y;
-    double z;
+  T x;
+  T y;
+  T z;
+
+  point_struct() = default;
+
+  template <typename S>
+  point_struct(const point_struct<S>& src) : x(src.x), y(src.y), z(src.z) {}
 };
 
-static void point_mapaxes_transform( point_type * p , const double origo[2], const double unit_x[2] , const double unit_y[2]) {
+typedef point_struct<double>          point_type;
+typedef point_struct<ecl_coord_type>  cell_point_type;
+
+template <typename T>
+static void point_mapaxes_transform( point_struct<T> * p , const double origo[2], const double unit_x[2] , const double unit_y[2]) {
   double new_x =  origo[0] + p->x*unit_x[0] + p->y*unit_y[0];
   double new_y =  origo[1] + p->x*unit_x[1] + p->y*unit_y[1];
 
@@ -587,7 +618,8 @@ static void point_mapaxes_invtransform( point_type * p , const double origo[2],
   p->y = org_y;
 }
 
-static void point_inplace_add(point_type * point , const point_type * add) {
+template <typename S>
+static void point_inplace_add(point_type * point , const point_struct<S> * add) {
   point->x += add->x;
   point->y += add->y;
   point->z += add->z;
@@ -620,7 +652,8 @@ static double point_dot_product( const point_type * v1 , const point_type * v2)
 }
 
 
-static void point_compare( const point_type *p1 , const point_type * p2, bool * equal) {
+template <typename T>
+static void point_compare( const point_struct<T> *p1 , const point_struct<T> * p2, bool * equal) {
   const double tolerance = 0.001;
 
   double diff_x = (fabs(p1->x - p2->x) / fabs(p1->x + p2->x + 1));
@@ -631,13 +664,15 @@ static void point_compare( const point_type *p1 , const point_type * p2, bool *
     *equal = false;
 }
 
-static void point_dump( const point_type * p , FILE * stream) {
+template <typename T>
+static void point_dump( const point_struct<T> * p , FILE * stream) {
   util_fwrite_double( p->x , stream );
   util_fwrite_double( p->y , stream );
   util_fwrite_double( p->z , stream );
 }
 
-static void point_dump_ascii( const point_type * p , FILE * stream , const double * offset) {
+template <typename T>
+static void point_dump_ascii( const point_struct<T> * p , FILE * stream , const double * offset) {
   if (offset)
     fprintf(stream , "(%7.2f, %7.2f, %7.2f) " , p->x - offset[0], p->y - offset[1] , p->z - offset[2]);
   else
@@ -645,21 +680,24 @@ static void point_dump_ascii( const point_type * p , FILE * stream , const doubl
 
 }
 
-static void point_set(point_type * p , double x , double y , double z) {
+template <typename T>
+static void point_set(point_struct<T> * p , double x , double y , double z) {
   p->x = x;
   p->y = y;
   p->z = z;
 }
 
 
-static void point_shift(point_type * p , double dx , double dy , double dz) {
+template <typename T>
+static void point_shift(point_struct<T> * p , double dx , double dy , double dz) {
   p->x += dx;
   p->y += dy;
   p->z += dz;
 }
 
 
-static void point_copy_values(point_type * p , const point_type * src) {
+template <typename T , typename S>
+static void point_copy_values(point_struct<T> * p , const point_struct<S> * src) {
   point_set(p , src->x , src->y , src->z);
 }
 
@@ -687,8 +725,8 @@ typedef struct ecl_cell_struct           ecl_cell_type;
 #define METER_TO_CM_SCALE_FACTOR   100.0
 
 struct ecl_cell_struct {
-  point_type center;
-  point_type corner_list[8];
+  cell_point_type center;
+  cell_point_type corner_list[8];
 
   double                 volume;             /* Cache volume - whether it is initialized or not is handled by a cell_flags. */
   int                    active;
@@ -751,6 +789,7 @@ struct ecl_grid_struct {
   double                 unit_y[2];
   double                 origo[2];
   float                * mapaxes;
+  double                 geometry_origin[3];  /* The cell corners and centers are stored relative to this point; always zero in double precision builds. */
   /*------------------------------:       the fields below this line are used for blocking algorithms - and not allocated by default.*/
   int                    block_dim; /* == 2 for maps and 3 for fields. 0 when not in use. */
   int                    block_size;
@@ -762,6 +801,33 @@ struct ecl_grid_struct {
                                         but in cases with skewed cells this has proved
                                         numerically challenging. */
 
+  /*
+    Grid wide geometry arrays with one element for each global cell,
+    the center array holds x,y,z interleaved. Each array is calculated
+    on first request, under the geometry_mutex, and they can be freed
+    again with ecl_grid_free_geometry_arrays().
+  */
+  mutable std::mutex          geometry_mutex;
+  mutable std::vector<double> volume_array;
+  mutable std::vector<double> center_array;
+  mutable std::vector<double> depth_array;
+  mutable std::vector<double> thickness_array;
+  mutable std::vector<double> bbox_array;   /* xmin, xmax, ymin, ymax, zmin and zmax blocks of size elements each. */
+  mutable std::vector<double> column_depth;  /* For each (i,j) column: the top depth of the nz cells followed by the bottom depth of the nz cells. */
+  mutable std::vector<char>   column_sorted; /* For each column: whether the bottom depths are non-decreasing. */
+
+  /*
+    When a grid with LGRs has been loaded the cells of the main grid
+    and all the LGRs are moved into one buffer owned by the main grid,
+    see ecl_grid_pack_lgr_cells(). The cells of the main grid come
+    first, followed by the cells of each LGR in the order of LGR_list;
+    the flat maps are only built for the main grid of a grid with LGRs.
+  */
+  bool                  shared_cells;   /* The cells are owned by the main grid. */
+  int                   flat_offset;    /* The flat index of cell 0 of this grid. */
+  std::vector<int>      flat_host_map;  /* The flat index of the host cell, -1 for cells in the main grid. */
+  std::vector<int>      flat_lgr_map;   /* The LGR_list index of the LGR refining the cell, -1 for unrefined cells. */
+
   ert_ecl_unit_enum     unit_system;
   int                   eclipse_version;
 };
@@ -770,7 +836,61 @@ ert_ecl_unit_enum ecl_grid_get_unit_system(const ecl_grid_type * grid) {
   return grid->unit_system;
 }
 
-static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
+
+/*
+  With ERT_GRID_FLOAT_GEOMETRY the absolute coordinates of a field at
+  UTM coordinates can not be represented in a float with sufficient
+  precision; the corners are therefor stored as float offsets from the
+  double precision geometry_origin, which is chosen as a point in the
+  grid before the cells are initialized. The ecl_cell_xxx() functions
+  work on these local coordinates, which is sufficient for translation
+  invariant properties like volume and cell dimensions. Points going
+  into and out of the grid are translated with the functions below. In
+  double precision builds the origin is zero and the translations are
+  exact no-ops.
+*/
+
+template <typename T>
+static void ecl_grid_init_geometry_origin( ecl_grid_type * grid , const T * xyz ) {
+#ifdef ERT_GRID_FLOAT_GEOMETRY
+  point_type origin;
+  point_set( &origin , xyz[0] , xyz[1] , xyz[2] );
+  if (grid->use_mapaxes)
+    point_mapaxes_transform( &origin , grid->origo , grid->unit_x , grid->unit_y );
+
+  grid->geometry_origin[0] = origin.x;
+  grid->geometry_origin[1] = origin.y;
+  grid->geometry_origin[2] = origin.z;
+#endif
+}
+
+
+static void ecl_grid_point_to_local( const ecl_grid_type * grid , point_type * p) {
+  point_shift( p , -grid->geometry_origin[0] , -grid->geometry_origin[1] , -grid->geometry_origin[2] );
+}
+
+
+static void ecl_grid_point_to_global( const ecl_grid_type * grid , point_type * p) {
+  point_shift( p , grid->geometry_origin[0] , grid->geometry_origin[1] , grid->geometry_origin[2] );
+}
+
+
+/* The arguments x,y,z are absolute coordinates, after mapaxes transformation. */
+static void ecl_grid_set_cell_corner( const ecl_grid_type * grid , ecl_cell_type * cell , int corner_nr , double x , double y , double z) {
+  point_set( &cell->corner_list[corner_nr] ,
+             x - grid->geometry_origin[0] ,
+             y - grid->geometry_origin[1] ,
+             z - grid->geometry_origin[2] );
+}
+
+
+static point_type ecl_grid_get_cell_corner( const ecl_grid_type * grid , const ecl_cell_type * cell , int corner_nr ) {
+  point_type p = cell->corner_list[corner_nr];
+  ecl_grid_point_to_global( grid , &p );
+  return p;
+}
+
+static void ecl_cell_compare(const ecl_grid_type * g1 , const ecl_cell_type * c1 , const ecl_grid_type * g2 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
   int i;
 
   if (c1->active != c2->active)
@@ -789,10 +909,19 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
   if (c1->host_cell != c2->host_cell)
     *equal = false;
 
+  /*
+    Bitwise identical corners is by far the most common case, the
+    relative tolerance test is only applied when that fails.
+  */
   if (*equal) {
-    for (i=0; i < 8; i++)
-      point_compare( &c1->corner_list[i] , &c2->corner_list[i] , equal );
-
+    bool same_origin = (memcmp( g1->geometry_origin , g2->geometry_origin , sizeof g1->geometry_origin ) == 0);
+    if (!same_origin || memcmp( c1->corner_list , c2->corner_list , sizeof c1->corner_list ) != 0) {
+      for (i=0; i < 8; i++) {
+        const point_type p1 = ecl_grid_get_cell_corner( g1 , c1 , i );
+        const point_type p2 = ecl_grid_get_cell_corner( g2 , c2 , i );
+        point_compare( &p1 , &p2 , equal );
+      }
+    }
   }
 
   if (include_nnc) {
@@ -803,16 +932,18 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
 }
 
 
-static void ecl_cell_dump( const ecl_cell_type * cell , FILE * stream) {
+static void ecl_cell_dump( const ecl_grid_type * grid , const ecl_cell_type * cell , FILE * stream) {
   int i;
-  for (i=0; i < 8; i++)
-    point_dump( &cell->corner_list[i] , stream );
+  for (i=0; i < 8; i++) {
+    const point_type p = ecl_grid_get_cell_corner( grid , cell , i );
+    point_dump( &p , stream );
+  }
 }
 
 
 static void ecl_cell_assert_center( ecl_cell_type * cell);
 
-static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k , FILE * stream , const double * offset) {
+static void ecl_cell_dump_ascii( const ecl_grid_type * grid , ecl_cell_type * cell , int i , int j , int k , FILE * stream , const double * offset) {
   fprintf(stream, "Cell: i:%3d  j:%3d    k:%3d   host_cell:%d  CoarseGroup:%4d active_nr:%6d  active:%d \nCorners:\n",
           i, j, k,
           cell->host_cell, cell->coarse_group,
@@ -820,15 +951,20 @@ static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k ,
           cell->active);
 
   ecl_cell_assert_center( cell );
-  fprintf(stream , "Center   : ");
-  point_dump_ascii( &cell->center , stream , offset);
-  fprintf(stream , "\n");
+  {
+    point_type center = cell->center;
+    ecl_grid_point_to_global( grid , &center );
+    fprintf(stream , "Center   : ");
+    point_dump_ascii( &center , stream , offset);
+    fprintf(stream , "\n");
+  }
 
   {
     int l;
     for (l=0; l < 8; l++) {
+      const point_type p = ecl_grid_get_cell_corner( grid , cell , l );
       fprintf(stream , "Corner %d : ",l);
-      point_dump_ascii( &cell->corner_list[l] , stream , offset);
+      point_dump_ascii( &p , stream , offset);
       fprintf(stream , "\n");
     }
   }
@@ -873,7 +1009,7 @@ static void ecl_cell_fwrite_GRID(const ecl_grid_type * grid,
     int c;
 
     for (c = 0; c < 8; c++) {
-      point_copy_values( &point , &cell->corner_list[c] );
+      point = ecl_grid_get_cell_corner( grid , cell , c );
       if (grid->use_mapaxes)
         point_mapaxes_invtransform( &point , grid->origo , grid->unit_x , grid->unit_y );
 
@@ -886,7 +1022,11 @@ static void ecl_cell_fwrite_GRID(const ecl_grid_type * grid,
 }
 
 //static const size_t cellMappingECLRi[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
-static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points) {
+static void ecl_cell_ri_export( const ecl_grid_type * grid , const ecl_cell_type * cell , double * ri_points) {
+  point_type corners[8];
+  for (int c = 0; c < 8; c++)
+    corners[c] = ecl_grid_get_cell_corner( grid , cell , c );
+
   int ecl_offset = 4;
   int ri_offset =  ecl_offset * 3;
   {
@@ -894,14 +1034,14 @@ static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points)
     // Handling the points 0,1 & 4,5 which map directly between ECLIPSE and RI
     for (point_nr =0; point_nr < 2; point_nr++) {
       // Points 0 & 1
-      ri_points[ point_nr * 3     ] =  cell->corner_list[point_nr].x;
-      ri_points[ point_nr * 3 + 1 ] =  cell->corner_list[point_nr].y;
-      ri_points[ point_nr * 3 + 2 ] = -cell->corner_list[point_nr].z;
+      ri_points[ point_nr * 3     ] =  corners[point_nr].x;
+      ri_points[ point_nr * 3 + 1 ] =  corners[point_nr].y;
+      ri_points[ point_nr * 3 + 2 ] = -corners[point_nr].z;
 
       // Points 4 & 5
-      ri_points[ ri_offset + point_nr * 3     ] =  cell->corner_list[ecl_offset + point_nr].x;
-      ri_points[ ri_offset + point_nr * 3 + 1 ] =  cell->corner_list[ecl_offset + point_nr].y;
-      ri_points[ ri_offset + point_nr * 3 + 2 ] = -cell->corner_list[ecl_offset + point_nr].z;
+      ri_points[ ri_offset + point_nr * 3     ] =  corners[ecl_offset + point_nr].x;
+      ri_points[ ri_offset + point_nr * 3 + 1 ] =  corners[ecl_offset + point_nr].y;
+      ri_points[ ri_offset + point_nr * 3 + 2 ] = -corners[ecl_offset + point_nr].z;
     }
   }
 
@@ -914,15 +1054,15 @@ static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points)
     for (ecl_point =2; ecl_point < 4; ecl_point++) {
       int ri_point = 5 - ecl_point;
       // Points 2 & 3
-      ri_points[ ri_point * 3     ] =  cell->corner_list[ecl_point].x;
-      ri_points[ ri_point * 3 + 1 ] =  cell->corner_list[ecl_point].y;
-      ri_points[ ri_point * 3 + 2 ] = -cell->corner_list[ecl_point].z;
+      ri_points[ ri_point * 3     ] =  corners[ecl_point].x;
+      ri_points[ ri_point * 3 + 1 ] =  corners[ecl_point].y;
+      ri_points[ ri_point * 3 + 2 ] = -corners[ecl_point].z;
 
 
       // Points 6 & 7
-      ri_points[ ri_offset + ri_point * 3     ] =  cell->corner_list[ecl_offset + ecl_point].x;
-      ri_points[ ri_offset + ri_point * 3 + 1 ] =  cell->corner_list[ecl_offset + ecl_point].y;
-      ri_points[ ri_offset + ri_point * 3 + 2 ] = -cell->corner_list[ecl_offset + ecl_point].z;
+      ri_points[ ri_offset + ri_point * 3     ] =  corners[ecl_offset + ecl_point].x;
+      ri_points[ ri_offset + ri_point * 3 + 1 ] =  corners[ecl_offset + ecl_point].y;
+      ri_points[ ri_offset + ri_point * 3 + 2 ] = -corners[ecl_offset + ecl_point].z;
     }
   }
 }
@@ -1030,10 +1170,10 @@ static double ecl_cell_max_y( const ecl_cell_type * cell ) {
  */
 
 
-static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
+static void ecl_cell_taint_cell( const ecl_grid_type * grid , ecl_cell_type * cell ) {
   int c;
   for (c = 0; c < 8; c++) {
-    const point_type p = cell->corner_list[c];
+    const point_type p = ecl_grid_get_cell_corner( grid , cell , c );
     if ((p.x == 0) && (p.y == 0)) {
       SET_CELL_FLAG(cell , CELL_FLAG_TAINTED);
       break;
@@ -1072,8 +1212,8 @@ static int ecl_cell_get_twist( const ecl_cell_type * cell ) {
   int twist_count = 0;
 
   for (int c = 0; c < 4; c++) {
-    const point_type * p1 = &cell->corner_list[c];
-    const point_type * p2 = &cell->corner_list[c + 4];
+    const cell_point_type * p1 = &cell->corner_list[c];
+    const cell_point_type * p2 = &cell->corner_list[c + 4];
     if ((p2->z - p1->z) < 0)
       twist_count += 1;
   }
@@ -1117,13 +1257,15 @@ static int ecl_cell_get_tetrahedron_method( int i , int j , int k) {
 */
 
 static void ecl_cell_set_center( ecl_cell_type * cell) {
-  point_set(&cell->center , 0 , 0 , 0);
+  point_type center;
+  point_set(&center , 0 , 0 , 0);
   {
     int c;
     for (c = 0; c < 8; c++)
-      point_inplace_add(&cell->center , &cell->corner_list[c]);
+      point_inplace_add(&center , &cell->corner_list[c]);
   }
-  point_inplace_scale(&cell->center , 1.0 / 8.0);
+  point_inplace_scale(&center , 1.0 / 8.0);
+  cell->center = center;
 
   SET_CELL_FLAG( cell , CELL_FLAG_CENTER );
 }
@@ -1389,7 +1531,7 @@ static bool ecl_cell_layer_contains_xy(const ecl_cell_type * cell,
   if (GET_CELL_FLAG(cell,CELL_FLAG_TAINTED))
     return false;
   {
-    const point_type *p0,*p1,*p2,*p3;
+    point_type p0,p1,p2,p3;
     {
       int corner_offset;
       if (lower_layer)
@@ -1397,16 +1539,16 @@ static bool ecl_cell_layer_contains_xy(const ecl_cell_type * cell,
       else
         corner_offset = 4;
 
-      p0 = &cell->corner_list[corner_offset + 0];
-      p1 = &cell->corner_list[corner_offset + 1];
-      p2 = &cell->corner_list[corner_offset + 2];
-      p3 = &cell->corner_list[corner_offset + 3];
+      p0 = cell->corner_list[corner_offset + 0];
+      p1 = cell->corner_list[corner_offset + 1];
+      p2 = cell->corner_list[corner_offset + 2];
+      p3 = cell->corner_list[corner_offset + 3];
     }
 
-    if (triangle_contains(p0,p1,p2,x,y))
+    if (triangle_contains(&p0,&p1,&p2,x,y))
       return true;
     else
-      return triangle_contains(p1,p2,p3,x,y);
+      return triangle_contains(&p1,&p2,&p3,x,y);
   }
 }
 
@@ -1419,7 +1561,8 @@ static bool ecl_cell_layer_contains_xy(const ecl_cell_type * cell,
          |   |           |   |
          0---1           4---5
 */
-static void ecl_cell_init_regular(ecl_cell_type * cell,
+static void ecl_cell_init_regular(const ecl_grid_type * grid,
+                                  ecl_cell_type * cell,
                                   const double * offset,
                                   int i,
                                   int j,
@@ -1429,23 +1572,18 @@ static void ecl_cell_init_regular(ecl_cell_type * cell,
                                   const double * jvec,
                                   const double * kvec,
                                   const int * actnum) {
-  point_set(&cell->corner_list[0] , offset[0] , offset[1] , offset[2] ); // Point 0
-
-  cell->corner_list[1] = cell->corner_list[0];                       // Point 1
-  point_shift(&cell->corner_list[1] , ivec[0] , ivec[1] , ivec[2]);
-
-  cell->corner_list[2] = cell->corner_list[0];                       // Point 2
-  point_shift(&cell->corner_list[2] , jvec[0] , jvec[1] , jvec[2]);
-
-  cell->corner_list[3] = cell->corner_list[1];                       // Point 3
-  point_shift(&cell->corner_list[3] , jvec[0] , jvec[1] , jvec[2]);
-
-  {
-    int i;
-    for (i=0; i < 4; i++) {
-      cell->corner_list[i+4] = cell->corner_list[i];                      // Point 4-7
-      point_shift(&cell->corner_list[i+4] , kvec[0] , kvec[1] , kvec[2]);
+  for (int c = 0; c < 8; c++) {
+    double p[3];
+    for (int d = 0; d < 3; d++) {
+      p[d] = offset[d];
+      if (c & 1)
+        p[d] += ivec[d];
+      if (c & 2)
+        p[d] += jvec[d];
+      if (c & 4)
+        p[d] += kvec[d];
     }
+    ecl_grid_set_cell_corner( grid , cell , c , p[0] , p[1] , p[2] );
   }
 
   if (actnum != NULL)
@@ -1483,7 +1621,7 @@ static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
   int index;
   for (index = 0; index < ecl_grid->size; index++) {
     ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , index );
-    ecl_cell_taint_cell( cell );
+    ecl_cell_taint_cell( ecl_grid , cell );
   }
 }
 
@@ -1497,7 +1635,8 @@ static void ecl_grid_free_cells( ecl_grid_type * grid ) {
     if (cell->nnc_info)
       nnc_info_free(cell->nnc_info);
   }
-  free( grid->cells );
+  if (!grid->shared_cells)
+    free( grid->cells );
 
 }
 
@@ -1548,6 +1687,9 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   grid->global_grid           = global_grid;
   grid->coarsening_active     = false;
   grid->mapaxes               = NULL;
+  grid->geometry_origin[0]    = 0;
+  grid->geometry_origin[1]    = 0;
+  grid->geometry_origin[2]    = 0;
 
   grid->dualp_flag            = dualp_flag;
   grid->coord_kw              = NULL;
@@ -1557,7 +1699,8 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   grid->fracture_index_map    = NULL;
   grid->inv_fracture_index_map = NULL;
   grid->unit_system            = unit_system;
-
+  grid->shared_cells           = false;
+  grid->flat_offset            = 0;
 
   if (global_grid != NULL) {
     /*
@@ -1628,10 +1771,13 @@ static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , in
   for (iz = 0; iz < 2; iz++) {
     for (ip = 0; ip < 4; ip++) {
       int c = ip + iz * 4;
-      point_set(&cell->corner_list[c] , x[ip][iz] , y[ip][iz] , z[ip][iz]);
+      point_type p;
+      point_set(&p , x[ip][iz] , y[ip][iz] , z[ip][iz]);
 
       if (ecl_grid->use_mapaxes)
-        point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
+        point_mapaxes_transform( &p , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
+
+      ecl_grid_set_cell_corner( ecl_grid , cell , c , p.x , p.y , p.z );
     }
   }
 
@@ -1738,11 +1884,13 @@ static void ecl_grid_set_cell_GRID(ecl_grid_type * ecl_grid,
 
     if (matrix_cell) {
       for (c = 0; c < 8; c++) {
-        point_set(&cell->corner_list[c] , corners[3*c] , corners[3*c + 1] , corners[3*c + 2]);
+        point_type p;
+        point_set(&p , corners[3*c] , corners[3*c + 1] , corners[3*c + 2]);
 
         if (ecl_grid->use_mapaxes)
-          point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
+          point_mapaxes_transform( &p , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
 
+        ecl_grid_set_cell_corner( ecl_grid , cell , c , p.x , p.y , p.z );
       }
     }
   }
@@ -1875,6 +2023,9 @@ static void ecl_grid_set_active_index(ecl_grid_type * ecl_grid) {
   } else {
     /* --- More involved path in the case of coarsening groups. --- */
 
+    for (int coarse_group = 0; coarse_group < ecl_grid_get_num_coarse_groups( ecl_grid ); coarse_group++)
+      ecl_coarse_cell_reset_active( ecl_grid_iget_coarse_group( ecl_grid , coarse_group ));
+
     /* 1: Go through all the cells and set the active index. In the
           case of coarse cells we only set the common active index of
           the entire coarse cell.
@@ -2116,6 +2267,62 @@ static void ecl_grid_install_lgr_common(ecl_grid_type * host_grid , ecl_grid_typ
 }
 
 
+/*
+  Called when all the LGRs have been installed in the main grid: the
+  cells of the main grid and all the LGRs are moved into one buffer
+  owned by the main grid, and the flat host and lgr maps are built.
+  The cells do not point to each other, and the nnc_info instances
+  are owned by the grid the cell belongs to, so the cells can be moved
+  with memcpy(). The LGRs must not be added after this.
+*/
+
+static void ecl_grid_pack_lgr_cells( ecl_grid_type * main_grid ) {
+  int num_lgr = vector_get_size( main_grid->LGR_list );
+  if (num_lgr == 0)
+    return;
+
+  {
+    std::unordered_map<const ecl_grid_type *, int> lgr_index;
+    int flat_size = main_grid->size;
+    for (int l = 0; l < num_lgr; l++) {
+      ecl_grid_type * lgr = (ecl_grid_type*)vector_iget( main_grid->LGR_list , l );
+      lgr_index[lgr] = l;
+      lgr->flat_offset = flat_size;
+      flat_size += lgr->size;
+    }
+
+    {
+      ecl_cell_type * cells = (ecl_cell_type*)util_malloc( flat_size * sizeof * cells );
+      for (int l = -1; l < num_lgr; l++) {
+        ecl_grid_type * grid = (l < 0) ? main_grid : (ecl_grid_type*)vector_iget( main_grid->LGR_list , l );
+        memcpy( &cells[grid->flat_offset] , grid->cells , grid->size * sizeof * cells );
+        free( grid->cells );
+        grid->cells = &cells[grid->flat_offset];
+        grid->shared_cells = (l >= 0);
+      }
+    }
+
+    main_grid->flat_host_map.assign( flat_size , HOST_CELL_NONE );
+    main_grid->flat_lgr_map.assign( flat_size , -1 );
+    for (int l = -1; l < num_lgr; l++) {
+      const ecl_grid_type * grid = (l < 0) ? main_grid : (const ecl_grid_type*)vector_iget_const( main_grid->LGR_list , l );
+      int host_offset = grid->parent_grid ? grid->parent_grid->flat_offset : 0;
+
+      for (int global_index = 0; global_index < grid->size; global_index++) {
+        const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+        int flat_index = grid->flat_offset + global_index;
+
+        if (cell->host_cell != HOST_CELL_NONE)
+          main_grid->flat_host_map[flat_index] = host_offset + cell->host_cell;
+
+        if (cell->lgr)
+          main_grid->flat_lgr_map[flat_index] = lgr_index[cell->lgr];
+      }
+    }
+  }
+}
+
+
 /**
    this function will set the lgr pointer of the relevant cells in the
    host grid to point to the lgr_grid. observe that the ecl_cell_type
@@ -2163,11 +2370,9 @@ static void ecl_grid_install_lgr_GRID(ecl_grid_type * host_grid , ecl_grid_type
 */
 
 
-static void ecl_grid_set_lgr_name_EGRID(ecl_grid_type * lgr_grid , const ecl_file_type * ecl_file , int grid_nr) {
-  ecl_kw_type * lgrname_kw = ecl_file_iget_named_kw( ecl_file , LGR_KW , grid_nr - 1);
+static void ecl_grid_set_lgr_name_EGRID(ecl_grid_type * lgr_grid , const ecl_kw_type * lgrname_kw , const ecl_kw_type * parent_kw) {
   lgr_grid->name = (char*)util_alloc_strip_copy( (const char*)ecl_kw_iget_ptr( lgrname_kw , 0) );  /* trailing zeros are stripped away. */
-  if (ecl_file_has_kw( ecl_file , LGR_PARENT_KW)) {
-    ecl_kw_type * parent_kw = ecl_file_iget_named_kw( ecl_file , LGR_PARENT_KW , grid_nr -1);
+  if (parent_kw) {
     char * parent = (char*)util_alloc_strip_copy( (const char*)ecl_kw_iget_ptr( parent_kw , 0));
 
     if (strlen( parent ) > 0)
@@ -2390,6 +2595,7 @@ void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid,
                                const int * corsnum) {
   const int ny = ecl_grid->ny;
   int j;
+  ecl_grid_init_geometry_origin( ecl_grid , coord );
 #pragma omp parallel for
   for ( j=0; j < ny; j++)
     ecl_grid_init_GRDECL_data_jslice( ecl_grid , zcorn, coord , actnum , corsnum , j );
@@ -2404,6 +2610,7 @@ void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid,
                                const int * corsnum) {
   const int ny = ecl_grid->ny;
   int j;
+  ecl_grid_init_geometry_origin( ecl_grid , coord );
 #pragma omp parallel for
   for ( j=0; j < ny; j++)
     ecl_grid_init_GRDECL_data_jslice( ecl_grid , zcorn, coord , actnum , corsnum , j );
@@ -2515,14 +2722,51 @@ static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_
       target_cell->nnc_info = nnc_info_alloc_copy( src_cell->nnc_info );
   }
   ecl_grid_copy_mapaxes( target_grid , src_grid );
+  for (int i = 0; i < 3; i++)
+    target_grid->geometry_origin[i] = src_grid->geometry_origin[i];
 
   target_grid->parent_name = util_alloc_string_copy( src_grid->parent_name );
   target_grid->name = util_alloc_string_copy( src_grid->name );
 
   target_grid->coarsening_active = src_grid->coarsening_active;
   ecl_grid_init_coarse_cells( target_grid );
+
+  /*
+    The grid wide geometry arrays do not depend on ACTNUM, arrays which
+    have already been calculated for the source grid are copied instead
+    of being recalculated on first request.
+  */
+  {
+    std::lock_guard<std::mutex> lock( src_grid->geometry_mutex );
+    target_grid->volume_array = src_grid->volume_array;
+    target_grid->center_array = src_grid->center_array;
+    target_grid->depth_array = src_grid->depth_array;
+    target_grid->thickness_array = src_grid->thickness_array;
+    target_grid->bbox_array = src_grid->bbox_array;
+    target_grid->column_depth = src_grid->column_depth;
+    target_grid->column_sorted = src_grid->column_sorted;
+  }
+}
+
+
+/*
+  Sets the active flag of all cells from the actnum array, NULL means
+  all cells are active. Returns true if any of the cells changed.
+*/
+static bool ecl_grid_apply_actnum( ecl_grid_type * grid , const int * actnum ) {
+  bool changed = false;
+  for (int g = 0; g < grid->size; g++) {
+    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
+    int active = actnum ? actnum[g] : CELL_ACTIVE;
+    if (cell->active != active) {
+      cell->active = active;
+      changed = true;
+    }
+  }
+  return changed;
 }
 
+
 static ecl_grid_type * ecl_grid_alloc_copy__( const ecl_grid_type * src_grid,  ecl_grid_type * main_grid ) {
   ecl_grid_type * copy_grid = ecl_grid_alloc_empty( main_grid ,
                                                     src_grid->unit_system,
@@ -2573,21 +2817,39 @@ ecl_grid_type * ecl_grid_alloc_copy( const ecl_grid_type * src_grid ) {
 
     }
   }
+  ecl_grid_pack_lgr_cells( copy_grid );
 
   return copy_grid;
 }
 
 /*
-  Does not handle LGR
+  Does not handle LGR.
+
+  When only the actnum is changed the cell geometry, and the geometry
+  arrays already calculated for the source grid, are copied as they
+  are and only the index maps are built for the new actnum. That is the
+  cheap way to create many ACTNUM variants of one grid; the alternative
+  ecl_grid_alloc_ext_actnum() loads the grid from file every time.
 */
 ecl_grid_type * ecl_grid_alloc_processed_copy( const ecl_grid_type * src_grid , const double * zcorn , const int * actnum)
 {
   ecl_grid_type * grid;
 
   if (zcorn == NULL) {
-    grid = ecl_grid_alloc_copy__( src_grid , NULL );
-    if (actnum)
-      ecl_grid_reset_actnum( grid , actnum );
+    grid = ecl_grid_alloc_empty( NULL ,
+                                 src_grid->unit_system,
+                                 src_grid->dualp_flag ,
+                                 ecl_grid_get_nx( src_grid ) ,
+                                 ecl_grid_get_ny( src_grid ) ,
+                                 ecl_grid_get_nz( src_grid ) ,
+                                 0 ,
+                                 false );
+    if (grid) {
+      ecl_grid_copy_content( grid , src_grid );
+      if (actnum)
+        ecl_grid_apply_actnum( grid , actnum );
+      ecl_grid_update_index( grid );
+    }
   } else {
     int nx,ny,nz,na;
     int zcorn_size = ecl_grid_get_zcorn_size( src_grid );
@@ -3003,20 +3265,65 @@ static void ecl_grid_init_nnc_amalgamated(ecl_grid_type * main_grid, ecl_file_ty
 */
 
 
-static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes, const int * ext_actnum) {
-  ecl_kw_type * gridhead_kw  = ecl_file_iget_named_kw( ecl_file , GRIDHEAD_KW  , grid_nr);
-  ecl_kw_type * zcorn_kw     = ecl_file_iget_named_kw( ecl_file , ZCORN_KW     , grid_nr);
-  ecl_kw_type * coord_kw     = ecl_file_iget_named_kw( ecl_file , COORD_KW     , grid_nr);
-  ecl_kw_type * corsnum_kw   = NULL;
-  ecl_kw_type * actnum_kw    = NULL;
-  ecl_kw_type * gridunit_kw  = NULL;
-  ecl_kw_type * mapaxes_kw   = NULL;
+/*
+  The keywords for one grid section in an EGRID file. The keywords are
+  fetched from the ecl_file instance up front; ecl_file is not thread
+  safe, whereas the grid construction from the keywords is.
+*/
+
+typedef struct {
+  int           grid_nr;
+  ecl_kw_type * gridhead_kw;
+  ecl_kw_type * zcorn_kw;
+  ecl_kw_type * coord_kw;
+  ecl_kw_type * actnum_kw;    /* Can be NULL */
+  ecl_kw_type * filehead_kw;  /* Main grid only */
+  ecl_kw_type * gridunit_kw;  /* Main grid only - can be NULL */
+  ecl_kw_type * mapaxes_kw;   /* Main grid only - can be NULL */
+  ecl_kw_type * corsnum_kw;   /* Main grid only - can be NULL */
+  ecl_kw_type * lgr_kw;       /* LGR only */
+  ecl_kw_type * parent_kw;    /* LGR only - can be NULL */
+  ecl_kw_type * hostnum_kw;   /* LGR only */
+} egrid_kw_type;
+
+
+static void ecl_grid_fetch_EGRID_kw( const ecl_file_type * ecl_file , int grid_nr , egrid_kw_type * grid_kw) {
+  memset( grid_kw , 0 , sizeof * grid_kw );
+  grid_kw->grid_nr     = grid_nr;
+  grid_kw->gridhead_kw = ecl_file_iget_named_kw( ecl_file , GRIDHEAD_KW  , grid_nr);
+  grid_kw->zcorn_kw    = ecl_file_iget_named_kw( ecl_file , ZCORN_KW     , grid_nr);
+  grid_kw->coord_kw    = ecl_file_iget_named_kw( ecl_file , COORD_KW     , grid_nr);
+
+  if (ecl_file_get_num_named_kw(ecl_file , ACTNUM_KW) > grid_nr)
+    grid_kw->actnum_kw = ecl_file_iget_named_kw( ecl_file , ACTNUM_KW    , grid_nr);
+
+  if (grid_nr == 0) {
+    grid_kw->filehead_kw = ecl_file_iget_named_kw( ecl_file , FILEHEAD_KW  , grid_nr);
+
+    /* MAPAXES and COARSENING only apply to the global grid. */
+    if (ecl_file_has_kw( ecl_file , MAPAXES_KW))
+      grid_kw->mapaxes_kw   = ecl_file_iget_named_kw( ecl_file , MAPAXES_KW , 0);
+
+    if (ecl_file_has_kw( ecl_file , CORSNUM_KW))
+      grid_kw->corsnum_kw   = ecl_file_iget_named_kw( ecl_file , CORSNUM_KW , 0);
+
+    if (ecl_file_has_kw(ecl_file, GRIDUNIT_KW))
+      grid_kw->gridunit_kw = ecl_file_iget_named_kw( ecl_file, GRIDUNIT_KW, 0);
+  } else {
+    grid_kw->lgr_kw     = ecl_file_iget_named_kw( ecl_file , LGR_KW , grid_nr - 1);
+    grid_kw->hostnum_kw = ecl_file_iget_named_kw( ecl_file , HOSTNUM_KW , grid_nr - 1);
+    if (ecl_file_has_kw( ecl_file , LGR_PARENT_KW))
+      grid_kw->parent_kw = ecl_file_iget_named_kw( ecl_file , LGR_PARENT_KW , grid_nr - 1);
+  }
+}
+
+
+static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const egrid_kw_type * grid_kw , bool apply_mapaxes, const int * ext_actnum) {
   int dualp_flag;
   int eclipse_version;
-  if (grid_nr == 0) {
-    ecl_kw_type * filehead_kw  = ecl_file_iget_named_kw( ecl_file , FILEHEAD_KW  , grid_nr);
-    dualp_flag                 = ecl_kw_iget_int( filehead_kw , FILEHEAD_DUALP_INDEX );
-    eclipse_version = ecl_kw_iget_int( filehead_kw, FILEHEAD_YEAR_INDEX);
+  if (grid_kw->grid_nr == 0) {
+    dualp_flag                 = ecl_kw_iget_int( grid_kw->filehead_kw , FILEHEAD_DUALP_INDEX );
+    eclipse_version = ecl_kw_iget_int( grid_kw->filehead_kw, FILEHEAD_YEAR_INDEX);
   } else{
     dualp_flag = main_grid->dualp_flag;
     eclipse_version = main_grid->eclipse_version;
@@ -3030,37 +3337,23 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
   if (ext_actnum)
     actnum_data = ext_actnum;
   else {
-    if (ecl_file_get_num_named_kw(ecl_file , ACTNUM_KW) > grid_nr) {
-      actnum_kw = ecl_file_iget_named_kw( ecl_file , ACTNUM_KW    , grid_nr);
-      actnum_data = ecl_kw_get_int_ptr(actnum_kw);
-    }
-  }
-
-  if (grid_nr == 0) {
-    /* MAPAXES and COARSENING only apply to the global grid. */
-    if (ecl_file_has_kw( ecl_file , MAPAXES_KW))
-      mapaxes_kw   = ecl_file_iget_named_kw( ecl_file , MAPAXES_KW , 0);
-
-    if (ecl_file_has_kw( ecl_file , CORSNUM_KW))
-      corsnum_kw   = ecl_file_iget_named_kw( ecl_file , CORSNUM_KW , 0);
-
-    if (ecl_file_has_kw(ecl_file, GRIDUNIT_KW))
-      gridunit_kw = ecl_file_iget_named_kw( ecl_file, GRIDUNIT_KW, 0);
+    if (grid_kw->actnum_kw)
+      actnum_data = ecl_kw_get_int_ptr(grid_kw->actnum_kw);
   }
 
   {
     ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__( main_grid ,
                                                            dualp_flag ,
                                                            apply_mapaxes,
-                                                           gridhead_kw ,
-                                                           zcorn_kw ,
-                                                           coord_kw ,
-                                                           gridunit_kw,
-                                                           mapaxes_kw ,
-                                                           corsnum_kw,
+                                                           grid_kw->gridhead_kw ,
+                                                           grid_kw->zcorn_kw ,
+                                                           grid_kw->coord_kw ,
+                                                           grid_kw->gridunit_kw,
+                                                           grid_kw->mapaxes_kw ,
+                                                           grid_kw->corsnum_kw,
                                                            actnum_data);
 
-    if (ECL_GRID_MAINGRID_LGR_NR != grid_nr) ecl_grid_set_lgr_name_EGRID(ecl_grid , ecl_file , grid_nr);
+    if (ECL_GRID_MAINGRID_LGR_NR != grid_kw->grid_nr) ecl_grid_set_lgr_name_EGRID(ecl_grid , grid_kw->lgr_kw , grid_kw->parent_kw);
     ecl_grid->eclipse_version = eclipse_version;
     return ecl_grid;
   }
@@ -3073,6 +3366,12 @@ static ecl_grid_type * ecl_grid_alloc_GRID_all_grids(const char * filename) {
 }
 
 
+/*
+  The LGRs only depend on the main grid, and are created in parallel;
+  they are then added to the main grid and linked to their host cells
+  in the order they appear in the file.
+*/
+
 static ecl_grid_type * ecl_grid_alloc_EGRID_all_grids(const char * grid_file, bool apply_mapaxes, const int * ext_actnum) {
   ecl_file_enum   file_type;
   file_type = ecl_util_get_file_type(grid_file , NULL , NULL);
@@ -3082,25 +3381,34 @@ static ecl_grid_type * ecl_grid_alloc_EGRID_all_grids(const char * grid_file, bo
     ecl_file_type * ecl_file   = ecl_file_open( grid_file , 0);
     if (ecl_file) {
       int num_grid               = ecl_file_get_num_named_kw( ecl_file , GRIDHEAD_KW );
-      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes, ext_actnum );
-      int grid_nr;
+      std::vector<egrid_kw_type> grid_kw( num_grid );
+      std::vector<ecl_grid_type *> lgr_list( num_grid , NULL );
+
+      for (int grid_nr = 0; grid_nr < num_grid; grid_nr++)
+        ecl_grid_fetch_EGRID_kw( ecl_file , grid_nr , &grid_kw[grid_nr] );
+
+      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , &grid_kw[0] , apply_mapaxes, ext_actnum );
 
-      for ( grid_nr = 1; grid_nr < num_grid; grid_nr++) {
-        // The apply_mapaxes argument is ignored for LGR - 
-        //   it inherits from parent anyway.
-        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false, NULL );
+      // The apply_mapaxes argument is ignored for LGR -
+      //   it inherits from parent anyway.
+#pragma omp parallel for schedule(dynamic)
+      for (int grid_nr = 1; grid_nr < num_grid; grid_nr++)
+        lgr_list[grid_nr] = ecl_grid_alloc_EGRID__( main_grid , &grid_kw[grid_nr] , false, NULL );
+
+      for (int grid_nr = 1; grid_nr < num_grid; grid_nr++) {
+        ecl_grid_type * lgr_grid = lgr_list[grid_nr];
         ecl_grid_add_lgr( main_grid , lgr_grid );
         {
           ecl_grid_type * host_grid;
-          ecl_kw_type   * hostnum_kw = ecl_file_iget_named_kw( ecl_file , HOSTNUM_KW , grid_nr - 1);
           if (lgr_grid->parent_name == NULL)
             host_grid = main_grid;
           else
             host_grid = ecl_grid_get_lgr( main_grid , lgr_grid->parent_name );
 
-          ecl_grid_install_lgr_EGRID( host_grid , lgr_grid , ecl_kw_get_int_ptr( hostnum_kw) );
+          ecl_grid_install_lgr_EGRID( host_grid , lgr_grid , ecl_kw_get_int_ptr( grid_kw[grid_nr].hostnum_kw ));
         }
       }
+      ecl_grid_pack_lgr_cells( main_grid );
       main_grid->name = util_alloc_string_copy( grid_file );
       ecl_grid_init_nnc(main_grid, ecl_file);
       ecl_grid_init_nnc_amalgamated(main_grid, ecl_file);
@@ -3130,6 +3438,9 @@ static ecl_grid_type * ecl_grid_alloc_GRID_data__(ecl_grid_type * global_grid ,
       if (mapaxes != NULL)
         ecl_grid_init_mapaxes( grid , apply_mapaxes , mapaxes);
 
+      if (num_coords > 0)
+        ecl_grid_init_geometry_origin( grid , corners[0] );
+
       {
         int index;
         for ( index=0; index < num_coords; index++)
@@ -3351,6 +3662,7 @@ ecl_grid_type * ecl_grid_alloc_GRID(const char * grid_file, bool apply_mapaxes)
         ecl_grid_install_lgr_GRID( host_grid , lgr_grid );
       }
     }
+    ecl_grid_pack_lgr_cells( main_grid );
     main_grid->name = util_alloc_string_copy( grid_file );
     ecl_file_close( ecl_file );
     return main_grid;
@@ -3386,7 +3698,7 @@ ecl_grid_type * ecl_grid_alloc_regular( int nx, int ny , int nz , const double *
           };
 
           ecl_cell_type * cell = ecl_grid_get_cell(grid , global_index );
-          ecl_cell_init_regular( cell , offset , i,j,k,global_index , ivec , jvec , kvec , actnum );
+          ecl_cell_init_regular( grid , cell , offset , i,j,k,global_index , ivec , jvec , kvec , actnum );
         }
       }
     }
@@ -3453,7 +3765,7 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv( int nx, int ny , int nz , const doub
             ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
             ivec[0] = dxv[i];
 
-            ecl_cell_init_regular(cell, offset,
+            ecl_cell_init_regular(grid, cell, offset,
                                   i,j,k,global_index,
                                   ivec,jvec,kvec,
                                   actnum);
@@ -3480,57 +3792,47 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv_depthz( int nx, int ny , int nz , con
                                                /*lgr_nr=*/0, /*init_valid=*/true);
 
 
-    /* First layer - where the DEPTHZ keyword applies. */
+    /*
+      The DEPTHZ keyword applies to the top of the first layer, the
+      corner depths of the remaining layers are accumulated in double
+      precision.
+    */
     if (grid) {
-      int i,j;
-      int k = 0;
-      double y0 = 0;
+      const double origin[3] = {0, 0, depthz[0]};
+      std::vector<double> z( 4 * nx * ny );
+      int i,j,k;
+
+      ecl_grid_init_geometry_origin( grid , origin );
       for (j=0; j < ny; j++) {
-        double x0 = 0;
         for (i = 0; i < nx; i++) {
-          int global_index = i + j*nx + k*nx*ny;
-          ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
-          double z0 = depthz[ i     + j*(nx + 1)];
-          double z1 = depthz[ i + 1 + j*(nx + 1)];
-          double z2 = depthz[ i +     (j + 1)*(nx + 1)];
-          double z3 = depthz[ i + 1 + (j + 1)*(nx + 1)];
-
-
-          point_set(&cell->corner_list[0] , x0 , y0 , z0);
-          point_set(&cell->corner_list[1] , x0 + dxv[i] , y0 , z1);
-          point_set(&cell->corner_list[2] , x0          , y0 + dyv[j] , z2);
-          point_set(&cell->corner_list[3] , x0 + dxv[i] , y0 + dyv[j] , z3);
-          {
-            int c;
-            for (c = 0; c < 4; c++) {
-              cell->corner_list[c + 4] = cell->corner_list[c];
-              point_shift(&cell->corner_list[c + 4] , 0 , 0 , dzv[0]);
-            }
-          }
-          x0 += dxv[i];
+          double * cell_z = &z[4 * (i + j*nx)];
+          cell_z[0] = depthz[ i     + j*(nx + 1)];
+          cell_z[1] = depthz[ i + 1 + j*(nx + 1)];
+          cell_z[2] = depthz[ i +     (j + 1)*(nx + 1)];
+          cell_z[3] = depthz[ i + 1 + (j + 1)*(nx + 1)];
         }
-        y0 += dyv[j];
       }
-    }
 
-    /* Remaining layers */
-    if (grid) {
-      int i,j,k;
-      for (k=1; k < nz; k++) {
-        for (j=0; j <ny; j++) {
-          for (i=0; i < nx; i++) {
-            int g2 = i + j*nx + k*nx*ny;
-            int g1 = i + j*nx + (k - 1)*nx*ny;
-            ecl_cell_type* cell2 = ecl_grid_get_cell(grid, g2);
-            ecl_cell_type* cell1 = ecl_grid_get_cell(grid, g1);
+      for (k=0; k < nz; k++) {
+        double y0 = 0;
+        for (j=0; j < ny; j++) {
+          double x0 = 0;
+          for (i = 0; i < nx; i++) {
+            int global_index = i + j*nx + k*nx*ny;
+            ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
+            double * cell_z = &z[4 * (i + j*nx)];
+            const double x[4] = {x0, x0 + dxv[i], x0, x0 + dxv[i]};
+            const double y[4] = {y0, y0, y0 + dyv[j], y0 + dyv[j]};
             int c;
 
             for (c = 0; c < 4; c++) {
-              cell2->corner_list[c] = cell1->corner_list[c + 4];
-              cell2->corner_list[c + 4] = cell1->corner_list[c + 4];
-              point_shift( &cell2->corner_list[c + 4] , 0 , 0 , dzv[k]);
+              ecl_grid_set_cell_corner( grid , cell , c , x[c] , y[c] , cell_z[c] );
+              cell_z[c] += dzv[k];
+              ecl_grid_set_cell_corner( grid , cell , c + 4 , x[c] , y[c] , cell_z[c] );
             }
+            x0 += dxv[i];
           }
+          y0 += dyv[j];
         }
       }
     }
@@ -3584,9 +3886,12 @@ ecl_grid_type * ecl_grid_alloc_dx_dy_dz_tops( int nx, int ny , int nz , const do
                                              nx, ny, nz,
                                              0, true);
   if (grid) {
+    const double origin[3] = {0, 0, tops[0]};
     int i, j, k;
     double * y0 = (double*)util_calloc( nx, sizeof * y0 );
 
+    ecl_grid_init_geometry_origin( grid , origin );
+
     for (k=0; k < nz; k++) {
       for (i=0; i < nx; i++) {
         y0[i] = 0;
@@ -3598,15 +3903,15 @@ ecl_grid_type * ecl_grid_alloc_dx_dy_dz_tops( int nx, int ny , int nz , const do
           ecl_cell_type* cell = ecl_grid_get_cell(grid, g);
           double z0 = tops[ g ];
 
-          point_set(&cell->corner_list[0] , x0         , y0[i]         , z0);
-          point_set(&cell->corner_list[1] , x0 + dx[g] , y0[i]         , z0);
-          point_set(&cell->corner_list[2] , x0         , y0[i] + dy[g] , z0);
-          point_set(&cell->corner_list[3] , x0 + dx[g] , y0[i] + dy[g] , z0);
+          ecl_grid_set_cell_corner( grid , cell , 0 , x0         , y0[i]         , z0);
+          ecl_grid_set_cell_corner( grid , cell , 1 , x0 + dx[g] , y0[i]         , z0);
+          ecl_grid_set_cell_corner( grid , cell , 2 , x0         , y0[i] + dy[g] , z0);
+          ecl_grid_set_cell_corner( grid , cell , 3 , x0 + dx[g] , y0[i] + dy[g] , z0);
 
-          point_set(&cell->corner_list[4] , x0         , y0[i]         , z0 + dz[g]);
-          point_set(&cell->corner_list[5] , x0 + dx[g] , y0[i]         , z0 + dz[g]);
-          point_set(&cell->corner_list[6] , x0         , y0[i] + dy[g] , z0 + dz[g]);
-          point_set(&cell->corner_list[7] , x0 + dx[g] , y0[i] + dy[g] , z0 + dz[g]);
+          ecl_grid_set_cell_corner( grid , cell , 4 , x0         , y0[i]         , z0 + dz[g]);
+          ecl_grid_set_cell_corner( grid , cell , 5 , x0 + dx[g] , y0[i]         , z0 + dz[g]);
+          ecl_grid_set_cell_corner( grid , cell , 6 , x0         , y0[i] + dy[g] , z0 + dz[g]);
+          ecl_grid_set_cell_corner( grid , cell , 7 , x0 + dx[g] , y0[i] + dy[g] , z0 + dz[g]);
 
           x0    += dx[g];
           y0[i] += dy[g];
@@ -3911,32 +4216,77 @@ static bool ecl_grid_compare_coarse_cells(const ecl_grid_type * g1 , const ecl_g
 }
 
 
+/*
+  Will compare the cells of g1 and g2 and append the global index of
+  the differing cells to diff_list, at most max_diff cells are added -
+  max_diff <= 0 means no limit. The return value is the number of
+  differing cells added to the list.
+
+  The cells are compared in chunks; the cells within one chunk are
+  compared in parallel, and the comparison stops after the first chunk
+  where the number of differences reaches max_diff. Since the chunks
+  are processed in order the diff list will always contain the
+  differences with the lowest global index.
+*/
+
+#define ECL_GRID_COMPARE_CHUNK_SIZE 65536
+
+int ecl_grid_get_cell_diff_list(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , int max_diff , int_vector_type * diff_list) {
+  int num_diff = 0;
+
+  if (g1->size != g2->size)
+    util_abort("%s: can not compare grids of different size: %d / %d \n",__func__ , g1->size , g2->size);
+
+  if (max_diff <= 0)
+    max_diff = g1->size;
+
+  {
+    std::vector<char> diff( util_int_min( g1->size , ECL_GRID_COMPARE_CHUNK_SIZE ));
+    for (int offset = 0; offset < g1->size && num_diff < max_diff; offset += ECL_GRID_COMPARE_CHUNK_SIZE) {
+      int chunk_size = util_int_min( ECL_GRID_COMPARE_CHUNK_SIZE , g1->size - offset );
+
+#pragma omp parallel for
+      for (int index = 0; index < chunk_size; index++) {
+        bool equal = true;
+        ecl_cell_compare( g1 , ecl_grid_get_cell( g1 , offset + index ) , g2 , ecl_grid_get_cell( g2 , offset + index ) , include_nnc , &equal );
+        diff[index] = !equal;
+      }
+
+      for (int index = 0; index < chunk_size && num_diff < max_diff; index++) {
+        if (diff[index]) {
+          int_vector_append( diff_list , offset + index );
+          num_diff++;
+        }
+      }
+    }
+  }
+  return num_diff;
+}
+
+
 static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , bool verbose) {
-  int g;
   bool equal = true;
-  for (g = 0; g < g1->size; g++) {
-    bool this_equal = true;
+  int_vector_type * diff_list = int_vector_alloc( 0 , 0 );
+
+  if (ecl_grid_get_cell_diff_list( g1 , g2 , include_nnc , 1 , diff_list ) > 0) {
+    int g = int_vector_iget( diff_list , 0 );
     ecl_cell_type *c1 = ecl_grid_get_cell( g1 , g );
     ecl_cell_type *c2 = ecl_grid_get_cell( g2 , g );
-    ecl_cell_compare(c1 , c2 ,  include_nnc , &this_equal);
 
-    if (!this_equal) {
-      if (verbose) {
-        int i,j,k;
-        ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
-
-        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
-        printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c1 , i , j , k , stdout , NULL);
-        printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c2 , i , j , k , stdout , NULL );
-        printf("-----------------------------------------------------------------\n");
-
-      }
-      equal = false;
-      break;
+    if (verbose) {
+      int i,j,k;
+      ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
+
+      printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
+      printf("-----------------------------------------------------------------\n");
+      ecl_cell_dump_ascii( g1 , c1 , i , j , k , stdout , NULL);
+      printf("-----------------------------------------------------------------\n");
+      ecl_cell_dump_ascii( g2 , c2 , i , j , k , stdout , NULL );
+      printf("-----------------------------------------------------------------\n");
     }
+    equal = false;
   }
+  int_vector_free( diff_list );
   return equal;
 }
 
@@ -4106,15 +4456,97 @@ static bool ecl_grid_cube_contains(const ecl_cell_type * cell, const point_type
   return true;
 }
 
+
+/*
+  The bounding boxes of all the cells are stored as six separate
+  arrays, in the same order as the checks in ecl_grid_cube_contains().
+  With this layout the rejection test in ecl_grid_bbox_filter() is a
+  simple branch free loop over contiguous memory which the compiler
+  can vectorize, and the full point in cell test is only performed for
+  the few cells which survive the bounding box test.
+*/
+
+#define ECL_GRID_BBOX_BLOCK_SIZE 1024
+
+static void ecl_grid_init_bbox_array( const ecl_grid_type * grid ) {
+  std::lock_guard<std::mutex> lock( grid->geometry_mutex );
+  if (!grid->bbox_array.empty() || grid->size == 0)
+    return;
+
+  {
+    const int size = grid->size;
+    std::vector<double> bbox( 6 * size );
+    int global_index;
+
+#pragma omp parallel for
+    for (global_index = 0; global_index < size; global_index++) {
+      const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+      const double * origin = grid->geometry_origin;
+      bbox[global_index           ] = origin[0] + ecl_cell_min_x( cell );
+      bbox[global_index +     size] = origin[0] + ecl_cell_max_x( cell );
+      bbox[global_index + 2 * size] = origin[1] + ecl_cell_min_y( cell );
+      bbox[global_index + 3 * size] = origin[1] + ecl_cell_max_y( cell );
+      bbox[global_index + 4 * size] = origin[2] + ecl_cell_min_z( cell );
+      bbox[global_index + 5 * size] = origin[2] + ecl_cell_max_z( cell );
+    }
+    grid->bbox_array.swap( bbox );
+  }
+}
+
+
+/*
+  Returns the bounding boxes of all cells as six consecutive blocks of
+  global size: xmin, xmax, ymin, ymax, zmin and zmax. Observe that the
+  z limits are the minimum of the top corners and the maximum of the
+  bottom corners.
+*/
+const double * ecl_grid_get_bbox_array( const ecl_grid_type * grid ) {
+  ecl_grid_init_bbox_array( grid );
+  return grid->bbox_array.data();
+}
+
+
+/*
+  Will store the global index of all cells in [index1, index2) whose
+  bounding box overlaps the box [box_min, box_max] in the candidates
+  array, and return the number of candidates. The candidates array
+  must have room for (index2 - index1) elements. With box_min == box_max
+  this is the cells whose bounding box contains a point.
+*/
+int ecl_grid_bbox_filter( const ecl_grid_type * grid , const double * box_min , const double * box_max , int index1 , int index2 , int * candidates) {
+  ecl_grid_init_bbox_array( grid );
+  {
+    const int size = grid->size;
+    const double * xmin = grid->bbox_array.data();
+    const double * xmax = xmin + size;
+    const double * ymin = xmin + 2 * size;
+    const double * ymax = xmin + 3 * size;
+    const double * zmin = xmin + 4 * size;
+    const double * zmax = xmin + 5 * size;
+    int num_candidates = 0;
+
+    index1 = util_int_max( index1 , 0 );
+    index2 = util_int_min( index2 , size );
+    for (int global_index = index1; global_index < index2; global_index++) {
+      int inside = (box_max[2] >= zmin[global_index]) & (box_min[2] <= zmax[global_index]) &
+                   (box_max[0] >= xmin[global_index]) & (box_min[0] <= xmax[global_index]) &
+                   (box_max[1] >= ymin[global_index]) & (box_min[1] <= ymax[global_index]);
+      candidates[num_candidates] = global_index;
+      num_candidates += inside;
+    }
+    return num_candidates;
+  }
+}
+
 /*
    Returns true if and only if p is on plane "plane" of cell when decomposed by "method".
 */
 static bool ecl_grid_on_plane(const ecl_cell_type * cell, const int method,
         const int plane, const point_type * p) {
-  const point_type * p0 = &cell->corner_list[ tetrahedron_permutations[method][plane][0] ];
-  const point_type * p1 = &cell->corner_list[ tetrahedron_permutations[method][plane][1] ];
-  const point_type * p2 = &cell->corner_list[ tetrahedron_permutations[method][plane][2] ];
-  return triangle_contains3d(p0, p1, p2, p);
+  const point_type p0 = cell->corner_list[ tetrahedron_permutations[method][plane][0] ];
+  const point_type p1 = cell->corner_list[ tetrahedron_permutations[method][plane][1] ];
+  const point_type p2 = cell->corner_list[ tetrahedron_permutations[method][plane][2] ];
+  return triangle_contains3d(&p0, &p1, &p2, p);
 }
 
 /*
@@ -4213,26 +4645,29 @@ static bool tetrahedron_by_points_contains(const point_type * p0,
  Note: This function relies *HEAVILY* on the permutation of tetrahedron_permutations.
 */
 static bool concave_cell_contains( const ecl_cell_type * cell, int method, const point_type * p) {
+  point_type corners[8];
+  for (int c = 0; c < 8; c++)
+    corners[c] = cell->corner_list[c];
 
   const point_type * dia[2][2] = {
       {
-          &cell->corner_list[tetrahedron_permutations[method][0][1]],
-          &cell->corner_list[tetrahedron_permutations[method][0][2]]
+          &corners[tetrahedron_permutations[method][0][1]],
+          &corners[tetrahedron_permutations[method][0][2]]
       },
       {
-          &cell->corner_list[tetrahedron_permutations[method][10][1]],
-          &cell->corner_list[tetrahedron_permutations[method][10][2]]
+          &corners[tetrahedron_permutations[method][10][1]],
+          &corners[tetrahedron_permutations[method][10][2]]
       }
   };
 
   const point_type * extra[2][2] = {
       {
-          &cell->corner_list[tetrahedron_permutations[method][0][0]],
-          &cell->corner_list[tetrahedron_permutations[method][1][0]]
+          &corners[tetrahedron_permutations[method][0][0]],
+          &corners[tetrahedron_permutations[method][1][0]]
       },
       {
-          &cell->corner_list[tetrahedron_permutations[method][10][0]],
-          &cell->corner_list[tetrahedron_permutations[method][11][0]]
+          &corners[tetrahedron_permutations[method][10][0]],
+          &corners[tetrahedron_permutations[method][11][0]]
       }
   };
 
@@ -4271,6 +4706,7 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
   point_type p;
   ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , ecl_grid_get_global_index3( ecl_grid , i, j , k ));
   point_set( &p , x , y , z);
+  ecl_grid_point_to_local( ecl_grid , &p );
   int method = (i + j + k) % 2; // Chooses the approperiate decomposition method for the cell
 
   if (GET_CELL_FLAG(cell , CELL_FLAG_TAINTED))
@@ -4319,7 +4755,8 @@ int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k ,
   for (j=0; j < ecl_grid->ny; j++)
     for (i=0; i < ecl_grid->nx; i++) {
       int global_index = ecl_grid_get_global_index3( ecl_grid , i , j , k );
-      if (ecl_cell_layer_contains_xy( ecl_grid_get_cell( ecl_grid , global_index ) , lower_layer , x , y))
+      if (ecl_cell_layer_contains_xy( ecl_grid_get_cell( ecl_grid , global_index ) , lower_layer ,
+                                      x - ecl_grid->geometry_origin[0] , y - ecl_grid->geometry_origin[1]))
         return global_index;
     }
   return -1; /* Did not find x,y */
@@ -4442,16 +4879,41 @@ int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double
   }
 
   /*
-    OK - the attempted shortcuts did not pay off. Perform full linear search.
+    OK - the attempted shortcuts did not pay off. Perform full linear
+    search, block by block, where the full test is only performed for
+    the cells whose bounding box contains the point.
   */
+  {
+    const double xyz[3] = {x , y , z};
+    int candidates[ECL_GRID_BBOX_BLOCK_SIZE];
+    for (int index1 = 0; index1 < grid->size; index1 += ECL_GRID_BBOX_BLOCK_SIZE) {
+      int index2 = util_int_min( grid->size , index1 + ECL_GRID_BBOX_BLOCK_SIZE );
+      int num_candidates = ecl_grid_bbox_filter( grid , xyz , xyz , index1 , index2 , candidates );
+
+      for (int c = 0; c < num_candidates; c++) {
+        if (ecl_grid_cell_contains_xyz1( grid , candidates[c] , x , y , z))
+          return candidates[c];
+      }
+    }
+  }
+  return -1;
+}
 
-  global_index = -1;
 
-  for (int index = 0; index < grid->size; index++) {
-    if (ecl_grid_cell_contains_xyz1( grid , index , x , y , z))
-      return index;
+/*
+  Batched version of ecl_grid_get_global_index_from_xyz(). The result
+  for each point is used as start index for the next point, i.e. the
+  lookup is fastest when consecutive points are close - as e.g. along
+  a well path. Points which are not found in the grid get the global
+  index -1.
+*/
+void ecl_grid_get_global_index_list_from_xyz(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index) {
+  int start_index = -1;
+  for (int ip = 0; ip < num_points; ip++) {
+    global_index[ip] = ecl_grid_get_global_index_from_xyz( grid , x[ip] , y[ip] , z[ip] , start_index );
+    if (global_index[ip] >= 0)
+      start_index = global_index[ip];
   }
-  return -1;
 }
 
 bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k ) {
@@ -4609,6 +5071,14 @@ int ecl_grid_get_block_count3d(const ecl_grid_type * grid , int i , int j, int k
 /*****************************************************************/
 
 void ecl_grid_free(ecl_grid_type * grid) {
+  /*
+    The LGRs must be freed before the main grid cells, their cells
+    can be in the buffer owned by the main grid.
+  */
+  if (ECL_GRID_MAINGRID_LGR_NR == grid->lgr_nr) { /* This is the main grid. */
+    vector_free( grid->LGR_list );
+    int_vector_free( grid->lgr_index_map);
+  }
   ecl_grid_free_cells( grid );
   free(grid->index_map);
   free(grid->inv_index_map);
@@ -4623,10 +5093,6 @@ void ecl_grid_free(ecl_grid_type * grid) {
       double_vector_free( grid->values[i] );
     free( grid->values );
   }
-  if (ECL_GRID_MAINGRID_LGR_NR == grid->lgr_nr) { /* This is the main grid. */
-    vector_free( grid->LGR_list );
-    int_vector_free( grid->lgr_index_map);
-  }
   if (grid->coord_kw != NULL)
     ecl_kw_free( grid->coord_kw );
 
@@ -4638,6 +5104,106 @@ void ecl_grid_free(ecl_grid_type * grid) {
 }
 
 
+/*
+  Estimate of the memory held by the grid, in bytes, for one component
+  or in total; for the main grid the LGRs are included. The NNC
+  component is the nnc_info of the cells - the NNC keywords are not
+  retained after loading.
+*/
+
+size_t ecl_grid_get_memory_usage( const ecl_grid_type * grid , ecl_grid_memory_enum component ) {
+  switch (component) {
+  case ECL_GRID_MEMORY_CELLS:
+    {
+      size_t usage = grid->size * sizeof * grid->cells;
+      if (grid->coord_kw)
+        usage += ecl_kw_get_memory_usage( grid->coord_kw );
+      if (grid->mapaxes)
+        usage += 6 * sizeof * grid->mapaxes;
+      return usage;
+    }
+  case ECL_GRID_MEMORY_INDEX_MAPS:
+    {
+      size_t usage = 0;
+      if (grid->index_map)
+        usage += (grid->size + grid->total_active) * sizeof(int);
+      if (grid->fracture_index_map)
+        usage += (grid->size + grid->total_active_fracture) * sizeof(int);
+      if (grid->visited)
+        usage += grid->size * sizeof * grid->visited;
+      usage += ecl::util::memory_usage( grid->flat_host_map ) + ecl::util::memory_usage( grid->flat_lgr_map );
+      return usage;
+    }
+  case ECL_GRID_MEMORY_GEOMETRY_ARRAYS:
+    {
+      std::lock_guard<std::mutex> lock( grid->geometry_mutex );
+      return ecl::util::memory_usage( grid->volume_array ) +
+             ecl::util::memory_usage( grid->center_array ) +
+             ecl::util::memory_usage( grid->depth_array ) +
+             ecl::util::memory_usage( grid->thickness_array ) +
+             ecl::util::memory_usage( grid->bbox_array ) +
+             ecl::util::memory_usage( grid->column_depth ) +
+             ecl::util::memory_usage( grid->column_sorted );
+    }
+  case ECL_GRID_MEMORY_LGR:
+    {
+      size_t usage = ecl::util::memory_usage( grid->children ) + ecl::util::memory_usage( grid->LGR_hash );
+      if (grid->LGR_list) {
+        usage += vector_get_size( grid->LGR_list ) * sizeof(void *);
+        usage += int_vector_size( grid->lgr_index_map ) * sizeof(int);
+        for (int lgr_index = 0; lgr_index < vector_get_size( grid->LGR_list ); lgr_index++) {
+          const ecl_grid_type * lgr = (const ecl_grid_type*)vector_iget_const( grid->LGR_list , lgr_index );
+          usage += ecl_grid_get_memory_usage( lgr , ECL_GRID_MEMORY_TOTAL );
+        }
+      }
+      return usage;
+    }
+  case ECL_GRID_MEMORY_NNC:
+    {
+      size_t usage = 0;
+      for (int global_index = 0; global_index < grid->size; global_index++) {
+        const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+        if (cell->nnc_info)
+          usage += nnc_info_get_memory_usage( cell->nnc_info );
+      }
+      return usage;
+    }
+  case ECL_GRID_MEMORY_COARSE_CELLS:
+    {
+      size_t usage = vector_get_size( grid->coarse_cells ) * sizeof(void *);
+      for (int coarse_nr = 0; coarse_nr < vector_get_size( grid->coarse_cells ); coarse_nr++)
+        usage += ecl_coarse_cell_get_memory_usage( (const ecl_coarse_cell_type*)vector_iget_const( grid->coarse_cells , coarse_nr ));
+      return usage;
+    }
+  case ECL_GRID_MEMORY_VALUES:
+    {
+      size_t usage = 0;
+      if (grid->values) {
+        usage += grid->block_size * sizeof * grid->values;
+        for (int index = 0; index < grid->block_size; index++)
+          usage += double_vector_size( grid->values[index] ) * sizeof(double);
+      }
+      return usage;
+    }
+  case ECL_GRID_MEMORY_TOTAL:
+    {
+      size_t usage = sizeof * grid;
+      if (grid->name)
+        usage += strlen( grid->name ) + 1;
+      if (grid->parent_name)
+        usage += strlen( grid->parent_name ) + 1;
+
+      for (int c = ECL_GRID_MEMORY_CELLS; c <= ECL_GRID_MEMORY_VALUES; c++)
+        usage += ecl_grid_get_memory_usage( grid , (ecl_grid_memory_enum) c );
+      return usage;
+    }
+  default:
+    util_abort("%s: invalid component:%d\n",__func__ , component);
+    return 0;
+  }
+}
+
+
 void ecl_grid_free__( void * arg ) {
   ecl_grid_type * ecl_grid = ecl_grid_safe_cast( arg );
   ecl_grid_free( ecl_grid );
@@ -4660,7 +5226,54 @@ void ecl_grid_get_distance(const ecl_grid_type * grid , int global_index1, int g
 }
 
 
-
+/*
+  Batched versions of ecl_grid_get_distance(); the distances are
+  calculated from the grid wide center array. Any of the output
+  arrays dx, dy, dz and distance can be NULL. For the list version
+  the distance between global_index1[i] and global_index2[i] is
+  calculated, for the one to many version the distance between
+  global_index and all the cells in global_index_list.
+
+  Small lists are handled on the calling thread; the threshold
+  ECL_GRID_DISTANCE_PARALLEL_SIZE avoids starting threads for a few
+  pairs.
+*/
+
+#define ECL_GRID_DISTANCE_PARALLEL_SIZE 100000
+
+static void ecl_grid_get_distance__(const double * center , int num_pairs , const int * global_index1 , int global_index , const int * global_index2 ,
+                                    double * dx , double * dy , double * dz , double * distance) {
+#pragma omp parallel for if (num_pairs > ECL_GRID_DISTANCE_PARALLEL_SIZE)
+  for (int i = 0; i < num_pairs; i++) {
+    const double * c1 = &center[3 * (global_index1 ? global_index1[i] : global_index)];
+    const double * c2 = &center[3 * global_index2[i]];
+    double d[3] = {c1[0] - c2[0], c1[1] - c2[1], c1[2] - c2[2]};
+
+    if (dx)
+      dx[i] = d[0];
+    if (dy)
+      dy[i] = d[1];
+    if (dz)
+      dz[i] = d[2];
+    if (distance)
+      distance[i] = sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+  }
+}
+
+
+void ecl_grid_get_distance_list(const ecl_grid_type * grid , int num_pairs , const int * global_index1 , const int * global_index2 ,
+                                double * dx , double * dy , double * dz , double * distance) {
+  ecl_grid_get_distance__( ecl_grid_get_center_array( grid ) , num_pairs , global_index1 , 0 , global_index2 , dx , dy , dz , distance );
+}
+
+
+void ecl_grid_get_distance_one_to_many(const ecl_grid_type * grid , int global_index , int num_cells , const int * global_index_list ,
+                                       double * dx , double * dy , double * dz , double * distance) {
+  ecl_grid_get_distance__( ecl_grid_get_center_array( grid ) , num_cells , NULL , global_index , global_index_list , dx , dy , dz , distance );
+}
+
+
+
 /*****************************************************************/
 /* Index based query functions */
 /*****************************************************************/
@@ -4868,9 +5481,11 @@ void ecl_grid_get_xyz1(const ecl_grid_type * grid , int global_index , double *x
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
   ecl_cell_assert_center( cell );
   {
-    *xpos = cell->center.x;
-    *ypos = cell->center.y;
-    *zpos = cell->center.z;
+    point_type center = cell->center;
+    ecl_grid_point_to_global( grid , &center );
+    *xpos = center.x;
+    *ypos = center.y;
+    *zpos = center.z;
   }
 }
 
@@ -4894,7 +5509,7 @@ void ecl_grid_get_xyz3(const ecl_grid_type * grid , int i, int j , int k, double
 void ecl_grid_get_cell_corner_xyz1(const ecl_grid_type * grid , int global_index , int corner_nr , double * xpos , double * ypos , double * zpos ) {
   if ((corner_nr >= 0) &&  (corner_nr <= 7)) {
     const ecl_cell_type * cell  = ecl_grid_get_cell( grid , global_index );
-    const point_type      point = cell->corner_list[ corner_nr ];
+    const point_type      point = ecl_grid_get_cell_corner( grid , cell , corner_nr );
     *xpos = point.x;
     *ypos = point.y;
     *zpos = point.z;
@@ -4905,7 +5520,7 @@ void ecl_grid_get_cell_corner_xyz1(const ecl_grid_type * grid , int global_index
 void ecl_grid_export_cell_corners1(const ecl_grid_type * grid, int global_index, double *x, double *y, double *z) {
   const ecl_cell_type * cell = ecl_grid_get_cell(grid, global_index);
   for (int i=0; i<8; i++) {
-    const point_type point = cell->corner_list[i];
+    const point_type point = ecl_grid_get_cell_corner( grid , cell , i );
     x[i] = point.x;
     y[i] = point.y;
     z[i] = point.z;
@@ -4962,7 +5577,7 @@ void ecl_grid_get_xyz1A(const ecl_grid_type * grid , int active_index , double *
 double ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index) {
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
   ecl_cell_assert_center( cell );
-  return cell->center.z;
+  return grid->geometry_origin[2] + cell->center.z;
 }
 
 
@@ -4980,25 +5595,81 @@ double ecl_grid_get_cdepth1A(const ecl_grid_type * grid , int active_index) {
 
 
 
+/*
+  The top and bottom depth of all cells, stored contiguously column by
+  column, to support fast lookup of the layer at a given depth in
+  ecl_grid_locate_depth().
+*/
+
+static void ecl_grid_init_column_depth( const ecl_grid_type * grid ) {
+  std::lock_guard<std::mutex> lock( grid->geometry_mutex );
+  if (!grid->column_depth.empty() || grid->size == 0)
+    return;
+
+  {
+    const int nz = grid->nz;
+    const int num_columns = grid->nx * grid->ny;
+    std::vector<double> column_depth( 2 * grid->size );
+    std::vector<char> column_sorted( num_columns );
+    int column;
+
+#pragma omp parallel for
+    for (column = 0; column < num_columns; column++) {
+      double * top = &column_depth[2 * nz * column];
+      double * bottom = top + nz;
+      bool sorted = true;
+
+      for (int k = 0; k < nz; k++) {
+        int global_index = column + k * num_columns;
+        top[k] = ecl_grid_get_top1( grid , global_index );
+        bottom[k] = ecl_grid_get_bottom1( grid , global_index );
+        if (k > 0 && bottom[k] < bottom[k - 1])
+          sorted = false;
+      }
+      column_sorted[column] = sorted;
+    }
+    grid->column_sorted.swap( column_sorted );
+    grid->column_depth.swap( column_depth );
+  }
+}
+
+
+/*
+  Returns the layer k in column (i,j) which contains depth, i.e. the
+  cell where the bottom of the cell above is <= depth < bottom of the
+  cell. If depth is above the top of the column the function returns
+  -1 and if it is below the bottom the function returns -nz.
+*/
+
 int ecl_grid_locate_depth( const ecl_grid_type * grid , double depth , int i , int j ) {
-  if (depth < ecl_grid_get_top2( grid , i , j))
-    return -1;
-  else if (depth >= ecl_grid_get_bottom2( grid , i , j ))
-    return -1 * grid->nz;
-  else {
-    int k=0;
-    double bottom = ecl_grid_get_top3( grid , i , j , k);
+  ecl_grid_init_column_depth( grid );
+  {
+    const int nz = grid->nz;
+    const int column = i + j * grid->nx;
+    const double * top = &grid->column_depth[2 * nz * column];
+    const double * bottom = top + nz;
+
+    if (depth < top[0])
+      return -1;
+    else if (depth >= bottom[nz - 1])
+      return -1 * nz;
+    else if (grid->column_sorted[column])
+      return std::upper_bound( bottom , bottom + nz , depth ) - bottom;
+    else {
+      int k=0;
+      double cell_bottom = top[0];
 
-    while (true) {
-      double top = bottom;
-      bottom = ecl_grid_get_bottom3( grid , i , j , k );
+      while (true) {
+        double cell_top = cell_bottom;
+        cell_bottom = bottom[k];
 
-      if ((depth >= top) && (depth < bottom))
-        return k;
+        if ((depth >= cell_top) && (depth < cell_bottom))
+          return k;
 
-      k++;
-      if (k == grid->nz)
-        util_abort("%s: internal error when scanning for depth:%g \n",__func__ , depth);
+        k++;
+        if (k == nz)
+          util_abort("%s: internal error when scanning for depth:%g \n",__func__ , depth);
+      }
     }
   }
 }
@@ -5017,7 +5688,7 @@ double ecl_grid_get_top1(const ecl_grid_type * grid , int global_index) {
   for (ij = 0; ij < 4; ij++)
     depth += cell->corner_list[ij].z;
 
-  return depth * 0.25;
+  return grid->geometry_origin[2] + depth * 0.25;
 }
 
 
@@ -5059,7 +5730,7 @@ double ecl_grid_get_bottom1(const ecl_grid_type * grid , int global_index) {
   for (ij = 0; ij < 4; ij++)
     depth += cell->corner_list[ij + 4].z;
 
-  return depth * 0.25;
+  return grid->geometry_origin[2] + depth * 0.25;
 }
 
 
@@ -5406,6 +6077,54 @@ const ecl_grid_type * ecl_grid_get_cell_lgr1A(const ecl_grid_type * grid , int a
 }
 
 
+/*
+  The flat index space covers the main grid and all the LGRs, and is
+  the index into the cell buffer shared by the main grid and the LGRs:
+
+     flat_index = ecl_grid_get_flat_offset( lgr ) + global_index
+
+  The host and lgr maps make it possible to traverse the LGR hierarchy
+  with plain array lookups instead of following the cell->lgr and
+  host_cell links one grid at a time. The functions can be called with
+  the main grid or any of the LGRs; the maps are always those of the
+  main grid. For a grid without LGRs the maps are not built and the
+  functions return NULL; all cells are then unrefined main grid cells.
+*/
+
+static const ecl_grid_type * ecl_grid_get_flat_main_grid( const ecl_grid_type * grid ) {
+  return grid->global_grid ? grid->global_grid : grid;
+}
+
+
+int ecl_grid_get_flat_size( const ecl_grid_type * grid ) {
+  const ecl_grid_type * main_grid = ecl_grid_get_flat_main_grid( grid );
+  if (main_grid->flat_host_map.empty())
+    return main_grid->size;
+  return main_grid->flat_host_map.size();
+}
+
+
+int ecl_grid_get_flat_offset( const ecl_grid_type * grid ) {
+  return grid->flat_offset;
+}
+
+
+const int * ecl_grid_get_flat_host_map( const ecl_grid_type * grid ) {
+  const ecl_grid_type * main_grid = ecl_grid_get_flat_main_grid( grid );
+  if (main_grid->flat_host_map.empty())
+    return NULL;
+  return main_grid->flat_host_map.data();
+}
+
+
+const int * ecl_grid_get_flat_lgr_map( const ecl_grid_type * grid ) {
+  const ecl_grid_type * main_grid = ecl_grid_get_flat_main_grid( grid );
+  if (main_grid->flat_lgr_map.empty())
+    return NULL;
+  return main_grid->flat_lgr_map.data();
+}
+
+
 /**
    Will return the global grid for a lgr. If the input grid is indeed
    a global grid itself the function will return NULL.
@@ -5552,6 +6271,90 @@ double ecl_grid_get_cell_volume3( const ecl_grid_type * ecl_grid, int i , int j
 }
 
 
+/*
+  The functions below return geometry arrays of global size, i.e. with
+  one element (three for the center array) for every cell in the grid,
+  also the inactive cells. The arrays are owned by the grid, and each
+  array is calculated for all cells on the first call to its function;
+  this is much faster than calling the per cell functions in a loop
+  when the geometry of the whole grid is needed, e.g. for gravity and
+  subsidence calculations.
+
+  The functions can be called concurrently from several threads. The
+  returned pointers are valid until ecl_grid_free_geometry_arrays() or
+  ecl_grid_free() is called.
+*/
+
+template <typename cell_func>
+static const double * ecl_grid_get_geometry_array( const ecl_grid_type * grid , std::vector<double>& array , int width , cell_func init_cell) {
+  std::lock_guard<std::mutex> lock( grid->geometry_mutex );
+  if (array.empty() && grid->size > 0) {
+    const int size = grid->size;
+    std::vector<double> values( width * size );
+    int global_index;
+
+#pragma omp parallel for
+    for (global_index = 0; global_index < size; global_index++)
+      init_cell( global_index , &values[width * global_index] );
+
+    array.swap( values );
+  }
+  return array.data();
+}
+
+
+const double * ecl_grid_get_volume_array( const ecl_grid_type * grid ) {
+  return ecl_grid_get_geometry_array( grid , grid->volume_array , 1 , [grid](int global_index, double * volume) {
+      volume[0] = ecl_cell_get_volume( ecl_grid_get_cell( grid , global_index ));
+    });
+}
+
+
+const double * ecl_grid_get_center_array( const ecl_grid_type * grid ) {
+  return ecl_grid_get_geometry_array( grid , grid->center_array , 3 , [grid](int global_index, double * center) {
+      ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+      ecl_cell_assert_center( cell );
+      center[0] = grid->geometry_origin[0] + cell->center.x;
+      center[1] = grid->geometry_origin[1] + cell->center.y;
+      center[2] = grid->geometry_origin[2] + cell->center.z;
+    });
+}
+
+
+const double * ecl_grid_get_depth_array( const ecl_grid_type * grid ) {
+  return ecl_grid_get_geometry_array( grid , grid->depth_array , 1 , [grid](int global_index, double * depth) {
+      ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+      ecl_cell_assert_center( cell );
+      depth[0] = grid->geometry_origin[2] + cell->center.z;
+    });
+}
+
+
+const double * ecl_grid_get_thickness_array( const ecl_grid_type * grid ) {
+  return ecl_grid_get_geometry_array( grid , grid->thickness_array , 1 , [grid](int global_index, double * thickness) {
+      thickness[0] = ecl_grid_get_cell_thickness1( grid , global_index );
+    });
+}
+
+
+/*
+  Frees the geometry arrays, the bounding boxes and the column depths
+  which have been calculated for the grid; they will be recalculated
+  on the next request. Pointers returned by the array functions above
+  and by ecl_grid_get_bbox_array() are invalid after this call.
+*/
+void ecl_grid_free_geometry_arrays( const ecl_grid_type * grid ) {
+  std::lock_guard<std::mutex> lock( grid->geometry_mutex );
+  std::vector<double>().swap( grid->volume_array );
+  std::vector<double>().swap( grid->center_array );
+  std::vector<double>().swap( grid->depth_array );
+  std::vector<double>().swap( grid->thickness_array );
+  std::vector<double>().swap( grid->bbox_array );
+  std::vector<double>().swap( grid->column_depth );
+  std::vector<char>().swap( grid->column_sorted );
+}
+
+
 void ecl_grid_summarize(const ecl_grid_type * ecl_grid) {
   int             active_cells , nx,ny,nz;
   ecl_grid_get_dims(ecl_grid , &nx , &ny , &nz , &active_cells);
@@ -5919,7 +6722,7 @@ static void ecl_grid_dump__(const ecl_grid_type * grid , FILE * stream) {
     int i;
     for (i=0; i < grid->size; i++) {
       const ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-      ecl_cell_dump( cell , stream );
+      ecl_cell_dump( grid , cell , stream );
     }
   }
 }
@@ -5941,7 +6744,7 @@ static void ecl_grid_dump_ascii__(ecl_grid_type * grid , bool active_only , FILE
       if (cell->active_index[MATRIX_INDEX] >= 0 || !active_only) {
         int i,j,k;
         ecl_grid_get_ijk1( grid , l , &i , &j , &k);
-        ecl_cell_dump_ascii( cell , i,j,k , stream , NULL);
+        ecl_cell_dump_ascii( grid , cell , i,j,k , stream , NULL);
       }
     }
   }
@@ -5980,14 +6783,14 @@ void ecl_grid_dump_ascii_cell1(ecl_grid_type * grid , int global_index , FILE *
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
   int i,j,k;
   ecl_grid_get_ijk1( grid , global_index , &i , &j , &k);
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  ecl_cell_dump_ascii(grid , cell , i,j,k, stream , offset);
 }
 
 
 void ecl_grid_dump_ascii_cell3(ecl_grid_type * grid , int i , int j , int k , FILE * stream , const double * offset) {
   int global_index  = ecl_grid_get_global_index3(grid , i,j,k);
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  ecl_cell_dump_ascii(grid , cell , i,j,k, stream , offset);
 }
 
 /*****************************************************************/
@@ -6028,6 +6831,21 @@ bool ecl_grid_use_mapaxes( const ecl_grid_type * grid ) {
   return grid->use_mapaxes;
 }
 
+
+/*
+  Returns true if the library has been compiled with
+  ERT_GRID_FLOAT_GEOMETRY, i.e. the cell corners are stored in single
+  precision.
+*/
+
+bool ecl_grid_use_float_geometry( void ) {
+#ifdef ERT_GRID_FLOAT_GEOMETRY
+  return true;
+#else
+  return false;
+#endif
+}
+
 void ecl_grid_init_mapaxes_data_double( const ecl_grid_type * grid , double * mapaxes) {
   int i;
   for (i = 0; i < 6; i++)
@@ -6262,11 +7080,10 @@ ENDGRID             0:INTE
    a standard EGRID header without creating a grid instance first.
 */
 
-static void ecl_grid_fwrite_main_EGRID_header( const ecl_grid_type * grid , fortio_type * fortio , ert_ecl_unit_enum output_unit) {
+static void ecl_grid_fwrite_main_EGRID_header( fortio_type * fortio , ert_ecl_unit_enum output_unit , int dualp_flag , const float * mapaxes) {
   int EGRID_VERSION  = 3;
   int RELEASE_YEAR   = 2007;
   int COMPAT_VERSION = 0;
-  const float * mapaxes = ecl_grid_get_mapaxes( grid );
 
   {
     ecl_kw_type * filehead_kw = ecl_kw_alloc( FILEHEAD_KW , 100 , ECL_INT);
@@ -6276,7 +7093,7 @@ static void ecl_grid_fwrite_main_EGRID_header( const ecl_grid_type * grid , fort
     ecl_kw_iset_int( filehead_kw , FILEHEAD_YEAR_INDEX      , RELEASE_YEAR );
     ecl_kw_iset_int( filehead_kw , FILEHEAD_COMPAT_INDEX    , COMPAT_VERSION );
     ecl_kw_iset_int( filehead_kw , FILEHEAD_TYPE_INDEX      , FILEHEAD_GRIDTYPE_CORNERPOINT );
-    ecl_kw_iset_int( filehead_kw , FILEHEAD_DUALP_INDEX     , grid->dualp_flag );
+    ecl_kw_iset_int( filehead_kw , FILEHEAD_DUALP_INDEX     , dualp_flag );
     ecl_kw_iset_int( filehead_kw , FILEHEAD_ORGFORMAT_INDEX , FILEHEAD_ORGTYPE_CORNERPOINT );
 
     ecl_kw_fwrite( filehead_kw , fortio );
@@ -6284,8 +7101,11 @@ static void ecl_grid_fwrite_main_EGRID_header( const ecl_grid_type * grid , fort
   }
 
   ecl_grid_fwrite_mapunits( fortio , output_unit );
-  if (mapaxes != NULL)
-    ecl_grid_fwrite_mapaxes( grid , fortio );
+  if (mapaxes != NULL) {
+    ecl_kw_type * mapaxes_kw = ecl_kw_alloc_new( MAPAXES_KW , 6 , ECL_FLOAT , mapaxes );
+    ecl_kw_fwrite( mapaxes_kw , fortio );
+    ecl_kw_free( mapaxes_kw );
+  }
 
   ecl_grid_fwrite_gridunits( fortio , output_unit);
 }
@@ -6363,8 +7183,8 @@ static bool ecl_grid_init_coord_section__( const ecl_grid_type * grid , int i, i
     int corner_index = j_corner*2 + i_corner;
     int coord_offset = 6 * ( (j + j_corner) * (grid->nx + 1) + (i + i_corner) );
     {
-      point_copy_values( &top_point    , &top_cell->corner_list[corner_index]);
-      point_copy_values( &bottom_point , &bottom_cell->corner_list[ corner_index + 4]);
+      top_point    = ecl_grid_get_cell_corner( grid , top_cell , corner_index );
+      bottom_point = ecl_grid_get_cell_corner( grid , bottom_cell , corner_index + 4 );
 
 
       if ((top_point.z == bottom_point.z) && (force_set == false)) {
@@ -6489,10 +7309,10 @@ static void ecl_grid_init_zcorn_data__( const ecl_grid_type * grid , float * zco
         int l;
 
         for (l=0; l < 2; l++) {
-          point_type p0 = cell->corner_list[ 4*l];
-          point_type p1 = cell->corner_list[ 4*l + 1];
-          point_type p2 = cell->corner_list[ 4*l + 2];
-          point_type p3 = cell->corner_list[ 4*l + 3];
+          point_type p0 = ecl_grid_get_cell_corner( grid , cell , 4*l );
+          point_type p1 = ecl_grid_get_cell_corner( grid , cell , 4*l + 1 );
+          point_type p2 = ecl_grid_get_cell_corner( grid , cell , 4*l + 2 );
+          point_type p3 = ecl_grid_get_cell_corner( grid , cell , 4*l + 3 );
 
           int z1 = k*8*nx*ny + j*4*nx + 2*i            + l*4*nx*ny;
           int z2 = k*8*nx*ny + j*4*nx + 2*i  +  1      + l*4*nx*ny;
@@ -6715,17 +7535,67 @@ ecl_kw_type * ecl_grid_alloc_gridhead_kw( int nx, int ny , int nz , int grid_nr)
 /*****************************************************************/
 
 
+/*
+  Updates the ACTNUM of the grid in place. The cell geometry and the
+  geometry arrays are left untouched, only the active index of the
+  cells and the index maps are recalculated - and only if the actnum
+  differs from the current one.
+*/
 void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum ) {
-  const int global_size = ecl_grid_get_global_size( grid );
-  int g;
-  for (g=0; g < global_size; g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
-    if (actnum)
-      cell->active = actnum[g];
+  if (ecl_grid_apply_actnum( grid , actnum ))
+    ecl_grid_update_index( grid );
+}
+
+
+/*
+  The nnc1 and nnc2 arrays contain the global indices of the cells
+  with offset 1, as they are stored in the file.
+*/
+
+static void ecl_grid_fwrite_nnc_kw( fortio_type * fortio , int lgr_nr , int num_nnc , const int * nnc1 , const int * nnc2) {
+  ecl_kw_type * nnc1_kw = ecl_kw_alloc_new_shared( NNC1_KW , num_nnc , ECL_INT , (int *) nnc1);
+  ecl_kw_type * nnc2_kw = ecl_kw_alloc_new_shared( NNC2_KW , num_nnc , ECL_INT , (int *) nnc2);
+  ecl_kw_type * nnchead_kw = ecl_kw_alloc( NNCHEAD_KW , NNCHEAD_SIZE , ECL_INT);
+
+  ecl_kw_scalar_set_int( nnchead_kw , 0 );
+  ecl_kw_iset_int( nnchead_kw , NNCHEAD_NUMNNC_INDEX , num_nnc );
+  ecl_kw_iset_int( nnchead_kw , NNCHEAD_LGR_INDEX , lgr_nr );
+
+  ecl_kw_fwrite( nnchead_kw , fortio);
+  ecl_kw_fwrite( nnc1_kw , fortio);
+  ecl_kw_fwrite( nnc2_kw , fortio);
+
+  ecl_kw_free( nnchead_kw );
+  ecl_kw_free( nnc2_kw );
+  ecl_kw_free( nnc1_kw );
+}
+
+
+static void ecl_grid_fwrite_lgr_header( fortio_type * fortio , const char * lgr_name , const char * parent_name) {
+  {
+    ecl_kw_type * lgr_kw = ecl_kw_alloc(LGR_KW , 1 , ECL_CHAR);
+    ecl_kw_iset_string8( lgr_kw , 0 , lgr_name );
+    ecl_kw_fwrite( lgr_kw , fortio );
+    ecl_kw_free( lgr_kw );
+  }
+
+  {
+    ecl_kw_type * lgr_parent_kw = ecl_kw_alloc(LGR_PARENT_KW , 1 , ECL_CHAR);
+    if (parent_name != NULL)
+      ecl_kw_iset_string8( lgr_parent_kw , 0 , parent_name );
     else
-      cell->active = 1;
+      ecl_kw_iset_string8( lgr_parent_kw , 0 , "");
+
+    ecl_kw_fwrite( lgr_parent_kw , fortio );
+    ecl_kw_free( lgr_parent_kw );
   }
-  ecl_grid_update_index( grid );
+}
+
+
+static void ecl_grid_fwrite_empty_kw( fortio_type * fortio , const char * kw) {
+  ecl_kw_type * empty_kw = ecl_kw_alloc( kw , 0 , ECL_INT);
+  ecl_kw_fwrite( empty_kw , fortio );
+  ecl_kw_free( empty_kw );
 }
 
 
@@ -6748,24 +7618,7 @@ static void  ecl_grid_fwrite_self_nnc( const ecl_grid_type * grid , fortio_type
       }
     }
   }
-  {
-    int num_nnc = int_vector_size( g1 );
-    ecl_kw_type * nnc1_kw = ecl_kw_alloc_new_shared( NNC1_KW , num_nnc , ECL_INT , int_vector_get_ptr( g1 ));
-    ecl_kw_type * nnc2_kw = ecl_kw_alloc_new_shared( NNC2_KW , num_nnc , ECL_INT , int_vector_get_ptr( g2 ));
-    ecl_kw_type * nnchead_kw = ecl_kw_alloc( NNCHEAD_KW , NNCHEAD_SIZE , ECL_INT);
-
-    ecl_kw_scalar_set_int( nnchead_kw , 0 );
-    ecl_kw_iset_int( nnchead_kw , NNCHEAD_NUMNNC_INDEX , num_nnc );
-    ecl_kw_iset_int( nnchead_kw , NNCHEAD_LGR_INDEX , grid->lgr_nr );
-
-    ecl_kw_fwrite( nnchead_kw , fortio);
-    ecl_kw_fwrite( nnc1_kw , fortio);
-    ecl_kw_fwrite( nnc2_kw , fortio);
-
-    ecl_kw_free( nnchead_kw );
-    ecl_kw_free( nnc2_kw );
-    ecl_kw_free( nnc1_kw );
-  }
+  ecl_grid_fwrite_nnc_kw( fortio , grid->lgr_nr , int_vector_size( g1 ) , int_vector_get_ptr( g1 ) , int_vector_get_ptr( g2 ));
 
   int_vector_free( g1 );
   int_vector_free( g2 );
@@ -6779,26 +7632,9 @@ static void ecl_grid_fwrite_EGRID__( ecl_grid_type * grid , fortio_type * fortio
 
   /* Writing header */
   if (!is_lgr) {
-    ecl_grid_fwrite_main_EGRID_header( grid , fortio , output_unit );
-  } else {
-    {
-      ecl_kw_type * lgr_kw = ecl_kw_alloc(LGR_KW , 1 , ECL_CHAR);
-      ecl_kw_iset_string8( lgr_kw , 0 , grid->name );
-      ecl_kw_fwrite( lgr_kw , fortio );
-      ecl_kw_free( lgr_kw );
-    }
-
-    {
-      ecl_kw_type * lgr_parent_kw = ecl_kw_alloc(LGR_PARENT_KW , 1 , ECL_CHAR);
-      if (grid->parent_name != NULL)
-        ecl_kw_iset_string8( lgr_parent_kw , 0 , grid->parent_name );
-      else
-        ecl_kw_iset_string8( lgr_parent_kw , 0 , "");
-
-      ecl_kw_fwrite( lgr_parent_kw , fortio );
-      ecl_kw_free( lgr_parent_kw );
-    }
-  }
+    ecl_grid_fwrite_main_EGRID_header( fortio , output_unit , grid->dualp_flag , ecl_grid_get_mapaxes( grid ));
+  } else
+    ecl_grid_fwrite_lgr_header( fortio , grid->name , grid->parent_name );
 
   ecl_grid_fwrite_gridhead_kw( grid->nx , grid->ny , grid->nz , grid->lgr_nr , fortio);
   /* Writing main grid data */
@@ -6834,18 +7670,12 @@ static void ecl_grid_fwrite_EGRID__( ecl_grid_type * grid , fortio_type * fortio
       ecl_kw_free( corsnum_kw );
     }
 
-    {
-      ecl_kw_type * endgrid_kw = ecl_kw_alloc( ENDGRID_KW , 0 , ECL_INT);
-      ecl_kw_fwrite( endgrid_kw , fortio );
-      ecl_kw_free( endgrid_kw );
-    }
+    ecl_grid_fwrite_empty_kw( fortio , ENDGRID_KW );
   }
 
-  if (is_lgr) {
-    ecl_kw_type * endlgr_kw = ecl_kw_alloc( ENDLGR_KW , 0 , ECL_INT);
-    ecl_kw_fwrite( endlgr_kw , fortio );
-    ecl_kw_free( endlgr_kw );
-  }
+  if (is_lgr)
+    ecl_grid_fwrite_empty_kw( fortio , ENDLGR_KW );
+
   ecl_grid_fwrite_self_nnc( grid , fortio );
 }
 
@@ -6890,6 +7720,975 @@ void ecl_grid_fwrite_EGRID( ecl_grid_type * grid , const char * filename, bool o
 }
 
 
+/*****************************************************************/
+/* Streaming EGRID writer */
+
+/*
+  The ecl_egrid_writer is used to write an EGRID file directly from
+  COORD / ZCORN / ACTNUM data without first creating a ecl_grid
+  instance, i.e. without holding the cells of the full grid in
+  memory. The data is passed to the writer in slabs of arbitrary size,
+  and must be added in the order it is written to the file:
+
+     writer = ecl_egrid_writer_alloc( filename , unit , mapaxes );
+
+     ecl_egrid_writer_begin_grid( writer , nx , ny , nz );
+     ecl_egrid_writer_add_coord( writer , size , coord );    <- Repeated
+     ecl_egrid_writer_add_zcorn( writer , size , zcorn );    <- Repeated
+     ecl_egrid_writer_add_actnum( writer , size , actnum );  <- Repeated
+     ecl_egrid_writer_add_nnc( writer , num_nnc , g1 , g2 );  <- Optional
+     ecl_egrid_writer_end_grid( writer );
+
+     ecl_egrid_writer_begin_lgr( writer , name , parent , lgr_nr , nx , ny , nz );
+     .....
+     ecl_egrid_writer_add_hostnum( writer , size , hostnum ); <- Only LGR
+     ecl_egrid_writer_end_grid( writer );
+
+     ecl_egrid_writer_free( writer );
+
+  Each keyword is split in blocks of the same size as ecl_kw_fwrite()
+  uses, so the resulting file is identical to the file written by
+  ecl_grid_fwrite_EGRID2().
+*/
+
+#define ECL_EGRID_WRITER_ID 77160451
+
+#define EGRID_WRITER_BLOCK_SIZE 1000
+
+typedef enum {
+  EGRID_WRITER_GRIDHEAD = 0,
+  EGRID_WRITER_COORD    = 1,
+  EGRID_WRITER_ZCORN    = 2,
+  EGRID_WRITER_ACTNUM   = 3,
+  EGRID_WRITER_HOSTNUM  = 4,
+  EGRID_WRITER_CLOSED   = 5
+} egrid_writer_state_enum;
+
+
+struct ecl_egrid_writer_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  fortio_type             * fortio;
+  ert_ecl_unit_enum         unit_system;
+  bool                      main_grid;
+  int                       lgr_nr;
+  int                       nx, ny, nz;
+
+  egrid_writer_state_enum   state;
+  int                       kw_size;       /* Number of elements in the current keyword. */
+  int                       kw_written;    /* Number of elements added to the current keyword. */
+  std::vector<char>         block;
+  int                       block_size;    /* Number of elements in the block buffer. */
+
+  std::vector<int>          nnc1;
+  std::vector<int>          nnc2;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_egrid_writer , ECL_EGRID_WRITER_ID)
+
+static const char * ecl_egrid_writer_state_kw( egrid_writer_state_enum state ) {
+  switch (state) {
+  case EGRID_WRITER_COORD:
+    return COORD_KW;
+  case EGRID_WRITER_ZCORN:
+    return ZCORN_KW;
+  case EGRID_WRITER_ACTNUM:
+    return ACTNUM_KW;
+  case EGRID_WRITER_HOSTNUM:
+    return HOSTNUM_KW;
+  default:
+    return NULL;
+  }
+}
+
+
+static ecl_data_type ecl_egrid_writer_state_type( egrid_writer_state_enum state ) {
+  if (state == EGRID_WRITER_COORD || state == EGRID_WRITER_ZCORN)
+    return ECL_FLOAT;
+  else
+    return ECL_INT;
+}
+
+
+static int ecl_egrid_writer_state_size( const ecl_egrid_writer_type * writer , egrid_writer_state_enum state ) {
+  switch (state) {
+  case EGRID_WRITER_COORD:
+    return 6 * (writer->nx + 1) * (writer->ny + 1);
+  case EGRID_WRITER_ZCORN:
+    return 8 * writer->nx * writer->ny * writer->nz;
+  default:
+    return writer->nx * writer->ny * writer->nz;
+  }
+}
+
+
+static void ecl_egrid_writer_flush_block( ecl_egrid_writer_type * writer ) {
+  if (writer->block_size > 0) {
+    ecl_data_type data_type = ecl_egrid_writer_state_type( writer->state );
+    ecl_kw_type * block_kw = ecl_kw_alloc_new_shared( ecl_egrid_writer_state_kw( writer->state ) ,
+                                                      writer->block_size ,
+                                                      data_type ,
+                                                      writer->block.data() );
+    ecl_kw_fwrite_data( block_kw , writer->fortio );
+    ecl_kw_free( block_kw );
+    writer->block_size = 0;
+  }
+}
+
+
+/*
+  Will advance the writer to the keyword given by @state, the previous
+  keyword must be complete. The header of the new keyword is written
+  immediately.
+*/
+
+static void ecl_egrid_writer_begin_kw( ecl_egrid_writer_type * writer , egrid_writer_state_enum state ) {
+  if (writer->state == state)
+    return;
+
+  if (writer->state == EGRID_WRITER_CLOSED)
+    util_abort("%s: must call ecl_egrid_writer_begin_grid() or ecl_egrid_writer_begin_lgr() first \n",__func__);
+
+  if (state < writer->state || (state - writer->state) > 1)
+    util_abort("%s: keyword %s can not be added now - the keywords must be added in order COORD, ZCORN, ACTNUM [HOSTNUM]\n",
+               __func__ , ecl_egrid_writer_state_kw( state ));
+
+  if (writer->kw_written != writer->kw_size)
+    util_abort("%s: keyword %s incomplete - got %d elements, expected %d\n", __func__ ,
+               ecl_egrid_writer_state_kw( writer->state ) , writer->kw_written , writer->kw_size);
+
+  writer->state = state;
+  writer->kw_size = ecl_egrid_writer_state_size( writer , state );
+  writer->kw_written = 0;
+  writer->block_size = 0;
+  {
+    ecl_kw_type * header_kw = ecl_kw_alloc_new_shared( ecl_egrid_writer_state_kw( state ) , writer->kw_size , ecl_egrid_writer_state_type( state ) , NULL);
+    ecl_kw_fwrite_header( header_kw , writer->fortio );
+    ecl_kw_free( header_kw );
+  }
+}
+
+
+static void ecl_egrid_writer_add_data( ecl_egrid_writer_type * writer , egrid_writer_state_enum state , int size , const void * data) {
+  ecl_egrid_writer_begin_kw( writer , state );
+  if (writer->kw_written + size > writer->kw_size)
+    util_abort("%s: too much data for keyword %s - expected %d elements\n",__func__ , ecl_egrid_writer_state_kw( state ) , writer->kw_size);
+
+  {
+    const char * src = (const char *) data;
+    int sizeof_ctype = ecl_type_get_sizeof_ctype( ecl_egrid_writer_state_type( state ));
+    int offset = 0;
+
+    while (offset < size) {
+      int copy_size = util_int_min( EGRID_WRITER_BLOCK_SIZE - writer->block_size , size - offset);
+      memcpy( &writer->block[ writer->block_size * sizeof_ctype ] , &src[ offset * sizeof_ctype ] , copy_size * sizeof_ctype );
+
+      writer->block_size += copy_size;
+      offset += copy_size;
+      if (writer->block_size == EGRID_WRITER_BLOCK_SIZE)
+        ecl_egrid_writer_flush_block( writer );
+    }
+  }
+
+  writer->kw_written += size;
+  if (writer->kw_written == writer->kw_size)
+    ecl_egrid_writer_flush_block( writer );
+}
+
+
+ecl_egrid_writer_type * ecl_egrid_writer_alloc( const char * filename , ert_ecl_unit_enum unit_system , const float * mapaxes) {
+  ecl_egrid_writer_type * writer = new ecl_egrid_writer_type();
+  UTIL_TYPE_ID_INIT( writer , ECL_EGRID_WRITER_ID );
+  {
+    bool fmt_file = false;
+    bool is_fmt;
+
+    if (ecl_util_get_file_type( filename , &is_fmt, NULL ) != ECL_OTHER_FILE)
+      fmt_file = is_fmt;
+
+    writer->fortio = fortio_open_writer( filename , fmt_file , ECL_ENDIAN_FLIP );
+  }
+  if (writer->fortio == NULL)
+    util_abort("%s: failed to open:%s for writing \n",__func__ , filename);
+
+  writer->unit_system = unit_system;
+  writer->main_grid = false;
+  writer->lgr_nr = 0;
+  writer->nx = writer->ny = writer->nz = 0;
+  writer->state = EGRID_WRITER_CLOSED;
+  writer->kw_size = writer->kw_written = 0;
+  writer->block.resize( EGRID_WRITER_BLOCK_SIZE * util_int_max( sizeof(float) , sizeof(int) ));
+  writer->block_size = 0;
+
+  ecl_grid_fwrite_main_EGRID_header( writer->fortio , unit_system , FILEHEAD_SINGLE_POROSITY , mapaxes );
+  return writer;
+}
+
+
+static void ecl_egrid_writer_begin( ecl_egrid_writer_type * writer , int lgr_nr , int nx , int ny , int nz) {
+  if (writer->state != EGRID_WRITER_CLOSED)
+    util_abort("%s: must call ecl_egrid_writer_end_grid() before starting a new grid\n",__func__);
+
+  writer->lgr_nr = lgr_nr;
+  writer->nx = nx;
+  writer->ny = ny;
+  writer->nz = nz;
+  writer->nnc1.clear();
+  writer->nnc2.clear();
+  ecl_grid_fwrite_gridhead_kw( nx , ny , nz , lgr_nr , writer->fortio );
+
+  writer->state = EGRID_WRITER_GRIDHEAD;
+  writer->kw_size = writer->kw_written = 0;
+}
+
+
+void ecl_egrid_writer_begin_grid( ecl_egrid_writer_type * writer , int nx , int ny , int nz) {
+  writer->main_grid = true;
+  ecl_egrid_writer_begin( writer , 0 , nx , ny , nz );
+}
+
+
+void ecl_egrid_writer_begin_lgr( ecl_egrid_writer_type * writer , const char * lgr_name , const char * parent_name , int lgr_nr , int nx , int ny , int nz) {
+  if (writer->state != EGRID_WRITER_CLOSED)
+    util_abort("%s: must call ecl_egrid_writer_end_grid() before starting a new grid\n",__func__);
+
+  writer->main_grid = false;
+  ecl_grid_fwrite_lgr_header( writer->fortio , lgr_name , parent_name );
+  ecl_egrid_writer_begin( writer , lgr_nr , nx , ny , nz );
+}
+
+
+void ecl_egrid_writer_add_coord( ecl_egrid_writer_type * writer , int size , const float * coord) {
+  ecl_egrid_writer_add_data( writer , EGRID_WRITER_COORD , size , coord );
+}
+
+
+void ecl_egrid_writer_add_zcorn( ecl_egrid_writer_type * writer , int size , const float * zcorn) {
+  ecl_egrid_writer_add_data( writer , EGRID_WRITER_ZCORN , size , zcorn );
+}
+
+
+void ecl_egrid_writer_add_actnum( ecl_egrid_writer_type * writer , int size , const int * actnum) {
+  ecl_egrid_writer_add_data( writer , EGRID_WRITER_ACTNUM , size , actnum );
+}
+
+
+void ecl_egrid_writer_add_hostnum( ecl_egrid_writer_type * writer , int size , const int * hostnum) {
+  if (writer->main_grid)
+    util_abort("%s: HOSTNUM can only be added to an LGR\n",__func__);
+
+  ecl_egrid_writer_add_data( writer , EGRID_WRITER_HOSTNUM , size , hostnum );
+}
+
+
+/*
+  The nnc connections are given as zero based global indices within
+  the current grid; they are collected and written when the grid is
+  closed.
+*/
+
+void ecl_egrid_writer_add_nnc( ecl_egrid_writer_type * writer , int num_nnc , const int * global_index1 , const int * global_index2) {
+  if (writer->state == EGRID_WRITER_CLOSED)
+    util_abort("%s: must call ecl_egrid_writer_begin_grid() or ecl_egrid_writer_begin_lgr() first \n",__func__);
+
+  for (int i = 0; i < num_nnc; i++) {
+    writer->nnc1.push_back( global_index1[i] + 1 );
+    writer->nnc2.push_back( global_index2[i] + 1 );
+  }
+}
+
+
+void ecl_egrid_writer_end_grid( ecl_egrid_writer_type * writer ) {
+  egrid_writer_state_enum last_kw = writer->main_grid ? EGRID_WRITER_ACTNUM : EGRID_WRITER_HOSTNUM;
+
+  if (writer->state != last_kw || writer->kw_written != writer->kw_size)
+    util_abort("%s: grid incomplete - all of COORD, ZCORN, ACTNUM%s must be added before the grid is closed\n",
+               __func__ , writer->main_grid ? "" : " and HOSTNUM");
+
+  ecl_grid_fwrite_empty_kw( writer->fortio , ENDGRID_KW );
+  if (!writer->main_grid)
+    ecl_grid_fwrite_empty_kw( writer->fortio , ENDLGR_KW );
+
+  ecl_grid_fwrite_nnc_kw( writer->fortio , writer->lgr_nr , writer->nnc1.size() , writer->nnc1.data() , writer->nnc2.data());
+  writer->state = EGRID_WRITER_CLOSED;
+}
+
+
+void ecl_egrid_writer_free( ecl_egrid_writer_type * writer ) {
+  if (writer->state != EGRID_WRITER_CLOSED)
+    util_abort("%s: must call ecl_egrid_writer_end_grid() before the writer is closed\n",__func__);
+
+  fortio_fclose( writer->fortio );
+  delete writer;
+}
+
+
+/*****************************************************************/
+/* Processed grid cache */
+
+/*
+  The grid cache is a binary image of the processed grid structure,
+  i.e. the cell corners after mapaxes transformation and tainting, the
+  active index maps, the LGR relationships and the nnc information. The
+  purpose is to be able to reopen a large grid without going through
+  the ZCORN/COORD -> corner processing in ecl_grid_init_GRDECL_data().
+
+  The cache file is tied to the EGRID file it was created from. The
+  header contains the size and modification time of the source file,
+  a FNV-1a hash of the first ECL_GRID_CACHE_HEADER_HASH_SIZE bytes and
+  a FNV-1a hash of the full file. The cache is accepted without reading
+  all of the source file when the size, modification time and header
+  hash match; when only the modification time differs, e.g. for a
+  copied file, the full source file is hashed and compared. The cells
+  are stored as raw ecl_cell_type images; the header therefore also
+  contains sizeof(ecl_cell_type) and the cache is only valid for the
+  build which wrote it. The cache should be regarded as a local
+  throwaway file, it is not an exchange format.
+
+    int       ECL_GRID_CACHE_MAGIC
+    int       ECL_GRID_CACHE_VERSION
+    int       sizeof(ecl_cell_type)
+    int64_t   size of source file
+    int64_t   modification time of source file
+    uint64_t  hash of the first ECL_GRID_CACHE_HEADER_HASH_SIZE bytes of source file
+    uint64_t  hash of source file
+    int       number of grids, i.e. 1 + number of LGRs
+    ....      One section for each grid: header, cells, index maps, nnc.
+*/
+
+#define ECL_GRID_CACHE_MAGIC             0x47434545
+#define ECL_GRID_CACHE_VERSION           3
+#define ECL_GRID_CACHE_HEADER_HASH_SIZE  65536
+
+
+typedef struct {
+  int64_t  size;
+  int64_t  mtime;
+  uint64_t header_hash;
+  uint64_t hash;
+} ecl_grid_cache_source_type;
+
+
+/*
+  FNV-1a hash of the first max_size bytes of the file, or of the whole
+  file if max_size < 0.
+*/
+static bool ecl_grid_cache_hash_file( const char * filename , int64_t max_size , uint64_t * hash) {
+  FILE * stream = util_fopen__( filename , "rb" );
+  if (!stream)
+    return false;
+
+  {
+    const size_t buffer_size = 1 << 20;
+    unsigned char * buffer = (unsigned char*)util_malloc( buffer_size );
+    uint64_t h = 14695981039346656037ULL;
+    int64_t size = 0;
+    size_t bytes_read;
+
+    while ((max_size < 0 || size < max_size) && (bytes_read = fread( buffer , 1 , buffer_size , stream )) > 0) {
+      if (max_size >= 0 && size + static_cast<int64_t>(bytes_read) > max_size)
+        bytes_read = max_size - size;
+
+      for (size_t i = 0; i < bytes_read; i++) {
+        h ^= buffer[i];
+        h *= 1099511628211ULL;
+      }
+      size += bytes_read;
+    }
+
+    free( buffer );
+    fclose( stream );
+    *hash = h;
+  }
+  return true;
+}
+
+
+/*
+  Fills in the size, modification time and header hash of the source
+  file; the full hash is only calculated if full_hash is true.
+*/
+static bool ecl_grid_cache_stat_source( const char * filename , bool full_hash , ecl_grid_cache_source_type * source) {
+  stat_type stat_info;
+  if (util_stat( filename , &stat_info ) != 0)
+    return false;
+
+  source->size = stat_info.st_size;
+  source->mtime = stat_info.st_mtime;
+  source->hash = 0;
+  if (!ecl_grid_cache_hash_file( filename , ECL_GRID_CACHE_HEADER_HASH_SIZE , &source->header_hash ))
+    return false;
+
+  if (full_hash)
+    return ecl_grid_cache_hash_file( filename , -1 , &source->hash );
+
+  return true;
+}
+
+
+/*
+  The cache reader must never abort on a damaged or truncated cache
+  file, so all reads go through this small class instead of the
+  util_fread_xxx() functions. The cache file is memory mapped, and the
+  reads are checked against the remaining size of the mapping before
+  any memory is allocated; the first failure makes all subsequent
+  reads fail.
+*/
+namespace {
+
+class ecl_grid_cache_reader {
+public:
+  ecl_grid_cache_reader( const char * data , int64_t size ) :
+    ptr( data ),
+    remaining( size ),
+    valid( true )
+  {}
+
+  bool ok() const {
+    return this->valid;
+  }
+
+  bool has_bytes( int64_t size , int64_t count ) const {
+    return this->valid && size >= 0 && count >= 0 && (count == 0 || size <= this->remaining / count);
+  }
+
+  bool read( void * ptr , size_t size , int64_t count ) {
+    if (!this->has_bytes( size , count ))
+      this->valid = false;
+    else if (count > 0) {
+      memcpy( ptr , this->ptr , size * count );
+      this->ptr += size * count;
+      this->remaining -= size * count;
+    }
+    return this->valid;
+  }
+
+  int read_int() {
+    int value = 0;
+    this->read( &value , sizeof value , 1 );
+    return value;
+  }
+
+  bool read_bool() {
+    bool value = false;
+    this->read( &value , sizeof value , 1 );
+    return value;
+  }
+
+  /* Same format as util_fwrite_string(). */
+  char * read_alloc_string() {
+    int len = this->read_int();
+    if (len == 0 || !this->valid)
+      return NULL;
+
+    if (len == -1)
+      len = 0;
+    else if (len < 0 || !this->has_bytes( 1 , len + 1 )) {
+      this->valid = false;
+      return NULL;
+    }
+
+    {
+      char * s = (char*)util_calloc( len + 1 , sizeof * s );
+      if (!this->read( s , 1 , len + 1 ) || s[len] != '\0') {
+        free( s );
+        this->valid = false;
+        return NULL;
+      }
+      return s;
+    }
+  }
+
+private:
+  const char * ptr;
+  int64_t remaining;
+  bool valid;
+};
+
+}
+
+
+static void ecl_grid_fwrite_cache_nnc( const ecl_grid_type * grid , FILE * stream ) {
+  int num_nnc_cells = 0;
+  for (int g = 0; g < grid->size; g++)
+    if (grid->cells[g].nnc_info)
+      num_nnc_cells++;
+
+  util_fwrite_int( num_nnc_cells , stream );
+  for (int g = 0; g < grid->size; g++) {
+    const nnc_info_type * nnc_info = grid->cells[g].nnc_info;
+    if (nnc_info) {
+      int num_vectors = nnc_info_get_size( nnc_info );
+      util_fwrite_int( g , stream );
+      util_fwrite_int( num_vectors , stream );
+      for (int v = 0; v < num_vectors; v++) {
+        const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , v );
+        const std::vector<int>& grid_index_list = nnc_vector_get_grid_index_list( nnc_vector );
+        const std::vector<int>& nnc_index_list = nnc_vector_get_nnc_index_list( nnc_vector );
+        int num_nnc = nnc_vector_get_size( nnc_vector );
+
+        util_fwrite_int( nnc_vector_get_lgr_nr( nnc_vector ) , stream );
+        util_fwrite_int( num_nnc , stream );
+        util_fwrite_int_vector( grid_index_list.data() , num_nnc , stream , __func__ );
+        util_fwrite_int_vector( nnc_index_list.data() , num_nnc , stream , __func__ );
+      }
+    }
+  }
+}
+
+
+static bool ecl_grid_fread_cache_nnc( ecl_grid_type * grid , ecl_grid_cache_reader& reader , int num_grid ) {
+  int num_nnc_cells = reader.read_int();
+  std::vector<int> grid_index_list;
+  std::vector<int> nnc_index_list;
+
+  if (num_nnc_cells < 0 || num_nnc_cells > grid->size)
+    return false;
+
+  for (int n = 0; n < num_nnc_cells; n++) {
+    int g = reader.read_int();
+    int num_vectors = reader.read_int();
+    if (!reader.ok() || g < 0 || g >= grid->size || num_vectors < 0)
+      return false;
+
+    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
+    ecl_grid_init_cell_nnc_info( grid , g );
+    for (int v = 0; v < num_vectors; v++) {
+      int lgr_nr = reader.read_int();
+      int num_nnc = reader.read_int();
+      if (!reader.ok() || lgr_nr < 0 || lgr_nr >= num_grid || !reader.has_bytes( 2 * sizeof(int) , num_nnc ))
+        return false;
+
+      grid_index_list.resize( num_nnc );
+      nnc_index_list.resize( num_nnc );
+      if (!reader.read( grid_index_list.data() , sizeof(int) , num_nnc ) ||
+          !reader.read( nnc_index_list.data() , sizeof(int) , num_nnc ))
+        return false;
+
+      for (int i = 0; i < num_nnc; i++) {
+        if (grid_index_list[i] < 0 || nnc_index_list[i] < 0)
+          return false;
+        nnc_info_add_nnc( cell->nnc_info , lgr_nr , grid_index_list[i] , nnc_index_list[i] );
+      }
+    }
+  }
+  return reader.ok();
+}
+
+
+static void ecl_grid_fwrite_cache__( const ecl_grid_type * grid , FILE * stream ) {
+  util_fwrite_int( grid->lgr_nr , stream );
+  util_fwrite_int( grid->nx , stream );
+  util_fwrite_int( grid->ny , stream );
+  util_fwrite_int( grid->nz , stream );
+  util_fwrite_int( grid->dualp_flag , stream );
+  util_fwrite_int( grid->unit_system , stream );
+  util_fwrite_int( grid->eclipse_version , stream );
+  util_fwrite_bool( grid->coarsening_active , stream );
+  util_fwrite_string( grid->name , stream );
+  util_fwrite_string( grid->parent_name , stream );
+
+  util_fwrite_bool( grid->use_mapaxes , stream );
+  util_fwrite_double_vector( grid->unit_x , 2 , stream , __func__ );
+  util_fwrite_double_vector( grid->unit_y , 2 , stream , __func__ );
+  util_fwrite_double_vector( grid->origo , 2 , stream , __func__ );
+  util_fwrite_double_vector( grid->geometry_origin , 3 , stream , __func__ );
+  util_fwrite_bool( grid->mapaxes != NULL , stream );
+  if (grid->mapaxes)
+    util_fwrite( grid->mapaxes , sizeof * grid->mapaxes , 6 , stream , __func__ );
+
+  if (grid->coord_kw) {
+    util_fwrite_int( ecl_kw_get_size( grid->coord_kw ) , stream );
+    util_fwrite( ecl_kw_get_float_ptr( grid->coord_kw ) , sizeof(float) , ecl_kw_get_size( grid->coord_kw ) , stream , __func__ );
+  } else
+    util_fwrite_int( 0 , stream );
+
+  util_fwrite( grid->cells , sizeof * grid->cells , grid->size , stream , __func__ );
+
+  util_fwrite_int( grid->total_active , stream );
+  util_fwrite_int( grid->total_active_fracture , stream );
+  util_fwrite_int_vector( grid->index_map , grid->size , stream , __func__ );
+  util_fwrite_int_vector( grid->inv_index_map , grid->total_active , stream , __func__ );
+  if (grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
+    util_fwrite_int_vector( grid->fracture_index_map , grid->size , stream , __func__ );
+    util_fwrite_int_vector( grid->inv_fracture_index_map , grid->total_active_fracture , stream , __func__ );
+  }
+
+  ecl_grid_fwrite_cache_nnc( grid , stream );
+}
+
+
+/*
+  All indices read from the cache are checked before they are used, a
+  damaged cache must give NULL and not an out of bounds access.
+*/
+static bool ecl_grid_cache_check_index_map( const int * index_map , int size , const int * inv_index_map , int active_size ) {
+  for (int g = 0; g < size; g++)
+    if (index_map[g] < -1 || index_map[g] >= active_size)
+      return false;
+
+  for (int a = 0; a < active_size; a++)
+    if (inv_index_map[a] < 0 || inv_index_map[a] >= size)
+      return false;
+
+  return true;
+}
+
+
+/*
+  The nnc entries refer to cells in other grids, and can only be
+  checked when all the grids have been read.
+*/
+static bool ecl_grid_cache_check_nnc( const ecl_grid_type * main_grid , const ecl_grid_type * grid ) {
+  for (int g = 0; g < grid->size; g++) {
+    const nnc_info_type * nnc_info = grid->cells[g].nnc_info;
+    if (!nnc_info)
+      continue;
+
+    for (int v = 0; v < nnc_info_get_size( nnc_info ); v++) {
+      const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , v );
+      int lgr_nr = nnc_vector_get_lgr_nr( nnc_vector );
+      const ecl_grid_type * target_grid = NULL;
+
+      if (lgr_nr == ECL_GRID_MAINGRID_LGR_NR)
+        target_grid = main_grid;
+      else if (ecl_grid_has_lgr_nr( main_grid , lgr_nr ))
+        target_grid = ecl_grid_get_lgr_from_lgr_nr( main_grid , lgr_nr );
+
+      if (!target_grid)
+        return false;
+
+      for (int target_index : nnc_vector_get_grid_index_list( nnc_vector ))
+        if (target_index >= target_grid->size)
+          return false;
+    }
+  }
+  return true;
+}
+
+
+static bool ecl_grid_fread_cache_body( ecl_grid_type * grid , ecl_grid_cache_reader& reader , int num_grid ) {
+  grid->eclipse_version = reader.read_int();
+  grid->coarsening_active = reader.read_bool();
+  grid->name = reader.read_alloc_string();
+  grid->parent_name = reader.read_alloc_string();
+
+  grid->use_mapaxes = reader.read_bool();
+  reader.read( grid->unit_x , sizeof(double) , 2 );
+  reader.read( grid->unit_y , sizeof(double) , 2 );
+  reader.read( grid->origo , sizeof(double) , 2 );
+  reader.read( grid->geometry_origin , sizeof(double) , 3 );
+  if (reader.read_bool()) {
+    grid->mapaxes = (float*)util_malloc( 6 * sizeof * grid->mapaxes );
+    reader.read( grid->mapaxes , sizeof * grid->mapaxes , 6 );
+  }
+
+  {
+    int coord_size = reader.read_int();
+    if (!reader.has_bytes( sizeof(float) , coord_size ))
+      return false;
+
+    if (coord_size > 0) {
+      grid->coord_kw = ecl_kw_alloc( COORD_KW , coord_size , ECL_FLOAT );
+      reader.read( ecl_kw_get_float_ptr( grid->coord_kw ) , sizeof(float) , coord_size );
+    }
+  }
+
+  /*
+    The cells are read back as one block; the pointer members are
+    meaningless in the cache and are reset. The cell->lgr pointers are
+    reestablished when the LGRs are installed.
+  */
+  reader.read( grid->cells , sizeof * grid->cells , grid->size );
+  for (int g = 0; g < grid->size; g++) {
+    grid->cells[g].lgr = NULL;
+    grid->cells[g].nnc_info = NULL;
+  }
+
+  grid->total_active = reader.read_int();
+  grid->total_active_fracture = reader.read_int();
+  if (grid->total_active < 0 || grid->total_active > grid->size)
+    return false;
+  if (grid->total_active_fracture < 0 || grid->total_active_fracture > grid->size)
+    return false;
+  if (!reader.has_bytes( sizeof(int) , grid->size + grid->total_active ))
+    return false;
+
+  grid->index_map = (int*)util_malloc( grid->size * sizeof * grid->index_map );
+  grid->inv_index_map = (int*)util_malloc( grid->total_active * sizeof * grid->inv_index_map );
+  reader.read( grid->index_map , sizeof(int) , grid->size );
+  reader.read( grid->inv_index_map , sizeof(int) , grid->total_active );
+  if (grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
+    if (!reader.has_bytes( sizeof(int) , grid->size + grid->total_active_fracture ))
+      return false;
+
+    grid->fracture_index_map = (int*)util_malloc( grid->size * sizeof * grid->fracture_index_map );
+    grid->inv_fracture_index_map = (int*)util_malloc( grid->total_active_fracture * sizeof * grid->inv_fracture_index_map );
+    reader.read( grid->fracture_index_map , sizeof(int) , grid->size );
+    reader.read( grid->inv_fracture_index_map , sizeof(int) , grid->total_active_fracture );
+  }
+  if (!reader.ok())
+    return false;
+
+  if (!ecl_grid_cache_check_index_map( grid->index_map , grid->size , grid->inv_index_map , grid->total_active ))
+    return false;
+  if (grid->fracture_index_map && !ecl_grid_cache_check_index_map( grid->fracture_index_map , grid->size , grid->inv_fracture_index_map , grid->total_active_fracture ))
+    return false;
+
+  for (int g = 0; g < grid->size; g++) {
+    const ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
+    if (cell->host_cell < HOST_CELL_NONE)
+      return false;
+    if (cell->coarse_group < COARSE_GROUP_NONE || cell->coarse_group >= grid->size)
+      return false;
+    if ((cell->active & CELL_ACTIVE_MATRIX) && (cell->active_index[MATRIX_INDEX] < 0 || cell->active_index[MATRIX_INDEX] >= grid->total_active))
+      return false;
+    if ((cell->active & CELL_ACTIVE_FRACTURE) && (cell->active_index[FRACTURE_INDEX] < 0 || cell->active_index[FRACTURE_INDEX] >= grid->total_active_fracture))
+      return false;
+  }
+
+  /*
+    The coarse cell instances carry the active index of the coarse
+    group, and it is simplest to let ecl_grid_update_index() recreate
+    that; coarsened grids are rare.
+  */
+  if (grid->coarsening_active) {
+    ecl_grid_init_coarse_cells( grid );
+    ecl_grid_update_index( grid );
+  }
+
+  return ecl_grid_fread_cache_nnc( grid , reader , num_grid );
+}
+
+
+/*
+  Returns NULL if the cache section is invalid; the size of the grid is
+  checked against the remaining size of the file before the cells are
+  allocated.
+*/
+static ecl_grid_type * ecl_grid_fread_grid_cache( ecl_grid_type * main_grid , ecl_grid_cache_reader& reader , int num_grid ) {
+  int lgr_nr = reader.read_int();
+  int nx = reader.read_int();
+  int ny = reader.read_int();
+  int nz = reader.read_int();
+  int dualp_flag = reader.read_int();
+  ert_ecl_unit_enum unit_system = (ert_ecl_unit_enum) reader.read_int();
+
+  if (!reader.ok() || nx <= 0 || ny <= 0 || nz <= 0)
+    return NULL;
+
+  if ((dualp_flag != FILEHEAD_SINGLE_POROSITY) && (dualp_flag != FILEHEAD_DUAL_POROSITY) && (dualp_flag != FILEHEAD_DUAL_PERMEABILITY))
+    return NULL;
+
+  if (!reader.has_bytes( sizeof(ecl_cell_type) , static_cast<int64_t>(nx) * ny ) ||
+      !reader.has_bytes( sizeof(ecl_cell_type) * static_cast<int64_t>(nx) * ny , nz ))
+    return NULL;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_empty( main_grid , unit_system , dualp_flag , nx , ny , nz , lgr_nr , false );
+    if (grid && !ecl_grid_fread_cache_body( grid , reader , num_grid )) {
+      ecl_grid_free( grid );
+      grid = NULL;
+    }
+    return grid;
+  }
+}
+
+
+/**
+   Will write a cache file for the grid, the cache is tied to the
+   source_file - which should be the EGRID file the grid was loaded
+   from. Returns false if the source file can not be read or the cache
+   file can not be written.
+
+   The cache is first written to a temporary file in the same
+   directory, and then renamed; a concurrent reader will therefor
+   either see the previous cache file or the complete new one.
+*/
+
+bool ecl_grid_fwrite_cache( const ecl_grid_type * grid , const char * source_file , const char * cache_file) {
+  ecl_grid_cache_source_type source;
+
+  if (!ecl_grid_cache_stat_source( source_file , true , &source ))
+    return false;
+
+  {
+    char * path = util_split_alloc_dirname( cache_file );
+    char * tmp_file = util_alloc_tmp_file( path ? path : "." , "ecl_grid_cache" , true );
+    FILE * stream = util_fopen__( tmp_file , "wb" );
+    bool ok = false;
+
+    if (stream) {
+      util_fwrite_int( ECL_GRID_CACHE_MAGIC , stream );
+      util_fwrite_int( ECL_GRID_CACHE_VERSION , stream );
+      util_fwrite_int( sizeof(ecl_cell_type) , stream );
+      util_fwrite( &source.size , sizeof source.size , 1 , stream , __func__ );
+      util_fwrite( &source.mtime , sizeof source.mtime , 1 , stream , __func__ );
+      util_fwrite( &source.header_hash , sizeof source.header_hash , 1 , stream , __func__ );
+      util_fwrite( &source.hash , sizeof source.hash , 1 , stream , __func__ );
+
+      util_fwrite_int( 1 + vector_get_size( grid->LGR_list ) , stream );
+      ecl_grid_fwrite_cache__( grid , stream );
+      for (int grid_nr = 0; grid_nr < vector_get_size( grid->LGR_list ); grid_nr++)
+        ecl_grid_fwrite_cache__( (const ecl_grid_type*)vector_iget_const( grid->LGR_list , grid_nr ) , stream );
+
+      if (fclose( stream ) == 0)
+        ok = (rename( tmp_file , cache_file ) == 0);
+
+      if (!ok)
+        remove( tmp_file );
+    }
+
+    free( tmp_file );
+    free( path );
+    return ok;
+  }
+}
+
+
+static ecl_grid_type * ecl_grid_fread_cache__( ecl_grid_cache_reader& reader , const char * source_file ) {
+  {
+    int header[3];
+    ecl_grid_cache_source_type cache_source;
+    ecl_grid_cache_source_type source;
+
+    if (!reader.read( header , sizeof header[0] , 3 ))
+      return NULL;
+
+    if ((header[0] != ECL_GRID_CACHE_MAGIC) || (header[1] != ECL_GRID_CACHE_VERSION) || (header[2] != (int) sizeof(ecl_cell_type)))
+      return NULL;
+
+    if (!reader.read( &cache_source.size , sizeof cache_source.size , 1 ) ||
+        !reader.read( &cache_source.mtime , sizeof cache_source.mtime , 1 ) ||
+        !reader.read( &cache_source.header_hash , sizeof cache_source.header_hash , 1 ) ||
+        !reader.read( &cache_source.hash , sizeof cache_source.hash , 1 ))
+      return NULL;
+
+    if (!ecl_grid_cache_stat_source( source_file , false , &source ))
+      return NULL;
+
+    if ((source.size != cache_source.size) || (source.header_hash != cache_source.header_hash))
+      return NULL;
+
+    if (source.mtime != cache_source.mtime) {
+      if (!ecl_grid_cache_hash_file( source_file , -1 , &source.hash ) || (source.hash != cache_source.hash))
+        return NULL;
+    }
+  }
+
+  {
+    int num_grid = reader.read_int();
+    std::vector<bool> lgr_nr_used( num_grid > 0 ? num_grid : 0 , false );
+    ecl_grid_type * main_grid = NULL;
+
+    if (num_grid >= 1)
+      main_grid = ecl_grid_fread_grid_cache( NULL , reader , num_grid );
+
+    if (main_grid && main_grid->lgr_nr != ECL_GRID_MAINGRID_LGR_NR) {
+      ecl_grid_free( main_grid );
+      return NULL;
+    }
+
+    for (int grid_nr = 1; main_grid && (grid_nr < num_grid); grid_nr++) {
+      ecl_grid_type * lgr_grid = ecl_grid_fread_grid_cache( main_grid , reader , num_grid );
+      ecl_grid_type * host_grid = NULL;
+
+      /*
+        The LGRs are numbered 1,2,3,... in the EGRID files written by
+        ECLIPSE; a cache for a file which does not follow that will just
+        be rejected.
+      */
+      if (lgr_grid) {
+        if (lgr_grid->lgr_nr <= ECL_GRID_MAINGRID_LGR_NR || lgr_grid->lgr_nr >= num_grid || lgr_nr_used[lgr_grid->lgr_nr])
+          host_grid = NULL;
+        else if (lgr_grid->parent_name == NULL)
+          host_grid = main_grid;
+        else if (ecl_grid_has_lgr( main_grid , lgr_grid->parent_name ))
+          host_grid = ecl_grid_get_lgr( main_grid , lgr_grid->parent_name );
+
+        if (host_grid) {
+          for (int g = 0; g < lgr_grid->size; g++) {
+            int host_cell = ecl_grid_get_cell( lgr_grid , g )->host_cell;
+            if (host_cell < 0 || host_cell >= host_grid->size) {
+              host_grid = NULL;
+              break;
+            }
+          }
+        }
+
+        if (!host_grid || !lgr_grid->name) {
+          ecl_grid_free( lgr_grid );
+          lgr_grid = NULL;
+        }
+      }
+
+      if (!lgr_grid) {
+        ecl_grid_free( main_grid );
+        main_grid = NULL;
+        break;
+      }
+
+      lgr_nr_used[lgr_grid->lgr_nr] = true;
+      ecl_grid_add_lgr( main_grid , lgr_grid );
+      ecl_grid_install_lgr_GRID( host_grid , lgr_grid );
+    }
+
+    if (main_grid) {
+      bool nnc_valid = ecl_grid_cache_check_nnc( main_grid , main_grid );
+      for (int grid_nr = 0; nnc_valid && grid_nr < vector_get_size( main_grid->LGR_list ); grid_nr++)
+        nnc_valid = ecl_grid_cache_check_nnc( main_grid , (const ecl_grid_type*)vector_iget_const( main_grid->LGR_list , grid_nr ));
+
+      if (nnc_valid)
+        ecl_grid_pack_lgr_cells( main_grid );
+      else {
+        ecl_grid_free( main_grid );
+        main_grid = NULL;
+      }
+    }
+    return main_grid;
+  }
+}
+
+
+/**
+   Will load a grid from a cache file created with
+   ecl_grid_fwrite_cache(). If the cache file does not exist, has the
+   wrong format/version, is truncated or damaged, or does not
+   correspond to the current content of source_file the function will
+   return NULL.
+*/
+
+ecl_grid_type * ecl_grid_fread_cache( const char * cache_file , const char * source_file) {
+  if (!util_file_exists( cache_file ))
+    return NULL;
+
+  try {
+    ecl::util::mapped_file cache( cache_file );
+    ecl_grid_cache_reader reader( cache.data() , cache.size() );
+    return ecl_grid_fread_cache__( reader , source_file );
+  } catch (const std::runtime_error&) {
+    return NULL;
+  }
+}
+
+
+/**
+   Will load the grid from the cache_file if that is valid for
+   grid_file, otherwise the grid is loaded from grid_file and a new
+   cache file is written. Failure to write the cache is not an error.
+*/
+
+ecl_grid_type * ecl_grid_alloc_cached( const char * grid_file , const char * cache_file) {
+  ecl_grid_type * grid = ecl_grid_fread_cache( cache_file , grid_file );
+  if (!grid) {
+    grid = ecl_grid_alloc( grid_file );
+    if (grid)
+      ecl_grid_fwrite_cache( grid , grid_file , cache_file );
+  }
+  return grid;
+}
+
+
 
 void ecl_grid_fwrite_depth( const ecl_grid_type * grid , fortio_type * init_file , ert_ecl_unit_enum output_unit) {
   ecl_kw_type * depth_kw = ecl_kw_alloc("DEPTH" , ecl_grid_get_nactive(grid) , ECL_FLOAT);
@@ -7013,7 +8812,7 @@ void ecl_grid_fprintf_grdecl(ecl_grid_type * grid , FILE * stream ) {
 void ecl_grid_cell_ri_export( const ecl_grid_type * ecl_grid , int global_index , double * ri_points) {
   const ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
   int offset = global_index * 8 * 3;
-  ecl_cell_ri_export( cell , &ri_points[ offset ] );
+  ecl_cell_ri_export( ecl_grid , cell , &ri_points[ offset ] );
 }
 
 
@@ -7063,11 +8862,10 @@ static ecl_kw_type * ecl_grid_alloc_volume_kw_active( const ecl_grid_type * grid
   ecl_kw_type * volume_kw = ecl_kw_alloc("VOLUME" , ecl_grid_get_active_size(grid) , ECL_DOUBLE);
   {
     double * volume_data = (double*)ecl_kw_get_ptr( volume_kw );
+    const double * volume_array = ecl_grid_get_volume_array( grid );
     int active_index;
-    for (active_index = 0; active_index < ecl_grid_get_active_size(grid); active_index++) {
-      double cell_volume = ecl_grid_get_cell_volume1A(grid , active_index);
-      volume_data[ active_index] = cell_volume;
-    }
+    for (active_index = 0; active_index < ecl_grid_get_active_size(grid); active_index++)
+      volume_data[ active_index] = volume_array[ ecl_grid_get_global_index1A(grid , active_index) ];
   }
   return volume_kw;
 }
@@ -7077,11 +8875,8 @@ static ecl_kw_type * ecl_grid_alloc_volume_kw_global( const ecl_grid_type * grid
   ecl_kw_type * volume_kw = ecl_kw_alloc("VOLUME" , ecl_grid_get_global_size(grid) , ECL_DOUBLE);
   {
     double * volume_data = (double*)ecl_kw_get_ptr( volume_kw );
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size(grid); global_index++) {
-      double cell_volume = ecl_grid_get_cell_volume1(grid , global_index);
-      volume_data[ global_index] = cell_volume;
-    }
+    const double * volume_array = ecl_grid_get_volume_array( grid );
+    memcpy( volume_data , volume_array , ecl_grid_get_global_size(grid) * sizeof * volume_data );
   }
   return volume_kw;
 }
@@ -7138,18 +8933,22 @@ void ecl_grid_export_data_as_double( int index_size, const int * data_index, con
 
 //This function is meant to be used w/ pandas datafram and numpy
 void ecl_grid_export_volume( const ecl_grid_type * grid, int index_size, const int * global_index, double * output ) {
+  const double * volume = ecl_grid_get_volume_array( grid );
   for (int i = 0; i < index_size; i++) {
     int g = global_index[i];
-    output[i] = ecl_grid_get_cell_volume1(grid, g);
+    output[i] = volume[g];
   }
 }
 
 //This function is meant to be used w/ pandas datafram and numpy
 void ecl_grid_export_position( const ecl_grid_type * grid, int index_size, const int * global_index, double * output) {
+  const double * center = ecl_grid_get_center_array( grid );
   for (int i = 0; i < index_size; i++) {
     int g = global_index[i];
     int j = 3 * i;
-    ecl_grid_get_xyz1(grid, g, &output[j], &output[j+1], &output[j+2]);
+    output[j]   = center[3*g];
+    output[j+1] = center[3*g + 1];
+    output[j+2] = center[3*g + 2];
   }
 }
 
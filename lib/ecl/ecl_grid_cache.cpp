@@ -44,23 +44,31 @@ namespace ecl {
   ecl_grid_cache::ecl_grid_cache(const ecl_grid_type * grid) :
     grid(grid)
   {
-    for (int active_index = 0; active_index < ecl_grid_get_active_size(this->grid); active_index++) {
-      double x,y,z;
+    const double * center = ecl_grid_get_center_array(this->grid);
+    int active_size = ecl_grid_get_active_size(this->grid);
+
+    this->gi.resize(active_size);
+    this->xp.resize(active_size);
+    this->yp.resize(active_size);
+    this->zp.resize(active_size);
+    for (int active_index = 0; active_index < active_size; active_index++) {
       int global_index = ecl_grid_get_global_index1A(this->grid, active_index);
-      ecl_grid_get_xyz1(this->grid, global_index, &x, &y, &z);
 
-      this->gi.push_back(global_index);
-      this->xp.push_back(x);
-      this->yp.push_back(y);
-      this->zp.push_back(z);
+      this->gi[active_index] = global_index;
+      this->xp[active_index] = center[3*global_index];
+      this->yp[active_index] = center[3*global_index + 1];
+      this->zp[active_index] = center[3*global_index + 2];
     }
   }
 
 
   const std::vector<double>& ecl_grid_cache::volume() const {
     if (this->v.empty()) {
+      const double * volume = ecl_grid_get_volume_array(this->grid);
+
+      this->v.resize(this->size());
       for (int active_index = 0; active_index < this->size(); active_index++)
-        this->v.push_back( ecl_grid_get_cell_volume1A(this->grid, active_index));
+        this->v[active_index] = volume[this->gi[active_index]];
     }
     return this->v;
   }
@@ -0,0 +1,474 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_connectivity.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/nnc_info.hpp>
+#include <ert/ecl/nnc_vector.hpp>
+#include <ert/ecl/ecl_grid_connectivity.hpp>
+
+#include "detail/ecl/ecl_grid_face.hpp"
+
+#define ECL_GRID_CONNECTIVITY_TYPE_ID 8810427
+
+/*
+  The ecl_grid_connectivity contains the geometry of all the cell faces
+  and the connections between the cells of one grid. Everything is
+  computed once when the object is allocated.
+
+  Face geometry, ECL_CELL_NUM_FACES faces per cell in the order of
+  ecl_face_enum:
+
+    face_area:      The area of the face.
+    face_normal:    Outward unit normal, three values per face.
+    face_center:    The average of the four face corners, three values
+                    per face.
+    face_distance:  The distance from the cell center to the face center.
+
+  Connections, in compressed sparse row format. The connections of cell
+  g are the entries [offset[g], offset[g + 1]), sorted on neighbour:
+
+    neighbour:      Global index of the neighbour cell.
+    face:           The face of cell g which connects to the neighbour.
+    area:           The area of the connection; for lateral connections
+                    this is the overlap between the face of g and the
+                    opposite face of the neighbour, i.e. across a fault
+                    only the part of the face in contact counts. NNC
+                    connections between cells which are not structured
+                    neighbours have face ECL_FACE_NNC and area 0, the
+                    grid has no geometry for such connections.
+    normal:         Unit normal pointing from cell g towards the
+                    neighbour, three values per connection.
+
+  The connections are the structured neighbours with a face overlap
+  larger than zero, and all the NNC connections within the grid. Only
+  active cells with valid geometry are connected, i.e. inactive cells
+  have no connections even if they have a face geometry. The
+  connections are symmetric, i.e. each connection is listed both for
+  g1 and g2.
+*/
+
+struct ecl_grid_connectivity_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                 size;
+  std::vector<double> face_area;
+  std::vector<double> face_normal;
+  std::vector<double> face_center;
+  std::vector<double> face_distance;
+
+  std::vector<int>    offset;
+  std::vector<int>    neighbour;
+  std::vector<int>    face;
+  std::vector<double> area;
+  std::vector<double> normal;
+};
+
+typedef struct {
+  int     g1;
+  int     g2;
+  int     face;       /* Seen from g1. */
+  double  area;
+  double  normal[3];  /* Pointing from g1 to g2. */
+} connection_type;
+
+
+/*
+  For the lateral faces: the top and bottom corner on the two pillars
+  spanning the face. The pillars are ordered so that pillar 0 (1) of a
+  face is the same pillar as pillar 0 (1) of the opposite face in the
+  neighbour cell.
+*/
+static const int face_pillar_corners[4][2][2] = {{{0,4},{2,6}}, {{1,5},{3,7}}, {{0,4},{1,5}}, {{2,6},{3,7}}};
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_grid_connectivity , ECL_GRID_CONNECTIVITY_TYPE_ID )
+
+
+static void ecl_grid_connectivity_init_faces( ecl_grid_connectivity_type * connectivity , const ecl_grid_type * grid ) {
+  const int size = connectivity->size;
+  const double * center = ecl_grid_get_center_array( grid );
+
+  connectivity->face_area.resize( ECL_CELL_NUM_FACES * size );
+  connectivity->face_normal.resize( 3 * ECL_CELL_NUM_FACES * size );
+  connectivity->face_center.resize( 3 * ECL_CELL_NUM_FACES * size );
+  connectivity->face_distance.resize( ECL_CELL_NUM_FACES * size );
+
+#pragma omp parallel for
+  for (int g = 0; g < size; g++) {
+    double corners[8][3];
+    for (int c = 0; c < 8; c++)
+      ecl_grid_get_cell_corner_xyz1( grid , g , c , &corners[c][0] , &corners[c][1] , &corners[c][2] );
+
+    for (int f = 0; f < ECL_CELL_NUM_FACES; f++) {
+      const double * p0 = corners[ ecl::cell_face_corners[f][0] ];
+      const double * p1 = corners[ ecl::cell_face_corners[f][1] ];
+      const double * p2 = corners[ ecl::cell_face_corners[f][2] ];
+      const double * p3 = corners[ ecl::cell_face_corners[f][3] ];
+      double * face_normal = &connectivity->face_normal[ 3 * (ECL_CELL_NUM_FACES * g + f) ];
+      double * face_center = &connectivity->face_center[ 3 * (ECL_CELL_NUM_FACES * g + f) ];
+      double d1[3], d2[3], n[3];
+      double area, distance = 0, orientation = 0;
+
+      for (int l = 0; l < 3; l++) {
+        d1[l] = p2[l] - p0[l];
+        d2[l] = p3[l] - p1[l];
+        face_center[l] = 0.25 * (p0[l] + p1[l] + p2[l] + p3[l]);
+      }
+
+      /* The area of a quadrilateral is half the cross product of the diagonals. */
+      ecl::vector_cross( d1 , d2 , n );
+      for (int l = 0; l < 3; l++)
+        n[l] *= 0.5;
+      area = sqrt( ecl::vector_dot( n , n ));
+
+      for (int l = 0; l < 3; l++) {
+        double d = face_center[l] - center[3 * g + l];
+        orientation += d * n[l];
+        distance += d * d;
+      }
+
+      for (int l = 0; l < 3; l++) {
+        if (area > 0)
+          face_normal[l] = (orientation < 0 ? -n[l] : n[l]) / area;
+        else
+          face_normal[l] = 0;
+      }
+      connectivity->face_area[ ECL_CELL_NUM_FACES * g + f ] = area;
+      connectivity->face_distance[ ECL_CELL_NUM_FACES * g + f ] = sqrt( distance );
+    }
+  }
+}
+
+
+/*
+  Integrates the positive part of the linear function going from v0
+  to v1 over an interval of length ds.
+*/
+static double positive_integral( double v0 , double v1 , double ds ) {
+  if (v0 >= 0 && v1 >= 0)
+    return 0.5 * (v0 + v1) * ds;
+
+  if (v0 <= 0 && v1 <= 0)
+    return 0;
+
+  {
+    double pos = util_double_max( v0 , v1 );
+    double neg = -util_double_min( v0 , v1 );
+    return 0.5 * ds * pos * pos / (pos + neg);
+  }
+}
+
+
+/*
+  Two lateral faces on the same pair of pillars; the top and bottom
+  depth of the faces vary linearly along the line s in [0,1] from
+  pillar 0 to pillar 1. The overlap is the integral of
+
+       min(bottom1(s) , bottom2(s)) - max(top1(s) , top2(s))
+
+  where it is positive, and the function returns the overlap as a
+  fraction of the size of face 1.
+*/
+static double overlap_fraction( const double top1[2] , const double bottom1[2] , const double top2[2] , const double bottom2[2]) {
+  double size1 = 0.5 * ((bottom1[0] - top1[0]) + (bottom1[1] - top1[1]));
+  std::vector<double> s_list = {0 , 1};
+
+  if (size1 <= 0)
+    return 0;
+
+  {
+    double dt0 = top1[0] - top2[0];
+    double dt1 = top1[1] - top2[1];
+    double db0 = bottom1[0] - bottom2[0];
+    double db1 = bottom1[1] - bottom2[1];
+
+    if (dt0 * dt1 < 0)
+      s_list.push_back( dt0 / (dt0 - dt1) );
+
+    if (db0 * db1 < 0)
+      s_list.push_back( db0 / (db0 - db1) );
+  }
+  std::sort( s_list.begin() , s_list.end() );
+
+  {
+    double overlap = 0;
+    for (size_t i = 0; i + 1 < s_list.size(); i++) {
+      double s[2] = {s_list[i] , s_list[i + 1]};
+      double length[2];
+
+      for (int e = 0; e < 2; e++) {
+        double t1 = top1[0] + s[e] * (top1[1] - top1[0]);
+        double t2 = top2[0] + s[e] * (top2[1] - top2[0]);
+        double b1 = bottom1[0] + s[e] * (bottom1[1] - bottom1[0]);
+        double b2 = bottom2[0] + s[e] * (bottom2[1] - bottom2[0]);
+        length[e] = util_double_min( b1 , b2 ) - util_double_max( t1 , t2 );
+      }
+      overlap += positive_integral( length[0] , length[1] , s[1] - s[0] );
+    }
+    return util_double_min( 1.0 , overlap / size1 );
+  }
+}
+
+
+static void face_pillar_depth( const ecl_grid_type * grid , int global_index , int face , double top[2] , double bottom[2]) {
+  double x, y;
+  for (int p = 0; p < 2; p++) {
+    ecl_grid_get_cell_corner_xyz1( grid , global_index , face_pillar_corners[face][p][0] , &x , &y , &top[p] );
+    ecl_grid_get_cell_corner_xyz1( grid , global_index , face_pillar_corners[face][p][1] , &x , &y , &bottom[p] );
+  }
+}
+
+
+static void ecl_grid_connectivity_init_connection( const ecl_grid_connectivity_type * connectivity , const ecl_grid_type * grid , connection_type * conn) {
+  int i1, j1, k1, i2, j2, k2;
+  int face = ECL_FACE_NNC;
+
+  ecl_grid_get_ijk1( grid , conn->g1 , &i1 , &j1 , &k1 );
+  ecl_grid_get_ijk1( grid , conn->g2 , &i2 , &j2 , &k2 );
+
+  if (abs(i2 - i1) == 1 && j2 == j1)
+    face = (i2 > i1) ? ECL_FACE_I_PLUS : ECL_FACE_I_MINUS;
+  else if (abs(j2 - j1) == 1 && i2 == i1)
+    face = (j2 > j1) ? ECL_FACE_J_PLUS : ECL_FACE_J_MINUS;
+  else if (i2 == i1 && j2 == j1 && abs(k2 - k1) == 1)
+    face = (k2 > k1) ? ECL_FACE_K_PLUS : ECL_FACE_K_MINUS;
+
+  conn->face = face;
+  if (face == ECL_FACE_NNC) {
+    const double * center = ecl_grid_get_center_array( grid );
+    double length = 0;
+    for (int l = 0; l < 3; l++) {
+      conn->normal[l] = center[3 * conn->g2 + l] - center[3 * conn->g1 + l];
+      length += conn->normal[l] * conn->normal[l];
+    }
+    length = sqrt( length );
+    for (int l = 0; l < 3; l++)
+      conn->normal[l] = (length > 0) ? conn->normal[l] / length : 0;
+    conn->area = 0;
+  } else {
+    int face_index = ECL_CELL_NUM_FACES * conn->g1 + face;
+    double fraction = 1;
+
+    if (face < ECL_FACE_K_MINUS) {
+      double top1[2], bottom1[2], top2[2], bottom2[2];
+      face_pillar_depth( grid , conn->g1 , face , top1 , bottom1 );
+      face_pillar_depth( grid , conn->g2 , face ^ 1 , top2 , bottom2 );
+      fraction = overlap_fraction( top1 , bottom1 , top2 , bottom2 );
+    }
+
+    conn->area = fraction * connectivity->face_area[face_index];
+    for (int l = 0; l < 3; l++)
+      conn->normal[l] = connectivity->face_normal[3 * face_index + l];
+  }
+}
+
+
+static bool ecl_grid_connectivity_cell_connected( const ecl_grid_type * grid , int global_index ) {
+  return ecl_grid_cell_active1( grid , global_index ) && !ecl_grid_cell_invalid1( grid , global_index );
+}
+
+
+static int64_t connection_key( int g1 , int g2 ) {
+  return (((int64_t) util_int_min( g1 , g2 )) << 32) + util_int_max( g1 , g2 );
+}
+
+
+/*
+  The candidate connections are collected as (key , nnc) pairs, and
+  structured neighbours without face overlap are discarded. A
+  connection which is listed as an NNC is always kept.
+*/
+static void ecl_grid_connectivity_init_connections( ecl_grid_connectivity_type * connectivity , const ecl_grid_type * grid ) {
+  const int nx = ecl_grid_get_nx( grid );
+  const int ny = ecl_grid_get_ny( grid );
+  const int nz = ecl_grid_get_nz( grid );
+  std::vector<std::pair<int64_t,int>> candidates;
+
+  for (int g = 0; g < connectivity->size; g++) {
+    int i, j, k;
+    ecl_grid_get_ijk1( grid , g , &i , &j , &k );
+
+    if (!ecl_grid_connectivity_cell_connected( grid , g ))
+      continue;
+
+    if (i + 1 < nx && ecl_grid_connectivity_cell_connected( grid , g + 1 ))
+      candidates.push_back( std::make_pair( connection_key( g , g + 1 ) , 0 ));
+
+    if (j + 1 < ny && ecl_grid_connectivity_cell_connected( grid , g + nx ))
+      candidates.push_back( std::make_pair( connection_key( g , g + nx ) , 0 ));
+
+    if (k + 1 < nz && ecl_grid_connectivity_cell_connected( grid , g + nx * ny ))
+      candidates.push_back( std::make_pair( connection_key( g , g + nx * ny ) , 0 ));
+
+    {
+      const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , g );
+      if (nnc_info) {
+        const nnc_vector_type * nnc_vector = nnc_info_get_self_vector( nnc_info );
+        if (nnc_vector) {
+          for (int neighbour : nnc_vector_get_grid_index_list( nnc_vector ))
+            if (neighbour != g && ecl_grid_connectivity_cell_connected( grid , neighbour ))
+              candidates.push_back( std::make_pair( connection_key( g , neighbour ) , 1 ));
+        }
+      }
+    }
+  }
+  std::sort( candidates.begin() , candidates.end() );
+
+  {
+    std::vector<connection_type> connections;
+    for (size_t c = 0; c < candidates.size(); c++) {
+      if (c + 1 < candidates.size() && candidates[c + 1].first == candidates[c].first)
+        continue;
+
+      connection_type conn;
+      conn.g1 = candidates[c].first >> 32;
+      conn.g2 = candidates[c].first & 0xFFFFFFFF;
+      conn.face = candidates[c].second;    /* Temporarily the nnc flag. */
+      connections.push_back( conn );
+    }
+
+#pragma omp parallel for
+    for (size_t c = 0; c < connections.size(); c++) {
+      bool nnc = connections[c].face;
+      ecl_grid_connectivity_init_connection( connectivity , grid , &connections[c] );
+      if (!nnc && connections[c].area <= 0)
+        connections[c].g1 = -1;
+    }
+
+    connectivity->offset.assign( connectivity->size + 1 , 0 );
+    for (const auto& conn : connections) {
+      if (conn.g1 >= 0) {
+        connectivity->offset[conn.g1 + 1]++;
+        connectivity->offset[conn.g2 + 1]++;
+      }
+    }
+    for (int g = 0; g < connectivity->size; g++)
+      connectivity->offset[g + 1] += connectivity->offset[g];
+
+    {
+      int num_entries = connectivity->offset[connectivity->size];
+      std::vector<int> fill( connectivity->offset.begin() , connectivity->offset.end() - 1 );
+
+      connectivity->neighbour.resize( num_entries );
+      connectivity->face.resize( num_entries );
+      connectivity->area.resize( num_entries );
+      connectivity->normal.resize( 3 * num_entries );
+
+      for (const auto& conn : connections) {
+        if (conn.g1 < 0)
+          continue;
+
+        for (int side = 0; side < 2; side++) {
+          int g = side == 0 ? conn.g1 : conn.g2;
+          int entry = fill[g]++;
+          double sign = side == 0 ? 1 : -1;
+
+          connectivity->neighbour[entry] = side == 0 ? conn.g2 : conn.g1;
+          connectivity->area[entry] = conn.area;
+          if (conn.face == ECL_FACE_NNC)
+            connectivity->face[entry] = ECL_FACE_NNC;
+          else
+            connectivity->face[entry] = side == 0 ? conn.face : conn.face ^ 1;
+
+          for (int l = 0; l < 3; l++)
+            connectivity->normal[3 * entry + l] = sign * conn.normal[l];
+        }
+      }
+    }
+  }
+}
+
+
+ecl_grid_connectivity_type * ecl_grid_connectivity_alloc( const ecl_grid_type * grid ) {
+  ecl_grid_connectivity_type * connectivity = new ecl_grid_connectivity_type();
+  UTIL_TYPE_ID_INIT( connectivity , ECL_GRID_CONNECTIVITY_TYPE_ID );
+  connectivity->size = ecl_grid_get_global_size( grid );
+
+  ecl_grid_connectivity_init_faces( connectivity , grid );
+  ecl_grid_connectivity_init_connections( connectivity , grid );
+  return connectivity;
+}
+
+
+void ecl_grid_connectivity_free( ecl_grid_connectivity_type * connectivity ) {
+  delete connectivity;
+}
+
+
+const double * ecl_grid_connectivity_get_face_area( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->face_area.data();
+}
+
+
+const double * ecl_grid_connectivity_get_face_normal( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->face_normal.data();
+}
+
+
+const double * ecl_grid_connectivity_get_face_center( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->face_center.data();
+}
+
+
+const double * ecl_grid_connectivity_get_face_distance( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->face_distance.data();
+}
+
+
+int ecl_grid_connectivity_get_num_cells( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->size;
+}
+
+
+/*
+  The number of distinct connections, i.e. half the number of entries
+  in the neighbour list.
+*/
+int ecl_grid_connectivity_get_num_connections( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->neighbour.size() / 2;
+}
+
+
+const int * ecl_grid_connectivity_get_offset( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->offset.data();
+}
+
+
+const int * ecl_grid_connectivity_get_neighbour( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->neighbour.data();
+}
+
+
+const int * ecl_grid_connectivity_get_face( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->face.data();
+}
+
+
+const double * ecl_grid_connectivity_get_area( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->area.data();
+}
+
+
+const double * ecl_grid_connectivity_get_normal( const ecl_grid_connectivity_type * connectivity ) {
+  return connectivity->normal.data();
+}
@@ -0,0 +1,436 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_mesh.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid_mesh.hpp>
+
+#define ECL_GRID_MESH_TYPE_ID 6610983
+
+/*
+  The ecl_grid_mesh is an unstructured hexahedron mesh of a selection
+  of grid cells, intended for visualisation:
+
+    vertices:     Deduplicated vertices as x,y,z float triplets. To
+                  retain precision for grids in UTM coordinates the
+                  vertices are relative to the origin, which is the
+                  lower corner of the bounding box of the mesh.
+
+    connectivity: Eight vertex indices per cell, in the VTK hexahedron
+                  order, i.e. corners 0,1,3,2 of the top face followed
+                  by corners 4,5,7,6 of the bottom face.
+
+    attributes:   One float value per cell for each keyword added with
+                  ecl_grid_mesh_add_kw().
+
+  Two cell corners are the same vertex if they are on the same pillar
+  and have the same depth, i.e. the vertices are not shared across
+  faults.
+*/
+
+struct ecl_grid_mesh_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                              grid_size;
+  int                              grid_nactive;
+  double                           origin[3];
+  std::vector<float>               vertices;
+  std::vector<int>                 connectivity;
+  std::vector<int>                 global_index;
+  std::vector<int>                 active_index;
+  std::vector<std::string>         attribute_names;
+  std::vector<std::vector<float>>  attributes;
+};
+
+typedef struct {
+  double z;
+  int    slot;            /* 8 * cell + corner */
+} mesh_corner_type;
+
+static const int vtk_corner_order[8] = {0,1,3,2,4,5,7,6};
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_grid_mesh , ECL_GRID_MESH_TYPE_ID )
+
+
+static bool mesh_corner_less( const mesh_corner_type& c1 , const mesh_corner_type& c2 ) {
+  if (c1.z != c2.z)
+    return c1.z < c2.z;
+  return c1.slot < c2.slot;
+}
+
+
+/*
+  The corners are sorted into one bucket per pillar, and then each
+  pillar is sorted by depth; the vertex numbering is pillar by pillar,
+  so the result is independent of the number of threads.
+*/
+
+static void ecl_grid_mesh_init_geometry( ecl_grid_mesh_type * mesh , const ecl_grid_type * grid ) {
+  const int num_cells = mesh->global_index.size();
+  const int nx = ecl_grid_get_nx( grid );
+  const int num_pillars = (nx + 1) * (ecl_grid_get_ny( grid ) + 1);
+  std::vector<double> xyz( 24 * num_cells );
+  std::vector<int> pillar( 8 * num_cells );
+  double min_x = 0, min_y = 0, min_z = 0;
+
+  if (num_cells > 0) {
+    min_x = min_y = min_z = 1e100;
+  }
+
+#pragma omp parallel for reduction(min:min_x,min_y,min_z)
+  for (int cell = 0; cell < num_cells; cell++) {
+    int i, j, k;
+    ecl_grid_get_ijk1( grid , mesh->global_index[cell] , &i , &j , &k );
+    for (int c = 0; c < 8; c++) {
+      double * p = &xyz[ 3 * (8 * cell + c) ];
+      ecl_grid_get_cell_corner_xyz1( grid , mesh->global_index[cell] , c , &p[0] , &p[1] , &p[2] );
+      pillar[8 * cell + c] = (j + (c % 4) / 2) * (nx + 1) + i + (c % 2);
+      min_x = std::min( min_x , p[0] );
+      min_y = std::min( min_y , p[1] );
+      min_z = std::min( min_z , p[2] );
+    }
+  }
+  mesh->origin[0] = min_x;
+  mesh->origin[1] = min_y;
+  mesh->origin[2] = min_z;
+
+  {
+    std::vector<int> pillar_offset( num_pillars + 1 , 0 );
+    std::vector<int> vertex_offset( num_pillars + 1 , 0 );
+    std::vector<mesh_corner_type> corners( 8 * num_cells );
+
+    for (int slot = 0; slot < 8 * num_cells; slot++)
+      pillar_offset[ pillar[slot] + 1 ]++;
+
+    for (int p = 0; p < num_pillars; p++)
+      pillar_offset[p + 1] += pillar_offset[p];
+
+    {
+      std::vector<int> fill( pillar_offset.begin() , pillar_offset.end() - 1 );
+      for (int slot = 0; slot < 8 * num_cells; slot++) {
+        mesh_corner_type& corner = corners[ fill[ pillar[slot] ]++ ];
+        corner.z = xyz[3 * slot + 2];
+        corner.slot = slot;
+      }
+    }
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int p = 0; p < num_pillars; p++) {
+      mesh_corner_type * begin = corners.data() + pillar_offset[p];
+      mesh_corner_type * end = corners.data() + pillar_offset[p + 1];
+      int num_unique = 0;
+
+      std::sort( begin , end , mesh_corner_less );
+      for (mesh_corner_type * corner = begin; corner < end; corner++)
+        if (corner == begin || corner->z != (corner - 1)->z)
+          num_unique++;
+
+      vertex_offset[p + 1] = num_unique;
+    }
+
+    for (int p = 0; p < num_pillars; p++)
+      vertex_offset[p + 1] += vertex_offset[p];
+
+    mesh->vertices.resize( 3 * vertex_offset[num_pillars] );
+    mesh->connectivity.resize( 8 * num_cells );
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int p = 0; p < num_pillars; p++) {
+      int vertex = vertex_offset[p] - 1;
+      for (int index = pillar_offset[p]; index < pillar_offset[p + 1]; index++) {
+        const mesh_corner_type& corner = corners[index];
+        int cell = corner.slot / 8;
+        int c = corner.slot % 8;
+
+        if (index == pillar_offset[p] || corner.z != corners[index - 1].z) {
+          vertex++;
+          for (int l = 0; l < 3; l++)
+            mesh->vertices[3 * vertex + l] = xyz[3 * corner.slot + l] - mesh->origin[l];
+        }
+        mesh->connectivity[8 * cell + vtk_corner_order[c]] = vertex;
+      }
+    }
+  }
+}
+
+
+ecl_grid_mesh_type * ecl_grid_mesh_alloc( const ecl_grid_type * grid , const int_vector_type * global_index_list) {
+  ecl_grid_mesh_type * mesh = new ecl_grid_mesh_type();
+  UTIL_TYPE_ID_INIT( mesh , ECL_GRID_MESH_TYPE_ID );
+  mesh->grid_size = ecl_grid_get_global_size( grid );
+  mesh->grid_nactive = ecl_grid_get_nactive( grid );
+
+  if (global_index_list) {
+    const int * global_index = int_vector_get_const_ptr( global_index_list );
+    mesh->global_index.assign( global_index , global_index + int_vector_size( global_index_list ));
+  } else {
+    mesh->global_index.resize( mesh->grid_nactive );
+    for (int active_index = 0; active_index < mesh->grid_nactive; active_index++)
+      mesh->global_index[active_index] = ecl_grid_get_global_index1A( grid , active_index );
+  }
+
+  mesh->active_index.resize( mesh->global_index.size() );
+  for (size_t cell = 0; cell < mesh->global_index.size(); cell++)
+    mesh->active_index[cell] = ecl_grid_get_active_index1( grid , mesh->global_index[cell] );
+
+  ecl_grid_mesh_init_geometry( mesh , grid );
+  return mesh;
+}
+
+
+ecl_grid_mesh_type * ecl_grid_mesh_alloc_region( const ecl_grid_type * grid , ecl_region_type * region) {
+  return ecl_grid_mesh_alloc( grid , ecl_region_get_global_list( region ));
+}
+
+
+void ecl_grid_mesh_free( ecl_grid_mesh_type * mesh ) {
+  delete mesh;
+}
+
+
+int ecl_grid_mesh_get_num_cells( const ecl_grid_mesh_type * mesh ) {
+  return mesh->global_index.size();
+}
+
+
+int ecl_grid_mesh_get_num_vertices( const ecl_grid_mesh_type * mesh ) {
+  return mesh->vertices.size() / 3;
+}
+
+
+void ecl_grid_mesh_get_origin( const ecl_grid_mesh_type * mesh , double * origin) {
+  memcpy( origin , mesh->origin , sizeof mesh->origin );
+}
+
+
+const float * ecl_grid_mesh_get_vertices( const ecl_grid_mesh_type * mesh ) {
+  return mesh->vertices.data();
+}
+
+
+const int * ecl_grid_mesh_get_connectivity( const ecl_grid_mesh_type * mesh ) {
+  return mesh->connectivity.data();
+}
+
+
+const int * ecl_grid_mesh_get_global_index( const ecl_grid_mesh_type * mesh ) {
+  return mesh->global_index.data();
+}
+
+
+/*
+  The keyword can have either one element per active cell or one
+  element per cell in the grid; for a keyword with active size the
+  inactive cells of the mesh get the value NaN.
+*/
+
+void ecl_grid_mesh_add_kw( ecl_grid_mesh_type * mesh , const ecl_kw_type * kw) {
+  const int kw_size = ecl_kw_get_size( kw );
+  const int num_cells = mesh->global_index.size();
+  const bool global_kw = (kw_size == mesh->grid_size);
+  std::vector<float> values( num_cells );
+
+  if (!ecl_type_is_numeric( ecl_kw_get_data_type( kw )))
+    util_abort("%s: keyword %s is not numeric\n",__func__ , ecl_kw_get_header( kw ));
+
+  if (!global_kw && kw_size != mesh->grid_nactive)
+    util_abort("%s: size mismatch for keyword %s: %d - expected %d or %d \n",__func__ ,
+               ecl_kw_get_header( kw ) , kw_size , mesh->grid_nactive , mesh->grid_size);
+
+#pragma omp parallel for
+  for (int cell = 0; cell < num_cells; cell++) {
+    int index = global_kw ? mesh->global_index[cell] : mesh->active_index[cell];
+    if (index >= 0)
+      values[cell] = ecl_kw_iget_as_double( kw , index );
+    else
+      values[cell] = NAN;
+  }
+
+  {
+    const char * name = ecl_kw_get_header( kw );
+    auto iter = std::find( mesh->attribute_names.begin() , mesh->attribute_names.end() , name );
+    if (iter == mesh->attribute_names.end()) {
+      mesh->attribute_names.push_back( name );
+      mesh->attributes.push_back( values );
+    } else
+      mesh->attributes[ iter - mesh->attribute_names.begin() ].swap( values );
+  }
+}
+
+
+int ecl_grid_mesh_get_num_attributes( const ecl_grid_mesh_type * mesh ) {
+  return mesh->attribute_names.size();
+}
+
+
+const char * ecl_grid_mesh_iget_attribute_name( const ecl_grid_mesh_type * mesh , int index) {
+  return mesh->attribute_names.at( index ).c_str();
+}
+
+
+const float * ecl_grid_mesh_get_attribute( const ecl_grid_mesh_type * mesh , const char * name) {
+  auto iter = std::find( mesh->attribute_names.begin() , mesh->attribute_names.end() , name );
+  if (iter == mesh->attribute_names.end())
+    return NULL;
+
+  return mesh->attributes[ iter - mesh->attribute_names.begin() ].data();
+}
+
+
+/*****************************************************************/
+
+/*
+  The mesh is written as a VTK XML UnstructuredGrid file with all the
+  arrays as raw binary appended data. The XML header with the offsets
+  of the arrays is written first, and the arrays are then streamed to
+  the file without any intermediate buffer; the offsets and cell types
+  arrays required by VTK are generated in small blocks on the way.
+*/
+
+#define VTK_HEXAHEDRON 12
+#define VTU_BLOCK_SIZE 4096
+
+typedef uint64_t vtu_header_type;
+
+
+/*
+  The attribute names are keyword headers and can contain characters
+  which must be escaped in an XML attribute value.
+*/
+static std::string vtu_xml_escape( const char * name ) {
+  std::string escaped;
+  for (const char * c = name; *c; c++) {
+    switch (*c) {
+    case '&':
+      escaped += "&amp;";
+      break;
+    case '<':
+      escaped += "&lt;";
+      break;
+    case '>':
+      escaped += "&gt;";
+      break;
+    case '"':
+      escaped += "&quot;";
+      break;
+    default:
+      escaped += *c;
+    }
+  }
+  return escaped;
+}
+
+
+static void vtu_fprintf_array( FILE * stream , const char * type , const char * name , int num_components , uint64_t * offset , uint64_t size) {
+  fprintf(stream , "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%llu\"/>\n",
+          type , vtu_xml_escape( name ).c_str() , num_components , (unsigned long long) *offset );
+  *offset += sizeof(vtu_header_type) + size;
+}
+
+
+static void vtu_fwrite_header( FILE * stream , uint64_t size ) {
+  vtu_header_type header = size;
+  util_fwrite( &header , sizeof header , 1 , stream , __func__ );
+}
+
+
+static void vtu_fwrite_array( FILE * stream , const void * data , uint64_t size ) {
+  vtu_fwrite_header( stream , size );
+  if (size > 0)
+    util_fwrite( data , 1 , size , stream , __func__ );
+}
+
+
+void ecl_grid_mesh_fwrite_vtu( const ecl_grid_mesh_type * mesh , const char * filename) {
+  const uint64_t num_cells = mesh->global_index.size();
+  const uint64_t num_vertices = mesh->vertices.size() / 3;
+  const uint16_t byte_order_test = 1;
+  const bool little_endian = (*((const char *) &byte_order_test) == 1);
+  FILE * stream = util_fopen( filename , "wb" );
+  uint64_t offset = 0;
+
+  fprintf(stream , "<?xml version=\"1.0\"?>\n");
+  fprintf(stream , "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+          little_endian ? "LittleEndian" : "BigEndian");
+  fprintf(stream , "  <UnstructuredGrid>\n");
+  fprintf(stream , "    <FieldData>\n");
+  fprintf(stream , "      <DataArray type=\"Float64\" Name=\"ORIGIN\" NumberOfTuples=\"3\" format=\"appended\" offset=\"%llu\"/>\n",
+          (unsigned long long) offset);
+  offset += sizeof(vtu_header_type) + sizeof mesh->origin;
+  fprintf(stream , "    </FieldData>\n");
+  fprintf(stream , "    <Piece NumberOfPoints=\"%llu\" NumberOfCells=\"%llu\">\n",
+          (unsigned long long) num_vertices , (unsigned long long) num_cells);
+  fprintf(stream , "      <Points>\n");
+  vtu_fprintf_array( stream , "Float32" , "Points" , 3 , &offset , num_vertices * 3 * sizeof(float));
+  fprintf(stream , "      </Points>\n");
+  fprintf(stream , "      <Cells>\n");
+  vtu_fprintf_array( stream , "Int32" , "connectivity" , 1 , &offset , num_cells * 8 * sizeof(int32_t));
+  vtu_fprintf_array( stream , "Int32" , "offsets" , 1 , &offset , num_cells * sizeof(int32_t));
+  vtu_fprintf_array( stream , "UInt8" , "types" , 1 , &offset , num_cells * sizeof(uint8_t));
+  fprintf(stream , "      </Cells>\n");
+  fprintf(stream , "      <CellData>\n");
+  vtu_fprintf_array( stream , "Int32" , "GLOBAL_INDEX" , 1 , &offset , num_cells * sizeof(int32_t));
+  for (size_t a = 0; a < mesh->attribute_names.size(); a++)
+    vtu_fprintf_array( stream , "Float32" , mesh->attribute_names[a].c_str() , 1 , &offset , num_cells * sizeof(float));
+  fprintf(stream , "      </CellData>\n");
+  fprintf(stream , "    </Piece>\n");
+  fprintf(stream , "  </UnstructuredGrid>\n");
+  fprintf(stream , "  <AppendedData encoding=\"raw\">\n");
+  fprintf(stream , "_");
+
+  vtu_fwrite_array( stream , mesh->origin , sizeof mesh->origin );
+  vtu_fwrite_array( stream , mesh->vertices.data() , mesh->vertices.size() * sizeof(float));
+  vtu_fwrite_array( stream , mesh->connectivity.data() , mesh->connectivity.size() * sizeof(int32_t));
+
+  {
+    int32_t offsets[VTU_BLOCK_SIZE];
+    vtu_fwrite_header( stream , num_cells * sizeof(int32_t));
+    for (uint64_t cell0 = 0; cell0 < num_cells; cell0 += VTU_BLOCK_SIZE) {
+      int block_size = std::min( (uint64_t) VTU_BLOCK_SIZE , num_cells - cell0 );
+      for (int c = 0; c < block_size; c++)
+        offsets[c] = 8 * (cell0 + c + 1);
+      util_fwrite( offsets , sizeof(int32_t) , block_size , stream , __func__ );
+    }
+  }
+
+  {
+    uint8_t types[VTU_BLOCK_SIZE];
+    memset( types , VTK_HEXAHEDRON , sizeof types );
+    vtu_fwrite_header( stream , num_cells * sizeof(uint8_t));
+    for (uint64_t cell0 = 0; cell0 < num_cells; cell0 += VTU_BLOCK_SIZE) {
+      int block_size = std::min( (uint64_t) VTU_BLOCK_SIZE , num_cells - cell0 );
+      util_fwrite( types , sizeof(uint8_t) , block_size , stream , __func__ );
+    }
+  }
+
+  vtu_fwrite_array( stream , mesh->global_index.data() , num_cells * sizeof(int32_t));
+  for (size_t a = 0; a < mesh->attributes.size(); a++)
+    vtu_fwrite_array( stream , mesh->attributes[a].data() , num_cells * sizeof(float));
+
+  fprintf(stream , "\n  </AppendedData>\n");
+  fprintf(stream , "</VTKFile>\n");
+  fclose( stream );
+}
@@ -0,0 +1,512 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_path.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <math.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/nnc_info.hpp>
+#include <ert/ecl/nnc_vector.hpp>
+#include <ert/ecl/ecl_grid_path.hpp>
+
+#include "detail/ecl/ecl_grid_face.hpp"
+
+#define ECL_GRID_PATH_TYPE_ID 7719023
+
+/*
+  The probe length is how far, in the length unit of the grid, the
+  path is followed past a face to determine which cell is on the other
+  side. Face intersections closer than the tolerance to the current
+  position are regarded as the face the path entered through.
+*/
+#define ECL_GRID_PATH_PROBE_LENGTH 1e-3
+#define ECL_GRID_PATH_TOLERANCE    1e-6
+#define ECL_GRID_PATH_BARYCENTRIC_TOLERANCE 1e-9
+
+/* The candidate cells are collected in blocks of this many cells. */
+#define ECL_GRID_PATH_BLOCK_SIZE 1024
+
+
+/*
+  The path is traversed one polyline segment at a time. Starting in
+  the cell containing the start of the segment the path is intersected
+  with the faces of the cell to find where it leaves the cell, and the
+  cell on the other side of that face is found by checking, in order:
+
+    1. The neighbour cell (i +/- 1, j +/- 1, k +/- 1) across the face.
+    2. The cells connected to the current cell with NNC; this is the
+       common case across faults.
+    3. A search through the cells whose bounding box is intersected
+       by the remaining part of the segment, this is also used to
+       find the first cell when the path enters the grid from outside.
+
+  Only the cells of the grid given as argument are considered, i.e.
+  for a path through an LGR the host cells in the main grid are
+  reported.
+*/
+
+struct ecl_grid_path_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  std::vector<ecl_grid_path_cell_type> * cells;
+};
+
+typedef struct {
+  double p0[3];
+  double d[3];
+  double length;
+  double md0;
+  double md1;
+  const double * grid_min;       /* The bounding box of the grid. */
+  const double * grid_max;
+  bool   candidates_init;
+  std::vector<int> * candidates; /* Cells whose bounding box overlaps the bounding box of the segment; the buffer is shared by all the segments of a path. */
+} path_segment_type;
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_grid_path, ECL_GRID_PATH_TYPE_ID )
+
+
+static void path_segment_point( const path_segment_type * seg , double t , double * p) {
+  for (int l = 0; l < 3; l++)
+    p[l] = seg->p0[l] + t * seg->d[l];
+}
+
+
+static double path_segment_md( const path_segment_type * seg , double t) {
+  return seg->md0 + t * (seg->md1 - seg->md0);
+}
+
+
+static bool path_segment_probe( const ecl_grid_type * grid , int global_index , const path_segment_type * seg , double t) {
+  double p[3];
+  path_segment_point( seg , t + ECL_GRID_PATH_PROBE_LENGTH / seg->length , p );
+  return ecl_grid_cell_contains_xyz1( grid , global_index , p[0] , p[1] , p[2] );
+}
+
+
+/*
+  Intersects the line through the segment with the triangle v0,v1,v2;
+  the line parameter of the intersection is returned in *t. All
+  coordinates are relative to the start of the segment.
+*/
+static bool path_segment_intersect_triangle( const path_segment_type * seg , const double * v0 , const double * v1 , const double * v2 , double * t) {
+  double e1[3], e2[3], h[3], s[3], q[3];
+  for (int l = 0; l < 3; l++) {
+    e1[l] = v1[l] - v0[l];
+    e2[l] = v2[l] - v0[l];
+    s[l]  = -v0[l];
+  }
+  ecl::vector_cross( seg->d , e2 , h );
+  {
+    double a = ecl::vector_dot( e1 , h );
+    if (fabs(a) <= 1e-12 * sqrt( ecl::vector_dot(e1,e1) * ecl::vector_dot(e2,e2) ) * seg->length)
+      return false;   /* The segment is parallel to the triangle. */
+
+    {
+      double f = 1.0 / a;
+      double u = f * ecl::vector_dot( s , h );
+      if (u < -ECL_GRID_PATH_BARYCENTRIC_TOLERANCE || u > 1 + ECL_GRID_PATH_BARYCENTRIC_TOLERANCE)
+        return false;
+
+      ecl::vector_cross( s , e1 , q );
+      {
+        double v = f * ecl::vector_dot( seg->d , q );
+        if (v < -ECL_GRID_PATH_BARYCENTRIC_TOLERANCE || u + v > 1 + ECL_GRID_PATH_BARYCENTRIC_TOLERANCE)
+          return false;
+      }
+      *t = f * ecl::vector_dot( e2 , q );
+      return true;
+    }
+  }
+}
+
+
+/*
+  All intersections between the line through the segment and the faces
+  of the cell, as (t, face) pairs sorted on t.
+*/
+static std::vector<std::pair<double,int>> path_segment_cell_intersections( const ecl_grid_type * grid , int global_index , const path_segment_type * seg) {
+  std::vector<std::pair<double,int>> intersections;
+  double corners[8][3];
+  {
+    double x[8], y[8], z[8];
+    ecl_grid_export_cell_corners1( grid , global_index , x , y , z );
+    for (int c = 0; c < 8; c++) {
+      corners[c][0] = x[c] - seg->p0[0];
+      corners[c][1] = y[c] - seg->p0[1];
+      corners[c][2] = z[c] - seg->p0[2];
+    }
+  }
+
+  for (int face = 0; face < ECL_CELL_NUM_FACES; face++) {
+    const int * fc = ecl::cell_face_corners[face];
+    double t;
+    if (path_segment_intersect_triangle( seg , corners[fc[0]] , corners[fc[1]] , corners[fc[2]] , &t ))
+      intersections.push_back( std::make_pair( t , face ));
+    if (path_segment_intersect_triangle( seg , corners[fc[0]] , corners[fc[2]] , corners[fc[3]] , &t ))
+      intersections.push_back( std::make_pair( t , face ));
+  }
+  std::sort( intersections.begin() , intersections.end() );
+  return intersections;
+}
+
+
+/*
+  Finds where the segment leaves the cell after the position t0. If
+  the segment does not leave the cell the function returns -1,
+  otherwise the face number is returned and the position in *t_exit.
+*/
+static int path_segment_cell_exit( const ecl_grid_type * grid , int global_index , const path_segment_type * seg , double t0 , double * t_exit) {
+  const double tolerance = ECL_GRID_PATH_TOLERANCE / seg->length;
+  std::vector<std::pair<double,int>> intersections = path_segment_cell_intersections( grid , global_index , seg );
+
+  for (const auto& intersection : intersections) {
+    if (intersection.first > t0 + tolerance) {
+      if (intersection.first >= 1)
+        return -1;
+
+      *t_exit = intersection.first;
+      return intersection.second;
+    }
+  }
+  return -1;
+}
+
+
+/*
+  Clips the segment to the bounding box of the grid with a slab test;
+  returns false if the segment does not intersect the grid, otherwise
+  the part of the segment inside the grid is [*t1, *t2].
+*/
+static bool path_segment_clip( const path_segment_type * seg , double * t1 , double * t2) {
+  const double tolerance = ECL_GRID_PATH_TOLERANCE / seg->length;
+  *t1 = 0;
+  *t2 = 1;
+  for (int l = 0; l < 3; l++) {
+    double min = seg->grid_min[l] - ECL_GRID_PATH_TOLERANCE;
+    double max = seg->grid_max[l] + ECL_GRID_PATH_TOLERANCE;
+    if (seg->d[l] == 0) {
+      if (seg->p0[l] < min || seg->p0[l] > max)
+        return false;
+    } else {
+      double ta = (min - seg->p0[l]) / seg->d[l];
+      double tb = (max - seg->p0[l]) / seg->d[l];
+      *t1 = util_double_max( *t1 , util_double_min( ta , tb ) - tolerance );
+      *t2 = util_double_min( *t2 , util_double_max( ta , tb ) + tolerance );
+    }
+  }
+  return *t1 <= *t2;
+}
+
+
+/*
+  The cells whose bounding box overlaps the bounding box of the part of
+  the segment inside the grid are collected with ecl_grid_bbox_filter()
+  the first time they are needed, and reused for all later searches
+  along the segment. The grid is filtered in blocks, so the candidate
+  buffer only grows to the number of candidates.
+*/
+static const std::vector<int>& path_segment_get_candidates( const ecl_grid_type * grid , path_segment_type * seg) {
+  if (!seg->candidates_init) {
+    double t1, t2;
+    seg->candidates->clear();
+    seg->candidates_init = true;
+
+    if (path_segment_clip( seg , &t1 , &t2 )) {
+      const int size = ecl_grid_get_global_size( grid );
+      double p1[3], p2[3];
+      double box_min[3], box_max[3];
+      int block[ECL_GRID_PATH_BLOCK_SIZE];
+
+      path_segment_point( seg , t1 , p1 );
+      path_segment_point( seg , t2 , p2 );
+      for (int l = 0; l < 3; l++) {
+        box_min[l] = util_double_min( p1[l] , p2[l] ) - ECL_GRID_PATH_TOLERANCE;
+        box_max[l] = util_double_max( p1[l] , p2[l] ) + ECL_GRID_PATH_TOLERANCE;
+      }
+
+      for (int index1 = 0; index1 < size; index1 += ECL_GRID_PATH_BLOCK_SIZE) {
+        int num_candidates = ecl_grid_bbox_filter( grid , box_min , box_max , index1 , index1 + ECL_GRID_PATH_BLOCK_SIZE , block );
+        seg->candidates->insert( seg->candidates->end() , block , block + num_candidates );
+      }
+    }
+  }
+  return *seg->candidates;
+}
+
+
+/*
+  Finds the first cell entered by the segment after position t0, by
+  going through the candidate cells with a bounding box intersected by
+  the remaining part of the segment.
+*/
+static int path_segment_find_entry( const ecl_grid_type * grid , path_segment_type * seg , double t0 , int exclude , double * t_entry) {
+  const int size = ecl_grid_get_global_size( grid );
+  const double * bbox = ecl_grid_get_bbox_array( grid );
+  const double tolerance = ECL_GRID_PATH_TOLERANCE / seg->length;
+  int entry_index = -1;
+  double entry_t = 2;
+
+  for (int global_index : path_segment_get_candidates( grid , seg )) {
+    double t1 = t0 - tolerance;
+    double t2 = 1;
+
+    if (global_index == exclude)
+      continue;
+
+    /* Slab test of the segment against the bounding box of the cell. */
+    for (int l = 0; l < 3 && t1 <= t2; l++) {
+      double min = bbox[(2 * l) * size + global_index];
+      double max = bbox[(2 * l + 1) * size + global_index];
+
+      if (seg->d[l] == 0) {
+        if (seg->p0[l] < min || seg->p0[l] > max)
+          t1 = 2;
+      } else {
+        double ta = (min - seg->p0[l]) / seg->d[l];
+        double tb = (max - seg->p0[l]) / seg->d[l];
+        t1 = util_double_max( t1 , util_double_min( ta , tb ) - tolerance );
+        t2 = util_double_min( t2 , util_double_max( ta , tb ) + tolerance );
+      }
+    }
+    if (t1 > t2 || t1 >= entry_t)
+      continue;
+
+    if (!ecl_grid_cell_valid1( grid , global_index ))
+      continue;
+
+    if (t1 <= t0 + tolerance && path_segment_probe( grid , global_index , seg , t0 )) {
+      entry_index = global_index;
+      entry_t = t0;
+      continue;
+    }
+
+    for (const auto& intersection : path_segment_cell_intersections( grid , global_index , seg )) {
+      double t = intersection.first;
+      if (t < t0 - tolerance || t > 1 || t >= entry_t)
+        continue;
+
+      if (path_segment_probe( grid , global_index , seg , t )) {
+        entry_index = global_index;
+        entry_t = t;
+        break;
+      }
+    }
+  }
+
+  if (entry_index >= 0)
+    *t_entry = util_double_max( entry_t , t0 );
+
+  return entry_index;
+}
+
+
+/*
+  Finds the cell on the other side of the face the segment exits cell
+  'global_index' through at t; if the face is not known (face < 0) all
+  the neighbours are checked.
+*/
+static int path_segment_step( const ecl_grid_type * grid , int global_index , int face , const path_segment_type * seg , double t , bool * nnc) {
+  int nx, ny, nz;
+  int i, j, k;
+  ecl_grid_get_dims( grid , &nx , &ny , &nz , NULL );
+  ecl_grid_get_ijk1( grid , global_index , &i , &j , &k );
+
+  *nnc = false;
+  for (int f = 0; f < ECL_CELL_NUM_FACES; f++) {
+    if (face >= 0 && f != face)
+      continue;
+
+    {
+      int i2 = i + ecl::cell_face_offset[f][0];
+      int j2 = j + ecl::cell_face_offset[f][1];
+      int k2 = k + ecl::cell_face_offset[f][2];
+
+      if (i2 < 0 || i2 >= nx || j2 < 0 || j2 >= ny || k2 < 0 || k2 >= nz)
+        continue;
+
+      {
+        int neighbour = ecl_grid_get_global_index3( grid , i2 , j2 , k2 );
+        if (ecl_grid_cell_valid1( grid , neighbour ) && path_segment_probe( grid , neighbour , seg , t ))
+          return neighbour;
+      }
+    }
+  }
+
+  {
+    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , global_index );
+    if (nnc_info) {
+      const nnc_vector_type * nnc_vector = nnc_info_get_self_vector( nnc_info );
+      if (nnc_vector) {
+        for (int neighbour : nnc_vector_get_grid_index_list( nnc_vector )) {
+          if (ecl_grid_cell_valid1( grid , neighbour ) && path_segment_probe( grid , neighbour , seg , t )) {
+            *nnc = true;
+            return neighbour;
+          }
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+
+static void ecl_grid_path_add_cell( ecl_grid_path_type * path , int global_index , const path_segment_type * seg , double t , bool nnc) {
+  ecl_grid_path_cell_type cell;
+  cell.global_index = global_index;
+  cell.nnc = nnc;
+  path_segment_point( seg , t , cell.entry );
+  path_segment_point( seg , t , cell.exit );
+  cell.md_entry = path_segment_md( seg , t );
+  cell.md_exit = cell.md_entry;
+  path->cells->push_back( cell );
+}
+
+
+static void ecl_grid_path_set_exit( ecl_grid_path_type * path , const path_segment_type * seg , double t) {
+  ecl_grid_path_cell_type& cell = path->cells->back();
+  path_segment_point( seg , t , cell.exit );
+  cell.md_exit = path_segment_md( seg , t );
+}
+
+
+static void ecl_grid_path_init_bbox( const ecl_grid_type * grid , double * grid_min , double * grid_max) {
+  const int size = ecl_grid_get_global_size( grid );
+  const double * bbox = ecl_grid_get_bbox_array( grid );
+  for (int l = 0; l < 3; l++) {
+    grid_min[l] = size > 0 ? *std::min_element( bbox + (2 * l) * size , bbox + (2 * l + 1) * size ) : 0;
+    grid_max[l] = size > 0 ? *std::max_element( bbox + (2 * l + 1) * size , bbox + (2 * l + 2) * size ) : -1;
+  }
+}
+
+
+/*
+  Will trace the polyline given by the points (x,y,z) through the grid
+  and return the cells intersected by it, in order along the path. The
+  md array with measured depth for the points can be NULL, in that
+  case the measured depth is the length along the path, starting at
+  zero.
+*/
+ecl_grid_path_type * ecl_grid_path_alloc( const ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const double * md) {
+  ecl_grid_path_type * path = (ecl_grid_path_type*)util_malloc( sizeof * path );
+  UTIL_TYPE_ID_INIT( path , ECL_GRID_PATH_TYPE_ID );
+  path->cells = new std::vector<ecl_grid_path_cell_type>();
+
+  {
+    int global_index = -1;
+    double md1 = md ? md[0] : 0;
+    double grid_min[3], grid_max[3];
+    std::vector<int> candidates;
+
+    ecl_grid_path_init_bbox( grid , grid_min , grid_max );
+
+    for (int ip = 0; ip < num_points - 1; ip++) {
+      path_segment_type seg;
+      double t = 0;
+
+      seg.p0[0] = x[ip];
+      seg.p0[1] = y[ip];
+      seg.p0[2] = z[ip];
+      seg.d[0] = x[ip + 1] - x[ip];
+      seg.d[1] = y[ip + 1] - y[ip];
+      seg.d[2] = z[ip + 1] - z[ip];
+      seg.length = sqrt( ecl::vector_dot( seg.d , seg.d ));
+      seg.md0 = md1;
+      seg.md1 = md ? md[ip + 1] : md1 + seg.length;
+      seg.grid_min = grid_min;
+      seg.grid_max = grid_max;
+      seg.candidates_init = false;
+      seg.candidates = &candidates;
+      md1 = seg.md1;
+      if (seg.length == 0)
+        continue;
+
+      /*
+        The previous segment ended inside a cell; if the path turns
+        into a neighbour at the bend we step into that before starting.
+      */
+      if (global_index >= 0 && !path_segment_probe( grid , global_index , &seg , 0 )) {
+        bool nnc;
+        int next = path_segment_step( grid , global_index , -1 , &seg , 0 , &nnc );
+        if (next < 0) {
+          next = path_segment_find_entry( grid , &seg , 0 , global_index , &t );
+          nnc = false;
+        }
+
+        global_index = next;
+        if (global_index < 0)
+          continue;
+        ecl_grid_path_add_cell( path , global_index , &seg , t , nnc );
+      }
+
+      if (global_index < 0) {
+        global_index = path_segment_find_entry( grid , &seg , 0 , -1 , &t );
+        if (global_index < 0)
+          continue;
+        ecl_grid_path_add_cell( path , global_index , &seg , t , false );
+      }
+
+      while (true) {
+        double t_exit;
+        bool nnc;
+        int next;
+        int face = path_segment_cell_exit( grid , global_index , &seg , t , &t_exit );
+        if (face < 0) {
+          ecl_grid_path_set_exit( path , &seg , 1 );
+          break;
+        }
+
+        ecl_grid_path_set_exit( path , &seg , t_exit );
+        t = t_exit;
+        next = path_segment_step( grid , global_index , face , &seg , t , &nnc );
+        if (next < 0) {
+          next = path_segment_find_entry( grid , &seg , t , global_index , &t );
+          nnc = false;
+        }
+
+        global_index = next;
+        if (global_index < 0)
+          break;
+        ecl_grid_path_add_cell( path , global_index , &seg , t , nnc );
+      }
+    }
+  }
+  return path;
+}
+
+
+void ecl_grid_path_free( ecl_grid_path_type * path ) {
+  delete path->cells;
+  free( path );
+}
+
+
+int ecl_grid_path_get_size( const ecl_grid_path_type * path ) {
+  return path->cells->size();
+}
+
+
+const ecl_grid_path_cell_type * ecl_grid_path_iget( const ecl_grid_path_type * path , int index ) {
+  const std::vector<ecl_grid_path_cell_type>& cells = *path->cells;
+  if (index < 0 || index >= static_cast<int>(cells.size()))
+    util_abort("%s: invalid index:%d - valid range: [0,%d) \n",__func__ , index , static_cast<int>(cells.size()));
+  return &cells[index];
+}
@@ -0,0 +1,231 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_upscale.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <ert/util/util.h>
+#include <ert/util/int_vector.hpp>
+
+#include <ert/ecl/ecl_type.hpp>
+#include <ert/ecl/ecl_kw_magic.hpp>
+#include <ert/ecl/ecl_coarse_cell.hpp>
+#include <ert/ecl/ecl_grid_upscale.hpp>
+
+/*
+  Upscaling of fine scale properties to the coarse groups defined with
+  the CORSNUM keyword. The fine scale keywords, and the PORV keyword
+  used as weight, can have either one element for each cell in the
+  grid, i.e. nx*ny*nz elements, or one element for each active cell:
+
+    - With one element for each cell in the grid all the cells in the
+      coarse group take part in the aggregate.
+
+    - With one element for each active cell the cells are mapped
+      through the active index, and the inactive cells are excluded
+      from the aggregate. All the active cells in a coarse group share
+      one active index, and that value is only counted once.
+
+  The coarse keywords have one element for each coarse group, ordered
+  as ecl_grid_iget_coarse_group().
+
+  The coarse keyword gets the same name as the fine keyword. It is of
+  type double if the fine keyword is of type int, otherwise of the same
+  type as the fine keyword.
+
+  The result for a coarse group where the aggregate is not defined,
+  i.e. a zero total pore volume for ECL_UPSCALE_PORV_MEAN and a non
+  positive value for ECL_UPSCALE_HARMONIC_MEAN, is zero.
+*/
+
+
+static double ecl_grid_upscale_iget( const ecl_kw_type * kw , ecl_type_enum type , int index) {
+  switch (type) {
+  case ECL_FLOAT_TYPE:
+    return ((const float *) ecl_kw_get_void_ptr( kw ))[index];
+  case ECL_DOUBLE_TYPE:
+    return ((const double *) ecl_kw_get_void_ptr( kw ))[index];
+  default:
+    return ((const int *) ecl_kw_get_void_ptr( kw ))[index];
+  }
+}
+
+
+static bool ecl_grid_upscale_active_kw( const ecl_grid_type * grid , const ecl_kw_type * kw) {
+  return ecl_kw_get_size( kw ) != ecl_grid_get_global_size( grid );
+}
+
+
+/*
+  The (fine index, porv index) pairs of the cells taking part in the
+  aggregate, see the comment at the top of the file. The active_cells
+  list is the global index of the active cells in the coarse group;
+  ecl_grid_cell_active1() can not be used since all the cells in an
+  active coarse group map to the active index of the group.
+*/
+static std::vector<std::pair<int,int>> ecl_grid_upscale_samples( const ecl_grid_type * grid , const ecl_kw_type * fine_kw , ecl_upscale_enum method , const ecl_kw_type * porv_kw ,
+                                                                 int num_cells , const int * cells , const std::vector<int>& active_cells) {
+  bool fine_active = ecl_grid_upscale_active_kw( grid , fine_kw );
+  bool porv_active = (method == ECL_UPSCALE_PORV_MEAN) && ecl_grid_upscale_active_kw( grid , porv_kw );
+  std::vector<std::pair<int,int>> samples;
+
+  if (fine_active) {
+    std::vector<int> active_list;
+    for (int global_index : active_cells)
+      active_list.push_back( ecl_grid_get_active_index1( grid , global_index ));
+
+    std::sort( active_list.begin() , active_list.end() );
+    active_list.erase( std::unique( active_list.begin() , active_list.end() ) , active_list.end() );
+    for (int active_index : active_list)
+      samples.push_back( std::make_pair( active_index , porv_active ? active_index : ecl_grid_get_global_index1A( grid , active_index )));
+  } else {
+    if (porv_active) {
+      for (int global_index : active_cells)
+        samples.push_back( std::make_pair( global_index , ecl_grid_get_active_index1( grid , global_index )));
+    } else {
+      for (int c = 0; c < num_cells; c++)
+        samples.push_back( std::make_pair( cells[c] , cells[c] ));
+    }
+  }
+  return samples;
+}
+
+
+static double ecl_grid_upscale_cells( const ecl_grid_type * grid , const ecl_kw_type * fine_kw , ecl_upscale_enum method , const ecl_kw_type * porv_kw ,
+                                      int num_cells , const int * cells , const std::vector<int>& active_cells) {
+  ecl_type_enum type = ecl_type_get_type( ecl_kw_get_data_type( fine_kw ));
+  std::vector<std::pair<int,int>> samples = ecl_grid_upscale_samples( grid , fine_kw , method , porv_kw , num_cells , cells , active_cells );
+  double result = 0;
+  double weight = 0;
+
+  for (size_t c = 0; c < samples.size(); c++) {
+    double value = ecl_grid_upscale_iget( fine_kw , type , samples[c].first );
+
+    switch (method) {
+    case ECL_UPSCALE_PORV_MEAN:
+      {
+        double porv = ecl_grid_upscale_iget( porv_kw , ecl_type_get_type( ecl_kw_get_data_type( porv_kw )) , samples[c].second );
+        result += porv * value;
+        weight += porv;
+      }
+      break;
+    case ECL_UPSCALE_SUM:
+      result += value;
+      break;
+    case ECL_UPSCALE_HARMONIC_MEAN:
+      if (value <= 0)
+        return 0;
+      result += 1.0 / value;
+      weight += 1;
+      break;
+    case ECL_UPSCALE_MIN:
+      if (c == 0 || value < result)
+        result = value;
+      break;
+    case ECL_UPSCALE_MAX:
+      if (c == 0 || value > result)
+        result = value;
+      break;
+    }
+  }
+
+  switch (method) {
+  case ECL_UPSCALE_PORV_MEAN:
+    return (weight > 0) ? result / weight : 0;
+  case ECL_UPSCALE_HARMONIC_MEAN:
+    return (result > 0) ? weight / result : 0;
+  default:
+    return result;
+  }
+}
+
+
+static void ecl_grid_upscale_assert_kw( const ecl_grid_type * grid , const ecl_kw_type * kw , const char * caller) {
+  ecl_type_enum type = ecl_type_get_type( ecl_kw_get_data_type( kw ));
+  if (ecl_kw_get_size( kw ) != ecl_grid_get_global_size( grid ) && ecl_kw_get_size( kw ) != ecl_grid_get_active_size( grid ))
+    util_abort("%s: keyword:%s has %d elements - expected %d (global size) or %d (active size)\n",
+               caller , ecl_kw_get_header( kw ) , ecl_kw_get_size( kw ) , ecl_grid_get_global_size( grid ) , ecl_grid_get_active_size( grid ));
+
+  if (type != ECL_FLOAT_TYPE && type != ECL_DOUBLE_TYPE && type != ECL_INT_TYPE)
+    util_abort("%s: keyword:%s must be of type float, double or int\n", caller , ecl_kw_get_header( kw ));
+}
+
+
+/*
+  All the keywords are upscaled in one pass over the coarse groups.
+  The coarse keywords are allocated by the function and returned in
+  the coarse_kw array, which must have room for num_kw elements. The
+  porv_kw argument can be NULL unless one of the methods is
+  ECL_UPSCALE_PORV_MEAN.
+*/
+
+void ecl_grid_alloc_coarse_kw_list( const ecl_grid_type * grid , int num_kw , const ecl_kw_type ** fine_kw , const ecl_upscale_enum * method ,
+                                    const ecl_kw_type * porv_kw , ecl_kw_type ** coarse_kw) {
+  int num_groups = ecl_grid_get_num_coarse_groups( grid );
+  std::vector<const int *> group_cells( num_groups );
+  std::vector<int> group_size( num_groups );
+  std::vector<std::vector<int>> group_active( num_groups );
+
+  for (int ikw = 0; ikw < num_kw; ikw++) {
+    ecl_grid_upscale_assert_kw( grid , fine_kw[ikw] , __func__ );
+    if (method[ikw] == ECL_UPSCALE_PORV_MEAN) {
+      if (!porv_kw)
+        util_abort("%s: the pore volume keyword must be supplied for pore volume weighted mean of %s\n",
+                   __func__ , ecl_kw_get_header( fine_kw[ikw] ));
+      ecl_grid_upscale_assert_kw( grid , porv_kw , __func__ );
+    }
+  }
+
+  /*
+    The index list of a coarse cell is sorted on first access; that is
+    done here before the threads are started.
+  */
+  for (int group = 0; group < num_groups; group++) {
+    ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( grid , group );
+    group_cells[group] = ecl_coarse_cell_get_index_ptr( coarse_cell );
+    group_size[group] = ecl_coarse_cell_get_size( coarse_cell );
+    for (int a = 0; a < ecl_coarse_cell_get_num_active( coarse_cell ); a++)
+      if (ecl_coarse_cell_iget_active_value( coarse_cell , a ) & CELL_ACTIVE_MATRIX)
+        group_active[group].push_back( ecl_coarse_cell_iget_active_cell_index( coarse_cell , a ));
+  }
+
+  for (int ikw = 0; ikw < num_kw; ikw++) {
+    ecl_data_type fine_type = ecl_kw_get_data_type( fine_kw[ikw] );
+    ecl_data_type coarse_type = ecl_type_is_int( fine_type ) ? ECL_DOUBLE : fine_type;
+    coarse_kw[ikw] = ecl_kw_alloc( ecl_kw_get_header( fine_kw[ikw] ) , num_groups , coarse_type );
+  }
+
+#pragma omp parallel for schedule(dynamic, 16)
+  for (int group = 0; group < num_groups; group++) {
+    for (int ikw = 0; ikw < num_kw; ikw++) {
+      double value = ecl_grid_upscale_cells( grid , fine_kw[ikw] , method[ikw] , porv_kw , group_size[group] , group_cells[group] , group_active[group] );
+      if (ecl_type_is_float( ecl_kw_get_data_type( coarse_kw[ikw] )))
+        ecl_kw_iset_float( coarse_kw[ikw] , group , value );
+      else
+        ecl_kw_iset_double( coarse_kw[ikw] , group , value );
+    }
+  }
+}
+
+
+ecl_kw_type * ecl_grid_alloc_coarse_kw( const ecl_grid_type * grid , const ecl_kw_type * fine_kw , const ecl_kw_type * porv_kw , ecl_upscale_enum method) {
+  ecl_kw_type * coarse_kw;
+  ecl_grid_alloc_coarse_kw_list( grid , 1 , &fine_kw , &method , porv_kw , &coarse_kw );
+  return coarse_kw;
+}
@@ -595,6 +595,23 @@ size_t ecl_kw_fortio_size( const ecl_kw_type * ecl_kw ) {
 }
 
 
+/**
+   Returns the number of bytes of memory held by this ecl_kw instance;
+   data which is shared with another owner is not counted.
+*/
+
+size_t ecl_kw_get_memory_usage( const ecl_kw_type * ecl_kw ) {
+  size_t usage = sizeof * ecl_kw;
+  if (ecl_kw->header8)
+    usage += strlen( ecl_kw->header8 ) + 1;
+  if (ecl_kw->header)
+    usage += strlen( ecl_kw->header ) + 1;
+  if (ecl_kw->data && !ecl_kw->shared_data)
+    usage += ecl_kw->size * ecl_type_get_sizeof_ctype( ecl_kw->data_type );
+  return usage;
+}
+
+
 /**
    The data is copied from the input argument to the ecl_kw; data can be NULL.
 */
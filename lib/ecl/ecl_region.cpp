@@ -796,9 +796,10 @@ void ecl_region_deselect_k1k2( ecl_region_type * region , int k1 , int k2) {
 
 
 static void ecl_region_select_from_depth__( ecl_region_type * region , double depth_limit , bool select_deep  , bool select) {
+  const double * depth = ecl_grid_get_depth_array( region->parent_grid );
   int global_index;
   for (global_index = 0; global_index < region->grid_vol; global_index++) {
-    double cell_depth = ecl_grid_get_cdepth1( region->parent_grid , global_index );
+    double cell_depth = depth[ global_index ];
     if (select_deep) {
       // The select/deselect mechanism should be applied to deep cells.
       if (cell_depth >= depth_limit)
@@ -28,12 +28,16 @@
 #include <map>
 #include <algorithm>
 #include <memory>
+#include <stdexcept>
 
 #include <ert/util/hash.hpp>
 #include <ert/util/util.h>
 #include <ert/util/float_vector.hpp>
 #include <ert/util/stringlist.hpp>
 #include "detail/util/path.hpp"
+#include "detail/util/memory_usage.hpp"
+#include "detail/ecl/ecl_smspec_key_table.hpp"
+#include "detail/ecl/ecl_smspec_key_matcher.hpp"
 
 #include <ert/ecl/ecl_smspec.hpp>
 #include <ert/ecl/ecl_file.hpp>
@@ -113,6 +117,7 @@ struct ecl_smspec_struct {
   node_map             field_var_index;
   node_map             misc_var_index;            /* Variables like 'TCPU' and 'NEWTON'. */
   node_map             gen_var_index              /* This is "everything" - things can either be found as gen_var("WWCT:OP_X") or as well_var("WWCT" , "OP_X") */;
+  ecl::smspec_key_table gen_key_table;           /* Hash table over the keys of gen_var_index - used for the general key lookups. */
 
   std::map<std::string, node_map> well_var_index; /* Indexes for all well variables:
                                                      {well1: {var1: index1 , var2: index2} , well2: {var1: index1 , var2: index2}} */
@@ -668,25 +673,31 @@ static int ecl_smspec_get_global_grid_index(const ecl_smspec_type * smspec , int
 /**
    This function takes a fully initialized smspec_node instance, generates the
    corresponding key and inserts smspec_node instance in the main hash table
-   smspec->gen_var_index.
+   smspec->gen_var_index, and in the gen_key_table used for lookup.
 
    The format strings used, i.e. VAR:WELL for well based variables is implicitly
    defined through the format strings used in this function.
 */
 
+static void ecl_smspec_install_gen_key( ecl_smspec_type * smspec , const char * gen_key , const ecl::smspec_node& smspec_node ) {
+  auto& entry = *smspec->gen_var_index.emplace( gen_key , nullptr ).first;
+  entry.second = &smspec_node;
+  smspec->gen_key_table.insert( entry.first , &smspec_node );
+}
+
 static void ecl_smspec_install_gen_keys( ecl_smspec_type * smspec , const ecl::smspec_node& smspec_node ) {
   /* Insert the default general mapping. */
   {
     const char * gen_key1 = smspec_node.get_gen_key1();
     if (gen_key1)
-      smspec->gen_var_index[gen_key1] = &smspec_node;
+      ecl_smspec_install_gen_key( smspec , gen_key1 , smspec_node );
   }
 
   /* Insert the (optional) extra mapping for block related variables and region_2_region variables: */
   {
     const char * gen_key2 = smspec_node.get_gen_key2();
     if (gen_key2)
-      smspec->gen_var_index[gen_key2] = &smspec_node;
+      ecl_smspec_install_gen_key( smspec , gen_key2 , smspec_node );
   }
 }
 
@@ -1530,7 +1541,7 @@ int  ecl_smspec_get_well_completion_var_params_index(const ecl_smspec_type * ecl
 
 
 const ecl::smspec_node& ecl_smspec_get_general_var_node( const ecl_smspec_type * smspec , const char * lookup_kw ) {
-  const auto node_ptr = ecl_smspec_get_var_node(smspec->gen_var_index, lookup_kw);
+  const auto node_ptr = smspec->gen_key_table.get( lookup_kw );
   if (!node_ptr)
     throw std::out_of_range("No such variable: " + std::string(lookup_kw));
 
@@ -1539,13 +1550,26 @@ const ecl::smspec_node& ecl_smspec_get_general_var_node( const ecl_smspec_type *
 
 
 int ecl_smspec_get_general_var_params_index(const ecl_smspec_type * ecl_smspec , const char * lookup_kw) {
-  const auto node_ptr = ecl_smspec_get_var_node(ecl_smspec->gen_var_index , lookup_kw );
+  const auto node_ptr = ecl_smspec->gen_key_table.get( lookup_kw );
   return node_valid_index( node_ptr );
 }
 
 
 bool ecl_smspec_has_general_var(const ecl_smspec_type * ecl_smspec , const char * lookup_kw) {
-  const auto node_ptr = ecl_smspec_get_var_node(ecl_smspec->gen_var_index , lookup_kw );
+  const auto node_ptr = ecl_smspec->gen_key_table.get( lookup_kw );
+  return node_exists( node_ptr );
+}
+
+
+/*
+  Resolves @lookup_kw and stores the result in @handle; if the key does
+  not exist false is returned, and the handle is not valid.
+*/
+bool ecl_smspec_init_key_handle( const ecl_smspec_type * ecl_smspec , const char * lookup_kw , ecl_smspec_key_handle_type * handle) {
+  const auto node_ptr = ecl_smspec->gen_key_table.get( lookup_kw );
+  handle->smspec = ecl_smspec;
+  handle->node = node_ptr;
+  handle->params_index = node_ptr ? node_ptr->get_params_index() : -1;
   return node_exists( node_ptr );
 }
 
@@ -1635,6 +1659,36 @@ void ecl_smspec_free(ecl_smspec_type *ecl_smspec) {
 }
 
 
+/*
+  Estimate of the memory held by the smspec instance; the nodes and all
+  the lookup tables.
+*/
+size_t ecl_smspec_get_memory_usage( const ecl_smspec_type * ecl_smspec ) {
+  size_t usage = sizeof * ecl_smspec;
+
+  usage += ecl::util::memory_usage( ecl_smspec->smspec_nodes );
+  for (const auto& node : ecl_smspec->smspec_nodes)
+    usage += node->memory_usage();
+
+  usage += ecl::util::memory_usage( ecl_smspec->field_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->misc_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->gen_var_index );
+  usage += ecl_smspec->gen_key_table.memory_usage();
+  usage += ecl::util::memory_usage( ecl_smspec->well_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->group_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->region_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->block_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->well_completion_var_index );
+  usage += ecl::util::memory_usage( ecl_smspec->index_map );
+  usage += ecl::util::memory_usage( ecl_smspec->inv_index_map );
+  usage += ecl::util::memory_usage( ecl_smspec->params_default );
+  usage += ecl::util::memory_usage( ecl_smspec->key_join_string );
+  usage += ecl::util::memory_usage( ecl_smspec->header_file );
+  usage += ecl::util::memory_usage( ecl_smspec->restart_case );
+  return usage;
+}
+
+
 void ecl_smspec_free__(void * __ecl_smspec) {
   ecl_smspec_type * ecl_smspec = ecl_smspec_safe_cast( __ecl_smspec);
   ecl_smspec_free( ecl_smspec );
@@ -1691,28 +1745,53 @@ bool ecl_smspec_general_is_total( const ecl_smspec_type * smspec , const char *
 */
 
 
-void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec , const char * pattern , stringlist_type * keys) {
-  std::set<std::string> ex_keys;
-  for (int i=0; i < stringlist_get_size( keys ); i++)
-    ex_keys.insert( stringlist_iget(keys, i));
+namespace {
 
-  {
-    for (const auto& pair : smspec->gen_var_index) {
-      const char * key = pair.first.c_str();
+template <typename T>
+std::vector<const std::string *> ecl_smspec_sorted_keys( const std::map<std::string, T>& mp ) {
+  std::vector<const std::string *> keys;
+  keys.reserve( mp.size() );
+  for (const auto& pair : mp)
+    keys.push_back( &pair.first );
+  return keys;
+}
+
+}
 
-      /*
-         The TIME is typically special cased by output and will not
-         match the 'all keys' wildcard.
-      */
-      if (util_string_equal( key , "TIME")) {
-        if ((pattern == NULL) || (util_string_equal( pattern , "*")))
-          continue;
-      }
 
+/*
+  Selects the general keys matching any of the @patterns in one pass
+  over the keys; see ecl_smspec_select_matching_general_var_list() for
+  the semantics.
+*/
+void ecl_smspec_select_matching_general_var_patterns( const ecl_smspec_type * smspec , const stringlist_type * patterns , stringlist_type * keys) {
+  ecl::key_matcher matcher;
+  bool all_keys = false;
+
+  /*
+     The TIME is typically special cased by output and will not
+     match the 'all keys' wildcard.
+  */
+  for (int i=0; i < stringlist_get_size( patterns ); i++) {
+    const char * pattern = stringlist_iget( patterns , i );
+    if ((pattern == NULL) || (util_string_equal( pattern , "*")))
+      all_keys = true;
+    else
+      matcher.add_pattern( pattern );
+  }
 
-      if ((pattern == NULL) || (util_fnmatch( pattern , key ) == 0)) {
+  {
+    const auto gen_keys = ecl_smspec_sorted_keys( smspec->gen_var_index );
+    std::vector<bool> selected = matcher.select( gen_keys );
+    std::set<std::string> ex_keys;
+    for (int i=0; i < stringlist_get_size( keys ); i++)
+      ex_keys.insert( stringlist_iget(keys, i));
+
+    for (size_t i=0; i < gen_keys.size(); i++) {
+      const std::string& key = *gen_keys[i];
+      if (selected[i] || (all_keys && key != "TIME")) {
         if (ex_keys.find(key) == ex_keys.end())
-          stringlist_append_copy( keys , key );
+          stringlist_append_copy( keys , key.c_str() );
       }
     }
   }
@@ -1721,6 +1800,14 @@ void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec
 }
 
 
+void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec , const char * pattern , stringlist_type * keys) {
+  stringlist_type * patterns = stringlist_alloc_new();
+  stringlist_append_copy( patterns , pattern ? pattern : "*" );
+  ecl_smspec_select_matching_general_var_patterns( smspec , patterns , keys );
+  stringlist_free( patterns );
+}
+
+
 /**
    Allocates a new stringlist and initializes it with the
    ecl_smspec_select_matching_general_var_list() function.
@@ -1754,15 +1841,18 @@ const char * ecl_smspec_get_join_string( const ecl_smspec_type * smspec) {
 
 static stringlist_type * ecl_smspec_alloc_map_list( const std::map<std::string, node_map>& mp , const char * pattern) {
   stringlist_type * map_list = stringlist_alloc_new( );
+  const auto names = ecl_smspec_sorted_keys( mp );
+  std::vector<bool> selected(names.size(), true);
 
-  for (const auto& pair : mp) {
-    const char * map_name = pair.first.c_str();
-
-    if (pattern == NULL)
-      stringlist_append_copy( map_list , map_name );
-    else if (util_fnmatch( pattern , map_name) == 0)
-      stringlist_append_copy( map_list , map_name );
+  if (pattern) {
+    ecl::key_matcher matcher;
+    matcher.add_pattern( pattern );
+    selected = matcher.select( names );
+  }
 
+  for (size_t i=0; i < names.size(); i++) {
+    if (selected[i])
+      stringlist_append_copy( map_list , names[i]->c_str() );
   }
   stringlist_sort( map_list , (string_cmp_ftype *) util_strcmp_int );
   return map_list;
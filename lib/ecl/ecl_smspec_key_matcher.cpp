@@ -0,0 +1,245 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_smspec_key_matcher.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <algorithm>
+
+#include <ert/util/util.h>
+
+#include "detail/ecl/ecl_smspec_key_matcher.hpp"
+
+namespace ecl {
+
+
+/*
+  Compiles @input to a list of tokens; returns false if the pattern uses
+  features which are not supported here, in which case the pattern must
+  be matched with util_fnmatch().
+*/
+bool key_matcher::compile(const char * input, pattern& output) {
+  const unsigned char * p = reinterpret_cast<const unsigned char *>(input);
+
+  while (*p) {
+    token tok;
+    tok.c = 0;
+
+    if (*p >= 128)
+      return false;
+
+    if (*p == '\\') {
+      if (!p[1])
+        return false;
+
+      tok.type = LITERAL;
+      tok.c = p[1];
+      p += 2;
+    } else if (*p == '?') {
+      tok.type = ANY;
+      p++;
+    } else if (*p == '*') {
+      tok.type = STAR;
+      p++;
+      if (!output.tokens.empty() && output.tokens.back().type == STAR)
+        continue;
+    } else if (*p == '[') {
+      const unsigned char * q = p + 1;
+      bool negate = false;
+      bool first = true;
+
+      if (*q == '!' || *q == '^') {
+        negate = true;
+        q++;
+      }
+
+      tok.type = CLASS;
+      while (true) {
+        unsigned char c = *q;
+        if (c == 0 || c >= 128)
+          return false;
+
+        if (c == ']' && !first)
+          break;
+
+        /* Character classes, collating symbols and equivalence classes. */
+        if (c == '[' && (q[1] == ':' || q[1] == '.' || q[1] == '='))
+          return false;
+
+        if (c == '\\') {
+          if (!q[1])
+            return false;
+          c = *(++q);
+        }
+        q++;
+        first = false;
+
+        if (*q == '-' && q[1] && q[1] != ']') {
+          unsigned char last = q[1];
+          if (last == '\\' || last == '[' || last >= 128)
+            return false;
+
+          for (int i = c; i <= last; i++)
+            tok.members.set( i );
+          q += 2;
+        } else
+          tok.members.set( c );
+      }
+
+      if (negate)
+        tok.members.flip();
+      p = q + 1;
+    } else {
+      tok.type = LITERAL;
+      tok.c = *p;
+      p++;
+    }
+
+    output.tokens.push_back( tok );
+  }
+  return true;
+}
+
+
+void key_matcher::add_pattern(const char * input) {
+  pattern compiled;
+  if (compile( input , compiled ))
+    this->patterns.push_back( compiled );
+  else
+    this->fallback_patterns.push_back( input );
+}
+
+
+bool key_matcher::empty() const {
+  return this->patterns.empty() && this->fallback_patterns.empty();
+}
+
+
+/*
+  Adds the state (@pattern_index, @pos) to @states; a STAR can match the
+  empty string, so the position after the STAR is added as well.
+*/
+void key_matcher::add_closure(int pattern_index, int pos, std::vector<state>& states) const {
+  const auto& tokens = this->patterns[pattern_index].tokens;
+
+  states.push_back( {pattern_index, pos} );
+  if (pos < static_cast<int>(tokens.size()) && tokens[pos].type == STAR)
+    states.push_back( {pattern_index, pos + 1} );
+}
+
+
+void key_matcher::step(const std::vector<state>& states, unsigned char c, std::vector<state>& next) const {
+  next.clear();
+  for (const auto& s : states) {
+    const auto& tokens = this->patterns[s.pattern].tokens;
+    if (s.pos == static_cast<int>(tokens.size()))
+      continue;
+
+    const token& tok = tokens[s.pos];
+    switch (tok.type) {
+    case STAR:
+      this->add_closure( s.pattern , s.pos , next );
+      break;
+    case ANY:
+      this->add_closure( s.pattern , s.pos + 1 , next );
+      break;
+    case LITERAL:
+      if (tok.c == c)
+        this->add_closure( s.pattern , s.pos + 1 , next );
+      break;
+    case CLASS:
+      if (tok.members.test( c ))
+        this->add_closure( s.pattern , s.pos + 1 , next );
+      break;
+    }
+  }
+
+  std::sort( next.begin() , next.end() , [](const state& s1, const state& s2) {
+    return (s1.pattern < s2.pattern) || (s1.pattern == s2.pattern && s1.pos < s2.pos);
+  });
+  next.erase( std::unique( next.begin() , next.end() , [](const state& s1, const state& s2) {
+    return s1.pattern == s2.pattern && s1.pos == s2.pos;
+  }) , next.end() );
+}
+
+
+/*
+  All the keys in [begin, end) share the first @depth characters, and
+  @states are the pattern states after those characters.
+*/
+void key_matcher::visit(const std::vector<const std::string *>& keys, size_t begin, size_t end, size_t depth,
+                        const std::vector<state>& states, std::vector<bool>& selected) const {
+  if (states.empty())
+    return;
+
+  bool accept = false;
+  for (const auto& s : states) {
+    const auto& tokens = this->patterns[s.pattern].tokens;
+    const int size = tokens.size();
+
+    /* A trailing STAR matches everything after the prefix. */
+    if (s.pos == size - 1 && tokens[s.pos].type == STAR) {
+      std::fill( selected.begin() + begin , selected.begin() + end , true );
+      return;
+    }
+
+    if (s.pos == size)
+      accept = true;
+  }
+
+  /* The key which is equal to the prefix sorts first. */
+  if (keys[begin]->size() == depth) {
+    if (accept)
+      selected[begin] = true;
+    begin++;
+  }
+
+  std::vector<state> next;
+  while (begin < end) {
+    const unsigned char c = (*keys[begin])[depth];
+    const size_t group_end = std::upper_bound( keys.begin() + begin , keys.begin() + end , c ,
+                                               [depth](unsigned char value, const std::string * key) {
+                                                 return value < static_cast<unsigned char>((*key)[depth]);
+                                               }) - keys.begin();
+
+    this->step( states , c , next );
+    this->visit( keys , begin , group_end , depth + 1 , next , selected );
+    begin = group_end;
+  }
+}
+
+
+std::vector<bool> key_matcher::select(const std::vector<const std::string *>& keys) const {
+  std::vector<bool> selected(keys.size(), false);
+
+  if (!keys.empty() && !this->patterns.empty()) {
+    std::vector<state> states;
+    for (size_t i = 0; i < this->patterns.size(); i++)
+      this->add_closure( i , 0 , states );
+
+    this->visit( keys , 0 , keys.size() , 0 , states , selected );
+  }
+
+  for (const auto& fallback : this->fallback_patterns) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (!selected[i] && util_fnmatch( fallback.c_str() , keys[i]->c_str() ) == 0)
+        selected[i] = true;
+    }
+  }
+
+  return selected;
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_smspec_key_table.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "detail/ecl/ecl_smspec_key_table.hpp"
+
+namespace ecl {
+
+namespace {
+
+const size_t MIN_CAPACITY = 16;
+
+}
+
+
+/*
+  FNV-1a hash of the nul terminated @key; the length of the key is
+  returned in @length.
+*/
+size_t smspec_key_table::hash(const char * key, size_t * length) {
+  size_t h = 14695981039346656037ULL;
+  const char * p = key;
+  while (*p) {
+    h ^= static_cast<unsigned char>(*p);
+    h *= 1099511628211ULL;
+    p++;
+  }
+  *length = p - key;
+  return h;
+}
+
+
+/*
+  The capacity is a power of two, and the table is grown when it is
+  half full, so the linear probe sequences are short.
+*/
+void smspec_key_table::insert(const std::string& key, const smspec_node * node) {
+  if (2 * (this->m_size + 1) > this->slots.size())
+    this->grow();
+
+  size_t length;
+  slot new_slot;
+  new_slot.hash = smspec_key_table::hash( key.c_str() , &length );
+  new_slot.key = &key;
+  new_slot.node = node;
+  this->insert_slot( new_slot );
+}
+
+
+void smspec_key_table::insert_slot(const slot& new_slot) {
+  const size_t mask = this->slots.size() - 1;
+  size_t index = new_slot.hash & mask;
+
+  while (true) {
+    slot& s = this->slots[index];
+    if (!s.key) {
+      s = new_slot;
+      this->m_size++;
+      return;
+    }
+
+    if (s.hash == new_slot.hash && *s.key == *new_slot.key) {
+      s = new_slot;
+      return;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
+
+void smspec_key_table::grow() {
+  std::vector<slot> previous(std::max( MIN_CAPACITY , 2 * this->slots.size()) , slot{0, nullptr, nullptr});
+  previous.swap( this->slots );
+  this->m_size = 0;
+
+  for (const auto& s : previous) {
+    if (s.key)
+      this->insert_slot( s );
+  }
+}
+
+
+const smspec_node * smspec_key_table::get(const char * key) const {
+  if (this->m_size == 0)
+    return nullptr;
+
+  size_t length;
+  const size_t h = smspec_key_table::hash( key , &length );
+  const size_t mask = this->slots.size() - 1;
+  size_t index = h & mask;
+
+  while (true) {
+    const slot& s = this->slots[index];
+    if (!s.key)
+      return nullptr;
+
+    if (s.hash == h && s.key->size() == length && memcmp( s.key->data() , key , length ) == 0)
+      return s.node;
+
+    index = (index + 1) & mask;
+  }
+}
+
+
+size_t smspec_key_table::size() const {
+  return this->m_size;
+}
+
+
+size_t smspec_key_table::memory_usage() const {
+  return this->slots.capacity() * sizeof(slot);
+}
+
+}
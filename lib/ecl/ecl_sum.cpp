@@ -17,6 +17,8 @@
 */
 
 #include <stdexcept>
+#include <memory>
+#include <vector>
 
 #include <string.h>
 #include <stdbool.h>
@@ -42,6 +44,8 @@
 #include <ert/ecl/smspec_node.hpp>
 
 #include "detail/util/path.hpp"
+#include "detail/ecl/ecl_sum_columnar.hpp"
+#include "detail/ecl/ecl_sum_ensemble.hpp"
 
 /**
    The ECLIPSE summary data is organised in a header file (.SMSPEC)
@@ -97,6 +101,7 @@
 struct ecl_sum_struct {
   UTIL_TYPE_ID_DECLARATION;
   ecl_smspec_type   * smspec;     /* Internalized version of the SMSPEC file. */
+  bool                owns_smspec;  /* False when the smspec is shared between the cases of an ensemble. */
   ecl_sum_data_type * data;       /* The data - can be NULL. */
   ecl_sum_type      * restart_case;
 
@@ -177,6 +182,7 @@ static ecl_sum_type * ecl_sum_alloc__( const char * input_arg , const char * key
   ecl_sum->key_join_string = util_alloc_string_copy( key_join_string );
 
   ecl_sum->smspec = NULL;
+  ecl_sum->owns_smspec = true;
   ecl_sum->data   = NULL;
   ecl_sum->restart_case = NULL;
 
@@ -209,14 +215,16 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum, bool lazy_load, int f
 
 
 
-static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart, bool lazy_load, int file_options) {
-  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
-  if (ecl_sum->smspec) {
+/*
+  Loads the data files of a case where the smspec has already been
+  assigned.
+*/
+static bool ecl_sum_fread_data_files(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart, bool lazy_load, int file_options) {
+  {
     bool fmt_file;
     ecl_util_get_file_type( header_file , &fmt_file , NULL);
     ecl_sum_set_fmt_case( ecl_sum , fmt_file );
-  } else
-    return false;
+  }
 
   if (ecl_sum_fread_data( ecl_sum , data_files , include_restart, lazy_load, file_options )) {
     ecl_file_enum file_type = ecl_util_get_file_type( stringlist_iget( data_files , 0 ) , NULL , NULL);
@@ -237,6 +245,15 @@ static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , con
 }
 
 
+static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart, bool lazy_load, int file_options) {
+  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
+  if (!ecl_sum->smspec)
+    return false;
+
+  return ecl_sum_fread_data_files( ecl_sum , header_file , data_files , include_restart , lazy_load , file_options );
+}
+
+
 static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart, bool lazy_load, int file_options) {
   char * header_file;
   stringlist_type * summary_file_list = stringlist_alloc_new();
@@ -276,6 +293,26 @@ ecl_sum_type * ecl_sum_fread_alloc(const char *header_file , const stringlist_ty
   return ecl_sum;
 }
 
+/*
+  As ecl_sum_fread_alloc(), but the already loaded @smspec is used
+  instead of loading the header file again. The smspec is not owned by
+  the new ecl_sum instance, and must outlive it; this is used by the
+  ecl_sum_ensemble to share the smspec between identical cases.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_shared_smspec(const char * input_file, const char * header_file , const stringlist_type * data_files , ecl_smspec_type * smspec, const char * key_join_string, bool include_restart, bool lazy_load, int file_options) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc__( input_file , key_join_string );
+  if (ecl_sum) {
+    ecl_sum->smspec = smspec;
+    ecl_sum->owns_smspec = false;
+    if (!ecl_sum_fread_data_files( ecl_sum , header_file , data_files , include_restart, lazy_load, file_options)) {
+      ecl_sum_free( ecl_sum );
+      ecl_sum = NULL;
+    }
+  }
+  return ecl_sum;
+}
+
 /*****************************************************************/
 
 void ecl_sum_set_unified( ecl_sum_type * ecl_sum , bool unified ) {
@@ -380,6 +417,75 @@ void ecl_sum_fwrite_smspec( const ecl_sum_type * ecl_sum ) {
   ecl_smspec_fwrite( ecl_sum->smspec , ecl_sum->ecl_case , ecl_sum->fmt_case );
 }
 
+
+/*
+  Writes the case - including the history from restart cases - as one
+  columnar summary file, see ecl_sum_columnar.cpp. With @compress the
+  columns are compressed with zlib, if that is available; compressed
+  columns must be inflated when read.
+*/
+
+bool ecl_sum_fwrite_columnar( const ecl_sum_type * ecl_sum , const char * filename , bool compress) {
+  return ecl::columnar_fwrite( ecl_sum , filename , compress );
+}
+
+
+/*
+  Loads a file written by ecl_sum_fwrite_columnar(). The returned case
+  is read only, and the path of @filename is used as case name. Returns
+  NULL if the file can not be loaded.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_columnar( const char * filename , const char * key_join_string) {
+  std::unique_ptr<ecl::columnar_loader> loader;
+  try {
+    loader.reset( new ecl::columnar_loader( filename ));
+  } catch (const std::runtime_error&) {
+    return NULL;
+  }
+
+  const auto& grid_dims = loader->grid_dims();
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer__( filename , NULL , 0 , false , true , key_join_string , loader->start_time() , true , grid_dims[0] , grid_dims[1] , grid_dims[2]);
+  if (!ecl_sum)
+    return NULL;
+
+  {
+    int params_index = 1;
+    for (const auto& node : loader->nodes()) {
+      const char * wgname = node.wgname.empty() ? NULL : node.wgname.c_str();
+      if (node.lgr.empty())
+        ecl_smspec_add_node( ecl_sum->smspec , params_index , node.keyword.c_str() , wgname , node.num , node.unit.c_str() , node.default_value );
+      else
+        ecl_smspec_add_node( ecl_sum->smspec , params_index , node.keyword.c_str() , wgname , node.num , node.unit.c_str() , node.lgr.c_str() ,
+                             node.lgr_ijk[0] , node.lgr_ijk[1] , node.lgr_ijk[2] , node.default_value );
+      params_index++;
+    }
+  }
+  loader.reset();
+
+  ecl_sum_free_data( ecl_sum );
+  ecl_sum->data = ecl_sum_data_alloc( ecl_sum->smspec );
+  if (!ecl_sum_data_fread_columnar( ecl_sum->data , filename )) {
+    ecl_sum_free( ecl_sum );
+    return NULL;
+  }
+  return ecl_sum;
+}
+
+
+/*
+  Returns a pointer to the values of the vector @gen_key, without
+  copying them, if the data is available as one contiguous column;
+  i.e. for a case loaded with ecl_sum_fread_alloc_columnar(), or a lazy
+  loaded unified case - where the column cache will be built. Otherwise
+  NULL is returned. The pointer is valid for the lifetime of @ecl_sum.
+*/
+
+const float * ecl_sum_get_vector_ptr( const ecl_sum_type * ecl_sum , const char * gen_key) {
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , gen_key );
+  return ecl_sum_data_get_vector_ptr( ecl_sum->data , params_index );
+}
+
 /*****************************************************************/
 
 
@@ -402,7 +508,7 @@ void ecl_sum_free( ecl_sum_type * ecl_sum ) {
   if (ecl_sum->data)
     ecl_sum_free_data( ecl_sum );
 
-  if (ecl_sum->smspec)
+  if (ecl_sum->smspec && ecl_sum->owns_smspec)
     ecl_smspec_free( ecl_sum->smspec );
 
   free( ecl_sum->path );
@@ -418,6 +524,50 @@ void ecl_sum_free( ecl_sum_type * ecl_sum ) {
 
 
 
+/**
+   Estimate of the memory held by the ecl_sum instance, in bytes. The
+   ECL_SUM_MEMORY_RESTART component is the memory of the restart cases
+   which have been loaded along with this case. The column cache, see
+   ecl_sum_set_column_cache(), is counted in ECL_SUM_MEMORY_DATA.
+*/
+
+size_t ecl_sum_get_memory_usage( const ecl_sum_type * ecl_sum , ecl_sum_memory_enum component) {
+  switch (component) {
+  case ECL_SUM_MEMORY_SMSPEC:
+    return ecl_sum->smspec ? ecl_smspec_get_memory_usage( ecl_sum->smspec ) : 0;
+  case ECL_SUM_MEMORY_DATA:
+    return ecl_sum->data ? ecl_sum_data_get_memory_usage( ecl_sum->data ) : 0;
+  case ECL_SUM_MEMORY_RESTART:
+    return ecl_sum->restart_case ? ecl_sum_get_memory_usage( ecl_sum->restart_case , ECL_SUM_MEMORY_TOTAL ) : 0;
+  case ECL_SUM_MEMORY_TOTAL:
+    return sizeof * ecl_sum +
+      ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_SMSPEC ) +
+      ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ) +
+      ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_RESTART );
+  default:
+    util_abort("%s: invalid component:%d\n",__func__ , component);
+    return 0;
+  }
+}
+
+
+/**
+   With the column cache enabled the first extraction of a vector
+   builds a column major copy of all the summary values, and later
+   vector extractions are contiguous copies from that. This is faster
+   when many vectors are extracted, but doubles the memory used by the
+   summary data. The cache is off by default; turning it off releases
+   the copy. The setting also applies to the restart cases.
+*/
+void ecl_sum_set_column_cache( ecl_sum_type * ecl_sum , bool column_cache ) {
+  if (ecl_sum->data)
+    ecl_sum_data_set_column_cache( ecl_sum->data , column_cache );
+
+  if (ecl_sum->restart_case)
+    ecl_sum_set_column_cache( ecl_sum->restart_case , column_cache );
+}
+
+
 void ecl_sum_free__(void * __ecl_sum) {
   ecl_sum_type * ecl_sum = ecl_sum_safe_cast( __ecl_sum);
   ecl_sum_free( ecl_sum );
@@ -745,6 +895,36 @@ double ecl_sum_get_general_var_from_sim_time( const ecl_sum_type * ecl_sum , tim
   return ecl_sum_get_from_sim_time( ecl_sum , sim_time , node );
 }
 
+bool ecl_sum_init_key_handle( const ecl_sum_type * ecl_sum , const char * lookup_kw , ecl_smspec_key_handle_type * handle) {
+  return ecl_smspec_init_key_handle( ecl_sum->smspec , lookup_kw , handle );
+}
+
+
+static void ecl_sum_assert_key_handle( const ecl_sum_type * ecl_sum , const ecl_smspec_key_handle_type * handle) {
+  if (handle->smspec != ecl_sum->smspec)
+    util_abort("%s: the key handle was created for a different smspec\n",__func__);
+
+  if (!handle->node)
+    util_abort("%s: invalid key handle\n",__func__);
+}
+
+
+/*
+  The handle must have been initialized with ecl_sum_init_key_handle()
+  on this case, or on a case sharing the smspec.
+*/
+double ecl_sum_iget_handle( const ecl_sum_type * ecl_sum , int time_index , const ecl_smspec_key_handle_type * handle) {
+  ecl_sum_assert_key_handle( ecl_sum , handle );
+  return ecl_sum_data_iget( ecl_sum->data , time_index , handle->params_index );
+}
+
+
+double ecl_sum_get_handle_from_sim_time( const ecl_sum_type * ecl_sum , time_t sim_time , const ecl_smspec_key_handle_type * handle) {
+  ecl_sum_assert_key_handle( ecl_sum , handle );
+  return ecl_sum_get_from_sim_time( ecl_sum , sim_time , handle->node );
+}
+
+
 double ecl_sum_get_general_var_from_sim_days( const ecl_sum_type * ecl_sum , double sim_days , const char * var) {
   const ecl::smspec_node * node = ecl_sum_get_general_var_node( ecl_sum , var );
   return ecl_sum_data_get_from_sim_days( ecl_sum->data , sim_days , *node );
@@ -802,42 +982,27 @@ ecl_sum_type * ecl_sum_alloc_resample(const ecl_sum_type * ecl_sum, const char *
 
   */
   ecl_sum_vector_type * ecl_sum_vector = ecl_sum_vector_alloc(ecl_sum, true);
-  double_vector_type * data = double_vector_alloc( ecl_sum_vector_get_size(ecl_sum_vector) , 0);
+  const int num_keywords = ecl_sum_vector_get_size(ecl_sum_vector);
+  std::vector<double> frame(static_cast<size_t>(num_keywords) * time_t_vector_size(times));
+
+  /*
+    All the resampled values are calculated in one pass; values before
+    the start of the case are clamped to the first value and values
+    after the end to the last value, or zero for rates.
+  */
+  ecl_sum_data_init_double_frame_interp(ecl_sum->data, ecl_sum_vector, times, frame.data());
 
   for (int report_step = 0; report_step < time_t_vector_size(times); report_step++) {
     time_t input_t = time_t_vector_iget(times, report_step);
-    if (input_t < start_time) {
-      //clamping to the first value for t < start_time or if it is a rate than derivative is 0
-      for (int i=1; i < ecl_smspec_num_nodes(ecl_sum->smspec); i++) {
-        double value = 0;
-        const ecl::smspec_node& node = ecl_smspec_iget_node_w_node_index(ecl_sum->smspec, i);
-        if (!node.is_rate())
-          value = ecl_sum_iget_first_value(ecl_sum, node.get_params_index());
-        double_vector_iset(data, i-1, value);
-      }
-    } else if (input_t > end_time) {
-      //clamping to the last value for t > end_time or if it is a rate than derivative is 0
-      for (int i=1; i < ecl_smspec_num_nodes(ecl_sum->smspec); i++) {
-        double value = 0;
-        const ecl::smspec_node& node = ecl_smspec_iget_node_w_node_index(ecl_sum->smspec, i);
-        if (!node.is_rate())
-          value = ecl_sum_iget_last_value(ecl_sum, node.get_params_index());
-        double_vector_iset(data, i-1, value);
-      }
-    } else {
-      /* Look up interpolated data in the original case. */
-      ecl_sum_get_interp_vector( ecl_sum, input_t, ecl_sum_vector, data);
-    }
+    const double * row = &frame[static_cast<size_t>(report_step) * num_keywords];
 
     /* Add timestep corresponding to the interpolated data in the resampled case. */
     ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum_resampled , report_step , input_t - input_start);
-    for (int data_index = 0; data_index < ecl_sum_vector_get_size(ecl_sum_vector); data_index++) {
-      double value = double_vector_iget(data,data_index);
+    for (int data_index = 0; data_index < num_keywords; data_index++) {
       int params_index = data_index + 1;  // The +1 shift is because the first element in the tstep is time value.
-      ecl_sum_tstep_iset(tstep, params_index, value);
+      ecl_sum_tstep_iset(tstep, params_index, row[data_index]);
     }
   }
-  double_vector_free( data );
   ecl_sum_vector_free( ecl_sum_vector );
   return ecl_sum_resampled;
 }
@@ -1268,10 +1433,17 @@ bool ecl_sum_same_case( const ecl_sum_type * ecl_sum , const char * input_file )
     {
       bool   fmt_file = ecl_smspec_get_formatted( ecl_sum->smspec );
       char * header_file = ecl_util_alloc_exfilename( path , base , ECL_SUMMARY_HEADER_FILE , fmt_file , -1 );
-      if (header_file != NULL) {
-        same_case = util_same_file( header_file , ecl_smspec_get_header_file( ecl_sum->smspec ));
-        free( header_file );
-      }
+      /*
+        The header file of this case is located from the case path, the
+        header file of the smspec can be the one of another case when
+        the smspec is shared.
+      */
+      char * case_header_file = ecl_util_alloc_exfilename( ecl_sum->path , ecl_sum->base , ECL_SUMMARY_HEADER_FILE , fmt_file , -1 );
+      if (header_file != NULL && case_header_file != NULL)
+        same_case = util_same_file( header_file , case_header_file );
+
+      free( header_file );
+      free( case_header_file );
     }
 
     free( path );
@@ -1294,6 +1466,10 @@ void ecl_sum_select_matching_general_var_list( const ecl_sum_type * ecl_sum , co
   ecl_smspec_select_matching_general_var_list( ecl_sum->smspec , pattern , keys );
 }
 
+void ecl_sum_select_matching_general_var_patterns( const ecl_sum_type * ecl_sum , const stringlist_type * patterns , stringlist_type * keys) {
+  ecl_smspec_select_matching_general_var_patterns( ecl_sum->smspec , patterns , keys );
+}
+
 stringlist_type * ecl_sum_alloc_well_list( const ecl_sum_type * ecl_sum , const char * pattern) {
   return ecl_smspec_alloc_well_list( ecl_sum->smspec , pattern );
 }
@@ -0,0 +1,484 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_columnar.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ert/util/ert_api_config.hpp>
+#include <ert/util/util.h>
+#include <ert/util/double_vector.hpp>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_smspec.hpp>
+#include <ert/ecl/smspec_node.hpp>
+
+#include "detail/ecl/ecl_sum_columnar.hpp"
+
+#ifdef ERT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ecl {
+
+namespace {
+
+/*
+  Layout of the columnar summary file:
+
+    columnar_header
+    nodes           : num_nodes * {num, lgr_i, lgr_j, lgr_k, default,
+                                   keyword, wgname, unit, lgr}
+    time axis       : length * double sim_seconds, length * int32 report_step
+    column table    : params_size * {int64 offset, int64 size}
+    columns         : each column starts at a COLUMNAR_ALIGNMENT boundary
+
+  Strings are stored as an int32 length followed by the characters. All
+  values are in native byte order; the byte_order field is used to
+  reject files written on a platform with different endianness.
+
+  A column is compressed if its size is different from length *
+  sizeof(float). Compressed columns are byte shuffled - i.e. all the
+  first bytes of the floats, then all the second bytes and so on -
+  before they are deflated with zlib.
+*/
+
+const char COLUMNAR_MAGIC[8] = "ECLCSUM";
+const int32_t COLUMNAR_VERSION = 1;
+const int32_t COLUMNAR_BYTE_ORDER = 0x01020304;
+const int32_t COLUMNAR_COMPRESSED = 1;
+const size_t COLUMNAR_ALIGNMENT = 64;
+
+struct columnar_header {
+  char    magic[8];
+  int32_t version;
+  int32_t byte_order;
+  int32_t flags;
+  int32_t params_size;
+  int32_t num_nodes;
+  int32_t grid_dims[3];
+  int64_t length;
+  int64_t start_time;
+};
+
+struct column_table_entry {
+  int64_t offset;
+  int64_t size;
+};
+
+
+class columnar_reader {
+public:
+  columnar_reader(const char * data, size_t size) :
+    data(data),
+    size(size)
+  {}
+
+  void read(void * ptr, size_t bytes) {
+    if (this->pos + bytes > this->size)
+      throw std::runtime_error("Columnar summary file is truncated");
+
+    memcpy(ptr, this->data + this->pos, bytes);
+    this->pos += bytes;
+  }
+
+  template <typename T>
+  T read() {
+    T value;
+    this->read(&value, sizeof value);
+    return value;
+  }
+
+  std::string read_string() {
+    int32_t length = this->read<int32_t>();
+    if (length < 0 || this->pos + length > this->size)
+      throw std::runtime_error("Columnar summary file is truncated");
+
+    std::string s(this->data + this->pos, length);
+    this->pos += length;
+    return s;
+  }
+
+private:
+  const char * data;
+  size_t size;
+  size_t pos = 0;
+};
+
+
+template <typename T>
+void fwrite_value(T value, FILE * stream) {
+  util_fwrite(&value, sizeof value, 1, stream, __func__);
+}
+
+
+void fwrite_string(const char * s, FILE * stream) {
+  int32_t length = s ? strlen(s) : 0;
+  fwrite_value(length, stream);
+  if (length > 0)
+    util_fwrite(s, 1, length, stream, __func__);
+}
+
+
+void fwrite_padding(FILE * stream) {
+  static const char zero[COLUMNAR_ALIGNMENT] = {0};
+  size_t pos = util_ftell(stream);
+  size_t padding = (COLUMNAR_ALIGNMENT - pos % COLUMNAR_ALIGNMENT) % COLUMNAR_ALIGNMENT;
+  if (padding > 0)
+    util_fwrite(zero, 1, padding, stream, __func__);
+}
+
+
+/*
+  Returns the compressed representation of @column, or an empty vector
+  if compression is not available or does not reduce the size.
+*/
+std::vector<char> compress_column(const std::vector<float>& column) {
+  std::vector<char> compressed;
+#ifdef ERT_HAVE_ZLIB
+  const size_t raw_size = column.size() * sizeof(float);
+  std::vector<unsigned char> shuffled(raw_size);
+  const unsigned char * raw = reinterpret_cast<const unsigned char *>(column.data());
+
+  for (size_t i = 0; i < column.size(); i++)
+    for (size_t b = 0; b < sizeof(float); b++)
+      shuffled[b * column.size() + i] = raw[i * sizeof(float) + b];
+
+  uLongf compressed_size = compressBound(raw_size);
+  compressed.resize(compressed_size);
+  if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &compressed_size, shuffled.data(), raw_size, Z_DEFAULT_COMPRESSION) != Z_OK)
+    return std::vector<char>();
+
+  if (compressed_size >= raw_size)
+    return std::vector<char>();
+
+  compressed.resize(compressed_size);
+#endif
+  return compressed;
+}
+
+
+std::vector<float> inflate_column(const char * data, size_t size, int length) {
+  std::vector<float> column(length);
+#ifdef ERT_HAVE_ZLIB
+  const size_t raw_size = column.size() * sizeof(float);
+  std::vector<unsigned char> shuffled(raw_size);
+  uLongf inflated_size = raw_size;
+
+  if (uncompress(shuffled.data(), &inflated_size, reinterpret_cast<const Bytef *>(data), size) != Z_OK || inflated_size != raw_size)
+    throw std::runtime_error("Failed to inflate compressed summary column");
+
+  unsigned char * raw = reinterpret_cast<unsigned char *>(column.data());
+  for (size_t i = 0; i < column.size(); i++)
+    for (size_t b = 0; b < sizeof(float); b++)
+      raw[i * sizeof(float) + b] = shuffled[b * column.size() + i];
+#else
+  throw std::runtime_error("Compressed summary columns require zlib support");
+#endif
+  return column;
+}
+
+
+bool is_time_node(const ecl::smspec_node& node) {
+  return util_string_equal(node.get_gen_key1(), "TIME");
+}
+
+}
+
+
+columnar_loader::columnar_loader(const std::string& filename) :
+  file(filename)
+{
+  columnar_reader reader(this->file.data(), this->file.size());
+  columnar_header header;
+
+  reader.read(&header, sizeof header);
+  if (memcmp(header.magic, COLUMNAR_MAGIC, sizeof header.magic) != 0)
+    throw std::runtime_error("Not a columnar summary file: " + filename);
+
+  if (header.byte_order != COLUMNAR_BYTE_ORDER)
+    throw std::runtime_error("Columnar summary file has wrong byte order: " + filename);
+
+  if (header.version != COLUMNAR_VERSION)
+    throw std::runtime_error("Unsupported columnar summary file version: " + filename);
+
+  if (header.params_size != header.num_nodes + 1 || header.length < 0)
+    throw std::runtime_error("Invalid columnar summary header: " + filename);
+
+  this->m_params_size = header.params_size;
+  this->m_length = header.length;
+  this->m_compressed = (header.flags & COLUMNAR_COMPRESSED);
+  this->m_start_time = header.start_time;
+  this->m_grid_dims = {{ header.grid_dims[0], header.grid_dims[1], header.grid_dims[2] }};
+
+  for (int i = 0; i < header.num_nodes; i++) {
+    columnar_node node;
+    node.num = reader.read<int32_t>();
+    for (int k = 0; k < 3; k++)
+      node.lgr_ijk[k] = reader.read<int32_t>();
+    node.default_value = reader.read<float>();
+    node.keyword = reader.read_string();
+    node.wgname = reader.read_string();
+    node.unit = reader.read_string();
+    node.lgr = reader.read_string();
+    this->m_nodes.push_back(node);
+  }
+
+  this->m_sim_seconds.resize(this->m_length);
+  this->m_report_steps.resize(this->m_length);
+  reader.read(this->m_sim_seconds.data(), this->m_length * sizeof(double));
+  reader.read(this->m_report_steps.data(), this->m_length * sizeof(int32_t));
+
+  for (int pos = 0; pos < this->m_params_size; pos++) {
+    column_table_entry entry = reader.read<column_table_entry>();
+    if (entry.offset < 0 || entry.size < 0 || static_cast<size_t>(entry.offset + entry.size) > this->file.size())
+      throw std::runtime_error("Invalid column table in: " + filename);
+
+    this->columns.push_back({entry.offset, entry.size});
+  }
+  this->inflated.resize(this->m_params_size);
+}
+
+
+int columnar_loader::params_size() const {
+  return this->m_params_size;
+}
+
+
+int columnar_loader::length() const {
+  return this->m_length;
+}
+
+
+bool columnar_loader::compressed() const {
+  return this->m_compressed;
+}
+
+
+time_t columnar_loader::start_time() const {
+  return this->m_start_time;
+}
+
+
+const std::array<int,3>& columnar_loader::grid_dims() const {
+  return this->m_grid_dims;
+}
+
+
+const std::vector<columnar_node>& columnar_loader::nodes() const {
+  return this->m_nodes;
+}
+
+
+/*
+  Uncompressed columns are returned as a pointer into the mapped file;
+  compressed columns are inflated on first access.
+*/
+const float * columnar_loader::column(int pos) const {
+  if (pos < 0 || pos >= this->m_params_size)
+    throw std::out_of_range("columnar_loader: invalid params index: " + std::to_string(pos));
+
+  const auto& entry = this->columns[pos];
+  if (entry.size == static_cast<int64_t>(this->m_length * sizeof(float)))
+    return reinterpret_cast<const float *>(this->file.data() + entry.offset);
+
+  std::lock_guard<std::mutex> lock(this->inflate_mutex);
+  auto& column = this->inflated[pos];
+  if (!column)
+    column.reset( new std::vector<float>(inflate_column(this->file.data() + entry.offset, entry.size, this->m_length)) );
+
+  return column->data();
+}
+
+
+const float * columnar_loader::column_ptr(int pos) const {
+  return this->column(pos);
+}
+
+
+std::vector<double> columnar_loader::get_vector(int pos) const {
+  const float * column = this->column(pos);
+  return std::vector<double>(column, column + this->m_length);
+}
+
+
+double columnar_loader::iget(int time_index, int params_index) const {
+  return this->column(params_index)[time_index];
+}
+
+
+std::vector<double> columnar_loader::sim_seconds() const {
+  return this->m_sim_seconds;
+}
+
+
+std::vector<time_t> columnar_loader::sim_time() const {
+  std::vector<time_t> st(this->m_length, this->m_start_time);
+  for (size_t i = 0; i < st.size(); i++)
+    util_inplace_forward_seconds_utc(&st[i], this->m_sim_seconds[i]);
+
+  return st;
+}
+
+
+/*
+  The report steps are stored as absolute values, the offset is not
+  used.
+*/
+std::vector<int> columnar_loader::report_steps(int offset) const {
+  return this->m_report_steps;
+}
+
+
+size_t columnar_loader::memory_usage() const {
+  size_t usage = sizeof * this + this->file.memory_usage();
+  for (const auto& node : this->m_nodes)
+    usage += sizeof node + node.keyword.capacity() + node.wgname.capacity() + node.unit.capacity() + node.lgr.capacity();
+
+  usage += this->m_sim_seconds.capacity() * sizeof(double);
+  usage += this->m_report_steps.capacity() * sizeof(int);
+  usage += this->columns.capacity() * sizeof(column_entry);
+
+  std::lock_guard<std::mutex> lock(this->inflate_mutex);
+  for (const auto& column : this->inflated) {
+    usage += sizeof column;
+    if (column)
+      usage += sizeof * column + column->capacity() * sizeof(float);
+  }
+  return usage;
+}
+
+
+/*
+  Writes the complete case - including the cases it has been restarted
+  from - as one columnar summary file. The file is first written to a
+  temporary file in the same directory, and then renamed.
+*/
+bool columnar_fwrite(const ecl_sum_type * ecl_sum, const std::string& filename, bool compress) {
+  const ecl_smspec_type * smspec = ecl_sum_get_smspec(ecl_sum);
+  const int length = ecl_sum_get_data_length(ecl_sum);
+  std::vector<int> params_index_list;
+
+  for (int node_index = 0; node_index < ecl_smspec_num_nodes(smspec); node_index++) {
+    const ecl::smspec_node& node = ecl_smspec_iget_node_w_node_index(smspec, node_index);
+    if (!is_time_node(node))
+      params_index_list.push_back(node.get_params_index());
+  }
+
+#ifndef ERT_HAVE_ZLIB
+  compress = false;
+#endif
+
+  const std::string tmp_file = filename + ".tmp";
+  FILE * stream = fopen(tmp_file.c_str(), "wb");
+  if (!stream)
+    return false;
+
+  {
+    columnar_header header;
+    const int * grid_dims = ecl_smspec_get_grid_dims(smspec);
+
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, COLUMNAR_MAGIC, sizeof header.magic);
+    header.version = COLUMNAR_VERSION;
+    header.byte_order = COLUMNAR_BYTE_ORDER;
+    header.flags = compress ? COLUMNAR_COMPRESSED : 0;
+    header.params_size = params_index_list.size() + 1;
+    header.num_nodes = params_index_list.size();
+    for (int k = 0; k < 3; k++)
+      header.grid_dims[k] = grid_dims[k];
+    header.length = length;
+    header.start_time = ecl_sum_get_start_time(ecl_sum);
+    util_fwrite(&header, sizeof header, 1, stream, __func__);
+  }
+
+  for (int params_index : params_index_list) {
+    const ecl::smspec_node& node = ecl_smspec_iget_node_w_params_index(smspec, params_index);
+    const auto& lgr_ijk = node.get_lgr_ijk();
+
+    fwrite_value<int32_t>(node.get_num(), stream);
+    for (int k = 0; k < 3; k++)
+      fwrite_value<int32_t>(lgr_ijk[k], stream);
+    fwrite_value<float>(node.get_default(), stream);
+    fwrite_string(node.get_keyword(), stream);
+    fwrite_string(node.get_wgname(), stream);
+    fwrite_string(node.get_unit(), stream);
+    fwrite_string(node.get_lgr_name(), stream);
+  }
+
+  std::vector<float> time_column(length);
+  {
+    std::vector<double> sim_seconds(length);
+    std::vector<int32_t> report_steps(length);
+    for (int time_index = 0; time_index < length; time_index++) {
+      double sim_days = ecl_sum_iget_sim_days(ecl_sum, time_index);
+      sim_seconds[time_index] = sim_days * 86400;
+      report_steps[time_index] = ecl_sum_iget_report_step(ecl_sum, time_index);
+      time_column[time_index] = sim_days;
+    }
+    util_fwrite(sim_seconds.data(), sizeof(double), length, stream, __func__);
+    util_fwrite(report_steps.data(), sizeof(int32_t), length, stream, __func__);
+  }
+
+  const offset_type table_offset = util_ftell(stream);
+  std::vector<column_table_entry> table(params_index_list.size() + 1);
+  util_fwrite(table.data(), sizeof(column_table_entry), table.size(), stream, __func__);
+
+  for (size_t pos = 0; pos < table.size(); pos++) {
+    std::vector<float> column;
+    if (pos == 0)
+      column = time_column;
+    else {
+      double_vector_type * data = ecl_sum_alloc_data_vector(ecl_sum, params_index_list[pos - 1], false);
+      const double * values = double_vector_get_const_ptr(data);
+      column.assign(values, values + double_vector_size(data));
+      double_vector_free(data);
+    }
+
+    fwrite_padding(stream);
+    table[pos].offset = util_ftell(stream);
+
+    std::vector<char> compressed;
+    if (compress)
+      compressed = compress_column(column);
+
+    if (compressed.empty()) {
+      table[pos].size = column.size() * sizeof(float);
+      util_fwrite(column.data(), sizeof(float), column.size(), stream, __func__);
+    } else {
+      table[pos].size = compressed.size();
+      util_fwrite(compressed.data(), 1, compressed.size(), stream, __func__);
+    }
+  }
+
+  util_fseek(stream, table_offset, SEEK_SET);
+  util_fwrite(table.data(), sizeof(column_table_entry), table.size(), stream, __func__);
+  fclose(stream);
+
+  if (std::rename(tmp_file.c_str(), filename.c_str()) != 0) {
+    util_unlink(tmp_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}
@@ -215,6 +215,10 @@ namespace {
       this->index.clear();
     }
 
+    size_t memory_usage() const {
+      return ecl::util::memory_usage(this->index);
+    }
+
     int length() const {
       return this->index.back().end();
     }
@@ -260,6 +264,28 @@ static double ecl_sum_data_iget_sim_seconds( const ecl_sum_data_type * data , in
 }
 
 
+/*
+  Only the last data file is owned by this ecl_sum_data instance, the
+  other data files belong to the restart cases.
+*/
+size_t ecl_sum_data_get_memory_usage( const ecl_sum_data_type * data ) {
+  size_t usage = sizeof * data + ecl::util::memory_usage( data->data_files ) + data->index.memory_usage();
+  if (data->data_files.size() > 0)
+    usage += data->data_files.back()->memory_usage();
+  return usage;
+}
+
+
+/*
+  Enables or disables the column cache of the data file owned by this
+  instance, see ecl_sum_file_data::set_column_cache().
+*/
+void ecl_sum_data_set_column_cache( ecl_sum_data_type * data , bool column_cache ) {
+  if (data->data_files.size() > 0)
+    data->data_files.back()->set_column_cache( column_cache );
+}
+
+
 ecl_sum_data_type * ecl_sum_data_alloc(ecl_smspec_type * smspec) {
   ecl_sum_data_type * data =  new ecl_sum_data_type();
   data->smspec = smspec;
@@ -715,6 +741,42 @@ bool ecl_sum_data_fread(ecl_sum_data_type * data , const stringlist_type * filel
 }
 
 
+/*
+  Loads the data from a columnar summary file; the smspec of @data must
+  have been created from the header of the same file.
+*/
+bool ecl_sum_data_fread_columnar(ecl_sum_data_type * data, const char * filename) {
+  ecl::ecl_sum_file_data * file_data = new ecl::ecl_sum_file_data( data->smspec );
+  if (file_data->fread_columnar( filename )) {
+    ecl_sum_data_append_file_data( data, file_data );
+    ecl_sum_data_build_index(data);
+    return true;
+  }
+  delete file_data;
+  return false;
+}
+
+
+/*
+  Returns a pointer to the contiguous values of the vector
+  @params_index, without copying, if that is possible; i.e. if the
+  data has been loaded from one file with a loader which can provide
+  the column. Otherwise NULL is returned and the values must be
+  extracted with ecl_sum_data_init_double_vector().
+*/
+const float * ecl_sum_data_get_vector_ptr(const ecl_sum_data_type * data, int params_index) {
+  if (data->data_files.size() != 1)
+    return NULL;
+
+  const auto& index_node = *data->index.begin();
+  int file_params_index = index_node.params_map[params_index];
+  if (file_params_index < 0)
+    return NULL;
+
+  return data->data_files[index_node.data_index]->column_ptr(file_params_index);
+}
+
+
 
 
 
@@ -1135,111 +1197,245 @@ double_vector_type * ecl_sum_data_alloc_data_vector( const ecl_sum_data_type * d
 }
 
 
+/*
+  Resampling to many time points is done in two steps. First the time
+  points are sorted, and the interpolation weights of all points are
+  calculated in one merge pass over the time axis of the case. The
+  weights are then applied to complete vectors; calculating the weights
+  is independent of the number of vectors.
+*/
+
+namespace {
+
+struct interp_point {
+  int position;                 /* -1: before start, 1: after end, 0: inside. */
+  int rate_index;
+  int index1;
+  int index2;
+  double weight1;
+  double weight2;
+};
+
+
+/*
+  Rates are step functions and are taken from the ministep ending at or
+  after the time point, other values are interpolated linearly between
+  two ministeps. Before the start and after the end of the case rates
+  are zero, and other values are clamped.
+*/
+inline double interp_point_value(const interp_point& point, const double * vector, int length, bool is_rate) {
+  if (point.position < 0)
+    return is_rate ? 0 : vector[0];
+
+  if (point.position > 0)
+    return is_rate ? 0 : vector[length - 1];
+
+  if (is_rate)
+    return vector[point.rate_index];
+
+  return vector[point.index1] * point.weight1 + vector[point.index2] * point.weight2;
+}
+
+}
+
+
+/*
+  The merge pass finds the first ministep at or after each time point,
+  i.e. the same index as the binary search in
+  ecl_sum_data_get_index_from_sim_time(), and the weights are the same
+  as in ecl_sum_data_init_interp_from_sim_time().
+*/
+
+static std::vector<interp_point> ecl_sum_data_alloc_interp_points(const ecl_sum_data_type * data, const time_t_vector_type * time_points) {
+  const int num_points = time_t_vector_size(time_points);
+  const int length = ecl_sum_data_get_length(data);
+  std::vector<interp_point> points(num_points);
+  std::vector<time_t> sim_time(length);
+  std::vector<int> order(num_points);
+
+  ecl_sum_data_init_time_vector(data, sim_time.data());
+  for (int i = 0; i < num_points; i++)
+    order[i] = i;
+
+  if (!time_t_vector_is_sorted(time_points, false))
+    std::stable_sort(order.begin(), order.end(),
+                     [time_points](int i1, int i2) { return time_t_vector_iget(time_points, i1) < time_t_vector_iget(time_points, i2); });
+
+  int time_index = 0;
+  for (int i : order) {
+    time_t t = time_t_vector_iget(time_points, i);
+    auto& point = points[i];
+
+    if (length == 0 || t < sim_time[0]) {
+      point.position = -1;
+      continue;
+    }
+
+    if (t > sim_time[length - 1]) {
+      point.position = 1;
+      continue;
+    }
+
+    while (sim_time[time_index] < t)
+      time_index++;
+
+    point.position = 0;
+    point.rate_index = time_index;
+    if (time_index == 0) {
+      point.index1 = 0;
+      point.index2 = 0;
+      point.weight1 = 1;
+      point.weight2 = 0;
+    } else {
+      double time_diff = sim_time[time_index] - sim_time[time_index - 1];
+
+      point.index1 = time_index - 1;
+      point.index2 = time_index;
+      point.weight1 = (sim_time[time_index] - t) / time_diff;
+      point.weight2 = (t - sim_time[time_index - 1]) / time_diff;
+    }
+  }
+  return points;
+}
+
+
 void ecl_sum_data_init_double_vector_interp(const ecl_sum_data_type * data,
                                             const ecl::smspec_node& smspec_node,
                                             const time_t_vector_type * time_points,
                                             double * output_data) {
   bool is_rate = smspec_node_is_rate(&smspec_node);
   int params_index = smspec_node_get_params_index(&smspec_node);
-  time_t start_time = ecl_sum_data_get_data_start(data);
-  time_t end_time   = ecl_sum_data_get_sim_end(data);
-  double start_value = 0;
-  double end_value = 0;
-
-  if (!is_rate) {
-    start_value = ecl_sum_data_iget_first_value(data, params_index);
-    end_value = ecl_sum_data_iget_last_value(data, params_index);
-  }
+  const int length = ecl_sum_data_get_length(data);
+  const auto points = ecl_sum_data_alloc_interp_points(data, time_points);
+  std::vector<double> vector(length);
 
-  for (int time_index=0; time_index < time_t_vector_size(time_points); time_index++) {
-    time_t sim_time = time_t_vector_iget( time_points, time_index);
-    double value;
-    if (sim_time < start_time)
-      value = start_value;
+  ecl_sum_data_init_double_vector__(data, params_index, vector.data(), false);
+  for (size_t i = 0; i < points.size(); i++)
+    output_data[i] = interp_point_value(points[i], vector.data(), length, is_rate);
+}
 
-    else if (sim_time > end_time)
-      value = end_value;
 
-    else {
-      int time_index1, time_index2;
-      double weight1, weight2;
-      ecl_sum_data_init_interp_from_sim_time(data, sim_time, &time_index1, &time_index2, &weight1, &weight2);
-      value = ecl_sum_data_vector_iget( data,
-                                        sim_time,
-                                        params_index,
-                                        is_rate,
-                                        time_index1,
-                                        time_index2,
-                                        weight1,
-                                        weight2);
-    }
 
-    output_data[time_index] = value;
+
+/*
+  The frame functions extract the vectors column wise, FRAME_BLOCK_SIZE
+  keywords at a time, and transpose each block into the row major frame
+  in tiles of FRAME_BLOCK_SIZE x FRAME_BLOCK_SIZE values. The blocks of
+  keywords are independent, and are distributed over the threads when
+  the data files allow concurrent vector extraction.
+*/
+
+namespace {
+
+const int FRAME_BLOCK_SIZE = 64;
+
+}
+
+
+static bool ecl_sum_data_prepare_concurrent_read(const ecl_sum_data_type * data) {
+  bool concurrent = true;
+  for (const auto& index_node : data->index) {
+    if (!data->data_files[index_node.data_index]->prepare_concurrent_read())
+      concurrent = false;
   }
+  return concurrent;
 }
 
 
+/*
+  Copies the columns of the keywords [key1, key2), each of @length
+  values, into the rows [row_offset, row_offset + length) of the row
+  major @output_data.
+*/
+
+static void ecl_sum_data_transpose_frame_block(const double * columns, int length, int key1, int key2, int num_keywords, int row_offset, double * output_data) {
+  for (int time1 = 0; time1 < length; time1 += FRAME_BLOCK_SIZE) {
+    int time2 = std::min(length, time1 + FRAME_BLOCK_SIZE);
+    for (int time_index = time1; time_index < time2; time_index++) {
+      double * row = &output_data[static_cast<size_t>(row_offset + time_index) * num_keywords];
+      for (int key_index = key1; key_index < key2; key_index++)
+        row[key_index] = columns[static_cast<size_t>(key_index - key1) * length + time_index];
+    }
+  }
+}
 
 
 void ecl_sum_data_init_double_frame(const ecl_sum_data_type * data, const ecl_sum_vector_type * keywords, double *output_data) {
-  int time_stride = ecl_sum_vector_get_size(keywords);
-  int key_stride = 1;
-  for (int time_index=0; time_index < ecl_sum_data_get_length(data); time_index++) {
-    for (int key_index = 0; key_index < ecl_sum_vector_get_size(keywords); key_index++) {
-      int param_index = ecl_sum_vector_iget_param_index(keywords, key_index);
-      int data_index = key_index*key_stride + time_index * time_stride;
-
-      output_data[data_index] = ecl_sum_data_iget(data, time_index, param_index);
+  const int num_keywords = ecl_sum_vector_get_size(keywords);
+  const int num_blocks = (num_keywords + FRAME_BLOCK_SIZE - 1) / FRAME_BLOCK_SIZE;
+  const bool concurrent = ecl_sum_data_prepare_concurrent_read(data);
+  (void) concurrent;   /* Only used in the OpenMP pragma. */
+
+  for (const auto& index_node : data->index) {
+    ecl::ecl_sum_file_data * data_file = data->data_files[index_node.data_index];
+    const int length = index_node.length;
+    std::vector<int> file_params(num_keywords);
+    std::vector<double> default_values(num_keywords);
+
+    for (int key_index = 0; key_index < num_keywords; key_index++) {
+      int params_index = ecl_sum_vector_iget_param_index(keywords, key_index);
+      file_params[key_index] = index_node.params_map[params_index];
+      if (file_params[key_index] < 0)
+        default_values[key_index] = ecl_smspec_iget_node_w_params_index(data->smspec, params_index).get_default();
+    }
+
+#pragma omp parallel for schedule(dynamic) if(concurrent)
+    for (int block = 0; block < num_blocks; block++) {
+      int key1 = block * FRAME_BLOCK_SIZE;
+      int key2 = std::min(num_keywords, key1 + FRAME_BLOCK_SIZE);
+      std::vector<double> columns(static_cast<size_t>(key2 - key1) * length);
+
+      for (int key_index = key1; key_index < key2; key_index++) {
+        double * column = &columns[static_cast<size_t>(key_index - key1) * length];
+        if (file_params[key_index] >= 0)
+          data_file->get_data(file_params[key_index], length, column);
+        else
+          std::fill(column, column + length, default_values[key_index]);
+      }
+      ecl_sum_data_transpose_frame_block(columns.data(), length, key1, key2, num_keywords, index_node.offset, output_data);
     }
   }
 }
 
 
+/*
+  The interpolation weights are calculated once for all the time
+  points, the values are then calculated from complete vectors extracted
+  in blocks of keywords, as for ecl_sum_data_init_double_frame().
+*/
+
 void ecl_sum_data_init_double_frame_interp(const ecl_sum_data_type * data,
                                            const ecl_sum_vector_type * keywords,
                                            const time_t_vector_type * time_points,
                                            double * output_data) {
-  int num_keywords = ecl_sum_vector_get_size(keywords);
-  int time_stride = num_keywords;
-  int key_stride = 1;
-  time_t start_time = ecl_sum_data_get_data_start(data);
-  time_t end_time   = ecl_sum_data_get_sim_end(data);
-
-
-  for (int time_index=0; time_index < time_t_vector_size(time_points); time_index++) {
-    time_t sim_time = time_t_vector_iget( time_points, time_index);
-    if (sim_time < start_time) {
-      for (int key_index = 0; key_index < num_keywords; key_index++) {
-        int param_index = ecl_sum_vector_iget_param_index(keywords, key_index);
-        int data_index = key_index*key_stride + time_index*time_stride;
-        bool is_rate = ecl_sum_vector_iget_is_rate(keywords, key_index);
-        if (is_rate)
-          output_data[data_index] = 0;
-        else
-          output_data[data_index] = ecl_sum_data_iget_first_value(data, param_index);
-      }
-    } else if (sim_time > end_time) {
-      for (int key_index = 0; key_index < num_keywords; key_index++) {
-        int param_index = ecl_sum_vector_iget_param_index(keywords, key_index);
-        int data_index = key_index*key_stride + time_index*time_stride;
-        bool is_rate = ecl_sum_vector_iget_is_rate(keywords, key_index);
-        if (is_rate)
-          output_data[data_index] = 0;
-        else
-          output_data[data_index] = ecl_sum_data_iget_last_value(data, param_index);
-      }
-    } else {
-      double weight1, weight2;
-      int    time_index1, time_index2;
+  const int num_keywords = ecl_sum_vector_get_size(keywords);
+  const int num_blocks = (num_keywords + FRAME_BLOCK_SIZE - 1) / FRAME_BLOCK_SIZE;
+  const int num_points = time_t_vector_size(time_points);
+  const int length = ecl_sum_data_get_length(data);
+  const auto points = ecl_sum_data_alloc_interp_points(data, time_points);
+
+  const bool concurrent = ecl_sum_data_prepare_concurrent_read(data);
+  (void) concurrent;   /* Only used in the OpenMP pragma. */
+#pragma omp parallel for schedule(dynamic) if(concurrent)
+  for (int block = 0; block < num_blocks; block++) {
+    int key1 = block * FRAME_BLOCK_SIZE;
+    int key2 = std::min(num_keywords, key1 + FRAME_BLOCK_SIZE);
+    std::vector<double> columns(static_cast<size_t>(key2 - key1) * length);
+    std::vector<bool> is_rate(key2 - key1);
+
+    for (int key_index = key1; key_index < key2; key_index++) {
+      int params_index = ecl_sum_vector_iget_param_index(keywords, key_index);
+      is_rate[key_index - key1] = ecl_sum_vector_iget_is_rate(keywords, key_index);
+      ecl_sum_data_init_double_vector__(data, params_index, &columns[static_cast<size_t>(key_index - key1) * length], false);
+    }
 
-      ecl_sum_data_init_interp_from_sim_time(data, sim_time, &time_index1, &time_index2, &weight1, &weight2);
+    for (int time_index = 0; time_index < num_points; time_index++) {
+      const auto& point = points[time_index];
+      double * row = &output_data[static_cast<size_t>(time_index) * num_keywords];
 
-      for (int key_index = 0; key_index < num_keywords; key_index++) {
-        int param_index = ecl_sum_vector_iget_param_index(keywords, key_index);
-        int data_index = key_index*key_stride + time_index*time_stride;
-        bool is_rate = ecl_sum_vector_iget_is_rate(keywords, key_index);
-        double value = ecl_sum_data_vector_iget( data, sim_time, param_index , is_rate, time_index1, time_index2, weight1, weight2);
-        output_data[data_index] = value;
+      for (int key_index = key1; key_index < key2; key_index++) {
+        const double * column = &columns[static_cast<size_t>(key_index - key1) * length];
+        row[key_index] = interp_point_value(point, column, length, is_rate[key_index - key1]);
       }
     }
   }
@@ -0,0 +1,318 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_ensemble.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/time_t_vector.hpp>
+
+#include <ert/ecl/ecl_util.hpp>
+#include <ert/ecl/ecl_smspec.hpp>
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_vector.hpp>
+#include <ert/ecl/ecl_sum_ensemble.hpp>
+
+#include "detail/ecl/ecl_sum_ensemble.hpp"
+
+/*
+  The ecl_sum_ensemble loads many cases of the same model. The SMSPEC
+  files of the cases are typically identical; each distinct SMSPEC file
+  is only parsed once, and the resulting smspec is shared by all the
+  cases with that SMSPEC file. The cases are loaded in parallel.
+
+  Only the size and a hash of the content are kept for each SMSPEC
+  file; when the hash matches the SMSPEC file of an earlier case the
+  two files are compared byte by byte before the smspec is shared.
+
+  When the smspec refers to a restart case it is not shared, because
+  the restart case is resolved relative to the location of the SMSPEC
+  file.
+*/
+
+#define ECL_SUM_ENSEMBLE_TYPE_ID 8768779
+
+struct ecl_sum_ensemble_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  std::vector<ecl_sum_type *>    cases;      /* NULL for the cases which failed to load. */
+  std::vector<ecl_smspec_type *> smspecs;    /* The shared smspec instances. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_sum_ensemble , ECL_SUM_ENSEMBLE_TYPE_ID )
+
+
+namespace {
+
+struct case_files {
+  std::string       header_file;
+  stringlist_type * data_files = NULL;
+  int               header_size = 0;
+  size_t            header_hash = 0;
+  int               smspec_index = -1;
+};
+
+
+void case_files_init(case_files& files, const char * ecl_case) {
+  char * path;
+  char * base;
+  char * ext;
+  char * header_file = NULL;
+
+  util_alloc_file_components( ecl_case , &path , &base , &ext );
+  files.data_files = stringlist_alloc_new();
+  ecl_util_alloc_summary_files( path , base , ext , &header_file , files.data_files );
+
+  if (header_file && stringlist_get_size( files.data_files ) > 0) {
+    int size;
+    char * content = util_fread_alloc_file_content( header_file , &size );
+
+    files.header_file = header_file;
+    files.header_size = size;
+    files.header_hash = std::hash<std::string>()( std::string( content , size ));
+    free( content );
+  }
+
+  free( header_file );
+  free( path );
+  free( base );
+  free( ext );
+}
+
+}
+
+
+ecl_sum_ensemble_type * ecl_sum_ensemble_fread_alloc( const stringlist_type * cases , const char * key_join_string , bool include_restart , bool lazy_load , int file_options) {
+  const int num_cases = stringlist_get_size( cases );
+  ecl_sum_ensemble_type * ensemble = new ecl_sum_ensemble_type();
+  std::vector<case_files> files(num_cases);
+  std::vector<int> representatives;
+
+  UTIL_TYPE_ID_INIT( ensemble , ECL_SUM_ENSEMBLE_TYPE_ID );
+  ensemble->cases.resize( num_cases , NULL );
+
+#pragma omp parallel for schedule(dynamic)
+  for (int iens = 0; iens < num_cases; iens++)
+    case_files_init( files[iens] , stringlist_iget( cases , iens ));
+
+  /* Group the cases with identical SMSPEC files. */
+  {
+    std::unordered_map<size_t, std::vector<int>> content_map;
+    for (int iens = 0; iens < num_cases; iens++) {
+      auto& case_file = files[iens];
+      if (case_file.header_file.empty())
+        continue;
+
+      auto& candidates = content_map[case_file.header_hash];
+      for (int smspec_index : candidates) {
+        const auto& representative = files[representatives[smspec_index]];
+        if (representative.header_size == case_file.header_size &&
+            util_files_equal( representative.header_file.c_str() , case_file.header_file.c_str() )) {
+          case_file.smspec_index = smspec_index;
+          break;
+        }
+      }
+
+      if (case_file.smspec_index < 0) {
+        case_file.smspec_index = representatives.size();
+        candidates.push_back( case_file.smspec_index );
+        representatives.push_back( iens );
+      }
+    }
+  }
+
+  ensemble->smspecs.resize( representatives.size() , NULL );
+#pragma omp parallel for schedule(dynamic)
+  for (int smspec_index = 0; smspec_index < static_cast<int>(representatives.size()); smspec_index++) {
+    const auto& case_file = files[representatives[smspec_index]];
+    ecl_smspec_type * smspec = ecl_smspec_fread_alloc( case_file.header_file.c_str() , key_join_string , include_restart );
+
+    if (smspec && ecl_smspec_get_restart_case( smspec )) {
+      ecl_smspec_free( smspec );
+      smspec = NULL;
+    }
+    ensemble->smspecs[smspec_index] = smspec;
+  }
+
+#pragma omp parallel for schedule(dynamic)
+  for (int iens = 0; iens < num_cases; iens++) {
+    const auto& case_file = files[iens];
+    const char * ecl_case = stringlist_iget( cases , iens );
+
+    if (case_file.header_file.empty())
+      continue;
+
+    ecl_smspec_type * smspec = ensemble->smspecs[case_file.smspec_index];
+    if (smspec)
+      ensemble->cases[iens] = ecl_sum_fread_alloc_shared_smspec( ecl_case ,
+                                                                 case_file.header_file.c_str() ,
+                                                                 case_file.data_files ,
+                                                                 smspec ,
+                                                                 key_join_string ,
+                                                                 include_restart ,
+                                                                 lazy_load ,
+                                                                 file_options );
+    else
+      ensemble->cases[iens] = ecl_sum_fread_alloc_case2__( ecl_case , key_join_string , include_restart , lazy_load , file_options );
+  }
+
+  for (auto& case_file : files)
+    stringlist_free( case_file.data_files );
+
+  ensemble->smspecs.erase( std::remove( ensemble->smspecs.begin() , ensemble->smspecs.end() , nullptr ) , ensemble->smspecs.end() );
+  return ensemble;
+}
+
+
+void ecl_sum_ensemble_free( ecl_sum_ensemble_type * ensemble ) {
+  for (ecl_sum_type * ecl_sum : ensemble->cases) {
+    if (ecl_sum)
+      ecl_sum_free( ecl_sum );
+  }
+
+  for (ecl_smspec_type * smspec : ensemble->smspecs)
+    ecl_smspec_free( smspec );
+
+  delete ensemble;
+}
+
+
+int ecl_sum_ensemble_get_size( const ecl_sum_ensemble_type * ensemble ) {
+  return ensemble->cases.size();
+}
+
+
+/*
+  Will return NULL if the case could not be loaded.
+*/
+const ecl_sum_type * ecl_sum_ensemble_iget( const ecl_sum_ensemble_type * ensemble , int iens ) {
+  return ensemble->cases.at( iens );
+}
+
+
+/*
+  The number of distinct smspec instances held by the loaded cases.
+*/
+int ecl_sum_ensemble_get_num_smspec( const ecl_sum_ensemble_type * ensemble ) {
+  std::set<const ecl_smspec_type *> smspecs;
+  for (const ecl_sum_type * ecl_sum : ensemble->cases) {
+    if (ecl_sum)
+      smspecs.insert( ecl_sum_get_smspec( ecl_sum ));
+  }
+  return smspecs.size();
+}
+
+
+/*
+  If all the loaded cases have the same time axis that time axis is
+  returned, otherwise NULL.
+*/
+time_t_vector_type * ecl_sum_ensemble_alloc_common_time( const ecl_sum_ensemble_type * ensemble ) {
+  time_t_vector_type * common_time = NULL;
+
+  for (const ecl_sum_type * ecl_sum : ensemble->cases) {
+    if (!ecl_sum)
+      continue;
+
+    time_t_vector_type * time_vector = ecl_sum_alloc_time_vector( ecl_sum , false );
+    if (!common_time)
+      common_time = time_vector;
+    else {
+      bool equal = time_t_vector_equal( common_time , time_vector );
+      time_t_vector_free( time_vector );
+      if (!equal) {
+        time_t_vector_free( common_time );
+        return NULL;
+      }
+    }
+  }
+  return common_time;
+}
+
+
+/*
+  Fills @data with the values of @keys for all the cases, as a
+  [case x time x key] array in row major order. If @time_points is
+  given all cases are resampled to these times, otherwise the cases
+  must share a common time axis - if they do not, false is returned.
+
+  Values of keys which are missing in a case, and of the cases which
+  failed to load, are set to NAN.
+*/
+bool ecl_sum_ensemble_init_double_cube( const ecl_sum_ensemble_type * ensemble , const stringlist_type * keys , const time_t_vector_type * time_points , double * data) {
+  time_t_vector_type * common_time = NULL;
+  if (!time_points) {
+    common_time = ecl_sum_ensemble_alloc_common_time( ensemble );
+    if (!common_time)
+      return false;
+  }
+
+  const int num_cases = ensemble->cases.size();
+  const int num_keys  = stringlist_get_size( keys );
+  const int num_times = time_t_vector_size( time_points ? time_points : common_time );
+  const size_t case_size = static_cast<size_t>(num_times) * num_keys;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int iens = 0; iens < num_cases; iens++) {
+    const ecl_sum_type * ecl_sum = ensemble->cases[iens];
+    double * case_data = data + iens * case_size;
+
+    std::fill( case_data , case_data + case_size , NAN );
+    if (!ecl_sum)
+      continue;
+
+    ecl_sum_vector_type * vector = ecl_sum_vector_alloc( ecl_sum , false );
+    std::vector<int> columns;
+    for (int key_index = 0; key_index < num_keys; key_index++) {
+      const char * key = stringlist_iget( keys , key_index );
+      if (ecl_sum_has_general_var( ecl_sum , key )) {
+        ecl_sum_vector_add_key( vector , key );
+        columns.push_back( key_index );
+      }
+    }
+
+    if (!columns.empty()) {
+      std::vector<double> frame(static_cast<size_t>(num_times) * columns.size());
+      if (time_points)
+        ecl_sum_init_double_frame_interp( ecl_sum , vector , time_points , frame.data() );
+      else
+        ecl_sum_init_double_frame( ecl_sum , vector , frame.data() );
+
+      for (int time_index = 0; time_index < num_times; time_index++) {
+        const double * frame_row = &frame[static_cast<size_t>(time_index) * columns.size()];
+        double * row = &case_data[static_cast<size_t>(time_index) * num_keys];
+        for (size_t i = 0; i < columns.size(); i++)
+          row[columns[i]] = frame_row[i];
+      }
+    }
+    ecl_sum_vector_free( vector );
+  }
+
+  if (common_time)
+    time_t_vector_free( common_time );
+
+  return true;
+}
@@ -10,6 +10,7 @@
 
 #include "detail/ecl/ecl_sum_file_data.hpp"
 #include "detail/ecl/ecl_unsmry_loader.hpp"
+#include "detail/ecl/ecl_sum_columnar.hpp"
 
 /*
   This file implements the type ecl_sum_data_type. The data structure
@@ -182,12 +183,43 @@ namespace ecl {
 
 ecl_sum_file_data::ecl_sum_file_data(const ecl_smspec_type * smspec) :
   ecl_smspec( smspec ),
-  data( vector_alloc_new() )
+  values( ecl_smspec_get_params_size( smspec ))
 {
 }
 
 ecl_sum_file_data::~ecl_sum_file_data() {
-  vector_free( data );
+  for (ecl_sum_tstep_type * tstep : this->tstep_handles) {
+    if (tstep)
+      ecl_sum_tstep_free( tstep );
+  }
+}
+
+
+/*
+  With the column cache enabled the vectors are extracted from a column
+  major copy of the values, which is built on the first extraction and
+  doubles the memory used by the values. Disabling the cache releases
+  the copy.
+*/
+void ecl_sum_file_data::set_column_cache(bool column_cache) {
+  this->values.set_lazy_transpose( column_cache );
+}
+
+
+size_t ecl_sum_file_data::memory_usage() const {
+  size_t usage = sizeof * this + this->index.memory_usage();
+  usage += this->values.memory_usage();
+  usage += ecl::util::memory_usage( this->ministeps );
+  usage += ecl::util::memory_usage( this->tstep_handles );
+  for (const ecl_sum_tstep_type * tstep : this->tstep_handles) {
+    if (tstep)
+      usage += ecl_sum_tstep_get_memory_usage( tstep );
+  }
+
+  if (this->loader)
+    usage += this->loader->memory_usage();
+
+  return usage;
 }
 
 
@@ -271,21 +303,36 @@ double ecl_sum_file_data::get_sim_length() const {
 double ecl_sum_file_data::iget( int time_index , int params_index ) const {
   if (this->loader)
     return this->loader->iget(time_index, params_index);
-  else {
-    const ecl_sum_tstep_type * ministep_data = iget_ministep( time_index  );
-    return ecl_sum_tstep_iget( ministep_data , params_index);
-  }
+  else
+    return this->values.get(time_index, params_index);
 }
 
 
 
-void ecl_sum_file_data::append_tstep(ecl_sum_tstep_type * tstep) {
-  /*
-     Here the tstep is just appended naively, the vector will be
-     sorted by ministep_nr before the data instance is returned.
-  */
+/*
+  Moves the values of @tstep into a new row of the matrix; the ministep
+  is appended naively, the rows are sorted by time when the index is
+  built. If @keep_handle is false the tstep is discarded, otherwise it
+  stays attached to the new row - that is used for the tsteps handed
+  out by add_new_tstep().
+*/
 
-  vector_append_owned_ref( data , tstep , ecl_sum_tstep_free__);
+void ecl_sum_file_data::append_tstep(ecl_sum_tstep_type * tstep, bool keep_handle) {
+  if (this->values.rows() == 0)
+    this->values.set_columns( ecl_smspec_get_params_size( this->ecl_smspec ));
+
+  this->ministeps.emplace_back(ecl_sum_tstep_get_report( tstep ),
+                               ecl_sum_tstep_get_ministep( tstep ),
+                               ecl_sum_tstep_get_sim_seconds( tstep ),
+                               ecl_sum_tstep_get_sim_time( tstep ));
+  ecl_sum_tstep_attach( tstep , &this->values );
+
+  if (keep_handle)
+    this->tstep_handles.push_back( tstep );
+  else {
+    this->tstep_handles.push_back( NULL );
+    ecl_sum_tstep_free( tstep );
+  }
 }
 
 
@@ -297,47 +344,32 @@ void ecl_sum_file_data::append_tstep(ecl_sum_tstep_type * tstep) {
 */
 
 ecl_sum_tstep_type * ecl_sum_file_data::add_new_tstep( int report_step , double sim_seconds) {
-  int ministep_nr = vector_get_size( data );
+  int ministep_nr = this->ministeps.size();
   ecl_sum_tstep_type * tstep = ecl_sum_tstep_alloc_new( report_step , ministep_nr , sim_seconds , ecl_smspec );
-  ecl_sum_tstep_type * prev_tstep = NULL;
-
-  if (vector_get_size( data ) > 0)
-    prev_tstep = (ecl_sum_tstep_type*) vector_get_last( data );
-
-  append_tstep( tstep );
-
-
   bool rebuild_index = true;
-  /*
-    In the simple case that we just add another timestep to the
-    currently active report_step, we do a limited update of the
-    index, otherwise we call ecl_sum_data_build_index() to get a
-    full recalculation of the index.
-  */
-  if (!prev_tstep)
-    goto exit;
 
-  if (ecl_sum_tstep_get_report(prev_tstep) != ecl_sum_tstep_get_report( tstep ))
-    goto exit;
-
-  if (ecl_sum_tstep_get_sim_days( prev_tstep ) >= ecl_sum_tstep_get_sim_days( tstep ))
-    goto exit;
-
-  this->index.add(ecl_sum_tstep_get_sim_time(tstep), sim_seconds, report_step);
-  rebuild_index = false;
+  if (!this->ministeps.empty()) {
+    /*
+      In the simple case that we just add another timestep to the
+      currently active report_step, we do a limited update of the
+      index, otherwise we call build_index() to get a full
+      recalculation of the index.
+    */
+    const auto& prev = this->ministeps.back();
+    if (prev.report_step == report_step && prev.sim_seconds < ecl_sum_tstep_get_sim_seconds( tstep ))
+      rebuild_index = false;
+  }
 
-exit:
+  append_tstep( tstep , true );
   if (rebuild_index)
-      this->build_index();
+    this->build_index();
+  else
+    this->index.add(ecl_sum_tstep_get_sim_time(tstep), sim_seconds, report_step);
 
   return tstep;
 }
 
 
-ecl_sum_tstep_type * ecl_sum_file_data::iget_ministep( int internal_index ) const {
-  return (ecl_sum_tstep_type*)vector_iget( data , internal_index );
-}
-
 double ecl_sum_file_data::iget_sim_days(int time_index ) const {
   const auto& node = this->index[time_index];
   return node.sim_seconds / 86400;
@@ -349,21 +381,37 @@ double ecl_sum_file_data::iget_sim_seconds(int time_index ) const {
 }
 
 
-static int cmp_ministep( const void * arg1 , const void * arg2) {
-  const ecl_sum_tstep_type * ministep1 = ecl_sum_tstep_safe_cast_const( arg1 );
-  const ecl_sum_tstep_type * ministep2 = ecl_sum_tstep_safe_cast_const( arg2 );
+/*
+  Sorts the rows of the matrix in time order; the tsteps which have
+  been handed out by add_new_tstep() are moved along with their rows.
+*/
 
-  time_t time1 = ecl_sum_tstep_get_sim_time( ministep1 );
-  time_t time2 = ecl_sum_tstep_get_sim_time( ministep2 );
+void ecl_sum_file_data::sort_ministeps() {
+  std::vector<int> order(this->ministeps.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
 
-  if (time1 < time2)
-    return -1;
-  else if (time1 == time2)
-    return 0;
-  else
-    return 1;
-}
+  std::stable_sort(order.begin(), order.end(),
+                   [this](int i1, int i2) { return this->ministeps[i1].sim_time < this->ministeps[i2].sim_time; });
+
+  if (std::is_sorted(order.begin(), order.end()))
+    return;
 
+  std::vector<ministep_info> ministeps;
+  std::vector<ecl_sum_tstep_type *> tstep_handles;
+  ministeps.reserve(order.size());
+  tstep_handles.reserve(order.size());
+  for (size_t row = 0; row < order.size(); row++) {
+    ministeps.push_back(this->ministeps[order[row]]);
+    tstep_handles.push_back(this->tstep_handles[order[row]]);
+    if (tstep_handles.back())
+      ecl_sum_tstep_set_row(tstep_handles.back(), row);
+  }
+
+  this->values.permute_rows(order);
+  this->ministeps.swap(ministeps);
+  this->tstep_handles.swap(tstep_handles);
+}
 
 
 void ecl_sum_file_data::build_index( ) {
@@ -381,13 +429,11 @@ void ecl_sum_file_data::build_index( ) {
                       report_steps[i]);
     }
   } else {
-    vector_sort( data , cmp_ministep );
-    for (int internal_index = 0; internal_index < vector_get_size( data ); internal_index++) {
-      const ecl_sum_tstep_type * ministep = iget_ministep( internal_index  );
-      this->index.add(ecl_sum_tstep_get_sim_time(ministep),
-                      ecl_sum_tstep_get_sim_seconds(ministep),
-                      ecl_sum_tstep_get_report(ministep));
-    }
+    this->sort_ministeps();
+    for (const auto& ministep : this->ministeps)
+      this->index.add(ministep.sim_time,
+                      ministep.sim_seconds,
+                      ministep.report_step);
   }
 }
 
@@ -417,12 +463,15 @@ int ecl_sum_file_data::get_time_report(int end_index, time_t *data) {
 
 void ecl_sum_file_data::get_data(int params_index, int length, double *data) {
   if (this->loader) {
-    const auto tmp_data = loader->get_vector(params_index);
-    memcpy(data, tmp_data.data(), length * sizeof data);
-  } else {
-    for (int time_index=0; time_index < length; time_index++)
-      data[time_index] = this->iget(time_index, params_index);
-  }
+    const float * column = this->loader->column_ptr(params_index);
+    if (column)
+      std::copy(column, column + length, data);
+    else {
+      const auto tmp_data = loader->get_vector(params_index);
+      memcpy(data, tmp_data.data(), length * sizeof * data);
+    }
+  } else
+    this->values.copy_column(params_index, length, data);
 }
 
 
@@ -469,10 +518,22 @@ void ecl_sum_file_data::fwrite_report( int report_step , fortio_type * fortio) c
 
   {
     auto range = this->report_range( report_step );
+    const int * index_map = ecl_smspec_get_index_map( ecl_smspec );
+    int num_nodes = ecl_smspec_num_nodes( ecl_smspec );
     for (int index = range.first; index <= range.second; index++) {
-      const ecl_sum_tstep_type * tstep = iget_ministep( index );
-      //ecl_sum_tstep_fwrite( tstep , ecl_smspec_get_index_map( ecl_smspec ) , fortio );
-      ecl_sum_tstep_fwrite( tstep , ecl_smspec_get_index_map(ecl_smspec) , ecl_smspec_num_nodes(ecl_smspec), fortio );
+      ecl_kw_type * ministep_kw = ecl_kw_alloc( MINISTEP_KW , 1 , ECL_INT );
+      ecl_kw_type * params_kw = ecl_kw_alloc( PARAMS_KW , num_nodes , ECL_FLOAT );
+      const float * row = this->values.row( index );
+      float * params = (float *) ecl_kw_get_ptr( params_kw );
+
+      ecl_kw_iset_int( ministep_kw , 0 , this->ministeps[index].ministep );
+      for (int i = 0; i < num_nodes; i++)
+        params[i] = row[ index_map[i] ];
+
+      ecl_kw_fwrite( ministep_kw , fortio );
+      ecl_kw_fwrite( params_kw , fortio );
+      ecl_kw_free( ministep_kw );
+      ecl_kw_free( params_kw );
     }
   }
 }
@@ -524,7 +585,7 @@ double ecl_sum_file_data::get_days_start() const {
 
 // **************************** Start Reading ************************************
 
-bool ecl_sum_file_data::check_file( ecl_file_type * ecl_file ) {
+bool ecl_sum_file_data::check_file( ecl_file_type * ecl_file ) const {
   return ecl_file_has_kw( ecl_file , PARAMS_KW ) &&
     (ecl_file_get_num_named_kw( ecl_file , PARAMS_KW ) == ecl_file_get_num_named_kw( ecl_file , MINISTEP_KW));
 }
@@ -555,28 +616,86 @@ bool ecl_sum_file_data::check_file( ecl_file_type * ecl_file ) {
 */
 
 void ecl_sum_file_data::add_ecl_file(int report_step, const ecl_file_view_type * summary_view) {
+  for (ecl_sum_tstep_type * tstep : this->load_tsteps( report_step , summary_view ))
+    append_tstep( tstep );
+}
 
+
+/*
+  Creates the ministeps of one summary section; the function does not
+  modify the ecl_sum_file_data instance and can be called from several
+  threads concurrently, as long as the summary views are different.
+*/
+
+std::vector<ecl_sum_tstep_type *> ecl_sum_file_data::load_tsteps(int report_step, const ecl_file_view_type * summary_view) const {
+  std::vector<ecl_sum_tstep_type *> tsteps;
   int num_ministep  = ecl_file_view_get_num_named_kw( summary_view , PARAMS_KW);
-  if (num_ministep > 0) {
-    int ikw;
 
-    for (ikw = 0; ikw < num_ministep; ikw++) {
-      ecl_kw_type * ministep_kw = ecl_file_view_iget_named_kw( summary_view , MINISTEP_KW , ikw);
-      ecl_kw_type * params_kw   = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW   , ikw);
+  for (int ikw = 0; ikw < num_ministep; ikw++) {
+    ecl_kw_type * ministep_kw = ecl_file_view_iget_named_kw( summary_view , MINISTEP_KW , ikw);
+    ecl_kw_type * params_kw   = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW   , ikw);
+
+    int ministep_nr = ecl_kw_iget_int( ministep_kw , 0 );
+    ecl_sum_tstep_type * tstep = ecl_sum_tstep_alloc_from_file( report_step ,
+                                                                ministep_nr ,
+                                                                params_kw ,
+                                                                ecl_file_view_get_src_file( summary_view ),
+                                                                this->ecl_smspec );
+    if (tstep)
+      tsteps.push_back( tstep );
+  }
+  return tsteps;
+}
+
 
-      {
-        int ministep_nr = ecl_kw_iget_int( ministep_kw , 0 );
-        ecl_sum_tstep_type * tstep = ecl_sum_tstep_alloc_from_file( report_step ,
-                                                                    ministep_nr ,
-                                                                    params_kw ,
-                                                                    ecl_file_view_get_src_file( summary_view ),
-                                                                    this->ecl_smspec );
-
-        if (tstep)
-            append_tstep( tstep );
-      }
+/*
+  Loads a list of non unified summary files BASE.S0001, BASE.S0002,
+  ... The files are opened, parsed and closed in parallel; each thread
+  holds at most one file open at a time, so the number of open files is
+  bounded by the number of threads. The ministeps are appended in report
+  step order when all files have been loaded.
+*/
+
+void ecl_sum_file_data::fread_multiple(const stringlist_type * filelist) {
+  const int num_files = stringlist_get_size( filelist );
+  std::vector<int> report_steps(num_files);
+  std::vector<std::vector<ecl_sum_tstep_type *>> file_tsteps(num_files);
+
+  for (int filenr = 0; filenr < num_files; filenr++) {
+    const char * data_file = stringlist_iget( filelist , filenr);
+    ecl_file_enum file_type = ecl_util_get_file_type( data_file , NULL , &report_steps[filenr]);
+    if (file_type != ECL_SUMMARY_FILE)
+      util_abort("%s: file:%s has wrong type \n",__func__ , data_file);
+  }
+
+#pragma omp parallel for schedule(dynamic)
+  for (int filenr = 0; filenr < num_files; filenr++) {
+    ecl_file_type * ecl_file = ecl_file_open( stringlist_iget( filelist , filenr) , 0);
+    if (ecl_file) {
+      if (check_file( ecl_file ))
+        file_tsteps[filenr] = this->load_tsteps( report_steps[filenr] , ecl_file_get_global_view( ecl_file ));
+      ecl_file_close( ecl_file );
     }
   }
+
+  {
+    std::vector<int> file_order(num_files);
+    for (int filenr = 0; filenr < num_files; filenr++)
+      file_order[filenr] = filenr;
+
+    std::stable_sort(file_order.begin(), file_order.end(),
+                     [&report_steps](int file1, int file2) { return report_steps[file1] < report_steps[file2]; });
+
+    size_t num_tsteps = 0;
+    for (const auto& tsteps : file_tsteps)
+      num_tsteps += tsteps.size();
+    this->values.set_columns( ecl_smspec_get_params_size( this->ecl_smspec ));
+    this->values.reserve( num_tsteps );
+
+    for (int filenr : file_order)
+      for (ecl_sum_tstep_type * tstep : file_tsteps[filenr])
+        append_tstep( tstep );
+  }
 }
 
 
@@ -591,21 +710,7 @@ bool ecl_sum_file_data::fread(const stringlist_type * filelist, bool lazy_load,
   if (file_type == ECL_SUMMARY_FILE) {
 
     /* Not unified. */
-    for (int filenr = 0; filenr < stringlist_get_size( filelist ); filenr++) {
-      const char * data_file = stringlist_iget( filelist , filenr);
-      ecl_file_enum file_type;
-      int report_step;
-      file_type = ecl_util_get_file_type( data_file , NULL , &report_step);
-      if (file_type != ECL_SUMMARY_FILE)
-        util_abort("%s: file:%s has wrong type \n",__func__ , data_file);
-      {
-        ecl_file_type * ecl_file = ecl_file_open( data_file , 0);
-        if (ecl_file && check_file( ecl_file )) {
-          this->add_ecl_file( report_step , ecl_file_get_global_view( ecl_file ));
-          ecl_file_close( ecl_file );
-        }
-      }
-    }
+    this->fread_multiple( filelist );
   } else if (file_type == ECL_UNIFIED_SUMMARY_FILE) {
     if (lazy_load) {
       try {
@@ -623,6 +728,8 @@ bool ecl_sum_file_data::fread(const stringlist_type * filelist, bool lazy_load,
       if (ecl_file && check_file( ecl_file )) {
         int first_report_step = ecl_smspec_get_first_step(this->ecl_smspec);
         int block_index = 0;
+        this->values.set_columns( ecl_smspec_get_params_size( this->ecl_smspec ));
+        this->values.reserve( ecl_file_get_num_named_kw( ecl_file , PARAMS_KW ));
         while (true) {
           /*
             Observe that there is a number discrepancy between ECLIPSE
@@ -646,6 +753,54 @@ bool ecl_sum_file_data::fread(const stringlist_type * filelist, bool lazy_load,
   return (length() > 0);
 }
 
+
+/*
+  Loads the data from a columnar summary file written with
+  ecl_sum_fwrite_columnar(). The smspec must have been created from the
+  header of the same file, i.e. with the same params layout.
+*/
+bool ecl_sum_file_data::fread_columnar(const std::string& filename) {
+  try {
+    std::unique_ptr<ecl::columnar_loader> columnar( new ecl::columnar_loader(filename) );
+    if (columnar->params_size() != ecl_smspec_get_params_size(this->ecl_smspec))
+      return false;
+
+    this->loader = std::move(columnar);
+  } catch (const std::runtime_error&) {
+    return false;
+  }
+
+  build_index();
+  return (length() > 0);
+}
+
+
+/*
+  Vectors can be extracted with get_data() from several threads
+  concurrently when the values are held in memory, or when the loader
+  provides the columns directly; for the unified loader this builds the
+  column cache. If false is returned get_data() must be called from one
+  thread at a time.
+*/
+bool ecl_sum_file_data::prepare_concurrent_read() const {
+  if (!this->loader || this->loader->length() == 0)
+    return true;
+
+  return this->loader->column_ptr(0) != nullptr;
+}
+
+
+/*
+  Pointer to the contiguous values of parameter @params_index, if the
+  loader can provide them without a copy; otherwise NULL.
+*/
+const float * ecl_sum_file_data::column_ptr(int params_index) const {
+  if (this->loader)
+    return this->loader->column_ptr(params_index);
+
+  return NULL;
+}
+
 const ecl_smspec_type * ecl_sum_file_data::smspec() const {
   return this->ecl_smspec;
 }
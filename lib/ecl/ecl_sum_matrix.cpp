@@ -0,0 +1,174 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_matrix.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "detail/ecl/ecl_sum_matrix.hpp"
+
+namespace ecl {
+
+namespace {
+
+/*
+  The transpose is done in square blocks of this size, so that both the
+  rows read and the columns written stay in cache.
+*/
+const int TRANSPOSE_BLOCK_SIZE = 64;
+
+}
+
+
+sum_matrix::sum_matrix(int columns) :
+  m_columns(columns)
+{
+}
+
+
+int sum_matrix::rows() const {
+  return this->m_rows;
+}
+
+
+int sum_matrix::columns() const {
+  return this->m_columns;
+}
+
+
+/*
+  The number of columns can only be changed as long as the matrix is
+  empty.
+*/
+void sum_matrix::set_columns(int columns) {
+  if (this->m_rows > 0 && columns != this->m_columns)
+    throw std::logic_error("sum_matrix: can not change the number of columns of a non empty matrix");
+
+  this->m_columns = columns;
+}
+
+
+void sum_matrix::reserve(int rows) {
+  this->values.reserve(static_cast<size_t>(rows) * this->m_columns);
+}
+
+
+int sum_matrix::append_row(const float * values) {
+  this->invalidate_transposed();
+  this->values.insert(this->values.end(), values, values + this->m_columns);
+  return this->m_rows++;
+}
+
+
+const float * sum_matrix::row(int row) const {
+  return this->values.data() + static_cast<size_t>(row) * this->m_columns;
+}
+
+
+/*
+  Observe that the non const row() accessor discards the transposed
+  copy, the caller can modify the row.
+*/
+float * sum_matrix::row(int row) {
+  this->invalidate_transposed();
+  return this->values.data() + static_cast<size_t>(row) * this->m_columns;
+}
+
+
+float sum_matrix::get(int row, int column) const {
+  if (row < 0 || row >= this->m_rows || column < 0 || column >= this->m_columns)
+    throw std::out_of_range("sum_matrix: index (" + std::to_string(row) + "," + std::to_string(column) + ") out of range");
+
+  return this->values[static_cast<size_t>(row) * this->m_columns + column];
+}
+
+
+void sum_matrix::copy_column(int column, int length, double * data) const {
+  if (this->lazy_transpose) {
+    std::lock_guard<std::mutex> lock(this->transpose_mutex);
+    if (this->transposed.empty() && this->m_rows > 0) {
+      this->transposed.resize(this->values.size());
+      for (int row0 = 0; row0 < this->m_rows; row0 += TRANSPOSE_BLOCK_SIZE) {
+        int row1 = std::min(this->m_rows, row0 + TRANSPOSE_BLOCK_SIZE);
+        for (int col0 = 0; col0 < this->m_columns; col0 += TRANSPOSE_BLOCK_SIZE) {
+          int col1 = std::min(this->m_columns, col0 + TRANSPOSE_BLOCK_SIZE);
+          for (int row = row0; row < row1; row++)
+            for (int col = col0; col < col1; col++)
+              this->transposed[static_cast<size_t>(col) * this->m_rows + row] = this->values[static_cast<size_t>(row) * this->m_columns + col];
+        }
+      }
+    }
+  }
+
+  if (!this->transposed.empty()) {
+    const float * src = this->transposed.data() + static_cast<size_t>(column) * this->m_rows;
+    std::copy(src, src + length, data);
+  } else {
+    const float * src = this->values.data() + column;
+    for (int row = 0; row < length; row++)
+      data[row] = src[static_cast<size_t>(row) * this->m_columns];
+  }
+}
+
+
+void sum_matrix::copy_row(int row, const int * columns, int num_columns, double * data) const {
+  const float * src = this->row(row);
+  for (int i = 0; i < num_columns; i++)
+    data[i] = src[columns[i]];
+}
+
+
+/*
+  Reorders the rows such that row i of the result is row order[i] of
+  the current matrix.
+*/
+void sum_matrix::permute_rows(const std::vector<int>& order) {
+  std::vector<float> permuted(this->values.size());
+  for (int row = 0; row < this->m_rows; row++)
+    memcpy(&permuted[static_cast<size_t>(row) * this->m_columns],
+           this->values.data() + static_cast<size_t>(order[row]) * this->m_columns,
+           this->m_columns * sizeof(float));
+
+  this->values.swap(permuted);
+  this->invalidate_transposed();
+}
+
+
+void sum_matrix::set_lazy_transpose(bool lazy_transpose) {
+  this->lazy_transpose = lazy_transpose;
+  if (!lazy_transpose)
+    this->invalidate_transposed();
+}
+
+
+void sum_matrix::invalidate_transposed() {
+  std::lock_guard<std::mutex> lock(this->transpose_mutex);
+  if (!this->transposed.empty())
+    std::vector<float>().swap(this->transposed);
+}
+
+
+size_t sum_matrix::memory_usage() const {
+  std::lock_guard<std::mutex> lock(this->transpose_mutex);
+  return sizeof * this + (this->values.capacity() + this->transposed.capacity()) * sizeof(float);
+}
+
+}
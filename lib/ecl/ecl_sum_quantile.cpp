@@ -0,0 +1,577 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_quantile.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/time_t_vector.hpp>
+#include <ert/util/double_vector.hpp>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_vector.hpp>
+#include <ert/ecl/ecl_sum_quantile.hpp>
+
+/*
+  The ecl_sum_quantile engine calculates quantiles of summary vectors
+  over an ensemble of cases. All the cases are resampled to a common
+  set of time points, and for every (key, time point) bin the engine
+  accumulates the values from all the cases.
+
+  The cases are streamed: each case is loaded, resampled and added to
+  the bins, and then discarded - the full cases are never held in
+  memory at the same time. Two accumulation modes are supported:
+
+    exact: All the resampled values are retained, and the quantiles
+       are calculated with std::nth_element when requested. Any
+       quantile can be requested, and the memory usage is one double
+       per case for each bin.
+
+    approximate: The P^2 algorithm of Jain and Chlamtac is used to
+       estimate the quantiles on the fly with five markers per
+       quantile. The quantiles must be given up front, and the memory
+       usage is independent of the size of the ensemble.
+
+  A case only contributes to the time points within the time span of
+  the case, so the cases can have different lengths.
+
+  The cases are loaded eagerly, the keys are extracted as one raw
+  [ministep x key] frame and resampled to the time points of the engine
+  with the same interpolation as ecl_sum_init_double_frame_interp().
+*/
+
+#define ECL_SUM_QUANTILE_TYPE_ID 6617743
+
+namespace {
+
+/*
+  Linear interpolation between the order statistics bracketing
+  quantile * (n - 1). The order of the elements in @values is modified.
+*/
+double exact_quantile(std::vector<double>& values, double quantile) {
+  if (values.empty())
+    return NAN;
+
+  double real_index = quantile * (values.size() - 1);
+  size_t lower_index = floor( real_index );
+  std::nth_element( values.begin() , values.begin() + lower_index , values.end() );
+
+  double lower_value = values[lower_index];
+  if (lower_index + 1 == values.size())
+    return lower_value;
+
+  double upper_value = *std::min_element( values.begin() + lower_index + 1 , values.end() );
+  return lower_value + (real_index - lower_index) * (upper_value - lower_value);
+}
+
+
+/*
+  Streaming estimate of one quantile with the P^2 algorithm. Until five
+  values have been added the values themselves are stored in the
+  marker heights, and the quantile is calculated exactly. The outer
+  markers are the minimum and maximum of the values added, and are
+  returned for the quantiles 0 and 1.
+*/
+class p2_estimator {
+public:
+  explicit p2_estimator(double quantile) :
+    p(quantile),
+    desired{0, 2*quantile, 4*quantile, 2 + 2*quantile, 4},
+    increment{0, quantile/2, quantile, (1 + quantile)/2, 1}
+  {}
+
+  void add(double x);
+  double value() const;
+
+private:
+  double parabolic(int i, double d) const;
+  double linear(int i, double d) const;
+
+  double p;
+  int count = 0;
+  double height[5];
+  double position[5] = {0, 1, 2, 3, 4};
+  double desired[5];
+  double increment[5];
+};
+
+
+void p2_estimator::add(double x) {
+  if (this->count < 5) {
+    this->height[this->count++] = x;
+    if (this->count == 5)
+      std::sort( this->height , this->height + 5 );
+    return;
+  }
+  this->count++;
+
+  int k;
+  if (x < this->height[0]) {
+    this->height[0] = x;
+    k = 0;
+  } else if (x >= this->height[4]) {
+    this->height[4] = x;
+    k = 3;
+  } else {
+    k = 0;
+    while (x >= this->height[k + 1])
+      k++;
+  }
+
+  for (int i = k + 1; i < 5; i++)
+    this->position[i] += 1;
+
+  for (int i = 0; i < 5; i++)
+    this->desired[i] += this->increment[i];
+
+  for (int i = 1; i < 4; i++) {
+    double d = this->desired[i] - this->position[i];
+    if ((d >= 1 && this->position[i + 1] - this->position[i] > 1) ||
+        (d <= -1 && this->position[i - 1] - this->position[i] < -1)) {
+      d = (d > 0) ? 1 : -1;
+
+      double h = this->parabolic( i , d );
+      if (this->height[i - 1] < h && h < this->height[i + 1])
+        this->height[i] = h;
+      else
+        this->height[i] = this->linear( i , d );
+
+      this->position[i] += d;
+    }
+  }
+}
+
+
+double p2_estimator::parabolic(int i, double d) const {
+  const double * q = this->height;
+  const double * n = this->position;
+  return q[i] + d / (n[i + 1] - n[i - 1]) * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                                             (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+
+double p2_estimator::linear(int i, double d) const {
+  int j = i + static_cast<int>(d);
+  return this->height[i] + d * (this->height[j] - this->height[i]) / (this->position[j] - this->position[i]);
+}
+
+
+double p2_estimator::value() const {
+  if (this->count >= 5) {
+    if (this->p == 0)
+      return this->height[0];
+
+    if (this->p == 1)
+      return this->height[4];
+
+    return this->height[2];
+  }
+
+  std::vector<double> values(this->height, this->height + this->count);
+  return exact_quantile( values , this->p );
+}
+
+
+/*
+  The keys of one case before resampling; the frame has one row of
+  num_keys values for each ministep.
+*/
+struct case_series {
+  time_t              start_time = 0;
+  time_t              end_time = 0;
+  std::vector<time_t> sim_time;
+  std::vector<double> frame;
+  std::vector<bool>   is_rate;
+};
+
+
+/* Number of cases which are loaded concurrently. */
+int num_concurrent_cases() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+}
+
+
+struct ecl_sum_quantile_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  bool                                 exact;
+  std::vector<std::string>             keys;
+  std::unordered_map<std::string, int> key_index;
+  std::vector<time_t>                  time_points;
+  std::vector<double>                  quantiles;    /* Only used in approximate mode. */
+  int                                  num_cases;
+
+  /*
+    Indexed with key_index * num_time + time_index; in approximate
+    mode each bin has one estimator for each of the quantiles.
+  */
+  std::vector<std::vector<double>>       values;
+  std::vector<std::vector<p2_estimator>> estimators;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_sum_quantile , ECL_SUM_QUANTILE_TYPE_ID )
+
+
+static void ecl_sum_quantile_init_bins( ecl_sum_quantile_type * quantile ) {
+  const size_t num_bins = quantile->keys.size() * quantile->time_points.size();
+  if (quantile->exact)
+    quantile->values.resize( num_bins );
+  else {
+    std::vector<p2_estimator> bin;
+    for (double q : quantile->quantiles)
+      bin.emplace_back( q );
+    quantile->estimators.resize( num_bins , bin );
+  }
+}
+
+
+static ecl_sum_quantile_type * ecl_sum_quantile_alloc__( const stringlist_type * keys , const double_vector_type * quantiles , bool exact) {
+  ecl_sum_quantile_type * quantile = new ecl_sum_quantile_type();
+  UTIL_TYPE_ID_INIT( quantile , ECL_SUM_QUANTILE_TYPE_ID );
+  quantile->exact = exact;
+  quantile->num_cases = 0;
+
+  for (int i = 0; i < stringlist_get_size( keys ); i++) {
+    const char * key = stringlist_iget( keys , i );
+    if (quantile->key_index.count( key ) == 0) {
+      quantile->key_index[key] = quantile->keys.size();
+      quantile->keys.push_back( key );
+    }
+  }
+
+  if (!exact) {
+    if (!quantiles)
+      util_abort("%s: the quantiles must be given for approximate quantile estimates\n",__func__);
+
+    for (int i = 0; i < double_vector_size( quantiles ); i++) {
+      double q = double_vector_iget( quantiles , i );
+      if (q < 0 || q > 1)
+        util_abort("%s: quantile must be in [0,1] \n",__func__);
+
+      if (std::find( quantile->quantiles.begin() , quantile->quantiles.end() , q ) == quantile->quantiles.end())
+        quantile->quantiles.push_back( q );
+    }
+  }
+  return quantile;
+}
+
+
+/*
+  In exact mode the @quantiles argument can be NULL, and all quantiles
+  can be requested afterwards. In approximate mode only the quantiles
+  listed in @quantiles can be requested; duplicated keys and quantiles
+  are only included once.
+*/
+ecl_sum_quantile_type * ecl_sum_quantile_alloc( const stringlist_type * keys , const time_t_vector_type * time_points , const double_vector_type * quantiles , bool exact) {
+  ecl_sum_quantile_type * quantile = ecl_sum_quantile_alloc__( keys , quantiles , exact );
+  for (int i = 0; i < time_t_vector_size( time_points ); i++)
+    quantile->time_points.push_back( time_t_vector_iget( time_points , i ));
+
+  ecl_sum_quantile_init_bins( quantile );
+  return quantile;
+}
+
+
+void ecl_sum_quantile_free( ecl_sum_quantile_type * quantile ) {
+  delete quantile;
+}
+
+
+int ecl_sum_quantile_get_size( const ecl_sum_quantile_type * quantile ) {
+  return quantile->num_cases;
+}
+
+
+bool ecl_sum_quantile_is_exact( const ecl_sum_quantile_type * quantile ) {
+  return quantile->exact;
+}
+
+
+/*
+  Extracts all the keys of the quantile engine from @ecl_sum. If the
+  case does not have all the keys false is returned.
+*/
+static bool ecl_sum_quantile_init_series( const ecl_sum_quantile_type * quantile , const ecl_sum_type * ecl_sum , case_series& series) {
+  bool valid = true;
+  ecl_sum_vector_type * vector = ecl_sum_vector_alloc( ecl_sum , false );
+  for (const auto& key : quantile->keys) {
+    if (!ecl_sum_vector_add_key( vector , key.c_str() )) {
+      valid = false;
+      break;
+    }
+  }
+
+  if (valid) {
+    time_t_vector_type * sim_time = ecl_sum_alloc_time_vector( ecl_sum , false );
+    const int length = time_t_vector_size( sim_time );
+
+    series.start_time = ecl_sum_get_start_time( ecl_sum );
+    series.end_time = ecl_sum_get_end_time( ecl_sum );
+    series.sim_time.assign( time_t_vector_get_const_ptr( sim_time ) , time_t_vector_get_const_ptr( sim_time ) + length );
+    series.frame.resize( static_cast<size_t>(length) * quantile->keys.size() );
+    ecl_sum_init_double_frame( ecl_sum , vector , series.frame.data() );
+
+    series.is_rate.resize( quantile->keys.size() );
+    for (size_t key_index = 0; key_index < quantile->keys.size(); key_index++)
+      series.is_rate[key_index] = ecl_sum_vector_iget_is_rate( vector , key_index );
+
+    time_t_vector_free( sim_time );
+  }
+  ecl_sum_vector_free( vector );
+  return valid;
+}
+
+
+static bool ecl_sum_quantile_load_series( const ecl_sum_quantile_type * quantile , const char * ecl_case , const char * key_join_string , case_series& series) {
+  ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( ecl_case , key_join_string , true , false , 0 );
+  if (!ecl_sum)
+    return false;
+
+  bool valid = ecl_sum_quantile_init_series( quantile , ecl_sum , series );
+  ecl_sum_free( ecl_sum );
+  return valid;
+}
+
+
+/*
+  Resamples the series to the time points of the quantile engine and
+  adds it to the bins. Rates are step functions and are taken from the
+  ministep ending at or after the time point, other values are
+  interpolated linearly between two ministeps. A case only contributes
+  to the time points within its time span.
+*/
+static void ecl_sum_quantile_add_series( ecl_sum_quantile_type * quantile , const case_series& series) {
+  const size_t num_keys = quantile->keys.size();
+  const size_t num_time = quantile->time_points.size();
+  const size_t length = series.sim_time.size();
+  std::vector<double> row(num_keys);
+
+  for (size_t time_index = 0; time_index < num_time; time_index++) {
+    time_t sim_time = quantile->time_points[time_index];
+    if (sim_time < series.start_time || sim_time > series.end_time)
+      continue;
+
+    if (length == 0 || sim_time < series.sim_time[0] || sim_time > series.sim_time[length - 1]) {
+      const double * value = &series.frame[(sim_time < series.sim_time[0]) ? 0 : (length - 1) * num_keys];
+      for (size_t key_index = 0; key_index < num_keys; key_index++)
+        row[key_index] = series.is_rate[key_index] ? 0 : value[key_index];
+    } else {
+      size_t index2 = std::lower_bound( series.sim_time.begin() , series.sim_time.end() , sim_time ) - series.sim_time.begin();
+      size_t index1 = (index2 == 0) ? 0 : index2 - 1;
+      double weight2 = 1;
+      if (index2 > 0)
+        weight2 = static_cast<double>(sim_time - series.sim_time[index1]) / (series.sim_time[index2] - series.sim_time[index1]);
+
+      for (size_t key_index = 0; key_index < num_keys; key_index++) {
+        double value1 = series.frame[index1 * num_keys + key_index];
+        double value2 = series.frame[index2 * num_keys + key_index];
+        row[key_index] = series.is_rate[key_index] ? value2 : value1 * (1 - weight2) + value2 * weight2;
+      }
+    }
+
+    for (size_t key_index = 0; key_index < num_keys; key_index++) {
+      size_t bin = key_index * num_time + time_index;
+      if (quantile->exact)
+        quantile->values[bin].push_back( row[key_index] );
+      else {
+        for (auto& estimator : quantile->estimators[bin])
+          estimator.add( row[key_index] );
+      }
+    }
+  }
+  quantile->num_cases++;
+}
+
+
+/*
+  Adds one case to the quantile estimates; if the case does not have
+  all the keys it is not added, and false is returned.
+*/
+bool ecl_sum_quantile_add_case( ecl_sum_quantile_type * quantile , const ecl_sum_type * ecl_sum ) {
+  case_series series;
+  if (!ecl_sum_quantile_init_series( quantile , ecl_sum , series ))
+    return false;
+
+  ecl_sum_quantile_add_series( quantile , series );
+  return true;
+}
+
+
+static void ecl_sum_quantile_append_failed( const stringlist_type * cases , const std::vector<char>& failed , stringlist_type * failed_cases ) {
+  if (failed_cases) {
+    for (int iens = 0; iens < stringlist_get_size( cases ); iens++)
+      if (failed[iens])
+        stringlist_append_copy( failed_cases , stringlist_iget( cases , iens ));
+  }
+}
+
+
+/*
+  Loads and adds all the cases in @cases. The cases are loaded in
+  parallel in chunks of one case per thread, and every case is
+  discarded as soon as its keys have been extracted. The series of a
+  chunk are added in the order of @cases before the next chunk is
+  loaded; the approximate estimators depend on the order of the values,
+  and the result is then independent of the number of threads.
+
+  The return value is the number of cases added. The cases which
+  could not be loaded, or which do not have all the keys, are appended
+  to @failed_cases if that is not NULL.
+*/
+int ecl_sum_quantile_add_cases( ecl_sum_quantile_type * quantile , const stringlist_type * cases , const char * key_join_string , stringlist_type * failed_cases ) {
+  const int num_cases = stringlist_get_size( cases );
+  const int chunk_size = num_concurrent_cases();
+  std::vector<char> failed(num_cases, 0);
+  std::vector<case_series> series(chunk_size);
+  int num_added = 0;
+
+  for (int chunk_start = 0; chunk_start < num_cases; chunk_start += chunk_size) {
+    const int chunk_end = std::min( num_cases , chunk_start + chunk_size );
+
+#pragma omp parallel for schedule(dynamic)
+    for (int iens = chunk_start; iens < chunk_end; iens++)
+      failed[iens] = !ecl_sum_quantile_load_series( quantile , stringlist_iget( cases , iens ) , key_join_string , series[iens - chunk_start] );
+
+    for (int iens = chunk_start; iens < chunk_end; iens++) {
+      case_series& case_data = series[iens - chunk_start];
+      if (!failed[iens]) {
+        ecl_sum_quantile_add_series( quantile , case_data );
+        num_added++;
+      }
+      case_data = case_series();
+    }
+  }
+
+  ecl_sum_quantile_append_failed( cases , failed , failed_cases );
+  return num_added;
+}
+
+
+/*
+  Loads all the cases in @cases in one pass and returns a quantile
+  engine with @num_points time points evenly spaced over the combined
+  time span of the cases. The keys of all the cases are retained until
+  the time span is known, i.e. the memory usage is the size of the
+  requested keys in all the cases, while every case itself is discarded
+  as soon as the keys have been extracted.
+
+  The arguments @keys, @quantiles and @exact are as for
+  ecl_sum_quantile_alloc(). The cases which could not be loaded, or
+  which do not have all the keys, are appended to @failed_cases if
+  that is not NULL. If no case could be added NULL is returned.
+*/
+ecl_sum_quantile_type * ecl_sum_quantile_alloc_cases( const stringlist_type * keys , const stringlist_type * cases , const char * key_join_string , int num_points , const double_vector_type * quantiles , bool exact , stringlist_type * failed_cases ) {
+  const int num_cases = stringlist_get_size( cases );
+  ecl_sum_quantile_type * quantile = ecl_sum_quantile_alloc__( keys , quantiles , exact );
+  std::vector<char> failed(num_cases, 0);
+  std::vector<case_series> series(num_cases);
+  time_t ensemble_start = -1;
+  time_t ensemble_end = -1;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int iens = 0; iens < num_cases; iens++)
+    failed[iens] = !ecl_sum_quantile_load_series( quantile , stringlist_iget( cases , iens ) , key_join_string , series[iens] );
+
+  ecl_sum_quantile_append_failed( cases , failed , failed_cases );
+  for (int iens = 0; iens < num_cases; iens++) {
+    if (failed[iens])
+      continue;
+
+    if (ensemble_start < 0 || series[iens].start_time < ensemble_start)
+      ensemble_start = series[iens].start_time;
+    ensemble_end = std::max( ensemble_end , series[iens].end_time );
+  }
+
+  if (ensemble_start < 0) {
+    ecl_sum_quantile_free( quantile );
+    return NULL;
+  }
+
+  for (int i = 0; i < num_points; i++) {
+    time_t t = (num_points > 1) ? ensemble_start + i * (ensemble_end - ensemble_start) / (num_points - 1) : ensemble_start;
+    quantile->time_points.push_back( t );
+  }
+  ecl_sum_quantile_init_bins( quantile );
+
+  for (int iens = 0; iens < num_cases; iens++) {
+    if (!failed[iens])
+      ecl_sum_quantile_add_series( quantile , series[iens] );
+    series[iens] = case_series();
+  }
+  return quantile;
+}
+
+
+static int ecl_sum_quantile_get_bin( const ecl_sum_quantile_type * quantile , const char * key , int time_index) {
+  const auto iter = quantile->key_index.find( key );
+  if (iter == quantile->key_index.end())
+    util_abort("%s: the key:%s is not included in the quantile estimate\n",__func__ , key);
+
+  if (time_index < 0 || time_index >= static_cast<int>(quantile->time_points.size()))
+    util_abort("%s: invalid time_index:%d\n",__func__ , time_index);
+
+  return iter->second * quantile->time_points.size() + time_index;
+}
+
+
+/*
+  Returns the quantile @q of @key at time point @time_index; if no
+  cases cover the time point NAN is returned. In approximate mode @q
+  must be one of the quantiles given when the engine was allocated.
+*/
+double ecl_sum_quantile_get( ecl_sum_quantile_type * quantile , const char * key , int time_index , double q ) {
+  int bin = ecl_sum_quantile_get_bin( quantile , key , time_index );
+
+  if (q < 0 || q > 1)
+    util_abort("%s: quantile must be in [0,1] \n",__func__);
+
+  if (quantile->exact)
+    return exact_quantile( quantile->values[bin] , q );
+
+  const auto iter = std::find( quantile->quantiles.begin() , quantile->quantiles.end() , q );
+  if (iter == quantile->quantiles.end())
+    util_abort("%s: the quantile:%g has not been estimated\n",__func__ , q);
+
+  if (quantile->num_cases == 0)
+    return NAN;
+
+  return quantile->estimators[bin][iter - quantile->quantiles.begin()].value();
+}
+
+
+void ecl_sum_quantile_init_vector( ecl_sum_quantile_type * quantile , const char * key , double q , double * data ) {
+  for (size_t time_index = 0; time_index < quantile->time_points.size(); time_index++)
+    data[time_index] = ecl_sum_quantile_get( quantile , key , time_index , q );
+}
@@ -30,6 +30,9 @@
 #include <ert/ecl/ecl_kw_magic.hpp>
 #include <ert/ecl/ecl_type.hpp>
 
+#include "detail/util/memory_usage.hpp"
+#include "detail/ecl/ecl_sum_matrix.hpp"
+
 #define ECL_SUM_TSTEP_ID 88631
 
 
@@ -50,7 +53,9 @@ Header direction: ecl_smspec   DAYS     WWCT:OP_3     FOPT     BPR:15,10,25
                                --------------------------------------------
 
   The ecl_sum_tstep structure corresponds to one 'horizontal line' in
-  the summary data.
+  the summary data. The ecl_sum_file_data class stores all the lines in
+  one matrix; the tsteps it hands out are attached to a row of that
+  matrix and do not have their own copy of the values.
 
   These timesteps correspond exactly to the simulators timesteps,
   i.e. when convergence is poor they are closely spaced. In the
@@ -68,9 +73,51 @@ struct ecl_sum_tstep_struct {
   double                   sim_seconds;     /* Accumulated simulation time up to this ministep. */
   int                      internal_index;  /* Used for lookups of the next / previous ministep based on an existing ministep. */
   const ecl_smspec_type  * smspec;          /* The smespec header information for this tstep - must be compatible. */
+  ecl::sum_matrix        * matrix;          /* If not NULL the values are stored in row 'row' of this matrix, and data is empty. */
+  int                      row;
 };
 
 
+static const float * ecl_sum_tstep_values( const ecl_sum_tstep_type * tstep ) {
+  if (tstep->matrix)
+    return static_cast<const ecl::sum_matrix *>(tstep->matrix)->row( tstep->row );
+
+  return tstep->data.data();
+}
+
+
+static float * ecl_sum_tstep_values( ecl_sum_tstep_type * tstep ) {
+  if (tstep->matrix)
+    return tstep->matrix->row( tstep->row );
+
+  return tstep->data.data();
+}
+
+
+static int ecl_sum_tstep_size( const ecl_sum_tstep_type * tstep ) {
+  if (tstep->matrix)
+    return tstep->matrix->columns();
+
+  return tstep->data.size();
+}
+
+
+int ecl_sum_tstep_attach( ecl_sum_tstep_type * tstep , ecl::sum_matrix * matrix ) {
+  if (tstep->matrix)
+    util_abort("%s: tstep is already attached to a matrix \n",__func__);
+
+  tstep->row = matrix->append_row( tstep->data.data() );
+  tstep->matrix = matrix;
+  std::vector<float>().swap( tstep->data );
+  return tstep->row;
+}
+
+
+void ecl_sum_tstep_set_row( ecl_sum_tstep_type * tstep , int row ) {
+  tstep->row = row;
+}
+
+
 ecl_sum_tstep_type * ecl_sum_tstep_alloc_remap_copy( const ecl_sum_tstep_type * src , const ecl_smspec_type * new_smspec, float default_value , const int * params_map) {
   int params_size = ecl_smspec_get_params_size( new_smspec );
   ecl_sum_tstep_type * target = new ecl_sum_tstep_type();
@@ -80,10 +127,11 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_remap_copy( const ecl_sum_tstep_type *
 
   target->smspec = new_smspec;
   target->data.resize(params_size);
+  const float * src_data = ecl_sum_tstep_values( src );
   for (int i=0; i < params_size; i++) {
 
     if (params_map[i] >= 0)
-      target->data[i] = src->data[ params_map[i] ];
+      target->data[i] = src_data[ params_map[i] ];
     else
       target->data[i] = default_value;
 
@@ -97,7 +145,7 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_copy( const ecl_sum_tstep_type * src )
   target->smspec      = src->smspec;
   target->report_step = src->report_step;
   target->ministep    = src->ministep;
-  target->data        = src->data;
+  target->data.assign( ecl_sum_tstep_values( src ) , ecl_sum_tstep_values( src ) + ecl_sum_tstep_size( src ));
   return target;
 }
 
@@ -123,6 +171,10 @@ void ecl_sum_tstep_free( ecl_sum_tstep_type * ministep ) {
 
 
 
+size_t ecl_sum_tstep_get_memory_usage( const ecl_sum_tstep_type * ministep ) {
+  return sizeof * ministep + ecl::util::memory_usage( ministep->data );
+}
+
 void ecl_sum_tstep_free__( void * __ministep) {
   ecl_sum_tstep_type * ministep = ecl_sum_tstep_safe_cast( __ministep );
   ecl_sum_tstep_free( ministep );
@@ -243,10 +295,10 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_new( int report_step , int ministep , f
 
 
 double ecl_sum_tstep_iget(const ecl_sum_tstep_type * ministep , int index) {
-  if ((index >= 0) && (index < (int)ministep->data.size()))
-    return ministep->data[index];
+  if ((index >= 0) && (index < ecl_sum_tstep_size( ministep )))
+    return ecl_sum_tstep_values( ministep )[index];
   else {
-    util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",__func__ , index , ministep->data.size());
+    util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",__func__ , index , ecl_sum_tstep_size( ministep ));
     return -1;
   }
 }
@@ -290,11 +342,12 @@ void ecl_sum_tstep_fwrite( const ecl_sum_tstep_type * ministep , const int * ind
     ecl_kw_type * params_kw = ecl_kw_alloc( PARAMS_KW , compact_size , ECL_FLOAT );
 
     float * data      = (float*)ecl_kw_get_ptr( params_kw );
+    const float * values = ecl_sum_tstep_values( ministep );
 
     {
       int i;
       for (i=0; i < compact_size; i++)
-        data[i] = ministep->data[ index_map[i] ];
+        data[i] = values[ index_map[i] ];
     }
     ecl_kw_fwrite( params_kw , fortio );
     ecl_kw_free( params_kw );
@@ -305,10 +358,10 @@ void ecl_sum_tstep_fwrite( const ecl_sum_tstep_type * ministep , const int * ind
 /*****************************************************************/
 
 void ecl_sum_tstep_iset( ecl_sum_tstep_type * tstep , int index , float value) {
-  if ((index < static_cast<int>(tstep->data.size())) && (index >= 0)  )
-    tstep->data[index] = value;
+  if ((index < ecl_sum_tstep_size( tstep )) && (index >= 0)  )
+    ecl_sum_tstep_values( tstep )[index] = value;
   else
-    util_abort("%s: index:%d invalid. Valid range: [0,%d) \n",__func__  ,index , tstep->data.size());
+    util_abort("%s: index:%d invalid. Valid range: [0,%d) \n",__func__  ,index , ecl_sum_tstep_size( tstep ));
 }
 
 void ecl_sum_tstep_iscale(ecl_sum_tstep_type * tstep, int index, float scalar) {
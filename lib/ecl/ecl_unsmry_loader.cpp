@@ -1,17 +1,57 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <string>
 #include <iostream>
+#include <stdexcept>
 
+#include <ert/util/util.h>
 #include <ert/util/int_vector.hpp>
 
 #include <ert/ecl/ecl_kw_magic.hpp>
+#include <ert/ecl/ecl_endian_flip.hpp>
 #include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/fortio.h>
 
+#include "detail/util/path.hpp"
 #include "detail/ecl/ecl_unsmry_loader.hpp"
 
 
 namespace ecl {
 
+namespace {
+
+/*
+  The column cache file starts with this header, followed by params_size
+  columns of length float values each. The values are stored in native
+  byte order, a cache written on a platform with different endianness
+  will fail the version check and be rebuilt.
+*/
+
+const char COLUMN_CACHE_MAGIC[8] = "ECLCOLS";
+const int32_t COLUMN_CACHE_VERSION = 1;
+const size_t COLUMN_CACHE_BLOCK_SIZE = 4 * 1024 * 1024;   // Number of float values in the transpose buffer.
+
+struct column_cache_header {
+  char    magic[8];
+  int32_t version;
+  int32_t params_size;
+  int64_t length;
+  int64_t source_size;
+  int64_t source_mtime;
+};
+
+std::string column_cache_file(const std::string& filename) {
+  return filename + ".cache";
+}
+
+}
+
+
 unsmry_loader::unsmry_loader(const ecl_smspec_type * smspec, const std::string& filename, int file_options) :
   size(ecl_smspec_get_params_size(smspec)),
   time_index(ecl_smspec_get_time_index(smspec)),
@@ -38,6 +78,11 @@ unsmry_loader::unsmry_loader(const ecl_smspec_type * smspec, const std::string&
   this->file = file;
   this->file_view = ecl_file_get_global_view( this->file );
   this->m_length = ecl_file_view_get_num_named_kw(this->file_view, PARAMS_KW);
+  this->filename = filename;
+  this->persistent_cache = ecl_file_view_check_flags(file_options, ECL_FILE_COLUMN_CACHE);
+
+  if (this->persistent_cache)
+    this->load_column_cache(column_cache_file(this->filename));
 }
 
 
@@ -46,6 +91,206 @@ unsmry_loader::~unsmry_loader() {
 }
 
 
+size_t unsmry_loader::memory_usage() const {
+  size_t usage = sizeof * this + ecl_file_get_memory_usage(this->file, ECL_FILE_MEMORY_TOTAL);
+  usage += this->filename.capacity();
+  if (this->column_cache)
+    usage += sizeof * this->column_cache + this->column_cache->memory_usage();
+  return usage;
+}
+
+
+/*
+  Will map an existing cache file if it is consistent with the size and
+  modification time of the summary file, and the dimensions of the
+  current case.
+*/
+bool unsmry_loader::load_column_cache(const std::string& cache_file) const {
+  if (!util_file_exists(cache_file.c_str()))
+    return false;
+
+  try {
+    std::unique_ptr<ecl::util::mapped_file> cache( new ecl::util::mapped_file(cache_file) );
+    column_cache_header header;
+    size_t expected_size = sizeof header + sizeof(float) * this->size * this->length();
+
+    if (cache->size() != expected_size)
+      return false;
+
+    memcpy(&header, cache->data(), sizeof header);
+    if (memcmp(header.magic, COLUMN_CACHE_MAGIC, sizeof header.magic) != 0)
+      return false;
+
+    if (header.version != COLUMN_CACHE_VERSION)
+      return false;
+
+    if (header.params_size != this->size || header.length != this->length())
+      return false;
+
+    if (header.source_size != static_cast<int64_t>(util_file_size(this->filename.c_str())))
+      return false;
+
+    if (header.source_mtime != static_cast<int64_t>(util_file_mtime(this->filename.c_str())))
+      return false;
+
+    /*
+      The modification time only has a resolution of seconds; as a last
+      check a sample of the values in the last PARAMS keyword is compared
+      with the cache.
+    */
+    if (this->length() > 0) {
+      const float * data = reinterpret_cast<const float *>(cache->data() + sizeof header);
+      const int stride = std::max(1, this->size / 16);
+      for (int pos = 0; pos < this->size; pos += stride) {
+        float value = static_cast<float>(this->read_value(this->length() - 1, pos));
+        if (memcmp(&value, &data[static_cast<size_t>(pos) * this->length() + this->length() - 1], sizeof value) != 0)
+          return false;
+      }
+    }
+
+    this->column_cache = std::move(cache);
+    return true;
+  } catch (const std::runtime_error&) {
+    return false;
+  }
+}
+
+
+/*
+  Makes one sequential pass through all the PARAMS keywords and writes
+  the values transposed, i.e. one contiguous column of length() values
+  for each parameter. The rows are transposed in blocks to limit the
+  memory usage. The file is then memory mapped, and extracting a vector
+  is a plain copy.
+
+  With the ECL_FILE_COLUMN_CACHE flag the cache is written to a file
+  next to the summary file, and will be reused by later instances;
+  otherwise - or if that file can not be written - an anonymous
+  temporary file is used.
+*/
+void unsmry_loader::build_column_cache() const {
+  const std::string cache_file = column_cache_file(this->filename);
+  std::string tmp_file;
+  FILE * stream = NULL;
+
+  if (this->persistent_cache) {
+    std::string path = ecl::util::path::dirname(cache_file);
+    char * tmp = util_alloc_tmp_file(path.empty() ? "." : path.c_str(),
+                                     ecl::util::path::basename(cache_file).c_str(),
+                                     true);
+    tmp_file = tmp;
+    free(tmp);
+    stream = fopen(tmp_file.c_str(), "w+b");
+  }
+
+  if (!stream) {
+    tmp_file.clear();
+    stream = tmpfile();
+  }
+
+  if (!stream)
+    throw std::runtime_error("Could not create column cache for: " + this->filename);
+
+  {
+    column_cache_header header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, COLUMN_CACHE_MAGIC, sizeof header.magic);
+    header.version = COLUMN_CACHE_VERSION;
+    header.params_size = this->size;
+    header.length = this->length();
+    header.source_size = util_file_size(this->filename.c_str());
+    header.source_mtime = util_file_mtime(this->filename.c_str());
+    util_fwrite(&header, sizeof header, 1, stream, __func__);
+  }
+
+  {
+    bool fmt_file;
+    ecl_util_fmt_file(this->filename.c_str(), &fmt_file);
+    fortio_type * fortio = fortio_open_reader(this->filename.c_str(), fmt_file, ECL_ENDIAN_FLIP);
+    if (!fortio) {
+      fclose(stream);
+      throw std::runtime_error("Could not open: " + this->filename);
+    }
+
+    const int block_rows = std::max(1, static_cast<int>(COLUMN_CACHE_BLOCK_SIZE / this->size));
+    std::vector<float> block(static_cast<size_t>(block_rows) * this->size);
+    std::vector<float> column(block_rows);
+
+    for (int row0 = 0; row0 < this->length(); row0 += block_rows) {
+      int num_rows = std::min(block_rows, this->length() - row0);
+
+      for (int row = 0; row < num_rows; row++) {
+        const ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw(this->file_view, PARAMS_KW, row0 + row);
+        fortio_fseek(fortio, ecl_file_kw_get_offset(file_kw), SEEK_SET);
+
+        ecl_kw_type * params_kw = ecl_kw_fread_alloc(fortio);
+        if (!params_kw || ecl_kw_get_size(params_kw) < this->size) {
+          if (params_kw)
+            ecl_kw_free(params_kw);
+          fortio_fclose(fortio);
+          fclose(stream);
+          throw std::runtime_error("Invalid PARAMS keyword in: " + this->filename);
+        }
+        memcpy(&block[static_cast<size_t>(row) * this->size], ecl_kw_get_float_ptr(params_kw), this->size * sizeof(float));
+        ecl_kw_free(params_kw);
+      }
+
+      for (int pos = 0; pos < this->size; pos++) {
+        for (int row = 0; row < num_rows; row++)
+          column[row] = block[static_cast<size_t>(row) * this->size + pos];
+
+        util_fseek(stream, sizeof(column_cache_header) + sizeof(float) * (static_cast<offset_type>(pos) * this->length() + row0), SEEK_SET);
+        util_fwrite(column.data(), sizeof(float), num_rows, stream, __func__);
+      }
+    }
+    fortio_fclose(fortio);
+  }
+
+  if (tmp_file.empty()) {
+    this->column_cache.reset( new ecl::util::mapped_file(stream) );
+    fclose(stream);
+  } else {
+    fclose(stream);
+    if (std::rename(tmp_file.c_str(), cache_file.c_str()) == 0)
+      this->column_cache.reset( new ecl::util::mapped_file(cache_file) );
+    else {
+      this->column_cache.reset( new ecl::util::mapped_file(tmp_file) );
+      util_unlink(tmp_file.c_str());
+    }
+  }
+}
+
+
+/*
+  Returns a pointer to the cached column of values for parameter @pos,
+  building the cache if it does not exist and @build_cache is true. If
+  the cache is not available NULL is returned, and the caller must fall
+  back to reading the values from the PARAMS keywords.
+*/
+const float * unsmry_loader::column(int pos, bool build_cache) const {
+  std::lock_guard<std::mutex> lock(this->cache_mutex);
+  if (!this->column_cache) {
+    if (!build_cache || this->cache_failed)
+      return NULL;
+
+    try {
+      this->build_column_cache();
+    } catch (const std::runtime_error&) {
+      this->cache_failed = true;
+      return NULL;
+    }
+  }
+
+  const float * data = reinterpret_cast<const float *>(this->column_cache->data() + sizeof(column_cache_header));
+  return data + static_cast<size_t>(pos) * this->length();
+}
+
+
+const float * unsmry_loader::column_ptr(int pos) const {
+  return this->column(pos, true);
+}
+
+
 int unsmry_loader::length() const {
   return this->m_length;
 }
@@ -55,6 +300,25 @@ std::vector<double> unsmry_loader::get_vector(int pos) const {
   if (pos >= size)
     throw std::out_of_range("unsmry_loader::get_vector pos: " + std::to_string(pos) + " PARAMS_SIZE: " + std::to_string(size));
 
+  return this->column_vector(pos, true);
+}
+
+
+/*
+  The time vectors are needed when the case is loaded; to avoid reading
+  the complete file at that point they only use the column cache if it
+  already exists.
+*/
+std::vector<double> unsmry_loader::column_vector(int pos, bool build_cache) const {
+  const float * column = this->column(pos, build_cache);
+  if (column)
+    return std::vector<double>(column, column + this->length());
+
+  return this->read_vector(pos);
+}
+
+
+std::vector<double> unsmry_loader::read_vector(int pos) const {
   std::vector<double> data(this->length());
   int_vector_type * index_map = int_vector_alloc( 1 , pos);
   char buffer[4];
@@ -69,8 +333,16 @@ std::vector<double> unsmry_loader::get_vector(int pos) const {
 }
 
 
-// This is horribly inefficient
 double unsmry_loader::iget(int time_index, int params_index) const {
+  const float * column = this->column(params_index, true);
+  if (column)
+    return column[time_index];
+
+  return this->read_value(time_index, params_index);
+}
+
+
+double unsmry_loader::read_value(int time_index, int params_index) const {
   int_vector_type * index_map = int_vector_alloc( 1 , params_index);
   float value;
   ecl_file_view_index_fload_kw(this->file_view, PARAMS_KW, time_index, index_map, (char *) &value);
@@ -137,9 +409,9 @@ std::vector<time_t> unsmry_loader::sim_time() const {
     return st;
 
   } else {
-    const auto day   = this->get_vector(this->date_index[0]);
-    const auto month = this->get_vector(this->date_index[1]);
-    const auto year  = this->get_vector(this->date_index[2]);
+    const auto day   = this->column_vector(this->date_index[0], false);
+    const auto month = this->column_vector(this->date_index[1], false);
+    const auto year  = this->column_vector(this->date_index[2], false);
     std::vector<time_t> st(this->length());
 
     for (size_t i=0; i < st.size(); i++)
@@ -154,7 +426,7 @@ std::vector<time_t> unsmry_loader::sim_time() const {
 
 std::vector<double> unsmry_loader::sim_seconds() const {
   if (this->time_index >= 0) {
-    std::vector<double> seconds = this->get_vector(this->time_index);
+    std::vector<double> seconds = this->column_vector(this->time_index, false);
     for (size_t i=0; i < seconds.size(); i++)
       seconds[i] *= this->time_seconds;
 
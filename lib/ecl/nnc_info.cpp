@@ -204,6 +204,18 @@ int nnc_info_get_total_size( const nnc_info_type * nnc_info ) {
 }
 
 
+size_t nnc_info_get_memory_usage( const nnc_info_type * nnc_info ) {
+  size_t usage = sizeof * nnc_info;
+  usage += vector_get_size( nnc_info->lgr_list ) * sizeof(void *);
+  usage += int_vector_size( nnc_info->lgr_index_map ) * sizeof(int);
+  for (int ivec = 0; ivec < vector_get_size( nnc_info->lgr_list ); ivec++) {
+    const nnc_vector_type * nnc_vector = (const nnc_vector_type*)vector_iget_const( nnc_info->lgr_list , ivec );
+    usage += nnc_vector_get_memory_usage( nnc_vector );
+  }
+  return usage;
+}
+
+
 void nnc_info_fprintf(const nnc_info_type * nnc_info , FILE * stream) {
   fprintf(stream,"LGR_NR:%d \n",nnc_info->lgr_nr);
   {
@@ -27,6 +27,8 @@
 
 #include <ert/ecl/nnc_vector.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 
 #define NNC_VECTOR_TYPE_ID 875615078
@@ -114,6 +116,12 @@ int nnc_vector_get_size( const nnc_vector_type * nnc_vector ) {
   return nnc_vector->grid_index_list.size();
 }
 
+size_t nnc_vector_get_memory_usage( const nnc_vector_type * nnc_vector ) {
+  return sizeof * nnc_vector +
+         ecl::util::memory_usage( nnc_vector->grid_index_list ) +
+         ecl::util::memory_usage( nnc_vector->nnc_index_list );
+}
+
 int nnc_vector_get_lgr_nr( const nnc_vector_type * nnc_vector ) {
   return nnc_vector->lgr_nr;
 }
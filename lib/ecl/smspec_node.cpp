@@ -42,6 +42,7 @@
 #include <ert/ecl/ecl_kw_magic.hpp>
 
 #include "detail/util/string_util.hpp"
+#include "detail/util/memory_usage.hpp"
 
 /**
    The special_vars list is used to associate keywords with special
@@ -959,6 +960,16 @@ smspec_node::smspec_node( int param_index_,
 
 /*****************************************************************/
 
+size_t smspec_node::memory_usage() const {
+  return sizeof * this +
+    ecl::util::memory_usage(this->wgname) +
+    ecl::util::memory_usage(this->keyword) +
+    ecl::util::memory_usage(this->unit) +
+    ecl::util::memory_usage(this->lgr_name) +
+    ecl::util::memory_usage(this->gen_key1) +
+    ecl::util::memory_usage(this->gen_key2);
+}
+
 int smspec_node::get_params_index() const {
   return this->params_index;
 }
@@ -21,6 +21,8 @@
 #include <stdbool.h>
 #include <math.h>
 
+#include <vector>
+
 #include <ert/util/test_util.hpp>
 #include <ert/ecl/ecl_grid.hpp>
 
@@ -182,6 +184,38 @@ void test_find( ecl_grid_type * grid ) {
 
 
 
+void test_find_list( ecl_grid_type * grid ) {
+  std::vector<double> x, y, z;
+  std::vector<int> expected;
+  int delta = util_int_max(1 , ecl_grid_get_global_size( grid ) / 100);
+
+  for (int init_index = 0; init_index < ecl_grid_get_global_size( grid ); init_index += delta) {
+    double xpos,ypos,zpos;
+    if (ecl_grid_get_cell_twist1( grid , init_index ) == 0 && get_test_point1( grid , init_index , &xpos,&ypos,&zpos)) {
+      x.push_back( xpos );
+      y.push_back( ypos );
+      z.push_back( zpos );
+      expected.push_back( init_index );
+    }
+  }
+
+  {
+    double xpos,ypos,zpos;
+    ecl_grid_get_xyz1( grid , 0 , &xpos , &ypos , &zpos );
+    x.push_back( xpos );
+    y.push_back( ypos );
+    z.push_back( zpos - 1e6 );
+    expected.push_back( -1 );
+  }
+
+  {
+    std::vector<int> global_index( x.size() );
+    ecl_grid_get_global_index_list_from_xyz( grid , x.size() , x.data() , y.data() , z.data() , global_index.data() );
+    for (size_t ip = 0; ip < x.size(); ip++)
+      test_assert_int_equal( expected[ip] , global_index[ip] );
+  }
+}
+
 
 void test_corners() {
   ecl_grid_type * grid = ecl_grid_alloc_rectangular(3,3,3,1,1,1,NULL);
@@ -259,6 +293,7 @@ int main(int argc , char ** argv) {
 
 
   test_find(grid);
+  test_find_list(grid);
   test_corners();
   ecl_grid_free( grid );
   exit(0);
@@ -0,0 +1,128 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_compare.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/int_vector.hpp>
+
+#include <ert/ecl/ecl_grid.hpp>
+
+
+/*
+  The grid is large enough to be compared in several chunks. The
+  zcorn values of the cells in @perturb are shifted with @shift.
+*/
+ecl_grid_type * alloc_grid( const std::vector<int>& perturb , float shift ) {
+  int nx = 50, ny = 40, nz = 40;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 1000 + 10 * i;
+      pillar[1] = 2000 + 10 * j;
+      pillar[2] = 1000;
+      pillar[3] = 1000 + 10 * i;
+      pillar[4] = 2000 + 10 * j;
+      pillar[5] = 1500;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++)
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = 1000 + 5 * (k + c / 4);
+
+  for (int g : perturb) {
+    int i = g % nx;
+    int j = (g / nx) % ny;
+    int k = g / (nx * ny);
+    for (int c = 0; c < 4; c++)
+      zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] += shift;
+  }
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, false, NULL);
+}
+
+
+void test_equal() {
+  ecl_grid_type * g1 = alloc_grid( {} , 0 );
+  ecl_grid_type * g2 = alloc_grid( {} , 0 );
+  int_vector_type * diff_list = int_vector_alloc( 0 , 0 );
+
+  test_assert_true( ecl_grid_compare( g1 , g2 , true , true , false ));
+  test_assert_int_equal( 0 , ecl_grid_get_cell_diff_list( g1 , g2 , true , 0 , diff_list ));
+  test_assert_int_equal( 0 , int_vector_size( diff_list ));
+
+  int_vector_free( diff_list );
+  ecl_grid_free( g2 );
+  ecl_grid_free( g1 );
+}
+
+
+void test_tolerance() {
+  ecl_grid_type * g1 = alloc_grid( {} , 0 );
+  ecl_grid_type * g2 = alloc_grid( {17 , 70000} , 0.001 );
+  int_vector_type * diff_list = int_vector_alloc( 0 , 0 );
+
+  test_assert_true( ecl_grid_compare( g1 , g2 , true , true , false ));
+  test_assert_int_equal( 0 , ecl_grid_get_cell_diff_list( g1 , g2 , true , 0 , diff_list ));
+
+  int_vector_free( diff_list );
+  ecl_grid_free( g2 );
+  ecl_grid_free( g1 );
+}
+
+
+void test_diff_list() {
+  std::vector<int> perturb = {79999 , 5 , 65536 , 100 , 3000 , 70000};
+  ecl_grid_type * g1 = alloc_grid( {} , 0 );
+  ecl_grid_type * g2 = alloc_grid( perturb , 3 );
+
+  test_assert_false( ecl_grid_compare( g1 , g2 , true , true , false ));
+  {
+    int_vector_type * diff_list = int_vector_alloc( 0 , 0 );
+    const int expected[6] = {5 , 100 , 3000 , 65536 , 70000 , 79999};
+
+    test_assert_int_equal( 6 , ecl_grid_get_cell_diff_list( g1 , g2 , true , 0 , diff_list ));
+    for (int i = 0; i < 6; i++)
+      test_assert_int_equal( expected[i] , int_vector_iget( diff_list , i ));
+
+    int_vector_reset( diff_list );
+    test_assert_int_equal( 4 , ecl_grid_get_cell_diff_list( g1 , g2 , true , 4 , diff_list ));
+    test_assert_int_equal( 4 , int_vector_size( diff_list ));
+    for (int i = 0; i < 4; i++)
+      test_assert_int_equal( expected[i] , int_vector_iget( diff_list , i ));
+
+    int_vector_free( diff_list );
+  }
+  ecl_grid_free( g2 );
+  ecl_grid_free( g1 );
+}
+
+
+int main(int argc , char ** argv) {
+  test_equal();
+  test_tolerance();
+  test_diff_list();
+  exit(0);
+}
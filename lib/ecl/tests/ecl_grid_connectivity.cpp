@@ -0,0 +1,243 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_connectivity.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+
+#include <ert/ecl/ecl_grid_connectivity.hpp>
+
+
+/*
+  Every connection must be listed for both cells, with the opposite
+  face and normal.
+*/
+void assert_symmetric( const ecl_grid_connectivity_type * connectivity ) {
+  const int * offset = ecl_grid_connectivity_get_offset( connectivity );
+  const int * neighbour = ecl_grid_connectivity_get_neighbour( connectivity );
+  const int * face = ecl_grid_connectivity_get_face( connectivity );
+  const double * area = ecl_grid_connectivity_get_area( connectivity );
+  const double * normal = ecl_grid_connectivity_get_normal( connectivity );
+
+  for (int g = 0; g < ecl_grid_connectivity_get_num_cells( connectivity ); g++) {
+    for (int e = offset[g]; e < offset[g + 1]; e++) {
+      int n = neighbour[e];
+      int found = 0;
+
+      if (e > offset[g])
+        test_assert_true( neighbour[e - 1] < n );
+
+      for (int e2 = offset[n]; e2 < offset[n + 1]; e2++) {
+        if (neighbour[e2] == g) {
+          found++;
+          test_assert_double_equal( area[e] , area[e2] );
+          if (face[e] == ECL_FACE_NNC)
+            test_assert_int_equal( ECL_FACE_NNC , face[e2] );
+          else
+            test_assert_int_equal( face[e] ^ 1 , face[e2] );
+          for (int l = 0; l < 3; l++)
+            test_assert_double_equal( normal[3 * e + l] , -normal[3 * e2 + l] );
+        }
+      }
+      test_assert_int_equal( 1 , found );
+    }
+  }
+}
+
+
+int find_entry( const ecl_grid_connectivity_type * connectivity , int g , int n) {
+  const int * offset = ecl_grid_connectivity_get_offset( connectivity );
+  const int * neighbour = ecl_grid_connectivity_get_neighbour( connectivity );
+  for (int e = offset[g]; e < offset[g + 1]; e++)
+    if (neighbour[e] == n)
+      return e;
+  return -1;
+}
+
+
+void test_rectangular() {
+  int nx = 4, ny = 3, nz = 2;
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , 3 , NULL );
+  ecl_grid_connectivity_type * connectivity = ecl_grid_connectivity_alloc( grid );
+  const double * face_area = ecl_grid_connectivity_get_face_area( connectivity );
+  const double * face_normal = ecl_grid_connectivity_get_face_normal( connectivity );
+  const double * face_distance = ecl_grid_connectivity_get_face_distance( connectivity );
+  const double expected_area[ECL_CELL_NUM_FACES] = {6 , 6 , 3 , 3 , 2 , 2};
+  const double expected_distance[ECL_CELL_NUM_FACES] = {0.5 , 0.5 , 1 , 1 , 1.5 , 1.5};
+
+  test_assert_true( ecl_grid_connectivity_is_instance( connectivity ));
+  test_assert_int_equal( (nx - 1)*ny*nz + nx*(ny - 1)*nz + nx*ny*(nz - 1) , ecl_grid_connectivity_get_num_connections( connectivity ));
+  for (int g = 0; g < nx*ny*nz; g++) {
+    for (int f = 0; f < ECL_CELL_NUM_FACES; f++) {
+      int index = ECL_CELL_NUM_FACES * g + f;
+      test_assert_double_equal( expected_area[f] , face_area[index] );
+      test_assert_double_equal( expected_distance[f] , face_distance[index] );
+      test_assert_double_equal( (f % 2) ? 1 : -1 , face_normal[3 * index + f / 2] );
+    }
+  }
+  assert_symmetric( connectivity );
+
+  {
+    int g = ecl_grid_get_global_index3( grid , 1 , 1 , 0 );
+    int n = ecl_grid_get_global_index3( grid , 1 , 1 , 1 );
+    int e = find_entry( connectivity , g , n );
+    test_assert_int_equal( ECL_FACE_K_PLUS , ecl_grid_connectivity_get_face( connectivity )[e] );
+    test_assert_double_equal( 2 , ecl_grid_connectivity_get_area( connectivity )[e] );
+    test_assert_double_equal( 1 , ecl_grid_connectivity_get_normal( connectivity )[3 * e + 2] );
+  }
+  ecl_grid_connectivity_free( connectivity );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Two blocks with a fault between i = 2 and i = 3, the right block is
+  thrown down by half a cell.
+*/
+ecl_grid_type * alloc_fault_grid() {
+  int nx = 6, ny = 1, nz = 4;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 1000 + 10 * i;
+      pillar[1] = 2000 + 10 * j;
+      pillar[2] = 900;
+      pillar[3] = 1000 + 10 * i;
+      pillar[4] = 2000 + 10 * j;
+      pillar[5] = 1100;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++)
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = 1000 + 5 * (k + c / 4) + (i >= 3 ? 2.5 : 0);
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, true, NULL);
+}
+
+
+void test_fault() {
+  ecl_grid_type * grid = alloc_fault_grid();
+  int g1 = ecl_grid_get_global_index3( grid , 2 , 0 , 1 );
+  int g2 = ecl_grid_get_global_index3( grid , 3 , 0 , 0 );
+  int g3 = ecl_grid_get_global_index3( grid , 0 , 0 , 0 );
+  int g4 = ecl_grid_get_global_index3( grid , 5 , 0 , 3 );
+
+  int g5 = ecl_grid_get_global_index3( grid , 0 , 0 , 3 );
+
+  ecl_grid_add_self_nnc( grid , g1 , g2 , 0 );
+  ecl_grid_add_self_nnc( grid , g4 , g3 , 1 );
+  ecl_grid_add_self_nnc( grid , g3 , g5 , 2 );   /* Pinch-out across two layers. */
+  {
+    ecl_grid_connectivity_type * connectivity = ecl_grid_connectivity_alloc( grid );
+    const int * face = ecl_grid_connectivity_get_face( connectivity );
+    const double * area = ecl_grid_connectivity_get_area( connectivity );
+
+    assert_symmetric( connectivity );
+
+    /* Structured neighbour across the fault: half the face is in contact. */
+    {
+      int e = find_entry( connectivity , g1 , ecl_grid_get_global_index3( grid , 3 , 0 , 1 ));
+      test_assert_int_equal( ECL_FACE_I_PLUS , face[e] );
+      test_assert_double_equal( 25 , area[e] );
+    }
+
+    /* Across the fault given as NNC. */
+    {
+      int e = find_entry( connectivity , g2 , g1 );
+      test_assert_int_equal( ECL_FACE_I_MINUS , face[e] );
+      test_assert_double_equal( 25 , area[e] );
+    }
+
+    /* Not in contact. */
+    test_assert_int_equal( -1 , find_entry( connectivity , g1 , ecl_grid_get_global_index3( grid , 3 , 0 , 2 )));
+
+    /* NNC between cells without a common face. */
+    {
+      int e = find_entry( connectivity , g3 , g4 );
+      test_assert_int_equal( ECL_FACE_NNC , face[e] );
+      test_assert_double_equal( 0 , area[e] );
+    }
+
+    /* NNC within one column spanning several layers. */
+    {
+      int e = find_entry( connectivity , g3 , g5 );
+      test_assert_int_equal( ECL_FACE_NNC , face[e] );
+      test_assert_double_equal( 0 , area[e] );
+      test_assert_double_equal( 1 , ecl_grid_connectivity_get_normal( connectivity )[3 * e + 2] );
+    }
+
+    /* Vertical neighbours in the same column. */
+    {
+      int e = find_entry( connectivity , g3 , ecl_grid_get_global_index3( grid , 0 , 0 , 1 ));
+      test_assert_int_equal( ECL_FACE_K_PLUS , face[e] );
+      test_assert_double_equal( 100 , area[e] );
+    }
+
+    /* Away from the fault. */
+    {
+      int e = find_entry( connectivity , ecl_grid_get_global_index3( grid , 0 , 0 , 0 ) , ecl_grid_get_global_index3( grid , 1 , 0 , 0 ));
+      test_assert_int_equal( ECL_FACE_I_PLUS , face[e] );
+      test_assert_double_equal( 50 , area[e] );
+    }
+    ecl_grid_connectivity_free( connectivity );
+  }
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Inactive cells have face geometry, but no connections.
+*/
+void test_inactive() {
+  int nx = 3, ny = 3, nz = 2;
+  std::vector<int> actnum( nx * ny * nz , 1 );
+  int inactive = 1 + 1 * nx;   /* (1,1,0) */
+  actnum[inactive] = 0;
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , actnum.data() );
+    ecl_grid_connectivity_type * connectivity = ecl_grid_connectivity_alloc( grid );
+    const int * offset = ecl_grid_connectivity_get_offset( connectivity );
+    const int * neighbour = ecl_grid_connectivity_get_neighbour( connectivity );
+    int num_connections = (nx - 1)*ny*nz + nx*(ny - 1)*nz + nx*ny*(nz - 1);
+
+    assert_symmetric( connectivity );
+    test_assert_int_equal( num_connections - 5 , ecl_grid_connectivity_get_num_connections( connectivity ));
+    test_assert_int_equal( offset[inactive] , offset[inactive + 1] );
+    for (int e = 0; e < offset[nx*ny*nz]; e++)
+      test_assert_int_not_equal( inactive , neighbour[e] );
+    test_assert_double_equal( 1 , ecl_grid_connectivity_get_face_area( connectivity )[ECL_CELL_NUM_FACES * inactive] );
+
+    ecl_grid_connectivity_free( connectivity );
+    ecl_grid_free( grid );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_rectangular();
+  test_fault();
+  test_inactive();
+  exit(0);
+}
@@ -0,0 +1,178 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_egrid_writer.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+
+ecl_grid_type * alloc_grid() {
+  int nx = 17, ny = 13, nz = 9;
+  std::vector<int> actnum(nx*ny*nz);
+  for (int i = 0; i < nx*ny*nz; i++)
+    actnum[i] = (i % 7) == 0 ? 0 : 1;
+
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , 3 , actnum.data() );
+  ecl_grid_add_self_nnc( grid , 5 , 60 , 0 );
+  ecl_grid_add_self_nnc( grid , 8 , 90 , 1 );
+  return grid;
+}
+
+
+/*
+  Adds the data in slabs of an odd size, so the slabs do not line up
+  with the blocks in the file.
+*/
+void add_float_slabs( ecl_egrid_writer_type * writer , const ecl_kw_type * kw , bool coord) {
+  const int slab_size = 777;
+  const float * data = ecl_kw_get_float_ptr( kw );
+  for (int offset = 0; offset < ecl_kw_get_size( kw ); offset += slab_size) {
+    int size = util_int_min( slab_size , ecl_kw_get_size( kw ) - offset );
+    if (coord)
+      ecl_egrid_writer_add_coord( writer , size , &data[offset] );
+    else
+      ecl_egrid_writer_add_zcorn( writer , size , &data[offset] );
+  }
+}
+
+
+void write_grid( ecl_egrid_writer_type * writer , const ecl_grid_type * grid , bool add_nnc) {
+  ecl_kw_type * coord_kw = ecl_grid_alloc_coord_kw( grid );
+  ecl_kw_type * zcorn_kw = ecl_grid_alloc_zcorn_kw( grid );
+  ecl_kw_type * actnum_kw = ecl_grid_alloc_actnum_kw( grid );
+  const int * actnum = ecl_kw_get_int_ptr( actnum_kw );
+  int size = ecl_kw_get_size( actnum_kw );
+
+  ecl_egrid_writer_begin_grid( writer , ecl_grid_get_nx( grid ) , ecl_grid_get_ny( grid ) , ecl_grid_get_nz( grid ));
+  add_float_slabs( writer , coord_kw , true );
+  add_float_slabs( writer , zcorn_kw , false );
+  ecl_egrid_writer_add_actnum( writer , size / 2 , actnum );
+  ecl_egrid_writer_add_actnum( writer , size - size / 2 , &actnum[size / 2] );
+  if (add_nnc) {
+    int g1[2] = {5 , 8};
+    int g2[2] = {60 , 90};
+    ecl_egrid_writer_add_nnc( writer , 2 , g1 , g2 );
+  }
+  ecl_egrid_writer_end_grid( writer );
+
+  ecl_kw_free( actnum_kw );
+  ecl_kw_free( zcorn_kw );
+  ecl_kw_free( coord_kw );
+}
+
+
+void test_main_grid( const char * ext ) {
+  char * file1 = util_alloc_sprintf( "GRID1.%s" , ext );
+  char * file2 = util_alloc_sprintf( "GRID2.%s" , ext );
+  ecl_grid_type * grid = alloc_grid();
+  ecl_grid_fwrite_EGRID2( grid , file1 , ECL_METRIC_UNITS );
+  {
+    ecl_egrid_writer_type * writer = ecl_egrid_writer_alloc( file2 , ECL_METRIC_UNITS , NULL );
+    test_assert_true( ecl_egrid_writer_is_instance( writer ));
+    write_grid( writer , grid , true );
+    ecl_egrid_writer_free( writer );
+  }
+  test_assert_true( util_files_equal( file1 , file2 ));
+  {
+    ecl_grid_type * grid2 = ecl_grid_alloc( file2 );
+    test_assert_true( ecl_grid_compare( grid , grid2 , true , true , true ));
+    test_assert_int_equal( 2 , ecl_grid_get_num_nnc( grid2 ));
+    ecl_grid_free( grid2 );
+  }
+  ecl_grid_free( grid );
+  free( file1 );
+  free( file2 );
+}
+
+
+/*
+  A 3x3x1 main grid where the center cell is refined 2x2x1.
+*/
+void test_lgr() {
+  {
+    ecl_egrid_writer_type * writer = ecl_egrid_writer_alloc( "LGR.EGRID" , ECL_METRIC_UNITS , NULL );
+    ecl_grid_type * main_grid = ecl_grid_alloc_rectangular( 3 , 3 , 1 , 10 , 10 , 10 , NULL );
+    write_grid( writer , main_grid , false );
+    {
+      int hostnum[4];
+      ecl_grid_type * lgr = ecl_grid_alloc_rectangular( 2 , 2 , 1 , 5 , 5 , 10 , NULL );
+      ecl_kw_type * coord_kw = ecl_grid_alloc_coord_kw( lgr );
+      ecl_kw_type * zcorn_kw = ecl_grid_alloc_zcorn_kw( lgr );
+      ecl_kw_type * actnum_kw = ecl_grid_alloc_actnum_kw( lgr );
+      float * coord = ecl_kw_get_float_ptr( coord_kw );
+
+      for (int i = 0; i < ecl_kw_get_size( coord_kw ); i++)
+        if ((i % 3) != 2)
+          coord[i] += 10;
+
+      for (int i = 0; i < 4; i++)
+        hostnum[i] = 1 + ecl_grid_get_global_index3( main_grid , 1 , 1 , 0 );
+
+      ecl_egrid_writer_begin_lgr( writer , "LGR1" , NULL , 1 , 2 , 2 , 1 );
+      ecl_egrid_writer_add_coord( writer , ecl_kw_get_size( coord_kw ) , coord );
+      ecl_egrid_writer_add_zcorn( writer , ecl_kw_get_size( zcorn_kw ) , ecl_kw_get_float_ptr( zcorn_kw ));
+      ecl_egrid_writer_add_actnum( writer , 4 , ecl_kw_get_int_ptr( actnum_kw ));
+      ecl_egrid_writer_add_hostnum( writer , 4 , hostnum );
+      ecl_egrid_writer_end_grid( writer );
+
+      ecl_kw_free( actnum_kw );
+      ecl_kw_free( zcorn_kw );
+      ecl_kw_free( coord_kw );
+      ecl_grid_free( lgr );
+    }
+    ecl_grid_free( main_grid );
+    ecl_egrid_writer_free( writer );
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "LGR.EGRID" );
+    test_assert_int_equal( 1 , ecl_grid_get_num_lgr( grid ));
+    {
+      ecl_grid_type * lgr = ecl_grid_get_lgr( grid , "LGR1" );
+      test_assert_int_equal( 2 , ecl_grid_get_nx( lgr ));
+      test_assert_int_equal( 2 , ecl_grid_get_ny( lgr ));
+      test_assert_int_equal( 1 , ecl_grid_get_nz( lgr ));
+      for (int g = 0; g < 4; g++)
+        test_assert_int_equal( 4 , ecl_grid_get_parent_cell1( lgr , g ));
+      test_assert_true( ecl_grid_get_cell_lgr1( grid , 4 ) == lgr );
+      {
+        double x, y, z;
+        ecl_grid_get_xyz3( lgr , 1 , 0 , 0 , &x , &y , &z );
+        test_assert_double_equal( 17.5 , x );
+        test_assert_double_equal( 12.5 , y );
+        test_assert_double_equal( 5 , z );
+      }
+    }
+    ecl_grid_free( grid );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  ecl::util::TestArea ta("egrid_writer");
+  test_main_grid( "EGRID" );
+  test_main_grid( "FEGRID" );
+  test_lgr();
+  exit(0);
+}
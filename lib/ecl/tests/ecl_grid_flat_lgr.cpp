@@ -0,0 +1,150 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_flat_lgr.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+
+void write_grid( ecl_egrid_writer_type * writer , const char * lgr_name , const char * parent_name , int lgr_nr ,
+                 int nx , int ny , int nz , int host_cell) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , NULL );
+  ecl_kw_type * coord_kw = ecl_grid_alloc_coord_kw( grid );
+  ecl_kw_type * zcorn_kw = ecl_grid_alloc_zcorn_kw( grid );
+  ecl_kw_type * actnum_kw = ecl_grid_alloc_actnum_kw( grid );
+
+  if (lgr_name)
+    ecl_egrid_writer_begin_lgr( writer , lgr_name , parent_name , lgr_nr , nx , ny , nz );
+  else
+    ecl_egrid_writer_begin_grid( writer , nx , ny , nz );
+
+  ecl_egrid_writer_add_coord( writer , ecl_kw_get_size( coord_kw ) , ecl_kw_get_float_ptr( coord_kw ));
+  ecl_egrid_writer_add_zcorn( writer , ecl_kw_get_size( zcorn_kw ) , ecl_kw_get_float_ptr( zcorn_kw ));
+  ecl_egrid_writer_add_actnum( writer , ecl_kw_get_size( actnum_kw ) , ecl_kw_get_int_ptr( actnum_kw ));
+  if (lgr_name) {
+    std::vector<int> hostnum( nx * ny * nz , host_cell + 1 );
+    ecl_egrid_writer_add_hostnum( writer , hostnum.size() , hostnum.data() );
+  }
+  ecl_egrid_writer_end_grid( writer );
+
+  ecl_kw_free( actnum_kw );
+  ecl_kw_free( zcorn_kw );
+  ecl_kw_free( coord_kw );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  A 4x4x1 main grid with the LGRs LGR1 in cell 5 and LGR2 in cell
+  10, and LGR3 nested in cell 3 of LGR1.
+*/
+void test_flat_maps() {
+  {
+    ecl_egrid_writer_type * writer = ecl_egrid_writer_alloc( "FLAT.EGRID" , ECL_METRIC_UNITS , NULL );
+    write_grid( writer , NULL , NULL , 0 , 4 , 4 , 1 , 0 );
+    write_grid( writer , "LGR1" , NULL , 1 , 2 , 2 , 1 , 5 );
+    write_grid( writer , "LGR2" , NULL , 2 , 2 , 2 , 1 , 10 );
+    write_grid( writer , "LGR3" , "LGR1" , 3 , 2 , 1 , 1 , 3 );
+    ecl_egrid_writer_free( writer );
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "FLAT.EGRID" );
+    const ecl_grid_type * lgr1 = ecl_grid_get_lgr( grid , "LGR1" );
+    const ecl_grid_type * lgr2 = ecl_grid_get_lgr( grid , "LGR2" );
+    const ecl_grid_type * lgr3 = ecl_grid_get_lgr( grid , "LGR3" );
+    test_assert_int_equal( 3 , ecl_grid_get_num_lgr( grid ));
+
+    test_assert_int_equal( 26 , ecl_grid_get_flat_size( grid ));
+    test_assert_int_equal( 26 , ecl_grid_get_flat_size( lgr3 ));
+    test_assert_int_equal( 0  , ecl_grid_get_flat_offset( grid ));
+    test_assert_int_equal( 16 , ecl_grid_get_flat_offset( lgr1 ));
+    test_assert_int_equal( 20 , ecl_grid_get_flat_offset( lgr2 ));
+    test_assert_int_equal( 24 , ecl_grid_get_flat_offset( lgr3 ));
+    test_assert_ptr_equal( ecl_grid_get_flat_host_map( grid ) , ecl_grid_get_flat_host_map( lgr2 ));
+
+    {
+      const int * host_map = ecl_grid_get_flat_host_map( grid );
+      const int * lgr_map = ecl_grid_get_flat_lgr_map( grid );
+
+      for (int i = 0; i < 16; i++)
+        test_assert_int_equal( -1 , host_map[i] );
+      for (int i = 16; i < 20; i++)
+        test_assert_int_equal( 5 , host_map[i] );
+      for (int i = 20; i < 24; i++)
+        test_assert_int_equal( 10 , host_map[i] );
+      for (int i = 24; i < 26; i++)
+        test_assert_int_equal( 16 + 3 , host_map[i] );
+
+      for (int i = 0; i < 26; i++) {
+        int expected = -1;
+        if (i == 5)
+          expected = 0;
+        else if (i == 10)
+          expected = 1;
+        else if (i == 19)
+          expected = 2;
+        test_assert_int_equal( expected , lgr_map[i] );
+      }
+
+      for (int l = 0; l < ecl_grid_get_num_lgr( grid ); l++) {
+        const ecl_grid_type * lgr = ecl_grid_iget_lgr( grid , l );
+        const ecl_grid_type * parent = (lgr == lgr3) ? lgr1 : grid;
+        for (int g = 0; g < ecl_grid_get_global_size( lgr ); g++)
+          test_assert_int_equal( ecl_grid_get_flat_offset( parent ) + ecl_grid_get_parent_cell1( lgr , g ),
+                                 host_map[ecl_grid_get_flat_offset( lgr ) + g] );
+      }
+    }
+
+    {
+      ecl_grid_type * copy = ecl_grid_alloc_copy( grid );
+      test_assert_true( ecl_grid_compare( grid , copy , true , false , true ));
+      test_assert_int_equal( 26 , ecl_grid_get_flat_size( copy ));
+      test_assert_int_equal( 24 , ecl_grid_get_flat_offset( ecl_grid_get_lgr( copy , "LGR3" )));
+      for (int i = 0; i < 26; i++) {
+        test_assert_int_equal( ecl_grid_get_flat_host_map( grid )[i] , ecl_grid_get_flat_host_map( copy )[i] );
+        test_assert_int_equal( ecl_grid_get_flat_lgr_map( grid )[i] , ecl_grid_get_flat_lgr_map( copy )[i] );
+      }
+      ecl_grid_free( copy );
+    }
+    ecl_grid_free( grid );
+  }
+}
+
+
+void test_no_lgr() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 3 , 3 , 3 , 1 , 1 , 1 , NULL );
+  test_assert_int_equal( 27 , ecl_grid_get_flat_size( grid ));
+  test_assert_int_equal( 0 , ecl_grid_get_flat_offset( grid ));
+  test_assert_NULL( ecl_grid_get_flat_host_map( grid ));
+  test_assert_NULL( ecl_grid_get_flat_lgr_map( grid ));
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl::util::TestArea ta("flat_lgr");
+  test_flat_maps();
+  test_no_lgr();
+  exit(0);
+}
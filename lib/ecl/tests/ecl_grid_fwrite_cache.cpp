@@ -0,0 +1,271 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_fwrite_cache.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <utime.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+
+ecl_grid_type * alloc_grid( int active_modulus ) {
+  int nx = 10, ny = 8, nz = 6;
+  int * actnum = (int*)util_malloc( nx*ny*nz * sizeof * actnum );
+  for (int i = 0; i < nx*ny*nz; i++)
+    actnum[i] = (i % active_modulus) == 0 ? 0 : 1;
+
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , 3 , actnum );
+  ecl_grid_add_self_nnc( grid , 5 , 60 , 0 );
+  ecl_grid_add_self_nnc( grid , 5 , 70 , 1 );
+  ecl_grid_add_self_nnc( grid , 8 , 90 , 2 );
+  free( actnum );
+  return grid;
+}
+
+
+void test_cache_roundtrip() {
+  ecl::util::TestArea ta("grid_cache");
+  ecl_grid_type * grid0 = alloc_grid( 7 );
+  ecl_grid_fwrite_EGRID2( grid0 , "CASE.EGRID" , ECL_METRIC_UNITS );
+  ecl_grid_free( grid0 );
+
+  test_assert_NULL( ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" ));
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "CASE.EGRID" );
+    test_assert_true( ecl_grid_fwrite_cache( grid , "CASE.EGRID" , "CASE.CACHE" ));
+    {
+      ecl_grid_type * cached_grid = ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" );
+      test_assert_not_NULL( cached_grid );
+      test_assert_true( ecl_grid_compare( grid , cached_grid , true , true , true ));
+      test_assert_int_equal( ecl_grid_get_nactive( grid ) , ecl_grid_get_nactive( cached_grid ));
+      test_assert_int_equal( ecl_grid_get_num_nnc( grid ) , ecl_grid_get_num_nnc( cached_grid ));
+      for (int a = 0; a < ecl_grid_get_nactive( grid ); a++) {
+        test_assert_int_equal( ecl_grid_get_global_index1A( grid , a ) , ecl_grid_get_global_index1A( cached_grid , a ));
+        test_assert_double_equal( ecl_grid_get_cell_volume1A( grid , a ) , ecl_grid_get_cell_volume1A( cached_grid , a ));
+      }
+      ecl_grid_free( cached_grid );
+    }
+    ecl_grid_free( grid );
+  }
+
+  /* The source file changes - the cache is stale. */
+  {
+    ecl_grid_type * grid1 = alloc_grid( 5 );
+    ecl_grid_fwrite_EGRID2( grid1 , "CASE.EGRID" , ECL_METRIC_UNITS );
+    test_assert_NULL( ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" ));
+
+    {
+      ecl_grid_type * cached_grid = ecl_grid_alloc_cached( "CASE.EGRID" , "CASE.CACHE" );
+      test_assert_true( ecl_grid_compare( grid1 , cached_grid , true , true , true ));
+      ecl_grid_free( cached_grid );
+    }
+
+    {
+      ecl_grid_type * cached_grid = ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" );
+      test_assert_not_NULL( cached_grid );
+      test_assert_true( ecl_grid_compare( grid1 , cached_grid , true , true , true ));
+      ecl_grid_free( cached_grid );
+    }
+    ecl_grid_free( grid1 );
+  }
+
+  /* Not a cache file at all. */
+  {
+    FILE * stream = util_fopen( "CASE.CACHE" , "w" );
+    fprintf(stream , "Hello");
+    fclose( stream );
+    test_assert_NULL( ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" ));
+  }
+}
+
+
+/*
+  A truncated cache file - e.g. from a writer which was killed - must
+  give NULL and not abort.
+*/
+void test_truncated_cache() {
+  ecl::util::TestArea ta("grid_cache_truncated");
+  ecl_grid_type * grid = alloc_grid( 7 );
+  ecl_grid_fwrite_EGRID2( grid , "CASE.EGRID" , ECL_METRIC_UNITS );
+  test_assert_true( ecl_grid_fwrite_cache( grid , "CASE.EGRID" , "CASE.CACHE" ));
+  ecl_grid_free( grid );
+
+  {
+    size_t cache_size = util_file_size( "CASE.CACHE" );
+    char * buffer = (char*)util_malloc( cache_size );
+    FILE * stream = util_fopen( "CASE.CACHE" , "rb" );
+    util_fread( buffer , 1 , cache_size , stream , __func__ );
+    fclose( stream );
+
+    for (size_t size = 0; size < cache_size; size += 1 + size / 3) {
+      stream = util_fopen( "TRUNCATED.CACHE" , "wb" );
+      util_fwrite( buffer , 1 , size , stream , __func__ );
+      fclose( stream );
+      test_assert_NULL( ecl_grid_fread_cache( "TRUNCATED.CACHE" , "CASE.EGRID" ));
+    }
+
+    /* The last bytes are the nnc information. */
+    for (size_t size = cache_size - 64; size < cache_size; size++) {
+      stream = util_fopen( "TRUNCATED.CACHE" , "wb" );
+      util_fwrite( buffer , 1 , size , stream , __func__ );
+      fclose( stream );
+      test_assert_NULL( ecl_grid_fread_cache( "TRUNCATED.CACHE" , "CASE.EGRID" ));
+    }
+    free( buffer );
+  }
+
+  {
+    ecl_grid_type * cached_grid = ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" );
+    test_assert_not_NULL( cached_grid );
+    ecl_grid_free( cached_grid );
+  }
+}
+
+
+/*
+  Only the modification time of the source file changes, e.g. when it
+  is copied; the full file is hashed and the cache is still valid.
+*/
+void test_touched_source() {
+  ecl::util::TestArea ta("grid_cache_touched");
+  ecl_grid_type * grid = alloc_grid( 7 );
+  ecl_grid_fwrite_EGRID2( grid , "CASE.EGRID" , ECL_METRIC_UNITS );
+  test_assert_true( ecl_grid_fwrite_cache( grid , "CASE.EGRID" , "CASE.CACHE" ));
+  {
+    struct utimbuf times;
+    times.actime = 1000000000;
+    times.modtime = 1000000000;
+    test_assert_int_equal( 0 , utime( "CASE.EGRID" , &times ));
+  }
+  {
+    ecl_grid_type * cached_grid = ecl_grid_fread_cache( "CASE.CACHE" , "CASE.EGRID" );
+    test_assert_not_NULL( cached_grid );
+    test_assert_true( ecl_grid_compare( grid , cached_grid , true , true , true ));
+    ecl_grid_free( cached_grid );
+  }
+  ecl_grid_free( grid );
+}
+
+
+void write_lgr_grid( ecl_egrid_writer_type * writer , const char * lgr_name , int lgr_nr , int nx , int ny , int nz , int host_cell) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , NULL );
+  ecl_kw_type * coord_kw = ecl_grid_alloc_coord_kw( grid );
+  ecl_kw_type * zcorn_kw = ecl_grid_alloc_zcorn_kw( grid );
+  ecl_kw_type * actnum_kw = ecl_grid_alloc_actnum_kw( grid );
+
+  if (lgr_name)
+    ecl_egrid_writer_begin_lgr( writer , lgr_name , NULL , lgr_nr , nx , ny , nz );
+  else
+    ecl_egrid_writer_begin_grid( writer , nx , ny , nz );
+
+  ecl_egrid_writer_add_coord( writer , ecl_kw_get_size( coord_kw ) , ecl_kw_get_float_ptr( coord_kw ));
+  ecl_egrid_writer_add_zcorn( writer , ecl_kw_get_size( zcorn_kw ) , ecl_kw_get_float_ptr( zcorn_kw ));
+  ecl_egrid_writer_add_actnum( writer , ecl_kw_get_size( actnum_kw ) , ecl_kw_get_int_ptr( actnum_kw ));
+  if (lgr_name) {
+    std::vector<int> hostnum( nx * ny * nz , host_cell + 1 );
+    ecl_egrid_writer_add_hostnum( writer , hostnum.size() , hostnum.data() );
+  }
+  ecl_egrid_writer_end_grid( writer );
+
+  ecl_kw_free( actnum_kw );
+  ecl_kw_free( zcorn_kw );
+  ecl_kw_free( coord_kw );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Overwrites four bytes at every offset in [begin, cache_size) with a
+  large and a negative value. The damaged caches must either give NULL
+  or a grid; an index read from the cache must never be used without
+  a bounds check.
+*/
+void test_damaged_cache( const char * cache_file , const char * source_file , size_t begin ) {
+  size_t cache_size = util_file_size( cache_file );
+  std::vector<char> buffer( cache_size );
+  {
+    FILE * stream = util_fopen( cache_file , "rb" );
+    util_fread( buffer.data() , 1 , cache_size , stream , __func__ );
+    fclose( stream );
+  }
+
+  for (int value : {0x7fffffff , -2}) {
+    for (size_t offset = begin; offset + sizeof value <= cache_size; offset++) {
+      std::vector<char> damaged = buffer;
+      memcpy( &damaged[offset] , &value , sizeof value );
+      {
+        FILE * stream = util_fopen( "DAMAGED.CACHE" , "wb" );
+        util_fwrite( damaged.data() , 1 , cache_size , stream , __func__ );
+        fclose( stream );
+      }
+      {
+        ecl_grid_type * grid = ecl_grid_fread_cache( "DAMAGED.CACHE" , source_file );
+        if (grid)
+          ecl_grid_free( grid );
+      }
+    }
+  }
+}
+
+
+void test_damaged_lgr_cache() {
+  ecl::util::TestArea ta("grid_cache_damaged_lgr");
+  {
+    ecl_egrid_writer_type * writer = ecl_egrid_writer_alloc( "LGR.EGRID" , ECL_METRIC_UNITS , NULL );
+    write_lgr_grid( writer , NULL , 0 , 4 , 4 , 1 , 0 );
+    write_lgr_grid( writer , "LGR1" , 1 , 2 , 2 , 1 , 5 );
+    ecl_egrid_writer_free( writer );
+  }
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "LGR.EGRID" );
+    test_assert_true( ecl_grid_fwrite_cache( grid , "LGR.EGRID" , "LGR.CACHE" ));
+    ecl_grid_free( grid );
+  }
+  test_damaged_cache( "LGR.CACHE" , "LGR.EGRID" , 0 );
+}
+
+
+/* The index maps and the nnc information are at the end of the file. */
+void test_damaged_nnc_cache() {
+  ecl::util::TestArea ta("grid_cache_damaged_nnc");
+  ecl_grid_type * grid = alloc_grid( 7 );
+  ecl_grid_fwrite_EGRID2( grid , "CASE.EGRID" , ECL_METRIC_UNITS );
+  test_assert_true( ecl_grid_fwrite_cache( grid , "CASE.EGRID" , "CASE.CACHE" ));
+  {
+    size_t tail = (ecl_grid_get_global_size( grid ) + ecl_grid_get_nactive( grid )) * sizeof(int) + 256;
+    test_damaged_cache( "CASE.CACHE" , "CASE.EGRID" , util_file_size( "CASE.CACHE" ) - tail );
+  }
+  ecl_grid_free( grid );
+}
+
+
+int main( int argc , char ** argv) {
+  test_cache_roundtrip();
+  test_truncated_cache();
+  test_touched_source();
+  test_damaged_lgr_cache();
+  test_damaged_nnc_cache();
+  exit(0);
+}
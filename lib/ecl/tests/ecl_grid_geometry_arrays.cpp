@@ -0,0 +1,182 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_geometry_arrays.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include <vector>
+#include <thread>
+
+#include <ert/util/test_util.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+
+ecl_grid_type * alloc_grid() {
+  int nx = 7, ny = 6, nz = 5;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+  std::vector<int> actnum(nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 50 * i;
+      pillar[1] = 40 * j;
+      pillar[2] = 1000;
+      pillar[3] = 50 * i + 2 * j;
+      pillar[4] = 40 * j + 3 * i;
+      pillar[5] = 1200;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++) {
+          int layer = k + c / 4;
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = 1050 + 10 * layer + 0.5 * (i + c % 2) + 0.25 * (j + (c % 4) / 2) * layer;
+        }
+
+  for (size_t g = 0; g < actnum.size(); g++)
+    actnum[g] = (g % 3) == 0 ? 0 : 1;
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), actnum.data(), true, NULL);
+}
+
+
+void test_arrays(const ecl_grid_type * grid) {
+  const double * volume = ecl_grid_get_volume_array(grid);
+  const double * center = ecl_grid_get_center_array(grid);
+  const double * depth = ecl_grid_get_depth_array(grid);
+  const double * thickness = ecl_grid_get_thickness_array(grid);
+
+  test_assert_ptr_equal(volume, ecl_grid_get_volume_array(grid));
+  for (int g = 0; g < ecl_grid_get_global_size(grid); g++) {
+    double x, y, z;
+    ecl_grid_get_xyz1(grid, g, &x, &y, &z);
+    test_assert_double_equal(center[3*g], x);
+    test_assert_double_equal(center[3*g + 1], y);
+    test_assert_double_equal(center[3*g + 2], z);
+    test_assert_double_equal(depth[g], ecl_grid_get_cdepth1(grid, g));
+    test_assert_double_equal(thickness[g], ecl_grid_get_cell_thickness1(grid, g));
+    test_assert_double_equal(volume[g], ecl_grid_get_cell_volume1(grid, g));
+  }
+
+  {
+    ecl_kw_type * volume_kw = ecl_grid_alloc_volume_kw(grid, true);
+    for (int a = 0; a < ecl_grid_get_active_size(grid); a++)
+      test_assert_double_equal(ecl_kw_iget_double(volume_kw, a), ecl_grid_get_cell_volume1A(grid, a));
+    ecl_kw_free(volume_kw);
+  }
+}
+
+
+void test_depth_only() {
+  ecl_grid_type * grid = alloc_grid();
+  int size = ecl_grid_get_global_size(grid);
+  const double * depth = ecl_grid_get_depth_array(grid);
+  size_t usage = ecl_grid_get_memory_usage(grid, ECL_GRID_MEMORY_GEOMETRY_ARRAYS);
+
+  test_assert_true(usage >= size * sizeof(double));
+  test_assert_true(usage < 2 * size * sizeof(double));
+  for (int g = 0; g < size; g++)
+    test_assert_double_equal(depth[g], ecl_grid_get_cdepth1(grid, g));
+
+  ecl_grid_free(grid);
+}
+
+
+void test_free_arrays() {
+  ecl_grid_type * grid = alloc_grid();
+  ecl_grid_get_volume_array(grid);
+  ecl_grid_get_bbox_array(grid);
+  ecl_grid_locate_depth(grid, 1075, 0, 0);
+  test_assert_true(ecl_grid_get_memory_usage(grid, ECL_GRID_MEMORY_GEOMETRY_ARRAYS) > 0);
+
+  ecl_grid_free_geometry_arrays(grid);
+  test_assert_size_t_equal(0, ecl_grid_get_memory_usage(grid, ECL_GRID_MEMORY_GEOMETRY_ARRAYS));
+  test_arrays(grid);
+  ecl_grid_free(grid);
+}
+
+
+void test_threads() {
+  ecl_grid_type * grid = alloc_grid();
+  std::vector<const double *> depth(8);
+  std::vector<std::thread> threads;
+
+  for (size_t t = 0; t < depth.size(); t++)
+    threads.emplace_back([grid, &depth, t]() {
+        ecl_grid_get_volume_array(grid);
+        ecl_grid_get_center_array(grid);
+        ecl_grid_get_thickness_array(grid);
+        depth[t] = ecl_grid_get_depth_array(grid);
+      });
+
+  for (auto& thread : threads)
+    thread.join();
+
+  for (size_t t = 1; t < depth.size(); t++)
+    test_assert_ptr_equal(depth[0], depth[t]);
+  test_arrays(grid);
+  ecl_grid_free(grid);
+}
+
+
+void test_distance(const ecl_grid_type * grid) {
+  int size = ecl_grid_get_global_size(grid);
+  std::vector<int> index1(size), index2(size);
+  std::vector<double> dx(size), dy(size), dz(size), distance(size);
+
+  for (int g = 0; g < size; g++) {
+    index1[g] = g;
+    index2[g] = (7 * g + 3) % size;
+  }
+
+  ecl_grid_get_distance_list(grid, size, index1.data(), index2.data(), dx.data(), dy.data(), dz.data(), distance.data());
+  for (int g = 0; g < size; g++) {
+    double x, y, z;
+    ecl_grid_get_distance(grid, index1[g], index2[g], &x, &y, &z);
+    test_assert_double_equal(x, dx[g]);
+    test_assert_double_equal(y, dy[g]);
+    test_assert_double_equal(z, dz[g]);
+    test_assert_double_equal(sqrt(x*x + y*y + z*z), distance[g]);
+  }
+
+  ecl_grid_get_distance_one_to_many(grid, 17, size, index2.data(), NULL, NULL, dz.data(), distance.data());
+  for (int g = 0; g < size; g++) {
+    double x, y, z;
+    ecl_grid_get_distance(grid, 17, index2[g], &x, &y, &z);
+    test_assert_double_equal(z, dz[g]);
+    test_assert_double_equal(sqrt(x*x + y*y + z*z), distance[g]);
+  }
+}
+
+
+int main(int argc, char ** argv) {
+  ecl_grid_type * grid = alloc_grid();
+  test_arrays(grid);
+  test_distance(grid);
+  ecl_grid_free(grid);
+
+  test_depth_only();
+  test_free_arrays();
+  test_threads();
+  exit(0);
+}
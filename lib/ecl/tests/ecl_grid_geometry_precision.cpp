@@ -0,0 +1,251 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_geometry_precision.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+/*
+  This test compares the cell centers and volumes from the grid with
+  a double precision reference calculated directly from COORD and
+  ZCORN. When the library is compiled with ERT_GRID_FLOAT_GEOMETRY the
+  difference is the error from storing the cell corners as float
+  offsets from the grid origin; the differences are printed to stdout.
+  Since the offsets are small also a grid at UTM coordinates should be
+  accurate to well below a millimeter.
+*/
+
+struct geometry_diff {
+  double center;
+  double volume;
+};
+
+
+static void reference_corners(const float * coord, const float * zcorn, const double * mapaxes,
+                              int nx, int ny, int i, int j, int k,
+                              double * x, double * y, double * z) {
+  for (int c = 0; c < 8; c++) {
+    int pillar = (j + (c % 4) / 2) * (nx + 1) + i + (c % 2);
+    const float * top = &coord[6 * pillar];
+    const float * bottom = &coord[6 * pillar + 3];
+    double t = 0;
+
+    z[c] = zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)];
+    if (bottom[2] != top[2])
+      t = (z[c] - top[2]) / (bottom[2] - top[2]);
+
+    x[c] = top[0] + t * (bottom[0] - top[0]);
+    y[c] = top[1] + t * (bottom[1] - top[1]);
+
+    if (mapaxes) {
+      double unit_y[2] = {mapaxes[0] - mapaxes[2], mapaxes[1] - mapaxes[3]};
+      double unit_x[2] = {mapaxes[4] - mapaxes[2], mapaxes[5] - mapaxes[3]};
+      double norm_x = 1.0 / sqrt(unit_x[0]*unit_x[0] + unit_x[1]*unit_x[1]);
+      double norm_y = 1.0 / sqrt(unit_y[0]*unit_y[0] + unit_y[1]*unit_y[1]);
+      double x0 = x[c];
+      double y0 = y[c];
+
+      x[c] = mapaxes[2] + x0 * unit_x[0] * norm_x + y0 * unit_y[0] * norm_y;
+      y[c] = mapaxes[3] + x0 * unit_x[1] * norm_x + y0 * unit_y[1] * norm_y;
+    }
+  }
+}
+
+
+static double triple_product(const double * a, const double * b, const double * c) {
+  return a[0] * (b[1]*c[2] - b[2]*c[1]) - a[1] * (b[0]*c[2] - b[2]*c[0]) + a[2] * (b[0]*c[1] - b[1]*c[0]);
+}
+
+/*
+  Volume of the trilinear hexahedron. The determinant of the jacobian
+  is a polynomial of degree two in each of the local coordinates, so
+  2x2x2 point Gauss quadrature is exact.
+*/
+static double reference_volume(const double * x, const double * y, const double * z) {
+  const double gauss[2] = {0.5 - 0.5 / sqrt(3.0), 0.5 + 0.5 / sqrt(3.0)};
+  double volume = 0;
+
+  for (int iu = 0; iu < 2; iu++)
+    for (int iv = 0; iv < 2; iv++)
+      for (int iw = 0; iw < 2; iw++) {
+        double local[3] = {gauss[iu], gauss[iv], gauss[iw]};
+        double jacobian[3][3] = {{0,0,0}, {0,0,0}, {0,0,0}};
+
+        for (int c = 0; c < 8; c++) {
+          int corner[3] = {c % 2, (c % 4) / 2, c / 4};
+          for (int d = 0; d < 3; d++) {
+            double dN = 1;
+            for (int l = 0; l < 3; l++) {
+              if (l == d)
+                dN *= corner[l] ? 1 : -1;
+              else
+                dN *= corner[l] ? local[l] : 1 - local[l];
+            }
+            jacobian[d][0] += dN * x[c];
+            jacobian[d][1] += dN * y[c];
+            jacobian[d][2] += dN * z[c];
+          }
+        }
+        volume += triple_product(jacobian[0], jacobian[1], jacobian[2]) / 8;
+      }
+
+  return fabs(volume);
+}
+
+
+static geometry_diff compare_geometry(const char * name, const ecl_grid_type * grid) {
+  int nx = ecl_grid_get_nx(grid);
+  int ny = ecl_grid_get_ny(grid);
+  int nz = ecl_grid_get_nz(grid);
+  ecl_kw_type * coord_kw = ecl_grid_alloc_coord_kw(grid);
+  ecl_kw_type * zcorn_kw = ecl_grid_alloc_zcorn_kw(grid);
+  const float * coord = ecl_kw_get_float_ptr(coord_kw);
+  const float * zcorn = ecl_kw_get_float_ptr(zcorn_kw);
+  double mapaxes_data[6];
+  const double * mapaxes = NULL;
+  geometry_diff diff = {0, 0};
+
+  if (ecl_grid_use_mapaxes(grid)) {
+    ecl_grid_init_mapaxes_data_double(grid, mapaxes_data);
+    mapaxes = mapaxes_data;
+  }
+
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int g = ecl_grid_get_global_index3(grid, i, j, k);
+        double x[8], y[8], z[8];
+        double center[3] = {0, 0, 0};
+        double grid_center[3];
+
+        if (!ecl_grid_cell_valid1(grid, g))
+          continue;
+
+        reference_corners(coord, zcorn, mapaxes, nx, ny, i, j, k, x, y, z);
+        for (int c = 0; c < 8; c++) {
+          center[0] += x[c] / 8;
+          center[1] += y[c] / 8;
+          center[2] += z[c] / 8;
+        }
+
+        ecl_grid_get_xyz1(grid, g, &grid_center[0], &grid_center[1], &grid_center[2]);
+        for (int l = 0; l < 3; l++)
+          diff.center = util_double_max(diff.center, fabs(center[l] - grid_center[l]));
+
+        {
+          // Pinched out cells have a volume of pure roundoff, and are skipped.
+          double volume = reference_volume(x, y, z);
+          if (volume > 1e-3) {
+            double rel_diff = fabs(volume - ecl_grid_get_cell_volume1(grid, g)) / volume;
+            diff.volume = util_double_max(diff.volume, rel_diff);
+          }
+        }
+      }
+    }
+  }
+  printf("%-50s  float geometry: %d   max center diff: %12.6g   max relative volume diff: %12.6g\n",
+         name, ecl_grid_use_float_geometry(), diff.center, diff.volume);
+
+  ecl_kw_free(coord_kw);
+  ecl_kw_free(zcorn_kw);
+  return diff;
+}
+
+
+/*
+  Skewed pillars, and a rotation with MAPAXES to put the grid at UTM
+  coordinates.
+*/
+static ecl_grid_type * alloc_utm_grid() {
+  int nx = 6, ny = 5, nz = 4;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+  float mapaxes[6];
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 75.25 * i;
+      pillar[1] = 61.75 * j;
+      pillar[2] = 1500;
+      pillar[3] = 75.25 * i + 3.5 * j;
+      pillar[4] = 61.75 * j + 2.25 * i;
+      pillar[5] = 1800;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++) {
+          int layer = k + c / 4;
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = 1600 + 12.5 * layer + 0.75 * (i + c % 2) + 0.5 * (j + (c % 4) / 2);
+        }
+
+  {
+    double angle = 0.35;
+    mapaxes[2] = 456123.37;
+    mapaxes[3] = 6780345.11;
+    mapaxes[0] = mapaxes[2] - 1000 * sin(angle);
+    mapaxes[1] = mapaxes[3] + 1000 * cos(angle);
+    mapaxes[4] = mapaxes[2] + 1000 * cos(angle);
+    mapaxes[5] = mapaxes[3] + 1000 * sin(angle);
+  }
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, true, mapaxes);
+}
+
+
+static void check_diff(const geometry_diff& diff, double center_tolerance, double volume_tolerance) {
+  if (ecl_grid_use_float_geometry()) {
+    test_assert_true(diff.center < center_tolerance);
+    test_assert_true(diff.volume < volume_tolerance);
+  } else {
+    test_assert_true(diff.center < 1e-6);
+    test_assert_true(diff.volume < 1e-6);
+  }
+}
+
+
+int main(int argc, char ** argv) {
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular(10, 10, 10, 1, 2, 3, NULL);
+    check_diff(compare_geometry("rectangular", grid), 1e-6, 1e-9);
+    ecl_grid_free(grid);
+  }
+
+  {
+    ecl_grid_type * grid = alloc_utm_grid();
+    check_diff(compare_geometry("utm", grid), 1e-3, 1e-4);
+    ecl_grid_free(grid);
+  }
+
+  for (int iarg = 1; iarg < argc; iarg++) {
+    ecl_grid_type * grid = ecl_grid_alloc_EGRID(argv[iarg], false);
+    check_diff(compare_geometry(argv[iarg], grid), 1e-3, 1e-4);
+    ecl_grid_free(grid);
+  }
+  exit(0);
+}
@@ -0,0 +1,98 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_locate_depth.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+
+#include <ert/ecl/ecl_grid.hpp>
+
+
+/*
+  Layers of varying thickness, and in column (1,1) the bottom of layer
+  2 is above the bottom of layer 1.
+*/
+ecl_grid_type * alloc_grid(int nx, int ny, int nz) {
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 100 + 10 * i;
+      pillar[1] = 100 + 10 * j;
+      pillar[2] = 1000;
+      pillar[3] = 100 + 10 * i;
+      pillar[4] = 100 + 10 * j;
+      pillar[5] = 2000;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++) {
+          int layer = k + c / 4;
+          double z = 1500 + 3 * layer + ((i + j + layer) % 3 == 0 ? 1 : 0) + 0.25 * (c % 2);
+          if (i == 1 && j == 1 && k == 2 && c >= 4)
+            z -= 4;
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = z;
+        }
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, true, NULL);
+}
+
+
+/* The linear scan from the top of the column. */
+int locate_depth(const ecl_grid_type * grid, double depth, int i, int j) {
+  int nz = ecl_grid_get_nz(grid);
+  if (depth < ecl_grid_get_top2(grid, i, j))
+    return -1;
+
+  if (depth >= ecl_grid_get_bottom2(grid, i, j))
+    return -1 * nz;
+
+  double bottom = ecl_grid_get_top3(grid, i, j, 0);
+  for (int k = 0; k < nz; k++) {
+    double top = bottom;
+    bottom = ecl_grid_get_bottom3(grid, i, j, k);
+    if (depth >= top && depth < bottom)
+      return k;
+  }
+  return -2;
+}
+
+
+int main(int argc, char ** argv) {
+  int nx = 4, ny = 3, nz = 8;
+  ecl_grid_type * grid = alloc_grid(nx, ny, nz);
+
+  for (int j = 0; j < ny; j++)
+    for (int i = 0; i < nx; i++)
+      for (double depth = 1490; depth < 1550; depth += 0.125)
+        test_assert_int_equal(locate_depth(grid, depth, i, j), ecl_grid_locate_depth(grid, depth, i, j));
+
+  test_assert_int_equal(-1, ecl_grid_locate_depth(grid, 0, 0, 0));
+  test_assert_int_equal(-nz, ecl_grid_locate_depth(grid, 5000, 0, 0));
+  test_assert_int_equal(0, ecl_grid_locate_depth(grid, ecl_grid_get_top3(grid, 2, 2, 0), 2, 2));
+  test_assert_int_equal(1, ecl_grid_locate_depth(grid, ecl_grid_get_bottom3(grid, 2, 2, 0), 2, 2));
+
+  ecl_grid_free(grid);
+  exit(0);
+}
@@ -0,0 +1,194 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_mesh.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid_mesh.hpp>
+
+
+static const int vtk_corner_order[8] = {0,1,3,2,4,5,7,6};
+
+/*
+  Every cell corner must be found as the corresponding vertex of the
+  mesh.
+*/
+void assert_corners( const ecl_grid_type * grid , const ecl_grid_mesh_type * mesh ) {
+  const float * vertices = ecl_grid_mesh_get_vertices( mesh );
+  const int * connectivity = ecl_grid_mesh_get_connectivity( mesh );
+  const int * global_index = ecl_grid_mesh_get_global_index( mesh );
+  double origin[3];
+
+  ecl_grid_mesh_get_origin( mesh , origin );
+  for (int cell = 0; cell < ecl_grid_mesh_get_num_cells( mesh ); cell++) {
+    for (int c = 0; c < 8; c++) {
+      double xyz[3];
+      int vertex = connectivity[8 * cell + vtk_corner_order[c]];
+      test_assert_true( vertex >= 0 && vertex < ecl_grid_mesh_get_num_vertices( mesh ));
+      ecl_grid_get_cell_corner_xyz1( grid , global_index[cell] , c , &xyz[0] , &xyz[1] , &xyz[2] );
+      for (int l = 0; l < 3; l++)
+        test_assert_double_equal( xyz[l] , origin[l] + vertices[3 * vertex + l] );
+    }
+  }
+}
+
+
+void test_rectangular() {
+  std::vector<int> actnum(4 * 3 * 2 , 1);
+  actnum[0] = 0;
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 4 , 3 , 2 , 10 , 10 , 5 , actnum.data() );
+  ecl_grid_mesh_type * mesh = ecl_grid_mesh_alloc( grid , NULL );
+
+  test_assert_true( ecl_grid_mesh_is_instance( mesh ));
+  test_assert_int_equal( 23 , ecl_grid_mesh_get_num_cells( mesh ));
+  /* The top vertex on the first pillar only belongs to the inactive cell. */
+  test_assert_int_equal( 5 * 4 * 3 - 1 , ecl_grid_mesh_get_num_vertices( mesh ));
+  assert_corners( grid , mesh );
+  {
+    double origin[3];
+    ecl_grid_mesh_get_origin( mesh , origin );
+    test_assert_double_equal( 0 , origin[0] );
+    test_assert_double_equal( 0 , origin[1] );
+    test_assert_double_equal( 0 , origin[2] );
+  }
+
+  {
+    ecl_kw_type * active_kw = ecl_kw_alloc( "PORO" , 23 , ECL_FLOAT );
+    ecl_kw_type * global_kw = ecl_kw_alloc( "SATNUM" , 24 , ECL_INT );
+    for (int i = 0; i < 23; i++)
+      ecl_kw_iset_float( active_kw , i , 0.5 * i );
+    for (int i = 0; i < 24; i++)
+      ecl_kw_iset_int( global_kw , i , i );
+
+    ecl_grid_mesh_add_kw( mesh , active_kw );
+    ecl_grid_mesh_add_kw( mesh , global_kw );
+    test_assert_int_equal( 2 , ecl_grid_mesh_get_num_attributes( mesh ));
+    test_assert_string_equal( "SATNUM" , ecl_grid_mesh_iget_attribute_name( mesh , 1 ));
+    test_assert_NULL( ecl_grid_mesh_get_attribute( mesh , "PERMX" ));
+    {
+      const float * poro = ecl_grid_mesh_get_attribute( mesh , "PORO" );
+      const float * satnum = ecl_grid_mesh_get_attribute( mesh , "SATNUM" );
+      for (int cell = 0; cell < 23; cell++) {
+        test_assert_double_equal( 0.5 * cell , poro[cell] );
+        test_assert_double_equal( cell + 1 , satnum[cell] );
+      }
+    }
+    ecl_kw_free( global_kw );
+    ecl_kw_free( active_kw );
+  }
+
+  {
+    /* A keyword name which must be escaped in the XML header. */
+    ecl_kw_type * kw = ecl_kw_alloc( "K<&>\"" , 23 , ECL_FLOAT );
+    ecl_kw_scalar_set_float( kw , 1 );
+    ecl_grid_mesh_add_kw( mesh , kw );
+    ecl_kw_free( kw );
+  }
+
+  {
+    ecl::util::TestArea ta("grid_mesh");
+    ecl_grid_mesh_fwrite_vtu( mesh , "GRID.vtu" );
+    {
+      /* Appended data: origin, points, connectivity, offsets, types, global index and three attributes. */
+      size_t data_size = 9 * 8 + 3 * 8 + 59 * 12 + 23 * (32 + 4 + 1 + 4 + 4 + 4 + 4);
+      FILE * stream = util_fopen( "GRID.vtu" , "rb" );
+      char line[256];
+      bool escaped = false;
+      test_assert_not_NULL( fgets( line , sizeof line , stream ));
+      test_assert_string_equal( "<?xml version=\"1.0\"?>\n" , line );
+      while (fgets( line , sizeof line , stream ) && !strstr( line , "</CellData>" ))
+        if (strstr( line , "Name=\"K&lt;&amp;&gt;&quot;\"" ))
+          escaped = true;
+      test_assert_true( escaped );
+      fclose( stream );
+      test_assert_true( util_file_size( "GRID.vtu" ) > data_size );
+    }
+  }
+
+  ecl_grid_mesh_free( mesh );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Across the fault the cells do not share vertices.
+*/
+void test_fault() {
+  int nx = 2, ny = 1, nz = 1;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 456000 + 10 * i;
+      pillar[1] = 6780000 + 10 * j;
+      pillar[2] = 1900;
+      pillar[3] = 456000 + 10 * i;
+      pillar[4] = 6780000 + 10 * j;
+      pillar[5] = 2100;
+    }
+  }
+  for (int i = 0; i < nx; i++)
+    for (int c = 0; c < 8; c++)
+      zcorn[ecl_grid_zcorn_index__(nx, ny, i, 0, 0, c)] = 2000 + 5 * (c / 4) + 2.5 * i;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, false, NULL);
+    ecl_grid_mesh_type * mesh = ecl_grid_mesh_alloc( grid , NULL );
+    test_assert_int_equal( 16 , ecl_grid_mesh_get_num_vertices( mesh ));
+    assert_corners( grid , mesh );
+    ecl_grid_mesh_free( mesh );
+    ecl_grid_free( grid );
+  }
+}
+
+
+void test_region() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 10 , 10 , 5 , 1 , 1 , 1 , NULL );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  ecl_region_select_k1k2( region , 2 , 2 );
+  {
+    ecl_grid_mesh_type * mesh = ecl_grid_mesh_alloc_region( grid , region );
+    test_assert_int_equal( 100 , ecl_grid_mesh_get_num_cells( mesh ));
+    test_assert_int_equal( 11 * 11 * 2 , ecl_grid_mesh_get_num_vertices( mesh ));
+    assert_corners( grid , mesh );
+    {
+      double origin[3];
+      ecl_grid_mesh_get_origin( mesh , origin );
+      test_assert_double_equal( 2 , origin[2] );
+    }
+    ecl_grid_mesh_free( mesh );
+  }
+  ecl_region_free( region );
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  test_rectangular();
+  test_fault();
+  test_region();
+  exit(0);
+}
@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_path.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+
+#include <ert/ecl/ecl_grid.hpp>
+#include <ert/ecl/ecl_grid_path.hpp>
+
+
+/*
+  The cells along the path must be contiguous, and the midpoint
+  between entry and exit must be inside the cell.
+*/
+void assert_continuous( const ecl_grid_type * grid , const ecl_grid_path_type * path ) {
+  for (int c = 0; c < ecl_grid_path_get_size( path ); c++) {
+    const ecl_grid_path_cell_type * cell = ecl_grid_path_iget( path , c );
+    test_assert_true( cell->md_exit > cell->md_entry );
+    test_assert_true( ecl_grid_cell_contains_xyz1( grid , cell->global_index ,
+                                                   0.5 * (cell->entry[0] + cell->exit[0]),
+                                                   0.5 * (cell->entry[1] + cell->exit[1]),
+                                                   0.5 * (cell->entry[2] + cell->exit[2])));
+    if (c > 0) {
+      const ecl_grid_path_cell_type * prev = ecl_grid_path_iget( path , c - 1 );
+      test_assert_double_equal( prev->md_exit , cell->md_entry );
+      for (int l = 0; l < 3; l++)
+        test_assert_double_equal( prev->exit[l] , cell->entry[l] );
+    }
+  }
+}
+
+
+void test_vertical() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 5 , 5 , 10 , 1 , 1 , 1 , NULL );
+  double x[2] = {2.5 , 2.5};
+  double y[2] = {3.5 , 3.5};
+  double z[2] = {-1 , 11};
+  ecl_grid_path_type * path = ecl_grid_path_alloc( grid , 2 , x , y , z , NULL );
+
+  test_assert_true( ecl_grid_path_is_instance( path ));
+  test_assert_int_equal( 10 , ecl_grid_path_get_size( path ));
+  for (int k = 0; k < 10; k++) {
+    const ecl_grid_path_cell_type * cell = ecl_grid_path_iget( path , k );
+    test_assert_int_equal( ecl_grid_get_global_index3( grid , 2 , 3 , k ) , cell->global_index );
+    test_assert_double_equal( k , cell->entry[2] );
+    test_assert_double_equal( k + 1 , cell->exit[2] );
+    test_assert_double_equal( k + 1 , cell->md_entry );
+    test_assert_double_equal( k + 2 , cell->md_exit );
+    test_assert_false( cell->nnc );
+  }
+  assert_continuous( grid , path );
+  ecl_grid_path_free( path );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Starts inside the grid, bends exactly on a cell face and ends inside
+  the grid; measured depth is given explicitly.
+*/
+void test_bend() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 8 , 8 , 4 , 1 , 1 , 1 , NULL );
+  double x[3]  = {0.5 , 5.0 , 5.25};
+  double y[3]  = {0.5 , 0.5 , 6.5};
+  double z[3]  = {0.5 , 1.5 , 3.5};
+  double md[3] = {100 , 110 , 120};
+  ecl_grid_path_type * path = ecl_grid_path_alloc( grid , 3 , x , y , z , md );
+
+  assert_continuous( grid , path );
+  {
+    const ecl_grid_path_cell_type * first = ecl_grid_path_iget( path , 0 );
+    const ecl_grid_path_cell_type * last = ecl_grid_path_iget( path , ecl_grid_path_get_size( path ) - 1);
+    test_assert_int_equal( ecl_grid_get_global_index3( grid , 0 , 0 , 0 ) , first->global_index );
+    test_assert_int_equal( ecl_grid_get_global_index3( grid , 5 , 6 , 3 ) , last->global_index );
+    test_assert_double_equal( 100 , first->md_entry );
+    test_assert_double_equal( 120 , last->md_exit );
+  }
+  ecl_grid_path_free( path );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  Two blocks with a fault between i = 2 and i = 3, the right block is
+  thrown down by half a cell. The grid is moved away from the origin,
+  cells with a corner at (0,0) are regarded as invalid.
+*/
+ecl_grid_type * alloc_fault_grid() {
+  int nx = 6, ny = 1, nz = 4;
+  std::vector<float> coord(6 * (nx + 1) * (ny + 1));
+  std::vector<float> zcorn(8 * nx * ny * nz);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = 1000 + 10 * i;
+      pillar[1] = 2000 + 10 * j;
+      pillar[2] = 900;
+      pillar[3] = 1000 + 10 * i;
+      pillar[4] = 2000 + 10 * j;
+      pillar[5] = 1100;
+    }
+  }
+
+  for (int k = 0; k < nz; k++)
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        for (int c = 0; c < 8; c++)
+          zcorn[ecl_grid_zcorn_index__(nx, ny, i, j, k, c)] = 1000 + 5 * (k + c / 4) + (i >= 3 ? 2.5 : 0);
+
+  return ecl_grid_alloc_GRDECL_data(nx, ny, nz, zcorn.data(), coord.data(), NULL, true, NULL);
+}
+
+
+void test_fault( bool add_nnc ) {
+  ecl_grid_type * grid = alloc_fault_grid();
+  double x[2] = {995 , 1065};
+  double y[2] = {2005 , 2005};
+  double z[2] = {1006 , 1006};
+  const int expected[6][3] = {{0,0,1}, {1,0,1}, {2,0,1}, {3,0,0}, {4,0,0}, {5,0,0}};
+
+  if (add_nnc)
+    ecl_grid_add_self_nnc( grid , ecl_grid_get_global_index3( grid , 2 , 0 , 1 ) , ecl_grid_get_global_index3( grid , 3 , 0 , 0 ) , 0 );
+
+  {
+    ecl_grid_path_type * path = ecl_grid_path_alloc( grid , 2 , x , y , z , NULL );
+    test_assert_int_equal( 6 , ecl_grid_path_get_size( path ));
+    for (int c = 0; c < 6; c++) {
+      const ecl_grid_path_cell_type * cell = ecl_grid_path_iget( path , c );
+      test_assert_int_equal( ecl_grid_get_global_index3( grid , expected[c][0] , expected[c][1] , expected[c][2]) , cell->global_index );
+      test_assert_double_equal( 5 + 10 * c , cell->md_entry );
+      test_assert_bool_equal( add_nnc && c == 3 , cell->nnc );
+    }
+    assert_continuous( grid , path );
+    ecl_grid_path_free( path );
+  }
+  ecl_grid_free( grid );
+}
+
+
+void test_outside() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 4 , 4 , 4 , 1 , 1 , 1 , NULL );
+  double x[2] = {10 , 20};
+  double y[2] = {10 , 20};
+  double z[2] = {10 , 20};
+  ecl_grid_path_type * path = ecl_grid_path_alloc( grid , 2 , x , y , z , NULL );
+  test_assert_int_equal( 0 , ecl_grid_path_get_size( path ));
+  ecl_grid_path_free( path );
+
+  /* The first segment is outside the grid, the second goes down through column (0,0). */
+  {
+    double px[3] = {10 , 0.5 , 0.5};
+    double py[3] = {10 , 0.5 , 0.5};
+    double pz[3] = {-10 , -1 , 3.5};
+    double md[3] = {0 , 100 , 104.5};
+    path = ecl_grid_path_alloc( grid , 3 , px , py , pz , md );
+    test_assert_int_equal( 4 , ecl_grid_path_get_size( path ));
+    for (int k = 0; k < 4; k++)
+      test_assert_int_equal( ecl_grid_get_global_index3( grid , 0 , 0 , k ) , ecl_grid_path_iget( path , k )->global_index );
+    test_assert_double_equal( 101 , ecl_grid_path_iget( path , 0 )->md_entry );
+    assert_continuous( grid , path );
+    ecl_grid_path_free( path );
+  }
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  test_vertical();
+  test_bend();
+  test_fault( false );
+  test_fault( true );
+  test_outside();
+  exit(0);
+}
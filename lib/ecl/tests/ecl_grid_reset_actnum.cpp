@@ -19,11 +19,74 @@
 #include <stdbool.h>
 
 #include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
 
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/ecl_kw_magic.hpp>
 #include <ert/ecl/ecl_grid.hpp>
 
 
+void test_processed_copy( const ecl_grid_type * src , const int * actnum ) {
+  ecl_grid_type * copy = ecl_grid_alloc_processed_copy( src , NULL , actnum );
+  ecl_grid_type * reset = ecl_grid_alloc_copy( src );
 
+  ecl_grid_reset_actnum( reset , actnum );
+  test_assert_true( ecl_grid_compare( copy , reset , false , false , true ));
+  test_assert_int_equal( ecl_grid_get_nactive( reset ) , ecl_grid_get_nactive( copy ));
+  for (int a = 0; a < ecl_grid_get_nactive( copy ); a++)
+    test_assert_int_equal( ecl_grid_get_global_index1A( reset , a ) , ecl_grid_get_global_index1A( copy , a ));
+  for (int g = 0; g < ecl_grid_get_global_size( copy ); g++)
+    test_assert_double_equal( ecl_grid_get_cell_volume1( src , g ) , ecl_grid_get_cell_volume1( copy , g ));
+
+  ecl_grid_free( reset );
+  ecl_grid_free( copy );
+}
+
+
+/*
+  A 4x1x2 grid where the cells i in [0,1] form one coarse group; the
+  active index of the coarse group must follow repeated ACTNUM updates.
+*/
+void test_coarse() {
+  ecl::util::TestArea ta("reset_actnum");
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular( 4 , 1 , 2 , 1 , 1 , 1 , NULL );
+    const int corsnum[8] = {1, 1, 0, 0, 1, 1, 0, 0};
+    ecl_kw_type * corsnum_kw = ecl_kw_alloc_new( CORSNUM_KW , 8 , ECL_INT , corsnum );
+    ecl_grid_fwrite_EGRID2( grid , "COARSE.EGRID" , ECL_METRIC_UNITS );
+    {
+      fortio_type * fortio = fortio_open_append( "COARSE.EGRID" , false , ECL_ENDIAN_FLIP );
+      ecl_kw_fwrite( corsnum_kw , fortio );
+      fortio_fclose( fortio );
+    }
+    ecl_kw_free( corsnum_kw );
+    ecl_grid_free( grid );
+  }
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "COARSE.EGRID" );
+    const int actnum1[8] = {0, 0, 1, 1, 1, 0, 1, 1};
+    const int actnum2[8] = {1, 1, 0, 1, 1, 1, 1, 0};
+
+    test_assert_int_equal( 5 , ecl_grid_get_nactive( grid ));
+    for (int iter = 0; iter < 2; iter++) {
+      ecl_grid_reset_actnum( grid , actnum1 );
+      test_assert_int_equal( 5 , ecl_grid_get_nactive( grid ));
+      test_assert_int_equal( 2 , ecl_grid_get_active_index1( grid , 0 ));
+      test_assert_int_equal( 2 , ecl_grid_get_active_index1( grid , 5 ));
+      test_assert_int_equal( 3 , ecl_grid_get_active_index1( grid , 6 ));
+      test_assert_int_equal( 1 , ecl_coarse_cell_get_num_active( ecl_grid_iget_coarse_group( grid , 0 )));
+      test_assert_int_equal( 4 , ecl_grid_get_global_index1A( grid , 2 ));
+
+      ecl_grid_reset_actnum( grid , actnum2 );
+      test_assert_int_equal( 3 , ecl_grid_get_nactive( grid ));
+      test_assert_int_equal( 0 , ecl_grid_get_active_index1( grid , 5 ));
+      test_assert_int_equal( -1 , ecl_grid_get_active_index1( grid , 2 ));
+      test_assert_int_equal( 4 , ecl_coarse_cell_get_num_active( ecl_grid_iget_coarse_group( grid , 0 )));
+    }
+    ecl_grid_free( grid );
+  }
+}
 
 
 int main(int argc , char ** argv) {
@@ -59,7 +122,10 @@ int main(int argc , char ** argv) {
   test_assert_int_equal(  2 , ecl_grid_get_global_index1A( grid , 2 ));
 
 
-
+  test_processed_copy( grid , actnum2 );
+  test_processed_copy( grid , NULL );
   ecl_grid_free( grid );
+
+  test_coarse();
   exit(0);
 }
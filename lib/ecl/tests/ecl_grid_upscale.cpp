@@ -0,0 +1,202 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_upscale.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.hpp>
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_kw_magic.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+#include <ert/ecl/ecl_grid_upscale.hpp>
+
+
+/*
+  A 4x4x2 grid where the columns i in [0,1], j in [0,1] form coarse
+  group 1 and the columns i in [2,3], j in [0,1] form coarse group 2;
+  both over the two layers.
+*/
+ecl_grid_type * alloc_coarse_grid( const int * actnum ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 4 , 4 , 2 , 1 , 1 , 1 , actnum );
+  ecl_kw_type * corsnum_kw = ecl_kw_alloc( CORSNUM_KW , 32 , ECL_INT );
+
+  ecl_kw_scalar_set_int( corsnum_kw , 0 );
+  for (int k = 0; k < 2; k++)
+    for (int j = 0; j < 2; j++)
+      for (int i = 0; i < 4; i++)
+        ecl_kw_iset_int( corsnum_kw , ecl_grid_get_global_index3( grid , i , j , k ) , 1 + i / 2 );
+
+  ecl_grid_fwrite_EGRID2( grid , "COARSE.EGRID" , ECL_METRIC_UNITS );
+  {
+    fortio_type * fortio = fortio_open_append( "COARSE.EGRID" , false , ECL_ENDIAN_FLIP );
+    ecl_kw_fwrite( corsnum_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  ecl_kw_free( corsnum_kw );
+  ecl_grid_free( grid );
+  return ecl_grid_alloc( "COARSE.EGRID" );
+}
+
+
+void test_upscale() {
+  ecl_grid_type * grid = alloc_coarse_grid( NULL );
+  ecl_kw_type * porv_kw = ecl_kw_alloc( "PORV" , 32 , ECL_FLOAT );
+  ecl_kw_type * perm_kw = ecl_kw_alloc( "PERMX" , 32 , ECL_DOUBLE );
+  ecl_kw_type * satnum_kw = ecl_kw_alloc( "SATNUM" , 32 , ECL_INT );
+  test_assert_int_equal( 2 , ecl_grid_get_num_coarse_groups( grid ));
+
+  for (int g = 0; g < 32; g++) {
+    ecl_kw_iset_float( porv_kw , g , (g % 2) ? 1 : 3 );
+    ecl_kw_iset_double( perm_kw , g , g + 1 );
+    ecl_kw_iset_int( satnum_kw , g , 1 + g % 5 );
+  }
+
+  {
+    const ecl_kw_type * fine_kw[6] = {perm_kw , perm_kw , perm_kw , perm_kw , perm_kw , satnum_kw};
+    ecl_upscale_enum method[6] = {ECL_UPSCALE_PORV_MEAN , ECL_UPSCALE_SUM , ECL_UPSCALE_HARMONIC_MEAN ,
+                                  ECL_UPSCALE_MIN , ECL_UPSCALE_MAX , ECL_UPSCALE_MAX};
+    ecl_kw_type * coarse_kw[6];
+    ecl_grid_alloc_coarse_kw_list( grid , 6 , fine_kw , method , porv_kw , coarse_kw );
+
+    for (int ikw = 0; ikw < 6; ikw++) {
+      test_assert_int_equal( 2 , ecl_kw_get_size( coarse_kw[ikw] ));
+      test_assert_string_equal( ecl_kw_get_header( fine_kw[ikw] ) , ecl_kw_get_header( coarse_kw[ikw] ));
+      test_assert_true( ecl_type_is_double( ecl_kw_get_data_type( coarse_kw[ikw] )));
+    }
+
+    for (int group = 0; group < 2; group++) {
+      ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( grid , group );
+      const int * cells = ecl_coarse_cell_get_index_ptr( coarse_cell );
+      double pv_sum = 0 , pv_value = 0 , sum = 0 , inv_sum = 0;
+      double min = 1e9 , max = -1e9;
+      int satnum_max = 0;
+
+      test_assert_int_equal( 8 , ecl_coarse_cell_get_size( coarse_cell ));
+      for (int c = 0; c < 8; c++) {
+        double value = ecl_kw_iget_double( perm_kw , cells[c] );
+        double porv = ecl_kw_iget_float( porv_kw , cells[c] );
+        pv_sum += porv;
+        pv_value += porv * value;
+        sum += value;
+        inv_sum += 1.0 / value;
+        min = util_double_min( min , value );
+        max = util_double_max( max , value );
+        satnum_max = util_int_max( satnum_max , ecl_kw_iget_int( satnum_kw , cells[c] ));
+      }
+
+      test_assert_double_equal( pv_value / pv_sum , ecl_kw_iget_double( coarse_kw[0] , group ));
+      test_assert_double_equal( sum , ecl_kw_iget_double( coarse_kw[1] , group ));
+      test_assert_double_equal( 8 / inv_sum , ecl_kw_iget_double( coarse_kw[2] , group ));
+      test_assert_double_equal( min , ecl_kw_iget_double( coarse_kw[3] , group ));
+      test_assert_double_equal( max , ecl_kw_iget_double( coarse_kw[4] , group ));
+      test_assert_double_equal( satnum_max , ecl_kw_iget_double( coarse_kw[5] , group ));
+    }
+
+    for (int ikw = 0; ikw < 6; ikw++)
+      ecl_kw_free( coarse_kw[ikw] );
+  }
+
+  {
+    ecl_kw_type * coarse_kw = ecl_grid_alloc_coarse_kw( grid , porv_kw , NULL , ECL_UPSCALE_SUM );
+    test_assert_true( ecl_type_is_float( ecl_kw_get_data_type( coarse_kw )));
+    test_assert_double_equal( 16 , ecl_kw_iget_float( coarse_kw , 0 ));
+    test_assert_double_equal( 16 , ecl_kw_iget_float( coarse_kw , 1 ));
+    ecl_kw_free( coarse_kw );
+  }
+
+  ecl_kw_free( satnum_kw );
+  ecl_kw_free( perm_kw );
+  ecl_kw_free( porv_kw );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  With one inactive cell in each coarse group, and one inactive cell
+  outside the coarse groups. Keywords with one element for each active
+  cell only count the active cells, and each coarse group has one
+  active index.
+*/
+void test_upscale_active() {
+  int actnum[32];
+  for (int g = 0; g < 32; g++)
+    actnum[g] = 1;
+  actnum[0] = 0;        /* (0,0,0) in group 1 */
+  actnum[18] = 0;       /* (2,0,1) in group 2 */
+  actnum[12] = 0;       /* (0,3,0) not coarsened */
+  {
+    ecl_grid_type * grid = alloc_coarse_grid( actnum );
+    int nactive = ecl_grid_get_active_size( grid );
+    ecl_kw_type * active_kw = ecl_kw_alloc( "PERMA" , nactive , ECL_DOUBLE );
+    ecl_kw_type * porv_kw = ecl_kw_alloc( "PORV" , nactive , ECL_FLOAT );
+    ecl_kw_type * perm_kw = ecl_kw_alloc( "PERMX" , 32 , ECL_DOUBLE );
+
+    test_assert_int_equal( 2 + 15 , nactive );
+    for (int a = 0; a < nactive; a++) {
+      ecl_kw_iset_double( active_kw , a , 10 * a + 1 );
+      ecl_kw_iset_float( porv_kw , a , 2 );
+    }
+    for (int g = 0; g < 32; g++)
+      ecl_kw_iset_double( perm_kw , g , g + 1 );
+
+    {
+      const ecl_kw_type * fine_kw[4] = {active_kw , active_kw , active_kw , perm_kw};
+      ecl_upscale_enum method[4] = {ECL_UPSCALE_PORV_MEAN , ECL_UPSCALE_SUM , ECL_UPSCALE_HARMONIC_MEAN , ECL_UPSCALE_PORV_MEAN};
+      ecl_kw_type * coarse_kw[4];
+      ecl_grid_alloc_coarse_kw_list( grid , 4 , fine_kw , method , porv_kw , coarse_kw );
+
+      for (int group = 0; group < 2; group++) {
+        ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( grid , group );
+        const int * cells = ecl_coarse_cell_get_index_ptr( coarse_cell );
+        double value = ecl_kw_iget_double( active_kw , ecl_grid_get_active_index1( grid , cells[0] ));
+        double sum = 0;
+        int num_active = 0;
+
+        for (int c = 0; c < 8; c++) {
+          if (actnum[cells[c]]) {
+            sum += ecl_kw_iget_double( perm_kw , cells[c] );
+            num_active++;
+          }
+        }
+        test_assert_int_equal( 7 , num_active );
+        test_assert_double_equal( value , ecl_kw_iget_double( coarse_kw[0] , group ));
+        test_assert_double_equal( value , ecl_kw_iget_double( coarse_kw[1] , group ));
+        test_assert_double_equal( value , ecl_kw_iget_double( coarse_kw[2] , group ));
+        test_assert_double_equal( sum / num_active , ecl_kw_iget_double( coarse_kw[3] , group ));
+      }
+
+      for (int ikw = 0; ikw < 4; ikw++)
+        ecl_kw_free( coarse_kw[ikw] );
+    }
+
+    ecl_kw_free( perm_kw );
+    ecl_kw_free( porv_kw );
+    ecl_kw_free( active_kw );
+    ecl_grid_free( grid );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  ecl::util::TestArea ta("grid_upscale");
+  test_upscale();
+  test_upscale_active();
+  exit(0);
+}
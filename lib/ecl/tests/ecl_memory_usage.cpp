@@ -0,0 +1,135 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_memory_usage.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_file.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/fortio.h>
+
+
+size_t grid_component_sum( const ecl_grid_type * grid ) {
+  size_t usage = 0;
+  for (int c = ECL_GRID_MEMORY_CELLS; c <= ECL_GRID_MEMORY_VALUES; c++)
+    usage += ecl_grid_get_memory_usage( grid , (ecl_grid_memory_enum) c );
+  return usage;
+}
+
+
+void test_grid() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1 , 1 , NULL );
+  size_t total = ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_TOTAL );
+  size_t coord_size = ecl_grid_use_float_geometry() ? sizeof(float) : sizeof(double);
+
+  /* Eight corners with three coordinates for each cell. */
+  test_assert_true( ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_CELLS ) >= 1000 * 24 * coord_size );
+  test_assert_true( ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_INDEX_MAPS ) >= 2000 * sizeof(int) );
+  test_assert_size_t_equal( 0 , ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_NNC ));
+  test_assert_true( total > grid_component_sum( grid ));
+
+  {
+    size_t geometry = ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_GEOMETRY_ARRAYS );
+    ecl_grid_get_volume_array( grid );
+    test_assert_true( ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_GEOMETRY_ARRAYS ) >= geometry + 1000 * sizeof(double));
+    test_assert_true( ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_TOTAL ) > total );
+  }
+
+  ecl_grid_add_self_nnc( grid , 0 , 999 , 0 );
+  test_assert_true( ecl_grid_get_memory_usage( grid , ECL_GRID_MEMORY_NNC ) > 0 );
+  ecl_grid_free( grid );
+}
+
+
+void test_file() {
+  ecl::util::TestArea ta("memory_usage");
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "PRESSURE" , 10000 , ECL_FLOAT );
+    fortio_type * fortio = fortio_open_writer( "FILE.UNRST" , false , true );
+    ecl_kw_scalar_set_float( kw , 100 );
+    ecl_kw_fwrite( kw , fortio );
+    fortio_fclose( fortio );
+    ecl_kw_free( kw );
+  }
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "FILE.UNRST" , 0 );
+    size_t index = ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_INDEX );
+
+    test_assert_true( index > 0 );
+    test_assert_size_t_equal( 0 , ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_DATA ));
+
+    ecl_file_iget_kw( ecl_file , 0 );
+    test_assert_true( ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_DATA ) >= 10000 * sizeof(float));
+    test_assert_size_t_equal( index , ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_INDEX ));
+    test_assert_true( ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_TOTAL ) >=
+                      ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_INDEX ) +
+                      ecl_file_get_memory_usage( ecl_file , ECL_FILE_MEMORY_DATA ));
+    ecl_file_close( ecl_file );
+  }
+}
+
+
+void test_summary() {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , 0 , true , 10 , 10 , 10 );
+  ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+  const ecl::smspec_node * node = ecl_smspec_add_node( smspec , "FOPT" , "SM3" , 0.0 );
+  size_t smspec_usage = ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_SMSPEC );
+  size_t data_usage = ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA );
+
+  test_assert_true( smspec_usage > 0 );
+  test_assert_size_t_equal( 0 , ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_RESTART ));
+
+  for (int step = 0; step < 100; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step + 1 , step * 86400.0 );
+    ecl_sum_tstep_set_from_node( tstep , *node , step );
+  }
+  test_assert_true( ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ) >= data_usage + 100 * 2 * sizeof(float));
+  test_assert_true( ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_TOTAL ) >=
+                    ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_SMSPEC ) +
+                    ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ));
+
+  /* The column cache is off by default, and released when turned off. */
+  {
+    std::vector<double> fopt( 100 );
+    data_usage = ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA );
+    ecl_sum_init_double_vector( ecl_sum , "FOPT" , fopt.data() );
+    test_assert_size_t_equal( data_usage , ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ));
+
+    ecl_sum_set_column_cache( ecl_sum , true );
+    ecl_sum_init_double_vector( ecl_sum , "FOPT" , fopt.data() );
+    test_assert_true( ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ) >= data_usage + 100 * 2 * sizeof(float));
+    test_assert_double_equal( 99 , fopt[99] );
+
+    ecl_sum_set_column_cache( ecl_sum , false );
+    test_assert_size_t_equal( data_usage , ecl_sum_get_memory_usage( ecl_sum , ECL_SUM_MEMORY_DATA ));
+  }
+  ecl_sum_free( ecl_sum );
+}
+
+
+int main(int argc , char ** argv) {
+  test_grid();
+  test_file();
+  test_summary();
+  exit(0);
+}
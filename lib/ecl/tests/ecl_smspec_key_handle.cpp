@@ -0,0 +1,116 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_smspec_key_handle.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_smspec.hpp>
+
+#include "detail/ecl/ecl_smspec_key_table.hpp"
+
+
+const int num_wells = 500;
+const int num_steps = 5;
+
+
+void test_key_table() {
+  std::vector<std::string> keys;
+  std::vector<ecl::smspec_node> nodes;
+  ecl::smspec_key_table table;
+
+  for (int i = 0; i < 1000; i++) {
+    keys.push_back( "WOPR:W" + std::to_string(i) );
+    nodes.emplace_back( i , "WOPR" , ("W" + std::to_string(i)).c_str() , "SM3/DAY" , 0 , ":" );
+  }
+
+  test_assert_NULL( table.get( "WOPR:W0" ));
+  for (size_t i = 0; i < keys.size(); i++)
+    table.insert( keys[i] , &nodes[i] );
+  test_assert_int_equal( 1000 , table.size() );
+
+  for (size_t i = 0; i < keys.size(); i++)
+    test_assert_true( table.get( keys[i].c_str() ) == &nodes[i] );
+  test_assert_NULL( table.get( "WOPR:W1000" ));
+  test_assert_NULL( table.get( "WOPR:W" ));
+
+  /* Inserting an existing key replaces the node. */
+  table.insert( keys[7] , &nodes[8] );
+  test_assert_int_equal( 1000 , table.size() );
+  test_assert_true( table.get( "WOPR:W7" ) == &nodes[8] );
+}
+
+
+void test_handle() {
+  ecl::util::TestArea ta("key_handle");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  std::vector<const ecl::smspec_node *> nodes;
+
+  for (int well = 0; well < num_wells; well++)
+    nodes.push_back( ecl_sum_add_var( ecl_sum , "WOPR" , ("W" + std::to_string(well)).c_str() , 0 , "SM3/DAY" , 0.0 ));
+  nodes.push_back( ecl_sum_add_var( ecl_sum , "BPR" , NULL , 12 , "BARS" , 0.0 ));
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step + 1 , step * 86400.0 );
+    for (size_t i = 0; i < nodes.size(); i++)
+      ecl_sum_tstep_set_from_node( tstep , *nodes[i] , i * 100 + step );
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+
+  ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+  {
+    const ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+    ecl_smspec_key_handle_type handle;
+
+    test_assert_false( ecl_sum_init_key_handle( ecl_sum , "WOPR:NO_SUCH_WELL" , &handle ));
+    test_assert_false( ecl_sum_has_general_var( ecl_sum , "WOPR:NO_SUCH_WELL" ));
+
+    /* Both the general keys of a block variable: BPR:12 and BPR:2,2,1 */
+    test_assert_true( ecl_sum_init_key_handle( ecl_sum , "BPR:12" , &handle ));
+    test_assert_double_equal( num_wells * 100 + 3 , ecl_sum_iget_handle( ecl_sum , 3 , &handle ));
+    test_assert_true( ecl_sum_init_key_handle( ecl_sum , "BPR:2,2,1" , &handle ));
+    test_assert_double_equal( num_wells * 100 + 3 , ecl_sum_iget_handle( ecl_sum , 3 , &handle ));
+
+    for (int well = 0; well < num_wells; well++) {
+      std::string key = "WOPR:W" + std::to_string(well);
+      test_assert_true( ecl_smspec_init_key_handle( smspec , key.c_str() , &handle ));
+      test_assert_int_equal( ecl_sum_get_general_var_params_index( ecl_sum , key.c_str() ) , handle.params_index );
+
+      for (int step = 0; step < num_steps; step++) {
+        test_assert_double_equal( well * 100 + step , ecl_sum_iget_handle( ecl_sum , step , &handle ));
+        test_assert_double_equal( ecl_sum_get_general_var_from_sim_time( ecl_sum , ecl_sum_iget_sim_time( ecl_sum , step ) , key.c_str() ),
+                                  ecl_sum_get_handle_from_sim_time( ecl_sum , ecl_sum_iget_sim_time( ecl_sum , step ) , &handle ));
+      }
+    }
+  }
+  ecl_sum_free( ecl_sum );
+}
+
+
+int main(int argc , char ** argv) {
+  test_key_table();
+  test_handle();
+  exit(0);
+}
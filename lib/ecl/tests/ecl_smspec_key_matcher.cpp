@@ -0,0 +1,136 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_smspec_key_matcher.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+#include "detail/ecl/ecl_smspec_key_matcher.hpp"
+
+
+/*
+  The key_matcher must give the same result as util_fnmatch() for every
+  key, also when several patterns are combined.
+*/
+void test_matcher() {
+  std::vector<std::string> key_list = {"", "A", "AB", "BPR:1,1,1", "BPR:10", "BPR:12",
+                                       "FOPR", "FOPT", "FWPT", "RPR:2", "TIME",
+                                       "WOPR:OP_1", "WOPR:OP_10", "WOPR:OP_2", "WOPR:[X]",
+                                       "WWCT:OP_1", "WWCT:OP_2", "WWCT:INJ-1", "W*", "W\\X"};
+  std::sort( key_list.begin() , key_list.end() );
+
+  std::vector<const std::string *> keys;
+  for (const auto& key : key_list)
+    keys.push_back( &key );
+
+  std::vector<std::string> patterns = {"*", "", "A", "W*", "*:OP_1", "W???:OP_?", "WOPR:*", "*PT",
+                                       "BPR:1*", "[FR]*", "[!W]*", "[^W]*", "W[A-Z]*:OP_[0-9]", "*[]]",
+                                       "WOPR:[[]X]", "W\\*", "W\\\\X", "W[\\*]", "*:*:*", "?", "??*",
+                                       "*P*R*", "[[:digit:]]*", "*[[:alpha:]]", "WOPR:[X", "W*T:[a-z]*",
+                                       "[]-]*", "*[-]*"};
+
+  for (const auto& pattern : patterns) {
+    ecl::key_matcher matcher;
+    matcher.add_pattern( pattern.c_str() );
+    std::vector<bool> selected = matcher.select( keys );
+    for (size_t i = 0; i < keys.size(); i++) {
+      bool expected = (util_fnmatch( pattern.c_str() , keys[i]->c_str() ) == 0);
+      if (expected != selected[i])
+        test_error_exit("Pattern '%s' and key '%s': expected %d\n", pattern.c_str() , keys[i]->c_str() , expected);
+    }
+  }
+
+  for (size_t p1 = 0; p1 < patterns.size(); p1++) {
+    size_t p2 = (p1 * 7 + 3) % patterns.size();
+    ecl::key_matcher matcher;
+    matcher.add_pattern( patterns[p1].c_str() );
+    matcher.add_pattern( patterns[p2].c_str() );
+
+    std::vector<bool> selected = matcher.select( keys );
+    for (size_t i = 0; i < keys.size(); i++) {
+      bool expected = (util_fnmatch( patterns[p1].c_str() , keys[i]->c_str() ) == 0) ||
+                      (util_fnmatch( patterns[p2].c_str() , keys[i]->c_str() ) == 0);
+      test_assert_true( expected == selected[i] );
+    }
+  }
+}
+
+
+void test_smspec() {
+  ecl::util::TestArea ta("key_matcher");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+
+  ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+  ecl_sum_add_var( ecl_sum , "WOPR" , "OP_1" , 0 , "SM3/DAY" , 0.0 );
+  ecl_sum_add_var( ecl_sum , "WOPR" , "OP_2" , 0 , "SM3/DAY" , 0.0 );
+  ecl_sum_add_var( ecl_sum , "WWCT" , "OP_1" , 0 , "" , 0.0 );
+  ecl_sum_add_var( ecl_sum , "GOPR" , "G1" , 0 , "SM3/DAY" , 0.0 );
+
+  {
+    stringlist_type * keys = stringlist_alloc_new();
+    stringlist_type * patterns = stringlist_alloc_new();
+
+    /* The TIME key is only selected by patterns other than '*'. */
+    ecl_sum_select_matching_general_var_list( ecl_sum , "*" , keys );
+    test_assert_false( stringlist_contains( keys , "TIME" ));
+    test_assert_int_equal( 5 , stringlist_get_size( keys ));
+
+    stringlist_clear( keys );
+    stringlist_append_copy( patterns , "*:OP_1" );
+    stringlist_append_copy( patterns , "T*" );
+    stringlist_append_copy( patterns , "WOPR:*" );
+    ecl_sum_select_matching_general_var_patterns( ecl_sum , patterns , keys );
+    test_assert_int_equal( 4 , stringlist_get_size( keys ));
+    test_assert_string_equal( "TIME" , stringlist_iget( keys , 0 ));
+    test_assert_string_equal( "WOPR:OP_1" , stringlist_iget( keys , 1 ));
+    test_assert_string_equal( "WOPR:OP_2" , stringlist_iget( keys , 2 ));
+    test_assert_string_equal( "WWCT:OP_1" , stringlist_iget( keys , 3 ));
+
+    stringlist_free( patterns );
+    stringlist_free( keys );
+  }
+
+  {
+    stringlist_type * wells = ecl_sum_alloc_well_list( ecl_sum , "*_2" );
+    test_assert_int_equal( 1 , stringlist_get_size( wells ));
+    test_assert_string_equal( "OP_2" , stringlist_iget( wells , 0 ));
+    stringlist_free( wells );
+
+    wells = ecl_sum_alloc_well_list( ecl_sum , NULL );
+    test_assert_int_equal( 2 , stringlist_get_size( wells ));
+    stringlist_free( wells );
+  }
+
+  ecl_sum_free( ecl_sum );
+}
+
+
+int main(int argc , char ** argv) {
+  test_matcher();
+  test_smspec();
+  exit(0);
+}
@@ -0,0 +1,133 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_column_cache.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_file.hpp>
+
+
+const char * keys[] = {"BPR:1", "BPR:2", "BPR:3", "FOPT"};
+const int num_keys = 4;
+
+
+double value(int key, int step, double scale) {
+  return scale * (key + 1) * 1000 + step;
+}
+
+
+void write_case(int num_steps, double scale) {
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * nodes[num_keys];
+
+  for (int key = 0; key < 3; key++)
+    nodes[key] = ecl_sum_add_var( ecl_sum , "BPR" , NULL , key + 1 , "BARS" , 0.0 );
+  nodes[3] = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step / 5 + 1 , step * 86400.0 );
+    for (int key = 0; key < num_keys; key++)
+      ecl_sum_tstep_set_from_node( tstep , *nodes[key] , value( key , step , scale ));
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void verify_case(const ecl_sum_type * ecl_sum, int num_steps, double scale) {
+  std::vector<double> data(num_steps);
+
+  test_assert_int_equal( num_steps , ecl_sum_get_data_length( ecl_sum ));
+  for (int key = 0; key < num_keys; key++) {
+    int params_index = ecl_sum_get_general_var_params_index( ecl_sum , keys[key] );
+
+    ecl_sum_init_double_vector( ecl_sum , keys[key] , data.data() );
+    for (int step = 0; step < num_steps; step++) {
+      test_assert_double_equal( value( key , step , scale ) , data[step] );
+      test_assert_double_equal( value( key , step , scale ) , ecl_sum_iget( ecl_sum , step , params_index ));
+    }
+  }
+  test_assert_double_equal( num_steps - 1 , ecl_sum_get_sim_length( ecl_sum ));
+}
+
+
+void test_temporary_cache() {
+  ecl::util::TestArea ta("column_cache");
+  write_case( 50 , 1 );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , true , 0 );
+    verify_case( ecl_sum , 50 , 1 );
+    ecl_sum_free( ecl_sum );
+  }
+  test_assert_false( util_file_exists( "CASE.UNSMRY.cache" ));
+}
+
+
+void test_persistent_cache() {
+  ecl::util::TestArea ta("column_cache");
+  write_case( 50 , 1 );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , true , ECL_FILE_COLUMN_CACHE );
+    test_assert_false( util_file_exists( "CASE.UNSMRY.cache" ));
+    verify_case( ecl_sum , 50 , 1 );
+    test_assert_true( util_file_exists( "CASE.UNSMRY.cache" ));
+    ecl_sum_free( ecl_sum );
+  }
+
+  /* The existing cache is used. */
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , true , ECL_FILE_COLUMN_CACHE );
+    verify_case( ecl_sum , 50 , 1 );
+    ecl_sum_free( ecl_sum );
+  }
+
+  /* The summary file has changed - the cache must be rebuilt. */
+  write_case( 50 , 2 );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , true , ECL_FILE_COLUMN_CACHE );
+    verify_case( ecl_sum , 50 , 2 );
+    ecl_sum_free( ecl_sum );
+  }
+
+  write_case( 30 , 1 );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , true , ECL_FILE_COLUMN_CACHE );
+    verify_case( ecl_sum , 30 , 1 );
+    ecl_sum_free( ecl_sum );
+  }
+
+  /* The eager loader does not look at the cache. */
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case2__( "CASE" , ":" , false , false , 0 );
+    verify_case( ecl_sum , 30 , 1 );
+    ecl_sum_free( ecl_sum );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_temporary_cache();
+  test_persistent_cache();
+  exit(0);
+}
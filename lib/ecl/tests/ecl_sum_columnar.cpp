@@ -0,0 +1,141 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_columnar.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+
+const char * keys[] = {"BPR:1", "WOPR:OP_1", "WWCT:OP_2", "FOPT"};
+const int num_keys = 4;
+const int num_steps = 100;
+
+
+double value(int key, int step) {
+  return (key + 1) * 1000 + step * 0.5;
+}
+
+
+ecl_sum_type * write_case() {
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * nodes[num_keys];
+
+  nodes[0] = ecl_sum_add_var( ecl_sum , "BPR" , NULL , 1 , "BARS" , 0.0 );
+  nodes[1] = ecl_sum_add_var( ecl_sum , "WOPR" , "OP_1" , 0 , "SM3/DAY" , 0.0 );
+  nodes[2] = ecl_sum_add_var( ecl_sum , "WWCT" , "OP_2" , 0 , "" , 0.0 );
+  nodes[3] = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step / 10 + 1 , step * 43200.0 );
+    for (int key = 0; key < num_keys; key++)
+      ecl_sum_tstep_set_from_node( tstep , *nodes[key] , value( key , step ));
+  }
+  return ecl_sum;
+}
+
+
+void verify_case(const ecl_sum_type * ecl_sum, const ecl_sum_type * columnar) {
+  std::vector<double> data(num_steps);
+
+  test_assert_int_equal( num_steps , ecl_sum_get_data_length( columnar ));
+  test_assert_time_t_equal( ecl_sum_get_start_time( ecl_sum ) , ecl_sum_get_start_time( columnar ));
+  test_assert_false( ecl_sum_can_write( columnar ));
+
+  for (int step = 0; step < num_steps; step++) {
+    test_assert_time_t_equal( ecl_sum_iget_sim_time( ecl_sum , step ) , ecl_sum_iget_sim_time( columnar , step ));
+    test_assert_int_equal( ecl_sum_iget_report_step( ecl_sum , step ) , ecl_sum_iget_report_step( columnar , step ));
+  }
+  test_assert_int_equal( ecl_sum_get_first_report_step( ecl_sum ) , ecl_sum_get_first_report_step( columnar ));
+  test_assert_int_equal( ecl_sum_get_last_report_step( ecl_sum ) , ecl_sum_get_last_report_step( columnar ));
+
+  for (int key = 0; key < num_keys; key++) {
+    int params_index = ecl_sum_get_general_var_params_index( columnar , keys[key] );
+    const float * column = ecl_sum_get_vector_ptr( columnar , keys[key] );
+
+    test_assert_true( ecl_sum_has_key( columnar , keys[key] ));
+    test_assert_string_equal( ecl_sum_get_unit( ecl_sum , keys[key] ) , ecl_sum_get_unit( columnar , keys[key] ));
+    test_assert_true( column != NULL );
+
+    ecl_sum_init_double_vector( columnar , keys[key] , data.data() );
+    for (int step = 0; step < num_steps; step++) {
+      test_assert_double_equal( value( key , step ) , data[step] );
+      test_assert_double_equal( value( key , step ) , ecl_sum_iget( columnar , step , params_index ));
+      test_assert_double_equal( value( key , step ) , column[step] );
+    }
+  }
+  test_assert_false( ecl_sum_has_key( columnar , "WOPR:OP_3" ));
+}
+
+
+void test_columnar() {
+  ecl::util::TestArea ta("columnar");
+  ecl_sum_type * ecl_sum = write_case();
+
+  test_assert_true( ecl_sum_fwrite_columnar( ecl_sum , "CASE.CSUM" , false ));
+  test_assert_true( ecl_sum_fwrite_columnar( ecl_sum , "CASE_Z.CSUM" , true ));
+  test_assert_true( util_file_size( "CASE_Z.CSUM" ) <= util_file_size( "CASE.CSUM" ));
+  {
+    ecl_sum_type * columnar = ecl_sum_fread_alloc_columnar( "CASE.CSUM" , ":" );
+    test_assert_not_NULL( columnar );
+    verify_case( ecl_sum , columnar );
+    ecl_sum_free( columnar );
+  }
+  {
+    ecl_sum_type * columnar = ecl_sum_fread_alloc_columnar( "CASE_Z.CSUM" , ":" );
+    test_assert_not_NULL( columnar );
+    verify_case( ecl_sum , columnar );
+    ecl_sum_free( columnar );
+  }
+
+  /* A columnar case can be written again. */
+  {
+    ecl_sum_type * columnar = ecl_sum_fread_alloc_columnar( "CASE.CSUM" , ":" );
+    test_assert_true( ecl_sum_fwrite_columnar( columnar , "CASE2.CSUM" , false ));
+    ecl_sum_free( columnar );
+
+    columnar = ecl_sum_fread_alloc_columnar( "CASE2.CSUM" , ":" );
+    verify_case( ecl_sum , columnar );
+    ecl_sum_free( columnar );
+  }
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_invalid_file() {
+  ecl::util::TestArea ta("columnar_invalid");
+  {
+    FILE * stream = util_fopen( "INVALID.CSUM" , "w" );
+    fprintf( stream , "This is not a summary file\n" );
+    fclose( stream );
+  }
+  test_assert_NULL( ecl_sum_fread_alloc_columnar( "INVALID.CSUM" , ":" ));
+  test_assert_NULL( ecl_sum_fread_alloc_columnar( "DOES_NOT_EXIST.CSUM" , ":" ));
+}
+
+
+int main(int argc , char ** argv) {
+  test_columnar();
+  test_invalid_file();
+  exit(0);
+}
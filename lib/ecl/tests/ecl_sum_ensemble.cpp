@@ -0,0 +1,135 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_ensemble.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_ensemble.hpp>
+
+
+const int num_steps = 20;
+
+
+double value(int iens, int key, int step) {
+  return iens * 10000 + key * 1000 + step;
+}
+
+
+/*
+  Realization @iens is written to REAL_<iens>/CASE; the realization with
+  @extra_key has an additional vector, and a different SMSPEC file.
+*/
+void write_case(int iens, bool extra_key) {
+  std::string path = "REAL_" + std::to_string(iens);
+  std::string ecl_case = path + "/CASE";
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+
+  util_make_path( path.c_str() );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( ecl_case.c_str() , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * nodes[3];
+
+  nodes[0] = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+  nodes[1] = ecl_sum_add_var( ecl_sum , "WOPR" , "OP_1" , 0 , "SM3/DAY" , 0.0 );
+  nodes[2] = extra_key ? ecl_sum_add_var( ecl_sum , "WWCT" , "OP_1" , 0 , "" , 0.0 ) : NULL;
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step + 1 , (step + 1) * 86400.0 );
+    for (int key = 0; key < 3; key++)
+      if (nodes[key])
+        ecl_sum_tstep_set_from_node( tstep , *nodes[key] , value( iens , key , step ));
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_ensemble() {
+  ecl::util::TestArea ta("ensemble");
+  const int num_cases = 6;
+  stringlist_type * cases = stringlist_alloc_new();
+
+  for (int iens = 0; iens < num_cases; iens++) {
+    write_case( iens , iens == 3 );
+    stringlist_append_copy( cases , ("REAL_" + std::to_string(iens) + "/CASE").c_str() );
+  }
+  stringlist_append_copy( cases , "REAL_MISSING/CASE" );
+
+  ecl_sum_ensemble_type * ensemble = ecl_sum_ensemble_fread_alloc( cases , ":" , true , true , 0 );
+  test_assert_true( ecl_sum_ensemble_is_instance( ensemble ));
+  test_assert_int_equal( num_cases + 1 , ecl_sum_ensemble_get_size( ensemble ));
+  test_assert_NULL( ecl_sum_ensemble_iget( ensemble , num_cases ));
+  test_assert_int_equal( 2 , ecl_sum_ensemble_get_num_smspec( ensemble ));
+  test_assert_true( ecl_sum_get_smspec( ecl_sum_ensemble_iget( ensemble , 0 )) == ecl_sum_get_smspec( ecl_sum_ensemble_iget( ensemble , 5 )));
+  test_assert_true( ecl_sum_same_case( ecl_sum_ensemble_iget( ensemble , 5 ) , "REAL_5/CASE" ));
+  test_assert_false( ecl_sum_same_case( ecl_sum_ensemble_iget( ensemble , 5 ) , "REAL_0/CASE" ));
+
+  {
+    stringlist_type * keys = stringlist_alloc_new();
+    stringlist_append_copy( keys , "FOPT" );
+    stringlist_append_copy( keys , "WOPR:OP_1" );
+    stringlist_append_copy( keys , "WWCT:OP_1" );
+
+    {
+      std::vector<double> cube((num_cases + 1) * num_steps * 3);
+      test_assert_true( ecl_sum_ensemble_init_double_cube( ensemble , keys , NULL , cube.data() ));
+      for (int iens = 0; iens < num_cases + 1; iens++)
+        for (int step = 0; step < num_steps; step++)
+          for (int key = 0; key < 3; key++) {
+            double v = cube[(iens * num_steps + step) * 3 + key];
+            if (iens == num_cases || (key == 2 && iens != 3))
+              test_assert_true( isnan( v ));
+            else
+              test_assert_double_equal( value( iens , key , step ) , v );
+          }
+    }
+
+    {
+      time_t_vector_type * time_points = time_t_vector_alloc( 0 , 0 );
+      time_t start_time = ecl_sum_get_start_time( ecl_sum_ensemble_iget( ensemble , 0 ));
+      time_t_vector_append( time_points , start_time + 36 * 3600 );
+      time_t_vector_append( time_points , start_time + 6 * 86400 );
+
+      std::vector<double> cube((num_cases + 1) * 2 * 3);
+      test_assert_true( ecl_sum_ensemble_init_double_cube( ensemble , keys , time_points , cube.data() ));
+      for (int iens = 0; iens < num_cases; iens++) {
+        /* FOPT is interpolated, WOPR is a rate. */
+        test_assert_double_equal( value( iens , 0 , 0 ) + 0.5 , cube[(iens * 2 + 0) * 3 + 0] );
+        test_assert_double_equal( value( iens , 1 , 1 ) , cube[(iens * 2 + 0) * 3 + 1] );
+        test_assert_double_equal( value( iens , 0 , 5 ) , cube[(iens * 2 + 1) * 3 + 0] );
+      }
+      time_t_vector_free( time_points );
+    }
+    stringlist_free( keys );
+  }
+
+  ecl_sum_ensemble_free( ensemble );
+  stringlist_free( cases );
+}
+
+
+int main(int argc , char ** argv) {
+  test_ensemble();
+  exit(0);
+}
@@ -0,0 +1,155 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_frame.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_vector.hpp>
+
+
+/*
+  More wells than one block of keywords in the frame extraction; every
+  well has one rate (WOPR) and one state (WBHP) vector.
+*/
+const int num_wells = 100;
+const int num_steps = 150;
+
+
+double value(int var, int step) {
+  return var * 1000 + step;
+}
+
+
+void write_case() {
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  std::vector<const ecl::smspec_node *> nodes;
+
+  for (int well = 0; well < num_wells; well++) {
+    std::string wname = "W" + std::to_string(well);
+    nodes.push_back( ecl_sum_add_var( ecl_sum , "WOPR" , wname.c_str() , 0 , "SM3/DAY" , 0.0 ));
+    nodes.push_back( ecl_sum_add_var( ecl_sum , "WBHP" , wname.c_str() , 0 , "BARS" , 0.0 ));
+  }
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step / 10 + 1 , (step + 1) * 86400.0 );
+    for (size_t var = 0; var < nodes.size(); var++)
+      ecl_sum_tstep_set_from_node( tstep , *nodes[var] , value( var , step ));
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void verify_frame(const ecl_sum_type * ecl_sum) {
+  ecl_sum_vector_type * keywords = ecl_sum_vector_alloc( ecl_sum , true );
+  const int num_keywords = ecl_sum_vector_get_size( keywords );
+  const int length = ecl_sum_get_data_length( ecl_sum );
+  test_assert_int_equal( 2 * num_wells , num_keywords );
+
+  {
+    std::vector<double> frame(num_keywords * length);
+    ecl_sum_init_double_frame( ecl_sum , keywords , frame.data() );
+    for (int time_index = 0; time_index < length; time_index++)
+      for (int key_index = 0; key_index < num_keywords; key_index++) {
+        int params_index = ecl_sum_vector_iget_param_index( keywords , key_index );
+        test_assert_double_equal( ecl_sum_iget( ecl_sum , time_index , params_index ) , frame[time_index * num_keywords + key_index] );
+      }
+  }
+
+  {
+    time_t start_time = ecl_sum_get_data_start( ecl_sum );
+    time_t_vector_type * time_points = time_t_vector_alloc( 0 , 0 );
+    for (int hour = -24; hour < 24 * (num_steps + 3); hour += 7)
+      time_t_vector_append( time_points , start_time + hour * 3600 );
+
+    std::vector<double> frame(num_keywords * time_t_vector_size( time_points ));
+    ecl_sum_init_double_frame_interp( ecl_sum , keywords , time_points , frame.data() );
+    for (int time_index = 0; time_index < time_t_vector_size( time_points ); time_index++) {
+      time_t sim_time = time_t_vector_iget( time_points , time_index );
+
+      for (int key_index = 0; key_index < num_keywords; key_index++) {
+        const char * key = ecl_sum_vector_iget_key( keywords , key_index );
+        double expected;
+
+        if (sim_time < start_time || sim_time > ecl_sum_get_end_time( ecl_sum )) {
+          if (ecl_sum_vector_iget_is_rate( keywords , key_index ))
+            expected = 0;
+          else if (sim_time < start_time)
+            expected = ecl_sum_get_first_value_gen_key( ecl_sum , key );
+          else
+            expected = ecl_sum_get_last_value_gen_key( ecl_sum , key );
+        } else
+          expected = ecl_sum_get_general_var_from_sim_time( ecl_sum , sim_time , key );
+
+        test_assert_double_equal( expected , frame[time_index * num_keywords + key_index] );
+      }
+    }
+    time_t_vector_free( time_points );
+  }
+  ecl_sum_vector_free( keywords );
+}
+
+
+/*
+  The time points do not need to be sorted.
+*/
+void verify_vector_interp(const ecl_sum_type * ecl_sum) {
+  time_t start_time = ecl_sum_get_data_start( ecl_sum );
+  time_t_vector_type * time_points = time_t_vector_alloc( 0 , 0 );
+  for (int hour = 24 * num_steps; hour >= 0; hour -= 5)
+    time_t_vector_append( time_points , start_time + hour * 3600 );
+
+  for (const char * key : {"WOPR:W7", "WBHP:W7"}) {
+    std::vector<double> data(time_t_vector_size( time_points ));
+    ecl_sum_init_double_vector_interp( ecl_sum , key , time_points , data.data() );
+    for (int i = 0; i < time_t_vector_size( time_points ); i++) {
+      time_t sim_time = time_t_vector_iget( time_points , i );
+      if (sim_time <= ecl_sum_get_end_time( ecl_sum ))
+        test_assert_double_equal( ecl_sum_get_general_var_from_sim_time( ecl_sum , sim_time , key ) , data[i] );
+    }
+  }
+  time_t_vector_free( time_points );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl::util::TestArea ta("frame");
+  write_case();
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+    verify_frame( ecl_sum );
+    verify_vector_interp( ecl_sum );
+    ecl_sum_free( ecl_sum );
+  }
+  {
+    stringlist_type * data_files = stringlist_alloc_new();
+    stringlist_append_copy( data_files , "CASE.UNSMRY" );
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc( "CASE.SMSPEC" , data_files , ":" , false , true , 0 );
+    verify_frame( ecl_sum );
+    ecl_sum_free( ecl_sum );
+    stringlist_free( data_files );
+  }
+  exit(0);
+}
@@ -0,0 +1,114 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_matrix_storage.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+#include "detail/ecl/ecl_sum_matrix.hpp"
+
+
+void test_matrix() {
+  ecl::sum_matrix matrix(3);
+  std::vector<float> row = {1, 2, 3};
+  std::vector<double> column(4);
+
+  for (int i = 0; i < 4; i++) {
+    test_assert_int_equal( i , matrix.append_row( row.data() ));
+    for (auto& v : row)
+      v += 10;
+  }
+  test_assert_int_equal( 4 , matrix.rows() );
+  test_assert_double_equal( 32 , matrix.get(3,1) );
+  test_assert_throw( matrix.get(4,0) , std::out_of_range );
+  test_assert_throw( matrix.set_columns(4) , std::logic_error );
+
+  matrix.copy_column(2, 4, column.data());
+  test_assert_double_equal( 33 , column[3] );
+
+  matrix.set_lazy_transpose(true);
+  matrix.copy_column(2, 4, column.data());
+  test_assert_double_equal( 23 , column[2] );
+
+  matrix.row(2)[2] = 99;
+  matrix.copy_column(2, 4, column.data());
+  test_assert_double_equal( 99 , column[2] );
+
+  matrix.permute_rows({3,2,1,0});
+  matrix.copy_column(0, 4, column.data());
+  test_assert_double_equal( 31 , column[0] );
+  test_assert_double_equal(  1 , column[3] );
+}
+
+
+/*
+  The tsteps are added out of order; the data are sorted when the
+  index is rebuilt, and the tsteps handed out must still write to the
+  right rows afterwards.
+*/
+void test_unordered_writer() {
+  ecl::util::TestArea ta("matrix_storage");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( "CASE" , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * node = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+  const int num_steps = 10;
+  std::vector<ecl_sum_tstep_type *> tsteps(num_steps);
+
+  for (int step = num_steps - 1; step >= 0; step--)
+    tsteps[step] = ecl_sum_add_tstep( ecl_sum , step + 1 , step * 86400.0 );
+
+  for (int step = 0; step < num_steps; step++)
+    ecl_sum_tstep_set_from_node( tsteps[step] , *node , step * 100 );
+
+  {
+    std::vector<double> data(num_steps);
+    ecl_sum_init_double_vector( ecl_sum , "FOPT" , data.data() );
+    for (int step = 0; step < num_steps; step++) {
+      test_assert_double_equal( step * 100 , data[step] );
+      test_assert_double_equal( step * 100 , ecl_sum_tstep_get_from_key( tsteps[step] , "FOPT" ));
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+
+  {
+    ecl_sum_type * loaded = ecl_sum_fread_alloc_case( "CASE" , ":" );
+    std::vector<double> data(num_steps);
+    test_assert_int_equal( num_steps , ecl_sum_get_data_length( loaded ));
+
+    /* Twice: before and after the transposed copy has been built. */
+    for (int i = 0; i < 2; i++) {
+      ecl_sum_init_double_vector( loaded , "FOPT" , data.data() );
+      for (int step = 0; step < num_steps; step++)
+        test_assert_double_equal( step * 100 , data[step] );
+    }
+    ecl_sum_free( loaded );
+  }
+  ecl_sum_free( ecl_sum );
+}
+
+
+int main(int argc , char ** argv) {
+  test_matrix();
+  test_unordered_writer();
+  exit(0);
+}
@@ -0,0 +1,90 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_multiple_files.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+
+const int num_report = 40;
+const int num_ministep = 3;
+
+
+void write_case(const char * ecl_case, bool unified) {
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( ecl_case , false , unified , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * fopr = ecl_sum_add_var( ecl_sum , "FOPR" , NULL , 0 , "SM3/DAY" , 0.0 );
+  const ecl::smspec_node * bpr  = ecl_sum_add_var( ecl_sum , "BPR" , NULL , 10 , "BARS" , 0.0 );
+
+  for (int report_step = 1; report_step <= num_report; report_step++) {
+    for (int ministep = 0; ministep < num_ministep; ministep++) {
+      int step = (report_step - 1) * num_ministep + ministep;
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step , step * 86400.0 );
+      ecl_sum_tstep_set_from_node( tstep , *fopr , step );
+      ecl_sum_tstep_set_from_node( tstep , *bpr , 1000 - step );
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_multiple_files() {
+  ecl::util::TestArea ta("multiple_files");
+  write_case( "MULTIPLE" , false );
+  write_case( "UNIFIED" , true );
+
+  test_assert_true( util_file_exists( "MULTIPLE.S0040" ));
+  {
+    ecl_sum_type * multiple = ecl_sum_fread_alloc_case( "MULTIPLE" , ":" );
+    ecl_sum_type * unified = ecl_sum_fread_alloc_case( "UNIFIED" , ":" );
+    const int length = num_report * num_ministep;
+
+    test_assert_int_equal( length , ecl_sum_get_data_length( multiple ));
+    test_assert_int_equal( 1 , ecl_sum_get_first_report_step( multiple ));
+    test_assert_int_equal( num_report , ecl_sum_get_last_report_step( multiple ));
+
+    std::vector<double> data1(length);
+    std::vector<double> data2(length);
+    for (const char * key : {"FOPR", "BPR:10"}) {
+      ecl_sum_init_double_vector( multiple , key , data1.data() );
+      ecl_sum_init_double_vector( unified , key , data2.data() );
+      for (int step = 0; step < length; step++)
+        test_assert_double_equal( data1[step] , data2[step] );
+    }
+
+    for (int step = 0; step < length; step++) {
+      test_assert_int_equal( step / num_ministep + 1 , ecl_sum_iget_report_step( multiple , step ));
+      test_assert_time_t_equal( ecl_sum_iget_sim_time( unified , step ) , ecl_sum_iget_sim_time( multiple , step ));
+    }
+
+    ecl_sum_free( unified );
+    ecl_sum_free( multiple );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_multiple_files();
+  exit(0);
+}
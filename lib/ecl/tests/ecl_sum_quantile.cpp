@@ -0,0 +1,220 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_sum_quantile.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_sum_quantile.hpp>
+
+
+const int num_steps = 10;
+
+
+/*
+  The FOPT value of realization @iens is (iens + 1) * (step + 1); the
+  realization @short_case only has half the time steps, and the
+  realization @missing_key does not have the FOPT vector.
+*/
+std::string write_case(int iens, bool short_case, bool missing_key) {
+  std::string ecl_case = "REAL_" + std::to_string(iens) + "/CASE";
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  int length = short_case ? num_steps / 2 : num_steps;
+
+  util_make_path( ("REAL_" + std::to_string(iens)).c_str() );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( ecl_case.c_str() , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  const ecl::smspec_node * fopt = missing_key ? NULL : ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+  const ecl::smspec_node * fopr = ecl_sum_add_var( ecl_sum , "FOPR" , NULL , 0 , "SM3/DAY" , 0.0 );
+
+  for (int step = 0; step < length; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step + 1 , step * 86400.0 );
+    if (fopt)
+      ecl_sum_tstep_set_from_node( tstep , *fopt , (iens + 1) * (step + 1) );
+    ecl_sum_tstep_set_from_node( tstep , *fopr , iens );
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+  return ecl_case;
+}
+
+
+void test_quantile() {
+  ecl::util::TestArea ta("quantile");
+  const int num_cases = 11;
+  stringlist_type * cases = stringlist_alloc_new();
+  stringlist_type * keys = stringlist_alloc_new();
+  double_vector_type * quantiles = double_vector_alloc( 0 , 0 );
+
+  for (int iens = 0; iens < num_cases; iens++)
+    stringlist_append_copy( cases , write_case( iens , iens == 10 , false ).c_str() );
+  stringlist_append_copy( cases , write_case( num_cases , false , true ).c_str() );
+  stringlist_append_copy( cases , "REAL_MISSING/CASE" );
+
+  stringlist_append_copy( keys , "FOPT" );
+  stringlist_append_copy( keys , "FOPR" );
+  double_vector_append( quantiles , 0.50 );
+
+  /* The time span of the cases is the num_steps days starting at 1/1/2010. */
+  time_t_vector_type * time_points = time_t_vector_alloc( 0 , 0 );
+  for (int step = 0; step < num_steps; step++)
+    time_t_vector_append( time_points , util_make_date_utc( 1,1,2010 ) + step * 86400 );
+
+  for (bool exact : {true, false}) {
+    stringlist_type * failed = stringlist_alloc_new();
+    ecl_sum_quantile_type * quantile = ecl_sum_quantile_alloc_cases( keys , cases , ":" , num_steps , quantiles , exact , failed );
+
+    test_assert_true( ecl_sum_quantile_is_instance( quantile ));
+    test_assert_int_equal( num_cases , ecl_sum_quantile_get_size( quantile ));
+    test_assert_int_equal( 2 , stringlist_get_size( failed ));
+    test_assert_true( stringlist_contains( failed , "REAL_MISSING/CASE" ));
+
+    /*
+      All eleven cases cover the first half; only ten cases the second
+      half. The approximate estimates depend on the order the cases are
+      added, which is the order of the cases list.
+    */
+    {
+      double tolerance = exact ? 1e-8 : 1.0;
+      test_assert_true( fabs( ecl_sum_quantile_get( quantile , "FOPT" , 0 , 0.50 ) - 6 ) < tolerance );
+      test_assert_true( fabs( ecl_sum_quantile_get( quantile , "FOPR" , 0 , 0.50 ) - 5 ) < tolerance );
+      test_assert_true( fabs( ecl_sum_quantile_get( quantile , "FOPT" , num_steps - 1 , 0.50 ) - 5.5 * num_steps ) < tolerance * num_steps );
+    }
+
+    /*
+      Adding the cases to an engine with the same time points, in
+      chunks or one at a time in the same order, gives exactly the
+      same estimates.
+    */
+    {
+      ecl_sum_quantile_type * chunked = ecl_sum_quantile_alloc( keys , time_points , quantiles , exact );
+      ecl_sum_quantile_type * serial = ecl_sum_quantile_alloc( keys , time_points , quantiles , exact );
+      test_assert_int_equal( num_cases , ecl_sum_quantile_add_cases( chunked , cases , ":" , NULL ));
+      for (int iens = 0; iens < stringlist_get_size( cases ); iens++) {
+        ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( stringlist_iget( cases , iens ) , ":" );
+        if (ecl_sum) {
+          ecl_sum_quantile_add_case( serial , ecl_sum );
+          ecl_sum_free( ecl_sum );
+        }
+      }
+      test_assert_int_equal( num_cases , ecl_sum_quantile_get_size( serial ));
+      for (int time_index = 0; time_index < num_steps; time_index++) {
+        for (const char * key : {"FOPT", "FOPR"}) {
+          test_assert_double_equal( ecl_sum_quantile_get( serial , key , time_index , 0.50 ),
+                                    ecl_sum_quantile_get( quantile , key , time_index , 0.50 ));
+          test_assert_double_equal( ecl_sum_quantile_get( chunked , key , time_index , 0.50 ),
+                                    ecl_sum_quantile_get( quantile , key , time_index , 0.50 ));
+        }
+      }
+      ecl_sum_quantile_free( chunked );
+      ecl_sum_quantile_free( serial );
+    }
+
+    if (exact) {
+      test_assert_double_equal( 1 , ecl_sum_quantile_get( quantile , "FOPT" , 0 , 0.0 ));
+      test_assert_double_equal( 10 * num_steps , ecl_sum_quantile_get( quantile , "FOPT" , num_steps - 1 , 1.0 ));
+      test_assert_double_equal( 1.9 , ecl_sum_quantile_get( quantile , "FOPT" , 0 , 0.09 ));
+
+      std::vector<double> data(num_steps);
+      ecl_sum_quantile_init_vector( quantile , "FOPR" , 0.25 , data.data() );
+      test_assert_double_equal( 2.5 , data[0] );
+      test_assert_double_equal( 2.25 , data[num_steps - 1] );
+    }
+
+    stringlist_free( failed );
+    ecl_sum_quantile_free( quantile );
+  }
+
+  time_t_vector_free( time_points );
+  double_vector_free( quantiles );
+  stringlist_free( keys );
+  stringlist_free( cases );
+}
+
+
+/*
+  The P^2 estimate of a large sample should be close to the exact
+  quantile.
+*/
+void test_approximate() {
+  stringlist_type * keys = stringlist_alloc_new();
+  double_vector_type * quantiles = double_vector_alloc( 0 , 0 );
+  time_t_vector_type * time_points = time_t_vector_alloc( 0 , 0 );
+  ecl::util::TestArea ta("approximate");
+
+  stringlist_append_copy( keys , "FOPR" );
+  double_vector_append( quantiles , 0.10 );
+  double_vector_append( quantiles , 0.90 );
+  double_vector_append( quantiles , 0.0 );
+  double_vector_append( quantiles , 1.0 );
+  write_case( 0 , false , false );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "REAL_0/CASE" , ":" );
+    time_t_vector_append( time_points , ecl_sum_get_start_time( ecl_sum ));
+
+    ecl_sum_quantile_type * exact = ecl_sum_quantile_alloc( keys , time_points , NULL , true );
+    ecl_sum_quantile_type * approximate = ecl_sum_quantile_alloc( keys , time_points , quantiles , false );
+    for (int i = 0; i < 1000; i++) {
+      ecl_sum_quantile_add_case( exact , ecl_sum );
+      ecl_sum_quantile_add_case( approximate , ecl_sum );
+    }
+    test_assert_double_equal( 0 , ecl_sum_quantile_get( exact , "FOPR" , 0 , 0.90 ));
+    test_assert_double_equal( 0 , ecl_sum_quantile_get( approximate , "FOPR" , 0 , 0.90 ));
+    ecl_sum_quantile_free( exact );
+    ecl_sum_quantile_free( approximate );
+    ecl_sum_free( ecl_sum );
+  }
+
+  {
+    ecl_sum_quantile_type * approximate = ecl_sum_quantile_alloc( keys , time_points , quantiles , false );
+    std::vector<ecl_sum_type *> sums;
+    for (int iens = 1; iens <= 20; iens++) {
+      write_case( iens , false , false );
+      sums.push_back( ecl_sum_fread_alloc_case( ("REAL_" + std::to_string(iens) + "/CASE").c_str() , ":" ));
+    }
+
+    /* FOPR of case iens is iens; add 1000 values scattered over [1,20]. */
+    for (int i = 0; i < 1000; i++)
+      ecl_sum_quantile_add_case( approximate , sums[(i * 7) % sums.size()] );
+
+    test_assert_true( fabs( ecl_sum_quantile_get( approximate , "FOPR" , 0 , 0.10 ) - 2.9 ) < 1.0 );
+    test_assert_true( fabs( ecl_sum_quantile_get( approximate , "FOPR" , 0 , 0.90 ) - 18.1 ) < 1.0 );
+    test_assert_double_equal( 1 , ecl_sum_quantile_get( approximate , "FOPR" , 0 , 0.0 ));
+    test_assert_double_equal( 20 , ecl_sum_quantile_get( approximate , "FOPR" , 0 , 1.0 ));
+
+    for (auto * ecl_sum : sums)
+      ecl_sum_free( ecl_sum );
+    ecl_sum_quantile_free( approximate );
+  }
+
+  time_t_vector_free( time_points );
+  double_vector_free( quantiles );
+  stringlist_free( keys );
+}
+
+
+int main(int argc , char ** argv) {
+  test_quantile();
+  test_approximate();
+  exit(0);
+}
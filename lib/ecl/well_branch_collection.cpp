@@ -27,6 +27,8 @@
 #include <ert/ecl_well/well_conn.hpp>
 #include <ert/ecl_well/well_branch_collection.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 #define WELL_BRANCH_COLLECTION_TYPE_ID 67177087
 
@@ -71,6 +73,17 @@ void well_branch_collection_free__( void * arg ) {
 }
 
 
+/*
+  The start segments are owned by the segment collection, and not
+  counted here.
+*/
+size_t well_branch_collection_get_memory_usage( const well_branch_collection_type * branches ) {
+  return sizeof * branches
+    + ecl::util::memory_usage( branches->__start_segments )
+    + ecl::util::memory_usage( branches->index_map );
+}
+
+
 int well_branch_collection_get_size( const well_branch_collection_type * branches ) {
   return branches->__start_segments.size();
 }
@@ -249,6 +249,11 @@ void well_conn_free( well_conn_type * conn) {
 }
 
 
+size_t well_conn_get_memory_usage( const well_conn_type * conn ) {
+  return sizeof * conn;
+}
+
+
 void well_conn_free__( void * arg ) {
   well_conn_type * conn = well_conn_safe_cast( arg );
   well_conn_free( conn );
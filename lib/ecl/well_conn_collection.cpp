@@ -83,6 +83,17 @@ void well_conn_collection_free__( void * arg ) {
 }
 
 
+size_t well_conn_collection_get_memory_usage( const well_conn_collection_type * wellcc ) {
+  size_t usage = sizeof * wellcc;
+  usage += wellcc->connection_list.capacity() * sizeof(well_conn_type *);
+  usage += wellcc->connection_list_owned.capacity() / 8;
+  for (size_t i = 0; i < wellcc->connection_list.size(); i++)
+    if (wellcc->connection_list_owned[i])
+      usage += well_conn_get_memory_usage( wellcc->connection_list[i] );
+  return usage;
+}
+
+
 int well_conn_collection_get_size( const well_conn_collection_type * wellcc ) {
   return wellcc->connection_list.size();
 }
@@ -39,6 +39,8 @@
 #include <ert/ecl_well/well_info.hpp>
 #include <ert/ecl_well/well_ts.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 /*
   The library libwell contains functionality to read and interpret
@@ -361,6 +363,20 @@ void well_info_free( well_info_type * well_info ) {
   delete well_info;
 }
 
+
+/**
+   Returns an estimate of the number of bytes of memory held by the
+   well_info instance, including all the well states it has loaded.
+*/
+size_t well_info_get_memory_usage( const well_info_type * well_info ) {
+  size_t usage = sizeof * well_info;
+  usage += ecl::util::memory_usage( well_info->wells );
+  usage += ecl::util::memory_usage( well_info->well_names );
+  for (const auto& pair : well_info->wells)
+    usage += well_ts_get_memory_usage( pair.second );
+  return usage;
+}
+
 int well_info_get_well_size( const well_info_type * well_info , const char * well_name ) {
   well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
   return well_ts_get_size( well_ts );
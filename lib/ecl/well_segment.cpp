@@ -32,6 +32,8 @@
 #include <ert/ecl_well/well_segment.hpp>
 #include <ert/ecl_well/well_conn_collection.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 #define WELL_SEGMENT_TYPE_ID  2209166
 
 struct well_segment_struct {
@@ -130,6 +132,14 @@ void well_segment_free__(void * arg) {
 }
 
 
+size_t well_segment_get_memory_usage( const well_segment_type * segment ) {
+  size_t usage = sizeof * segment + ecl::util::memory_usage( segment->connections );
+  for (const auto& pair : segment->connections)
+    usage += well_conn_collection_get_memory_usage( pair.second );
+  return usage;
+}
+
+
 bool well_segment_active( const well_segment_type * segment ) {
   if (segment->branch_id == WELL_SEGMENT_BRANCH_INACTIVE_VALUE)
     return false;
@@ -33,6 +33,8 @@
 #include <ert/ecl_well/well_conn_collection.hpp>
 #include <ert/ecl_well/well_branch_collection.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 struct well_segment_collection_struct {
   std::vector<int> segment_index_map;
@@ -55,6 +57,16 @@ void well_segment_collection_free(well_segment_collection_type * segment_collect
 }
 
 
+size_t well_segment_collection_get_memory_usage( const well_segment_collection_type * segment_collection ) {
+  size_t usage = sizeof * segment_collection;
+  usage += ecl::util::memory_usage( segment_collection->segment_index_map );
+  usage += ecl::util::memory_usage( segment_collection->__segment_storage );
+  for (const auto * segment : segment_collection->__segment_storage)
+    usage += well_segment_get_memory_usage( segment );
+  return usage;
+}
+
+
 
 int well_segment_collection_get_size( const well_segment_collection_type * segment_collection ) {
   return segment_collection->__segment_storage.size();
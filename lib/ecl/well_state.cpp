@@ -51,6 +51,8 @@
 #include <ert/ecl_well/well_branch_collection.hpp>
 #include <ert/ecl_well/well_rseg_loader.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 /*
 
 Connections, segments and branches
@@ -635,6 +637,27 @@ void well_state_free( well_state_type * well ) {
   delete well;
 }
 
+
+size_t well_state_get_memory_usage( const well_state_type * well ) {
+  size_t usage = sizeof * well + ecl::util::memory_usage( well->name );
+
+  usage += ecl::util::memory_usage( well->index_wellhead );
+  for (const auto * wellhead : well->index_wellhead)
+    if (wellhead)
+      usage += well_conn_get_memory_usage( wellhead );
+
+  /* The wellheads in name_wellhead are shared with index_wellhead. */
+  usage += ecl::util::memory_usage( well->name_wellhead );
+
+  usage += ecl::util::memory_usage( well->connections );
+  for (const auto& pair : well->connections)
+    usage += well_conn_collection_get_memory_usage( pair.second );
+
+  usage += well_segment_collection_get_memory_usage( well->segments );
+  usage += well_branch_collection_get_memory_usage( well->branches );
+  return usage;
+}
+
 /*****************************************************************/
 
 int well_state_get_report_nr( const well_state_type * well_state ) {
@@ -73,6 +73,8 @@
 #include <ert/ecl_well/well_const.hpp>
 #include <ert/ecl_well/well_state.hpp>
 
+#include "detail/util/memory_usage.hpp"
+
 
 
 #define WELL_TS_TYPE_ID    6613005
@@ -279,6 +281,16 @@ void well_ts_free__( void * arg ) {
 }
 
 
+size_t well_ts_get_memory_usage( const well_ts_type * well_ts ) {
+  size_t usage = sizeof * well_ts;
+  usage += ecl::util::memory_usage( well_ts->well_name );
+  usage += ecl::util::memory_usage( well_ts->ts );
+  for (const auto * node : well_ts->ts)
+    usage += sizeof * node + well_state_get_memory_usage( node->well_state );
+  return usage;
+}
+
+
 int well_ts_get_size( const well_ts_type * well_ts) {
   return well_ts->ts.size();
 }
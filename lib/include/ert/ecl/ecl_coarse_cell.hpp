@@ -46,11 +46,13 @@ int         ecl_coarse_cell_get_k2(const ecl_coarse_cell_type * coarse_cell);
 const int * ecl_coarse_cell_get_box_ptr(const ecl_coarse_cell_type * coarse_cell);
 
 int         ecl_coarse_cell_get_size(const ecl_coarse_cell_type * coarse_cell);
+size_t      ecl_coarse_cell_get_memory_usage(const ecl_coarse_cell_type * coarse_cell);
 int         ecl_coarse_cell_iget_cell_index(ecl_coarse_cell_type * coarse_cell,
                                             int group_index);
 const int * ecl_coarse_cell_get_index_ptr(ecl_coarse_cell_type * coarse_cell);
 const int_vector_type * ecl_coarse_cell_get_index_vector(ecl_coarse_cell_type * coarse_cell);
 
+void ecl_coarse_cell_reset_active(ecl_coarse_cell_type * coarse_cell);
 void ecl_coarse_cell_update_index(ecl_coarse_cell_type * coarse_cell,
                                   int global_index,
                                   int * active_index,
@@ -38,19 +38,28 @@ extern "C" {
 
 #define ECL_FILE_FLAGS_ENUM_DEFS \
   {.value =   1 , .name="ECL_FILE_CLOSE_STREAM"}, \
-  {.value =   2 , .name="ECL_FILE_WRITABLE"}
-#define ECL_FILE_FLAGS_ENUM_SIZE 2
+  {.value =   2 , .name="ECL_FILE_WRITABLE"}, \
+  {.value =   4 , .name="ECL_FILE_COLUMN_CACHE"}
+#define ECL_FILE_FLAGS_ENUM_SIZE 3
 
 
 
 
   typedef struct ecl_file_struct ecl_file_type;
+
+  typedef enum {
+    ECL_FILE_MEMORY_TOTAL = 0,
+    ECL_FILE_MEMORY_INDEX = 1,
+    ECL_FILE_MEMORY_DATA  = 2
+  } ecl_file_memory_enum;
+
   bool             ecl_file_load_all( ecl_file_type * ecl_file );
   ecl_file_type  * ecl_file_open( const char * filename , int flags);
   ecl_file_type  * ecl_file_fast_open( const char * filename , const char * index_filename , int flags);
   bool             ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename);
   bool             ecl_file_index_valid(const char * file_name, const char * index_file_name);
   void             ecl_file_close( ecl_file_type * ecl_file );
+  size_t           ecl_file_get_memory_usage( const ecl_file_type * ecl_file , ecl_file_memory_enum component);
   void             ecl_file_fortio_detach( ecl_file_type * ecl_file );
   void             ecl_file_free__(void * arg);
   ecl_kw_type    * ecl_file_icopy_named_kw( const ecl_file_type * ecl_file , const char * kw, int ith);
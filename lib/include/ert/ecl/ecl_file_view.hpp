@@ -38,12 +38,19 @@ typedef enum {
                                     mainly to save filedescriptors in cases where many ecl_file instances are open at
                                     the same time. */
   //
-  ECL_FILE_WRITABLE      =  2    /*
+  ECL_FILE_WRITABLE      =  2 ,  /*
                                     This flag opens the file in a mode where it can be updated and modified, but it
                                     must still exist and be readable. I.e. this should not compared with the normal:
                                     fopen(filename , "w") where an existing file is truncated to zero upon successfull
                                     open.
                                  */
+  //
+  ECL_FILE_COLUMN_CACHE  =  4    /*
+                                    Only used when loading unified summary files lazily: the transposed column
+                                    cache is stored in the file <CASE>.UNSMRY.cache next to the summary file and
+                                    reused as long as the summary file is unchanged. Without this flag the cache
+                                    is kept in an anonymous temporary file.
+                                 */
 } ecl_file_flag_type;
 
 
@@ -76,6 +83,8 @@ typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
   bool      ecl_file_view_load_all( ecl_file_view_type * ecl_file_view );
   void      ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw);
   void      ecl_file_view_free( ecl_file_view_type * ecl_file_view );
+  size_t    ecl_file_view_get_memory_usage( const ecl_file_view_type * ecl_file_view );
+  size_t    ecl_file_view_get_data_memory_usage( const ecl_file_view_type * ecl_file_view );
   void      ecl_file_view_free__( void * arg );
   int       ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , const char * kw);
   void      ecl_file_view_fwrite( const ecl_file_view_type * ecl_file_view , fortio_type * target , int offset);
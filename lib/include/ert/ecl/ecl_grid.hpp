@@ -42,6 +42,22 @@ extern "C" {
 
   typedef double (block_function_ftype) ( const double_vector_type *);
   typedef struct ecl_grid_struct ecl_grid_type;
+  typedef struct ecl_egrid_writer_struct ecl_egrid_writer_type;
+
+  /*
+    The components of the memory held by a grid, see
+    ecl_grid_get_memory_usage().
+  */
+  typedef enum {
+    ECL_GRID_MEMORY_TOTAL           = 0,
+    ECL_GRID_MEMORY_CELLS           = 1,   /* The cell geometry, COORD and MAPAXES. */
+    ECL_GRID_MEMORY_INDEX_MAPS      = 2,   /* Global <-> active maps for matrix and fracture. */
+    ECL_GRID_MEMORY_GEOMETRY_ARRAYS = 3,   /* Lazily calculated grid wide arrays; volume, center, depth ... */
+    ECL_GRID_MEMORY_LGR             = 4,   /* The LGR grids, with all their components. */
+    ECL_GRID_MEMORY_NNC             = 5,
+    ECL_GRID_MEMORY_COARSE_CELLS    = 6,
+    ECL_GRID_MEMORY_VALUES          = 7    /* The blocking values, see ecl_grid_alloc_blocking_variables(). */
+  } ecl_grid_memory_enum;
 
   bool                         ecl_grid_have_coarse_cells( const ecl_grid_type * main_grid );
   bool                         ecl_grid_cell_in_coarse_group1( const ecl_grid_type * main_grid , int global_index );
@@ -79,6 +95,8 @@ extern "C" {
   double          ecl_grid_get_cell_thickness3( const ecl_grid_type * grid , int i , int j , int k);
 
   void            ecl_grid_get_distance(const ecl_grid_type * grid , int global_index1, int global_index2 , double *dx , double *dy , double *dz);
+  void            ecl_grid_get_distance_list(const ecl_grid_type * grid , int num_pairs , const int * global_index1 , const int * global_index2 , double * dx , double * dy , double * dz , double * distance);
+  void            ecl_grid_get_distance_one_to_many(const ecl_grid_type * grid , int global_index , int num_cells , const int * global_index_list , double * dx , double * dy , double * dz , double * distance);
   double          ecl_grid_get_cdepth1A(const ecl_grid_type * grid , int active_index);
   double          ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index);
   double          ecl_grid_get_cdepth3(const ecl_grid_type * grid , int i, int j , int k);
@@ -88,9 +106,17 @@ extern "C" {
   double          ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index );
   double          ecl_grid_get_cell_volume3( const ecl_grid_type * ecl_grid, int i , int j , int k);
   double          ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_index );
+  const double  * ecl_grid_get_volume_array( const ecl_grid_type * grid );
+  const double  * ecl_grid_get_center_array( const ecl_grid_type * grid );
+  const double  * ecl_grid_get_depth_array( const ecl_grid_type * grid );
+  const double  * ecl_grid_get_thickness_array( const ecl_grid_type * grid );
+  const double  * ecl_grid_get_bbox_array( const ecl_grid_type * grid );
+  void            ecl_grid_free_geometry_arrays( const ecl_grid_type * grid );
+  int             ecl_grid_bbox_filter( const ecl_grid_type * grid , const double * box_min , const double * box_max , int index1 , int index2 , int * candidates);
   bool            ecl_grid_cell_contains1(const ecl_grid_type * grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains3(const ecl_grid_type * grid , int i , int j ,int k , double x , double y , double z);
   int             ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index);
+  void            ecl_grid_get_global_index_list_from_xyz(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index);
   bool            ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k );
   bool            ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j);
   const  char   * ecl_grid_get_name( const ecl_grid_type * );
@@ -129,6 +155,7 @@ extern "C" {
   char          * ecl_grid_alloc_case_filename( const char * case_input );
 
   void            ecl_grid_free(ecl_grid_type * );
+  size_t          ecl_grid_get_memory_usage( const ecl_grid_type * grid , ecl_grid_memory_enum component );
   void            ecl_grid_free__( void * arg );
   grid_dims_type  ecl_grid_iget_dims( const ecl_grid_type * grid , int grid_nr);
   void            ecl_grid_get_dims(const ecl_grid_type * , int *, int * , int * , int *);
@@ -152,6 +179,7 @@ extern "C" {
 
   int             ecl_grid_get_global_size( const ecl_grid_type * ecl_grid );
   bool            ecl_grid_compare(const ecl_grid_type * g1 , const ecl_grid_type * g2 , bool include_lgr, bool include_nnc , bool verbose);
+  int             ecl_grid_get_cell_diff_list(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , int max_diff , int_vector_type * diff_list);
   int             ecl_grid_get_active_size( const ecl_grid_type * ecl_grid );
 
   double          ecl_grid_get_bottom1(const ecl_grid_type * grid , int global_index);
@@ -201,6 +229,10 @@ extern "C" {
   int                     ecl_grid_get_parent_cell1( const ecl_grid_type * grid , int global_index);
   int                     ecl_grid_get_parent_cell3( const ecl_grid_type * grid , int i , int j , int k);
   const ecl_grid_type   * ecl_grid_get_global_grid( const ecl_grid_type * grid );
+  int                     ecl_grid_get_flat_size( const ecl_grid_type * grid );
+  int                     ecl_grid_get_flat_offset( const ecl_grid_type * grid );
+  const int             * ecl_grid_get_flat_host_map( const ecl_grid_type * grid );
+  const int             * ecl_grid_get_flat_lgr_map( const ecl_grid_type * grid );
   bool                    ecl_grid_is_lgr( const ecl_grid_type * ecl_grid );
 
   double                ecl_grid_get_property(const ecl_grid_type * ecl_grid , const ecl_kw_type * ecl_kw , int i , int j , int k);
@@ -217,6 +249,17 @@ extern "C" {
   void                    ecl_grid_fwrite_EGRID(  ecl_grid_type * grid , const char * filename, bool metric_output);
   void                    ecl_grid_fwrite_EGRID2( ecl_grid_type * grid , const char * filename, ert_ecl_unit_enum output_unit);
 
+  ecl_egrid_writer_type * ecl_egrid_writer_alloc( const char * filename , ert_ecl_unit_enum unit_system , const float * mapaxes);
+  void                    ecl_egrid_writer_free( ecl_egrid_writer_type * writer );
+  void                    ecl_egrid_writer_begin_grid( ecl_egrid_writer_type * writer , int nx , int ny , int nz);
+  void                    ecl_egrid_writer_begin_lgr( ecl_egrid_writer_type * writer , const char * lgr_name , const char * parent_name , int lgr_nr , int nx , int ny , int nz);
+  void                    ecl_egrid_writer_end_grid( ecl_egrid_writer_type * writer );
+  void                    ecl_egrid_writer_add_coord( ecl_egrid_writer_type * writer , int size , const float * coord);
+  void                    ecl_egrid_writer_add_zcorn( ecl_egrid_writer_type * writer , int size , const float * zcorn);
+  void                    ecl_egrid_writer_add_actnum( ecl_egrid_writer_type * writer , int size , const int * actnum);
+  void                    ecl_egrid_writer_add_hostnum( ecl_egrid_writer_type * writer , int size , const int * hostnum);
+  void                    ecl_egrid_writer_add_nnc( ecl_egrid_writer_type * writer , int num_nnc , const int * global_index1 , const int * global_index2);
+
   void                    ecl_grid_fwrite_GRID( const ecl_grid_type * grid , const char * filename);
   void                    ecl_grid_fwrite_GRID2( const ecl_grid_type * grid , const char * filename, ert_ecl_unit_enum output_unit);
 
@@ -237,6 +280,10 @@ extern "C" {
   ecl_grid_type  * ecl_grid_alloc_copy( const ecl_grid_type * src_grid );
   ecl_grid_type  * ecl_grid_alloc_processed_copy( const ecl_grid_type * src_grid , const double * zcorn , const int * actnum);
 
+  bool             ecl_grid_fwrite_cache( const ecl_grid_type * grid , const char * source_file , const char * cache_file);
+  ecl_grid_type  * ecl_grid_fread_cache( const char * cache_file , const char * source_file);
+  ecl_grid_type  * ecl_grid_alloc_cached( const char * grid_file , const char * cache_file);
+
   void             ecl_grid_ri_export( const ecl_grid_type * ecl_grid , double * ri_points);
   void             ecl_grid_cell_ri_export( const ecl_grid_type * ecl_grid , int global_index , double * ri_points);
 
@@ -256,6 +303,7 @@ extern "C" {
 
   void ecl_grid_init_actnum_data( const ecl_grid_type * grid , int * actnum );
   bool ecl_grid_use_mapaxes( const ecl_grid_type * grid );
+  bool ecl_grid_use_float_geometry( void );
   void ecl_grid_init_mapaxes_data_double( const ecl_grid_type * grid , double * mapaxes);
   void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum );
   void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw);
@@ -271,6 +319,7 @@ extern "C" {
   void export_corners( const ecl_grid_type * grid, int index_size, const int * global_index, double * output);
 
   UTIL_IS_INSTANCE_HEADER( ecl_grid );
+  UTIL_IS_INSTANCE_HEADER( ecl_egrid_writer );
   UTIL_SAFE_CAST_HEADER( ecl_grid );
 
 #ifdef __cplusplus
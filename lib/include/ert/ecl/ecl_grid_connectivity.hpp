@@ -0,0 +1,69 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_connectivity.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_CONNECTIVITY_H
+#define ERT_ECL_GRID_CONNECTIVITY_H
+
+#include <ert/util/type_macros.hpp>
+
+#include <ert/ecl/ecl_grid.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  The six faces of a cell; ECL_FACE_NNC is used for connections
+  between cells which do not share a face, e.g. across several layers
+  or between cells which are not lateral neighbours.
+*/
+typedef enum {
+  ECL_FACE_I_MINUS = 0,
+  ECL_FACE_I_PLUS  = 1,
+  ECL_FACE_J_MINUS = 2,
+  ECL_FACE_J_PLUS  = 3,
+  ECL_FACE_K_MINUS = 4,
+  ECL_FACE_K_PLUS  = 5,
+  ECL_FACE_NNC     = 6
+} ecl_face_enum;
+
+#define ECL_CELL_NUM_FACES 6
+
+typedef struct ecl_grid_connectivity_struct ecl_grid_connectivity_type;
+
+UTIL_IS_INSTANCE_HEADER( ecl_grid_connectivity );
+ecl_grid_connectivity_type * ecl_grid_connectivity_alloc( const ecl_grid_type * grid );
+void                         ecl_grid_connectivity_free( ecl_grid_connectivity_type * connectivity );
+
+const double * ecl_grid_connectivity_get_face_area( const ecl_grid_connectivity_type * connectivity );
+const double * ecl_grid_connectivity_get_face_normal( const ecl_grid_connectivity_type * connectivity );
+const double * ecl_grid_connectivity_get_face_center( const ecl_grid_connectivity_type * connectivity );
+const double * ecl_grid_connectivity_get_face_distance( const ecl_grid_connectivity_type * connectivity );
+
+int            ecl_grid_connectivity_get_num_cells( const ecl_grid_connectivity_type * connectivity );
+int            ecl_grid_connectivity_get_num_connections( const ecl_grid_connectivity_type * connectivity );
+const int    * ecl_grid_connectivity_get_offset( const ecl_grid_connectivity_type * connectivity );
+const int    * ecl_grid_connectivity_get_neighbour( const ecl_grid_connectivity_type * connectivity );
+const int    * ecl_grid_connectivity_get_face( const ecl_grid_connectivity_type * connectivity );
+const double * ecl_grid_connectivity_get_area( const ecl_grid_connectivity_type * connectivity );
+const double * ecl_grid_connectivity_get_normal( const ecl_grid_connectivity_type * connectivity );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,57 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_mesh.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_MESH_H
+#define ERT_ECL_GRID_MESH_H
+
+#include <ert/util/type_macros.hpp>
+#include <ert/util/int_vector.hpp>
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+#include <ert/ecl/ecl_region.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ecl_grid_mesh_struct ecl_grid_mesh_type;
+
+UTIL_IS_INSTANCE_HEADER( ecl_grid_mesh );
+ecl_grid_mesh_type * ecl_grid_mesh_alloc( const ecl_grid_type * grid , const int_vector_type * global_index_list);
+ecl_grid_mesh_type * ecl_grid_mesh_alloc_region( const ecl_grid_type * grid , ecl_region_type * region);
+void                 ecl_grid_mesh_free( ecl_grid_mesh_type * mesh );
+
+int                  ecl_grid_mesh_get_num_cells( const ecl_grid_mesh_type * mesh );
+int                  ecl_grid_mesh_get_num_vertices( const ecl_grid_mesh_type * mesh );
+void                 ecl_grid_mesh_get_origin( const ecl_grid_mesh_type * mesh , double * origin);
+const float        * ecl_grid_mesh_get_vertices( const ecl_grid_mesh_type * mesh );
+const int          * ecl_grid_mesh_get_connectivity( const ecl_grid_mesh_type * mesh );
+const int          * ecl_grid_mesh_get_global_index( const ecl_grid_mesh_type * mesh );
+
+void                 ecl_grid_mesh_add_kw( ecl_grid_mesh_type * mesh , const ecl_kw_type * kw);
+int                  ecl_grid_mesh_get_num_attributes( const ecl_grid_mesh_type * mesh );
+const char         * ecl_grid_mesh_iget_attribute_name( const ecl_grid_mesh_type * mesh , int index);
+const float        * ecl_grid_mesh_get_attribute( const ecl_grid_mesh_type * mesh , const char * name);
+
+void                 ecl_grid_mesh_fwrite_vtu( const ecl_grid_mesh_type * mesh , const char * filename);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_path.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_PATH_H
+#define ERT_ECL_GRID_PATH_H
+
+#include <ert/util/type_macros.hpp>
+
+#include <ert/ecl/ecl_grid.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ecl_grid_path_struct ecl_grid_path_type;
+typedef struct ecl_grid_path_cell_struct ecl_grid_path_cell_type;
+
+/*
+  One cell intersected by the path. The entry and exit points are the
+  points where the path crosses the faces of the cell - or the end
+  points of the path if it starts or ends inside the cell.
+*/
+struct ecl_grid_path_cell_struct {
+  int    global_index;
+  double entry[3];
+  double exit[3];
+  double md_entry;
+  double md_exit;
+  bool   nnc;          /* The cell was entered through a non neighbour connection. */
+};
+
+UTIL_IS_INSTANCE_HEADER( ecl_grid_path );
+ecl_grid_path_type *            ecl_grid_path_alloc( const ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const double * md);
+void                            ecl_grid_path_free( ecl_grid_path_type * path );
+int                             ecl_grid_path_get_size( const ecl_grid_path_type * path );
+const ecl_grid_path_cell_type * ecl_grid_path_iget( const ecl_grid_path_type * path , int index );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,48 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_upscale.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_UPSCALE_H
+#define ERT_ECL_GRID_UPSCALE_H
+
+#include <ert/ecl/ecl_kw.hpp>
+#include <ert/ecl/ecl_grid.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  The aggregation used when a fine scale property is upscaled to the
+  coarse groups (CORSNUM) of a grid.
+*/
+typedef enum {
+  ECL_UPSCALE_PORV_MEAN     = 0,   /* Pore volume weighted arithmetic mean. */
+  ECL_UPSCALE_SUM           = 1,
+  ECL_UPSCALE_HARMONIC_MEAN = 2,
+  ECL_UPSCALE_MIN           = 3,
+  ECL_UPSCALE_MAX           = 4
+} ecl_upscale_enum;
+
+ecl_kw_type * ecl_grid_alloc_coarse_kw( const ecl_grid_type * grid , const ecl_kw_type * fine_kw , const ecl_kw_type * porv_kw , ecl_upscale_enum method);
+void          ecl_grid_alloc_coarse_kw_list( const ecl_grid_type * grid , int num_kw , const ecl_kw_type ** fine_kw , const ecl_upscale_enum * method ,
+                                             const ecl_kw_type * porv_kw , ecl_kw_type ** coarse_kw);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
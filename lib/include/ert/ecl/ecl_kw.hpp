@@ -67,9 +67,11 @@ extern "C" {
 
   int            ecl_kw_first_different( const ecl_kw_type * kw1 , const ecl_kw_type * kw2 , int offset, double abs_epsilon , double rel_epsilon);
   size_t         ecl_kw_fortio_size( const ecl_kw_type * ecl_kw );
+  size_t         ecl_kw_get_memory_usage( const ecl_kw_type * ecl_kw );
   void *         ecl_kw_get_ptr(const ecl_kw_type *ecl_kw);
   void           ecl_kw_set_data_ptr(ecl_kw_type * ecl_kw , void * data);
   void           ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw , fortio_type *fortio);
+  void           ecl_kw_fwrite_header(const ecl_kw_type *ecl_kw , fortio_type *fortio);
   bool           ecl_kw_fread_realloc_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
   ecl_data_type  ecl_kw_get_data_type(const ecl_kw_type *);
   const char   * ecl_kw_get_header8(const ecl_kw_type *);
@@ -31,6 +31,17 @@
 
 typedef struct ecl_smspec_struct ecl_smspec_type;
 
+/*
+  A general key resolved once with ecl_smspec_init_key_handle(); the
+  handle can then be used for repeated lookups without any string
+  handling, in all the summary cases which share the smspec.
+*/
+typedef struct {
+  const ecl_smspec_type  * smspec;
+  const ecl::smspec_node * node;
+  int                      params_index;
+} ecl_smspec_key_handle_type;
+
 #ifdef __cplusplus
 #include <vector>
 const std::vector<float>& ecl_smspec_get_params_default( const ecl_smspec_type * ecl_smspec );
@@ -79,6 +90,7 @@ extern "C" {
 
   ecl_smspec_type *        ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart);
   void                     ecl_smspec_free( ecl_smspec_type *);
+  size_t                   ecl_smspec_get_memory_usage( const ecl_smspec_type * ecl_smspec );
 
   int                      ecl_smspec_get_date_day_index( const ecl_smspec_type * smspec );
   int                      ecl_smspec_get_date_month_index( const ecl_smspec_type * smspec );
@@ -112,6 +124,7 @@ extern "C" {
   int                      ecl_smspec_get_general_var_params_index(const ecl_smspec_type * ecl_smspec , const char * lookup_kw);
   bool                     ecl_smspec_has_general_var(const ecl_smspec_type * ecl_smspec , const char * lookup_kw);
   const char             * ecl_smspec_get_general_var_unit( const ecl_smspec_type * ecl_smspec , const char * lookup_kw);
+  bool                     ecl_smspec_init_key_handle( const ecl_smspec_type * ecl_smspec , const char * lookup_kw , ecl_smspec_key_handle_type * handle);
 
 
   //bool                ecl_smspec_general_is_total(const ecl_smspec_type * ecl_smspec , const char * gen_key);
@@ -126,6 +139,7 @@ extern "C" {
 
 
   void              ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec , const char * pattern , stringlist_type * keys);
+  void              ecl_smspec_select_matching_general_var_patterns( const ecl_smspec_type * smspec , const stringlist_type * patterns , stringlist_type * keys);
   stringlist_type * ecl_smspec_alloc_matching_general_var_list(const ecl_smspec_type * smspec , const char * pattern);
 
   int               ecl_smspec_get_time_seconds( const ecl_smspec_type * ecl_smspec );
@@ -57,6 +57,13 @@ typedef struct ecl_sum_vector_struct ecl_sum_vector_type;
 
 typedef struct ecl_sum_struct       ecl_sum_type;
 
+typedef enum {
+  ECL_SUM_MEMORY_TOTAL   = 0,
+  ECL_SUM_MEMORY_SMSPEC  = 1,
+  ECL_SUM_MEMORY_DATA    = 2,
+  ECL_SUM_MEMORY_RESTART = 3
+} ecl_sum_memory_enum;
+
   void           ecl_sum_fmt_init_summary_x( const ecl_sum_type * ecl_sum , ecl_sum_fmt_type * fmt );
   double         ecl_sum_get_from_sim_time( const ecl_sum_type * ecl_sum , time_t sim_time , const ecl::smspec_node * node);
   double         ecl_sum_get_from_sim_days( const ecl_sum_type * ecl_sum , double sim_days , const ecl::smspec_node * node);
@@ -89,6 +96,8 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   void             ecl_sum_free_data(ecl_sum_type * );
   void             ecl_sum_free__(void * );
   void             ecl_sum_free(ecl_sum_type * );
+  size_t           ecl_sum_get_memory_usage( const ecl_sum_type * ecl_sum , ecl_sum_memory_enum component);
+  void             ecl_sum_set_column_cache( ecl_sum_type * ecl_sum , bool column_cache );
   ecl_sum_type   * ecl_sum_fread_alloc(const char * , const stringlist_type * data_files, const char * key_join_string, bool include_restart, bool lazy_load, int file_options);
   ecl_sum_type   * ecl_sum_fread_alloc_case(const char *  , const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case__(const char * input_file , const char * key_join_string , bool include_restart);
@@ -136,6 +145,9 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   double            ecl_sum_get_general_var_from_sim_days( const ecl_sum_type * ecl_sum , double sim_days , const char * var);
   double            ecl_sum_get_general_var_from_sim_time( const ecl_sum_type * ecl_sum , time_t sim_time , const char * var);
   const char *      ecl_sum_get_general_var_unit( const ecl_sum_type * ecl_sum , const char * var);
+  bool              ecl_sum_init_key_handle( const ecl_sum_type * ecl_sum , const char * lookup_kw , ecl_smspec_key_handle_type * handle);
+  double            ecl_sum_iget_handle( const ecl_sum_type * ecl_sum , int time_index , const ecl_smspec_key_handle_type * handle);
+  double            ecl_sum_get_handle_from_sim_time( const ecl_sum_type * ecl_sum , time_t sim_time , const ecl_smspec_key_handle_type * handle);
   ert_ecl_unit_enum ecl_sum_get_unit_system(const ecl_sum_type * ecl_sum);
 
   /***************/
@@ -190,6 +202,7 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   stringlist_type     * ecl_sum_alloc_well_var_list( const ecl_sum_type * ecl_sum );
   stringlist_type     * ecl_sum_alloc_matching_general_var_list(const ecl_sum_type * ecl_sum , const char * pattern);
   void                  ecl_sum_select_matching_general_var_list( const ecl_sum_type * ecl_sum , const char * pattern , stringlist_type * keys);
+  void                  ecl_sum_select_matching_general_var_patterns( const ecl_sum_type * ecl_sum , const stringlist_type * patterns , stringlist_type * keys);
   ecl_smspec_type     * ecl_sum_get_smspec( const ecl_sum_type * ecl_sum );
   ecl_smspec_var_type   ecl_sum_identify_var_type(const char * var);
   ecl_smspec_var_type   ecl_sum_get_var_type( const ecl_sum_type * ecl_sum , const char * gen_key);
@@ -230,6 +243,9 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   void                  ecl_sum_fwrite( const ecl_sum_type * ecl_sum );
   bool                  ecl_sum_can_write( const ecl_sum_type * ecl_sum );
   void                  ecl_sum_fwrite_smspec( const ecl_sum_type * ecl_sum );
+  bool                  ecl_sum_fwrite_columnar( const ecl_sum_type * ecl_sum , const char * filename , bool compress);
+  ecl_sum_type        * ecl_sum_fread_alloc_columnar( const char * filename , const char * key_join_string);
+  const float         * ecl_sum_get_vector_ptr( const ecl_sum_type * ecl_sum , const char * gen_key);
   const ecl::smspec_node    * ecl_sum_add_smspec_node(ecl_sum_type * ecl_sum, const ecl::smspec_node * node);
   const ecl::smspec_node    * ecl_sum_add_var(ecl_sum_type * ecl_sum ,
                                         const char * keyword ,
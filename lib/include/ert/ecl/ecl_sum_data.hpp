@@ -44,6 +44,8 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   void                     ecl_sum_data_fwrite( const ecl_sum_data_type * data , const char * ecl_case , bool fmt_case , bool unified);
   bool                     ecl_sum_data_can_write(const ecl_sum_data_type * data);
   bool                     ecl_sum_data_fread( ecl_sum_data_type * data , const stringlist_type * filelist, bool lazy_load, int file_options);
+  bool                     ecl_sum_data_fread_columnar( ecl_sum_data_type * data , const char * filename);
+  const float            * ecl_sum_data_get_vector_ptr( const ecl_sum_data_type * data , int params_index);
   ecl_sum_data_type      * ecl_sum_data_alloc_writer( ecl_smspec_type * smspec );
   ecl_sum_data_type      * ecl_sum_data_alloc( ecl_smspec_type * smspec);
   double                   ecl_sum_data_time2days( const ecl_sum_data_type * data , time_t sim_time);
@@ -72,6 +74,8 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
 
   ecl_sum_data_type      * ecl_sum_data_fread_alloc( ecl_smspec_type *  , const stringlist_type * filelist , bool include_restart, bool lazy_load);
   void                     ecl_sum_data_free( ecl_sum_data_type * );
+  size_t                   ecl_sum_data_get_memory_usage( const ecl_sum_data_type * data );
+  void                     ecl_sum_data_set_column_cache( ecl_sum_data_type * data , bool column_cache );
   int                      ecl_sum_data_get_last_report_step( const ecl_sum_data_type * data );
   int                      ecl_sum_data_get_first_report_step( const ecl_sum_data_type * data );
 
@@ -0,0 +1,49 @@
+/*
+  Copyright (C) 2019  Equinor ASA, Norway.
+
+  The file 'ecl_sum_ensemble.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+  ERT is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.
+
+  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+  for more details.
+*/
+
+#ifndef ERT_ECL_SUM_ENSEMBLE_H
+#define ERT_ECL_SUM_ENSEMBLE_H
+
+#include <ert/util/type_macros.hpp>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/time_t_vector.hpp>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ecl_sum_ensemble_struct ecl_sum_ensemble_type;
+
+  ecl_sum_ensemble_type * ecl_sum_ensemble_fread_alloc( const stringlist_type * cases , const char * key_join_string , bool include_restart , bool lazy_load , int file_options);
+  void                    ecl_sum_ensemble_free( ecl_sum_ensemble_type * ensemble );
+
+  int                     ecl_sum_ensemble_get_size( const ecl_sum_ensemble_type * ensemble );
+  const ecl_sum_type    * ecl_sum_ensemble_iget( const ecl_sum_ensemble_type * ensemble , int iens );
+  int                     ecl_sum_ensemble_get_num_smspec( const ecl_sum_ensemble_type * ensemble );
+
+  time_t_vector_type    * ecl_sum_ensemble_alloc_common_time( const ecl_sum_ensemble_type * ensemble );
+  bool                    ecl_sum_ensemble_init_double_cube( const ecl_sum_ensemble_type * ensemble , const stringlist_type * keys , const time_t_vector_type * time_points , double * data);
+
+  UTIL_IS_INSTANCE_HEADER( ecl_sum_ensemble );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
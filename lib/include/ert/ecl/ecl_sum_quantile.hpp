@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2019  Equinor ASA, Norway.
+
+  The file 'ecl_sum_quantile.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+  ERT is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.
+
+  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+  for more details.
+*/
+
+#ifndef ERT_ECL_SUM_QUANTILE_H
+#define ERT_ECL_SUM_QUANTILE_H
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.hpp>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/time_t_vector.hpp>
+#include <ert/util/double_vector.hpp>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ecl_sum_quantile_struct ecl_sum_quantile_type;
+
+  ecl_sum_quantile_type * ecl_sum_quantile_alloc( const stringlist_type * keys , const time_t_vector_type * time_points , const double_vector_type * quantiles , bool exact);
+  ecl_sum_quantile_type * ecl_sum_quantile_alloc_cases( const stringlist_type * keys , const stringlist_type * cases , const char * key_join_string , int num_points , const double_vector_type * quantiles , bool exact , stringlist_type * failed_cases );
+  void                    ecl_sum_quantile_free( ecl_sum_quantile_type * quantile );
+
+  bool                    ecl_sum_quantile_add_case( ecl_sum_quantile_type * quantile , const ecl_sum_type * ecl_sum );
+  int                     ecl_sum_quantile_add_cases( ecl_sum_quantile_type * quantile , const stringlist_type * cases , const char * key_join_string , stringlist_type * failed_cases );
+  int                     ecl_sum_quantile_get_size( const ecl_sum_quantile_type * quantile );
+  bool                    ecl_sum_quantile_is_exact( const ecl_sum_quantile_type * quantile );
+
+  double                  ecl_sum_quantile_get( ecl_sum_quantile_type * quantile , const char * key , int time_index , double q );
+  void                    ecl_sum_quantile_init_vector( ecl_sum_quantile_type * quantile , const char * key , double q , double * data );
+
+
+  UTIL_IS_INSTANCE_HEADER( ecl_sum_quantile );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
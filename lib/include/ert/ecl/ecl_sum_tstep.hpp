@@ -34,6 +34,7 @@ typedef struct ecl_sum_tstep_struct ecl_sum_tstep_type;
   ecl_sum_tstep_type * ecl_sum_tstep_alloc_copy( const ecl_sum_tstep_type * src );
   void ecl_sum_tstep_free( ecl_sum_tstep_type * ministep );
   void ecl_sum_tstep_free__( void * __ministep);
+  size_t ecl_sum_tstep_get_memory_usage( const ecl_sum_tstep_type * ministep );
   ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_file(int report_step    ,
                                                      int ministep_nr            ,
                                                      const ecl_kw_type * params_kw ,
@@ -53,6 +53,7 @@ extern "C" {
   int                     nnc_info_get_lgr_nr(const nnc_info_type * nnc_info );
   int                     nnc_info_get_size( const nnc_info_type * nnc_info );
   int                     nnc_info_get_total_size( const nnc_info_type * nnc_info );
+  size_t                  nnc_info_get_memory_usage( const nnc_info_type * nnc_info );
   void                    nnc_info_fprintf(const nnc_info_type * nnc_info , FILE * stream);
 
   bool                    nnc_info_equal( const nnc_info_type * nnc_info1 , const nnc_info_type * nnc_info2 );
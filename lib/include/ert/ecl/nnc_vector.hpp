@@ -46,6 +46,7 @@ extern "C" {
   int                       nnc_vector_get_lgr_nr(const nnc_vector_type * nnc_vector );
   void                      nnc_vector_free__(void * arg);
   int                       nnc_vector_get_size( const nnc_vector_type * nnc_vector );
+  size_t                    nnc_vector_get_memory_usage( const nnc_vector_type * nnc_vector );
   bool                      nnc_vector_equal( const nnc_vector_type * nnc_vector1 , const nnc_vector_type * nnc_vector2);
 
 #ifdef __cplusplus
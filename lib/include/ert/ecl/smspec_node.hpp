@@ -114,6 +114,7 @@ namespace ecl {
       bool                  need_nums() const;
       void                  fprintf__( FILE * stream) const;
       int                   get_params_index() const;
+      size_t                memory_usage() const;
       float                 get_default() const;
       const                 std::array<int,3>& get_ijk() const;
       const char          * get_lgr_name() const;
@@ -35,6 +35,7 @@ extern "C" {
 
   well_branch_collection_type * well_branch_collection_alloc(void);
   void                          well_branch_collection_free( well_branch_collection_type * branches );
+  size_t                        well_branch_collection_get_memory_usage( const well_branch_collection_type * branches );
   void                          well_branch_collection_free__( void * arg );
   bool                          well_branch_collection_has_branch( const well_branch_collection_type * branches , int branch_id);
   int                           well_branch_collection_get_size( const well_branch_collection_type * branches );
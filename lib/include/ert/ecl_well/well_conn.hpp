@@ -45,6 +45,7 @@ extern "C" {
 
 
   void             well_conn_free( well_conn_type * conn);
+  size_t           well_conn_get_memory_usage( const well_conn_type * conn );
   void             well_conn_free__( void * arg );
 
   well_conn_type * well_conn_alloc( int i , int j , int k , double connection_factor , well_conn_dir_enum dir, bool open);
@@ -35,6 +35,7 @@ typedef struct well_conn_collection_struct well_conn_collection_type;
 
 well_conn_collection_type * well_conn_collection_alloc(void);
 void                   well_conn_collection_free(well_conn_collection_type * wellcc);
+size_t                 well_conn_collection_get_memory_usage( const well_conn_collection_type * wellcc );
 void                   well_conn_collection_free__(void * arg);
 int                    well_conn_collection_get_size(const well_conn_collection_type * wellcc);
 const well_conn_type * well_conn_collection_iget_const(const well_conn_collection_type * wellcc,
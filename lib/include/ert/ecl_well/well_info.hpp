@@ -40,6 +40,7 @@ extern "C" {
   void              well_info_load_rstfile( well_info_type * well_info , const char * filename, bool load_segment_information);
   void              well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * rst_file , bool load_segment_information);
   void              well_info_free( well_info_type * well_info );
+  size_t            well_info_get_memory_usage( const well_info_type * well_info );
 
   well_ts_type    * well_info_get_ts( const well_info_type * well_info , const char *well_name);
   int               well_info_get_num_wells( const well_info_type * well_info );
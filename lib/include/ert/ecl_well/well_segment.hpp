@@ -42,6 +42,7 @@ extern "C" {
   well_segment_type * well_segment_alloc_from_kw( const ecl_kw_type * iseg_kw , const well_rseg_loader_type * rseg_loader , const ecl_rsthead_type * header , int well_nr, int segment_index , int segment_id);
   well_segment_type * well_segment_alloc(int segment_id , int outlet_segment_id , int branch_id , const double * rseg_data);
   void                well_segment_free(well_segment_type * segment );
+  size_t              well_segment_get_memory_usage( const well_segment_type * segment );
   void                well_segment_free__(void * arg);
 
   bool                well_segment_active( const well_segment_type * segment );
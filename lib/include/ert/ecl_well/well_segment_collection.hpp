@@ -38,6 +38,7 @@ extern "C" {
 
   well_segment_collection_type * well_segment_collection_alloc(void);
   void                           well_segment_collection_free(well_segment_collection_type * segment_collection );
+  size_t                         well_segment_collection_get_memory_usage( const well_segment_collection_type * segment_collection );
   int                            well_segment_collection_get_size( const well_segment_collection_type * segment_collection );
   void                           well_segment_collection_add( well_segment_collection_type * segment_collection , well_segment_type * segment);
   bool                           well_segment_collection_has_segment( const well_segment_collection_type * segment_collection , int segment_id);
@@ -75,6 +75,7 @@ extern "C" {
 
 
   void                   well_state_free( well_state_type * well );
+  size_t                 well_state_get_memory_usage( const well_state_type * well );
   const char           * well_state_get_name( const well_state_type * well );
   int                    well_state_get_report_nr( const well_state_type * well_state );
   time_t                 well_state_get_sim_time( const well_state_type * well_state );
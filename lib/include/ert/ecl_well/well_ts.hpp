@@ -30,6 +30,7 @@ extern "C" {
   typedef struct well_ts_struct well_ts_type;
 
   void                  well_ts_free( well_ts_type * well_ts );
+  size_t                well_ts_get_memory_usage( const well_ts_type * well_ts );
   void                  well_ts_add_well( well_ts_type * well_ts , well_state_type * well_state );
   well_ts_type        * well_ts_alloc( const char * well_name );
   void                  well_ts_free__( void * arg );
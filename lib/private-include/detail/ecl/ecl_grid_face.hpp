@@ -0,0 +1,51 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'ecl_grid_face.hpp' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_FACE_H
+#define ERT_ECL_GRID_FACE_H
+
+#include <ert/ecl/ecl_grid_connectivity.hpp>
+
+namespace ecl {
+
+/*
+  The corners of the six faces of a cell, in the order of ecl_face_enum
+  and in cyclic order around the face. Splitting a face along the
+  diagonal corner 0 - corner 2 gives the same two triangles as
+  splitting the opposite face of the neighbour cell, i.e. two
+  neighbouring cells share the triangulation of their common face.
+*/
+static const int cell_face_corners[ECL_CELL_NUM_FACES][4] = {{0,2,6,4}, {1,3,7,5}, {0,1,5,4}, {2,3,7,6}, {0,1,3,2}, {4,5,7,6}};
+
+/* The (i,j,k) offset to the neighbour cell across each face. */
+static const int cell_face_offset[ECL_CELL_NUM_FACES][3] = {{-1,0,0}, {1,0,0}, {0,-1,0}, {0,1,0}, {0,0,-1}, {0,0,1}};
+
+inline void vector_cross( const double * a , const double * b , double * c) {
+  c[0] = a[1]*b[2] - a[2]*b[1];
+  c[1] = a[2]*b[0] - a[0]*b[2];
+  c[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+inline double vector_dot( const double * a , const double * b) {
+  return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+}
+
+#endif
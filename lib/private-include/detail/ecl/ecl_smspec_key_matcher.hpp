@@ -0,0 +1,68 @@
+#ifndef ECL_SMSPEC_KEY_MATCHER_HPP
+#define ECL_SMSPEC_KEY_MATCHER_HPP
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+namespace ecl {
+
+/*
+  The key_matcher selects the keys matching any of a set of shell
+  wildcard patterns, with the same semantics as fnmatch() without
+  flags, i.e. what util_fnmatch() does.
+
+  The patterns are compiled to small state machines, and all patterns
+  are run in one pass over a sorted list of keys. The sorted list is
+  traversed as an implicit trie: keys sharing a prefix are consecutive,
+  and the patterns are only stepped once for the shared prefix. When
+  no pattern can match the prefix the whole range is skipped, and when
+  a pattern matches anything after the prefix, e.g. "WOPR:*", the whole
+  range is selected without looking further at the keys.
+
+  Patterns using features which are not compiled, e.g. character
+  classes like [[:digit:]], fall back to util_fnmatch() for every key.
+*/
+
+class key_matcher {
+public:
+  void add_pattern(const char * pattern);
+  bool empty() const;
+
+  /*
+    The @keys must be sorted; the return value has one element for each
+    key, which is true if the key matches at least one of the patterns.
+  */
+  std::vector<bool> select(const std::vector<const std::string *>& keys) const;
+
+private:
+  enum token_type { LITERAL, ANY, STAR, CLASS };
+
+  struct token {
+    token_type         type;
+    unsigned char      c;
+    std::bitset<256>   members;
+  };
+
+  struct pattern {
+    std::vector<token> tokens;
+  };
+
+  struct state {
+    int pattern;
+    int pos;
+  };
+
+  static bool compile(const char * input, pattern& output);
+  void add_closure(int pattern_index, int pos, std::vector<state>& states) const;
+  void step(const std::vector<state>& states, unsigned char c, std::vector<state>& next) const;
+  void visit(const std::vector<const std::string *>& keys, size_t begin, size_t end, size_t depth,
+             const std::vector<state>& states, std::vector<bool>& selected) const;
+
+  std::vector<pattern>     patterns;
+  std::vector<std::string> fallback_patterns;
+};
+
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef ECL_SMSPEC_KEY_TABLE_HPP
+#define ECL_SMSPEC_KEY_TABLE_HPP
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include <ert/ecl/smspec_node.hpp>
+
+namespace ecl {
+
+/*
+  Flat open addressing hash table from the general keys, e.g.
+  "WWCT:OP_1", to the smspec nodes; it is kept in sync with the
+  gen_var_index map of the smspec. The table does not own the key
+  strings, it points to the keys of the gen_var_index map - the nodes
+  of a std::map are never moved, so the pointers stay valid as long as
+  no keys are removed from the map.
+
+  Lookup hashes the C string directly, and does not allocate.
+*/
+
+class smspec_key_table {
+public:
+  void insert(const std::string& key, const smspec_node * node);
+  const smspec_node * get(const char * key) const;
+
+  size_t size() const;
+  size_t memory_usage() const;
+
+private:
+  struct slot {
+    size_t              hash;
+    const std::string * key;
+    const smspec_node * node;
+  };
+
+  static size_t hash(const char * key, size_t * length);
+  void grow();
+  void insert_slot(const slot& new_slot);
+
+  std::vector<slot> slots;
+  size_t m_size = 0;
+};
+
+}
+
+#endif
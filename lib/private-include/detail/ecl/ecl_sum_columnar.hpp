@@ -0,0 +1,93 @@
+#ifndef ECL_SUM_COLUMNAR_HPP
+#define ECL_SUM_COLUMNAR_HPP
+
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+
+#include <ert/ecl/ecl_sum.hpp>
+
+#include "detail/util/mapped_file.hpp"
+#include "detail/ecl/ecl_sum_loader.hpp"
+
+namespace ecl {
+
+/*
+  The columnar summary format stores a complete summary case in one
+  file: a header with the smspec nodes, the time axis and one contiguous
+  float column per parameter. The file is memory mapped when read, and
+  uncompressed columns are handed out as pointers into the mapping.
+
+  The TIME vector, in days, is always stored as parameter zero; the
+  remaining nodes follow in the smspec node order with params_index
+  1,2,3,...
+*/
+
+struct columnar_node {
+  std::string keyword;
+  std::string wgname;
+  std::string unit;
+  std::string lgr;
+  int num;
+  std::array<int,3> lgr_ijk;
+  float default_value;
+};
+
+
+class columnar_loader : public sum_loader {
+public:
+  explicit columnar_loader(const std::string& filename);
+
+  std::vector<double> get_vector(int pos) const override;
+  std::vector<double> sim_seconds() const override;
+  std::vector<time_t> sim_time() const override;
+  std::vector<int> report_steps(int offset) const override;
+  int length() const override;
+  double iget(int time_index, int params_index) const override;
+  size_t memory_usage() const override;
+  const float * column_ptr(int pos) const override;
+
+  int params_size() const;
+  bool compressed() const;
+  time_t start_time() const;
+  const std::array<int,3>& grid_dims() const;
+  const std::vector<columnar_node>& nodes() const;
+
+private:
+  struct column_entry {
+    int64_t offset;
+    int64_t size;
+  };
+
+  const float * column(int pos) const;
+
+  ecl::util::mapped_file file;
+  int m_params_size;
+  int m_length;
+  bool m_compressed;
+  time_t m_start_time;
+  std::array<int,3> m_grid_dims;
+  std::vector<columnar_node> m_nodes;
+  std::vector<double> m_sim_seconds;
+  std::vector<int> m_report_steps;
+  std::vector<column_entry> columns;
+
+  /*
+    Compressed columns are inflated on first access, and kept for the
+    lifetime of the loader.
+  */
+  mutable std::mutex inflate_mutex;
+  mutable std::vector<std::unique_ptr<std::vector<float>>> inflated;
+};
+
+
+bool columnar_fwrite(const ecl_sum_type * ecl_sum, const std::string& filename, bool compress);
+
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef ECL_SUM_ENSEMBLE_PRIVATE_HPP
+#define ECL_SUM_ENSEMBLE_PRIVATE_HPP
+
+#include <ert/util/stringlist.hpp>
+
+#include <ert/ecl/ecl_smspec.hpp>
+#include <ert/ecl/ecl_sum.hpp>
+
+ecl_sum_type * ecl_sum_fread_alloc_shared_smspec(const char * input_file,
+                                                 const char * header_file,
+                                                 const stringlist_type * data_files,
+                                                 ecl_smspec_type * smspec,
+                                                 const char * key_join_string,
+                                                 bool include_restart,
+                                                 bool lazy_load,
+                                                 int file_options);
+
+#endif
@@ -1,13 +1,16 @@
 #include <vector>
 #include <memory>
 #include <array>
-
-#include <ert/util/vector.hpp>
+#include <string>
+#include <limits>
 
 #include <ert/ecl/ecl_smspec.hpp>
 #include <ert/ecl/ecl_sum_tstep.hpp>
 #include <ert/ecl/ecl_file.hpp>
 
+#include "detail/util/memory_usage.hpp"
+#include "detail/ecl/ecl_sum_matrix.hpp"
+
 namespace ecl {
 
 #define INVALID_MINISTEP_NR -1
@@ -74,6 +77,10 @@ public:
     return this->nodes.size();
   }
 
+  size_t memory_usage() const {
+    return ecl::util::memory_usage(this->nodes) + ecl::util::memory_usage(this->report_map);
+  }
+
   std::pair<int,int>& report_range(int report_step) {
     return this->report_map[report_step];
   }
@@ -88,7 +95,27 @@ private:
 };
 
 
-class unsmry_loader;
+/*
+  The time information of one row in the sum_matrix of a
+  ecl_sum_file_data instance.
+*/
+struct ministep_info {
+
+ministep_info(int report_step, int ministep, double sim_seconds, time_t sim_time) :
+  report_step(report_step),
+  ministep(ministep),
+  sim_seconds(sim_seconds),
+  sim_time(sim_time)
+{}
+
+    int report_step;
+    int ministep;
+    double sim_seconds;
+    time_t sim_time;
+};
+
+
+class sum_loader;
 
 class ecl_sum_file_data {
 
@@ -107,7 +134,6 @@ public:
   time_t               iget_sim_time(int time_index ) const;
   double               iget_sim_days(int time_index ) const;
   double               iget_sim_seconds(int time_index ) const;
-  ecl_sum_tstep_type * iget_ministep( int internal_index ) const;
   double               get_days_start() const;
   double               get_sim_length() const;
 
@@ -128,20 +154,30 @@ public:
   void                 fwrite_unified( fortio_type * fortio ) const;
   void                 fwrite_multiple( const char * ecl_case , bool fmt_case ) const;
   bool                 fread(const stringlist_type * filelist, bool lazy_load, int file_options);
+  bool                 fread_columnar(const std::string& filename);
+  const float        * column_ptr(int params_index) const;
+  bool                 prepare_concurrent_read() const;
+  void                 set_column_cache(bool column_cache);
+  size_t               memory_usage() const;
 
 private:
   const ecl_smspec_type         * ecl_smspec;
 
   TimeIndex                       index;
-  vector_type                   * data;
+  ecl::sum_matrix                 values;
+  std::vector<ministep_info>      ministeps;
+  std::vector<ecl_sum_tstep_type *> tstep_handles;
 
-  std::unique_ptr<ecl::unsmry_loader> loader;
+  std::unique_ptr<ecl::sum_loader> loader;
 
-  void                 append_tstep(ecl_sum_tstep_type * tstep);
+  void                 append_tstep(ecl_sum_tstep_type * tstep, bool keep_handle = false);
+  void                 sort_ministeps();
   void                 build_index();
   void                 fwrite_report( int report_step , fortio_type * fortio) const;
-  bool                 check_file( ecl_file_type * ecl_file );
+  bool                 check_file( ecl_file_type * ecl_file ) const;
   void                 add_ecl_file(int report_step, const ecl_file_view_type * summary_view);
+  std::vector<ecl_sum_tstep_type *> load_tsteps(int report_step, const ecl_file_view_type * summary_view) const;
+  void                 fread_multiple(const stringlist_type * filelist);
 };
 
 
@@ -0,0 +1,38 @@
+#ifndef ECL_SUM_LOADER_HPP
+#define ECL_SUM_LOADER_HPP
+
+#include <time.h>
+
+#include <vector>
+
+namespace ecl {
+
+/*
+  Summary data which is read on demand from a file, instead of being
+  loaded into ecl_sum_tstep instances when the case is opened. The
+  ecl_sum_file_data class holds at most one loader.
+*/
+
+class sum_loader {
+public:
+  virtual ~sum_loader() = default;
+
+  virtual std::vector<double> get_vector(int pos) const = 0;
+  virtual std::vector<double> sim_seconds() const = 0;
+  virtual std::vector<time_t> sim_time() const = 0;
+  virtual std::vector<int> report_steps(int offset) const = 0;
+  virtual int length() const = 0;
+  virtual double iget(int time_index, int params_index) const = 0;
+  virtual size_t memory_usage() const = 0;
+
+  /*
+    Pointer to length() contiguous values for parameter @pos, which
+    stays valid for the lifetime of the loader; or NULL if the loader
+    can not provide that.
+  */
+  virtual const float * column_ptr(int pos) const { return nullptr; }
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef ECL_SUM_MATRIX_HPP
+#define ECL_SUM_MATRIX_HPP
+
+#include <vector>
+#include <mutex>
+
+#include <ert/ecl/ecl_sum_tstep.hpp>
+
+namespace ecl {
+
+/*
+  The summary values of one ecl_sum_file_data instance, stored as one
+  contiguous row major matrix with one row per ministep and one column
+  per params_index.
+
+  Extracting a vector is a strided copy from the row major storage. If
+  lazy transposing is enabled a column major copy of the matrix is
+  built on the first vector extraction, and later extractions are
+  contiguous copies; the transposed copy is discarded when the matrix
+  is modified.
+*/
+
+class sum_matrix {
+public:
+  explicit sum_matrix(int columns);
+
+  int rows() const;
+  int columns() const;
+  void set_columns(int columns);
+
+  void reserve(int rows);
+  int append_row(const float * values);
+
+  const float * row(int row) const;
+  float * row(int row);
+  float get(int row, int column) const;
+
+  void copy_column(int column, int length, double * data) const;
+  void copy_row(int row, const int * columns, int num_columns, double * data) const;
+  void permute_rows(const std::vector<int>& order);
+
+  void set_lazy_transpose(bool lazy_transpose);
+  size_t memory_usage() const;
+
+private:
+  void invalidate_transposed();
+
+  int m_columns;
+  int m_rows = 0;
+  std::vector<float> values;
+
+  bool lazy_transpose = false;
+  mutable std::mutex transpose_mutex;
+  mutable std::vector<float> transposed;
+};
+
+}
+
+/*
+  ecl_sum_tstep_attach() appends the values of @tstep as a new row of
+  @matrix and returns the row number. The tstep does not hold any
+  values itself after that; reads and writes go to the matrix row. If
+  the rows of the matrix are reordered the row number must be updated
+  with ecl_sum_tstep_set_row().
+*/
+int  ecl_sum_tstep_attach( ecl_sum_tstep_type * tstep , ecl::sum_matrix * matrix );
+void ecl_sum_tstep_set_row( ecl_sum_tstep_type * tstep , int row );
+
+#endif
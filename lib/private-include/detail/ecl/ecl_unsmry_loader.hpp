@@ -2,28 +2,42 @@
 #include <array>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <ert/ecl/ecl_smspec.hpp>
 #include <ert/ecl/ecl_file.hpp>
 
+#include "detail/util/mapped_file.hpp"
+#include "detail/ecl/ecl_sum_loader.hpp"
+
 namespace ecl {
 
-class unsmry_loader {
+class unsmry_loader : public sum_loader {
 public:
   unsmry_loader(const ecl_smspec_type * smspec, const std::string& filename, int file_options);
   ~unsmry_loader();
 
-  std::vector<double> get_vector(int pos) const;
-  std::vector<double> sim_seconds() const;
-  std::vector<time_t> sim_time() const;
-  int length() const;
+  std::vector<double> get_vector(int pos) const override;
+  std::vector<double> sim_seconds() const override;
+  std::vector<time_t> sim_time() const override;
+  int length() const override;
 
   time_t iget_sim_time(int time_index) const;
   double iget_sim_seconds(int time_index) const;
-  std::vector<int> report_steps(int offset) const;
-  double iget(int time_index, int params_index) const;
+  std::vector<int> report_steps(int offset) const override;
+  double iget(int time_index, int params_index) const override;
+  size_t memory_usage() const override;
+  const float * column_ptr(int pos) const override;
 
 private:
+  std::vector<double> read_vector(int pos) const;
+  double read_value(int time_index, int params_index) const;
+  std::vector<double> column_vector(int pos, bool build_cache) const;
+  const float * column(int pos, bool build_cache) const;
+  bool load_column_cache(const std::string& cache_file) const;
+  void build_column_cache() const;
+
   int size;           //Number of entries in the smspec index
   int time_index;
   int time_seconds;
@@ -33,6 +47,17 @@ private:
   std::array<int,3>    date_index;
   ecl_file_type      * file;
   ecl_file_view_type * file_view;
+
+  /*
+    The values of the PARAMS keywords transposed to one contiguous
+    column per parameter, built on first access; see
+    build_column_cache().
+  */
+  std::string          filename;
+  bool                 persistent_cache;
+  mutable std::mutex   cache_mutex;
+  mutable bool         cache_failed = false;
+  mutable std::unique_ptr<ecl::util::mapped_file> column_cache;
 };
 
 
@@ -0,0 +1,64 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'mapped_file.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ECL_MAPPED_FILE
+#define ECL_MAPPED_FILE
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+namespace ecl {
+  namespace util {
+
+    /*
+      Read only view of the full content of a file. On platforms with
+      mmap() the file is memory mapped, otherwise the content is read
+      into memory. The mapping stays valid after the file, or the
+      stream it was created from, has been closed.
+
+      The constructors throw std::runtime_error if the file can not
+      be opened or mapped.
+    */
+    class mapped_file {
+    public:
+      explicit mapped_file(const std::string& filename);
+      explicit mapped_file(FILE * stream);
+      ~mapped_file();
+
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+
+      const char * data() const { return this->ptr; }
+      size_t size() const { return this->length; }
+      size_t memory_usage() const { return this->buffer.capacity(); }
+
+    private:
+      void map(FILE * stream);
+
+      const char * ptr = nullptr;
+      size_t length = 0;
+      bool mapped = false;
+      std::vector<char> buffer;
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'memory_usage.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ECL_MEMORY_USAGE
+#define ECL_MEMORY_USAGE
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+/*
+  Estimates of the heap memory held by the standard containers, used by
+  the *_get_memory_usage() functions. The estimates include the element
+  storage and the per node bookkeeping of the node based containers,
+  but not the overhead of the allocator itself.
+*/
+
+namespace ecl {
+  namespace util {
+
+    const size_t MEMORY_NODE_OVERHEAD = 4 * sizeof(void *);
+
+    template <typename T> size_t memory_usage(const std::vector<T>& v);
+    template <typename K, typename V> size_t memory_usage(const std::map<K,V>& m);
+    template <typename K, typename V> size_t memory_usage(const std::unordered_map<K,V>& m);
+
+    inline size_t memory_usage(const std::string& s) {
+      /* Short strings are stored inline in the std::string object. */
+      static const size_t inline_capacity = std::string().capacity();
+      return (s.capacity() > inline_capacity) ? s.capacity() + 1 : 0;
+    }
+
+    template <typename T>
+    size_t memory_usage(const T&) {
+      return 0;
+    }
+
+    template <typename T>
+    size_t memory_usage(const std::vector<T>& v) {
+      size_t usage = v.capacity() * sizeof(T);
+      for (const auto& elm : v)
+        usage += memory_usage(elm);
+      return usage;
+    }
+
+    template <typename K, typename V>
+    size_t memory_usage(const std::map<K,V>& m) {
+      size_t usage = m.size() * (sizeof(typename std::map<K,V>::value_type) + MEMORY_NODE_OVERHEAD);
+      for (const auto& pair : m)
+        usage += memory_usage(pair.first) + memory_usage(pair.second);
+      return usage;
+    }
+
+    template <typename K, typename V>
+    size_t memory_usage(const std::unordered_map<K,V>& m) {
+      size_t usage = m.bucket_count() * sizeof(void *) + m.size() * (sizeof(typename std::unordered_map<K,V>::value_type) + sizeof(void *));
+      for (const auto& pair : m)
+        usage += memory_usage(pair.first) + memory_usage(pair.second);
+      return usage;
+    }
+
+  }
+}
+
+#endif
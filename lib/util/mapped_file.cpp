@@ -0,0 +1,91 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'mapped_file.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include "ert/util/build_config.hpp"
+
+#include <stdio.h>
+
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#include <ert/util/util.h>
+
+#include "detail/util/mapped_file.hpp"
+
+namespace ecl {
+  namespace util {
+
+    mapped_file::mapped_file(const std::string& filename) {
+      FILE * stream = fopen(filename.c_str(), "rb");
+      if (!stream)
+        throw std::runtime_error("Could not open file: " + filename);
+
+      try {
+        this->map(stream);
+      } catch (...) {
+        fclose(stream);
+        throw;
+      }
+      fclose(stream);
+    }
+
+
+    mapped_file::mapped_file(FILE * stream) {
+      this->map(stream);
+    }
+
+
+    void mapped_file::map(FILE * stream) {
+      fflush(stream);
+      util_fseek(stream, 0, SEEK_END);
+      this->length = util_ftell(stream);
+      if (this->length == 0)
+        return;
+
+#ifdef HAVE_MMAP
+      {
+        void * addr = mmap(nullptr, this->length, PROT_READ, MAP_SHARED, fileno(stream), 0);
+        if (addr != MAP_FAILED) {
+          this->ptr = static_cast<const char *>(addr);
+          this->mapped = true;
+          return;
+        }
+      }
+#endif
+
+      this->buffer.resize(this->length);
+      util_fseek(stream, 0, SEEK_SET);
+      if (fread(this->buffer.data(), 1, this->length, stream) != this->length)
+        throw std::runtime_error("Reading file content failed");
+      this->ptr = this->buffer.data();
+    }
+
+
+    mapped_file::~mapped_file() {
+#ifdef HAVE_MMAP
+      if (this->mapped)
+        munmap(const_cast<char *>(this->ptr), this->length);
+#endif
+    }
+
+  }
+}
@@ -38,6 +38,7 @@ import ecl.util.util
 from .fortio import FortIO, openFortIO
 from .ecl_kw import EclKW
 from .ecl_file_view import EclFileView
+from .ecl_file_memory_enum import EclFileMemoryEnum
 from .ecl_file import EclFile , openEclFile
 from .ecl_3dkw import Ecl3DKW
 from .ecl_3d_file import Ecl3DFile
@@ -46,7 +46,7 @@ from ecl import EclPrototype
 from ecl.util.util import CTime
 from ecl.util.util import monkey_the_camel
 from ecl import EclFileEnum
-from ecl.eclfile import EclKW, EclFileView
+from ecl.eclfile import EclKW, EclFileView, EclFileMemoryEnum
 
 
 class EclFile(BaseCClass):
@@ -67,6 +67,7 @@ class EclFile(BaseCClass):
     _get_global_view             = EclPrototype("ecl_file_view_ref ecl_file_get_global_view( ecl_file )")
     _write_index                 = EclPrototype("bool        ecl_file_write_index( ecl_file , char*)")
     _fast_open                   = EclPrototype("void*       ecl_file_fast_open( char* , char* , int )" , bind=False)
+    _get_memory_usage            = EclPrototype("size_t      ecl_file_get_memory_usage( ecl_file , ecl_file_memory_enum )")
 
 
     @staticmethod
@@ -263,6 +264,20 @@ class EclFile(BaseCClass):
         self.close()
 
 
+    def memory_usage(self):
+        """
+        Returns a dict with an estimate of the memory held by the file.
+
+        The "index" is the memory used for the keyword headers and
+        the views, "data" is the memory of the keywords which have
+        been loaded, and "total" is the sum.
+        """
+        components = {"total" : EclFileMemoryEnum.ECL_FILE_MEMORY_TOTAL,
+                      "index" : EclFileMemoryEnum.ECL_FILE_MEMORY_INDEX,
+                      "data"  : EclFileMemoryEnum.ECL_FILE_MEMORY_DATA}
+        return {name: self._get_memory_usage(component) for name, component in components.items()}
+
+
     def block_view(self, kw, kw_index):
         if not kw in self:
             raise KeyError('No such keyword "%s".' % kw)
@@ -0,0 +1,29 @@
+#  Copyright (C) 2019  Equinor ASA, Norway.
+#
+#  The file 'ecl_file_memory_enum.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+
+from cwrap import BaseCEnum
+
+
+class EclFileMemoryEnum(BaseCEnum):
+    TYPE_NAME = "ecl_file_memory_enum"
+    ECL_FILE_MEMORY_TOTAL = None
+    ECL_FILE_MEMORY_INDEX = None
+    ECL_FILE_MEMORY_DATA  = None
+
+
+EclFileMemoryEnum.addEnum("ECL_FILE_MEMORY_TOTAL", 0)
+EclFileMemoryEnum.addEnum("ECL_FILE_MEMORY_INDEX", 1)
+EclFileMemoryEnum.addEnum("ECL_FILE_MEMORY_DATA", 2)
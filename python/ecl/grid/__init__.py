@@ -30,6 +30,8 @@ import ecl.util.util
 import ecl.util.geometry
 
 from .cell import Cell
+from .ecl_grid_memory_enum import EclGridMemoryEnum
+from .ecl_upscale_enum import EclUpscaleEnum
 from .ecl_grid import EclGrid
 from .ecl_region import EclRegion
 from .ecl_grid_generator import EclGridGenerator
@@ -39,7 +39,7 @@ from ecl.util.util import monkey_the_camel
 from ecl.util.util import IntVector
 from ecl import  EclDataType, EclUnitTypeEnum, EclTypeEnum
 from ecl.eclfile import EclKW, FortIO
-from ecl.grid import Cell
+from ecl.grid import Cell, EclGridMemoryEnum, EclUpscaleEnum
 
 
 class EclGrid(BaseCClass):
@@ -58,6 +58,8 @@ class EclGrid(BaseCClass):
     _get_cell_lgr                 = EclPrototype("ecl_grid_ref ecl_grid_get_cell_lgr1(ecl_grid, int)")
     _num_coarse_groups            = EclPrototype("int  ecl_grid_get_num_coarse_groups(ecl_grid)")
     _in_coarse_group1             = EclPrototype("bool ecl_grid_cell_in_coarse_group1(ecl_grid, int)")
+    _alloc_coarse_kw              = EclPrototype("ecl_kw_obj ecl_grid_alloc_coarse_kw(ecl_grid, ecl_kw, ecl_kw, ecl_upscale_enum)")
+    _get_memory_usage             = EclPrototype("size_t ecl_grid_get_memory_usage(ecl_grid, ecl_grid_memory_enum)")
     _free                         = EclPrototype("void ecl_grid_free(ecl_grid)")
     _get_nx                       = EclPrototype("int ecl_grid_get_nx(ecl_grid)")
     _get_ny                       = EclPrototype("int ecl_grid_get_ny(ecl_grid)")
@@ -102,6 +104,7 @@ class EclGrid(BaseCClass):
     _invalid_cell                 = EclPrototype("bool   ecl_grid_cell_invalid1(ecl_grid, int)")
     _valid_cell                   = EclPrototype("bool   ecl_grid_cell_valid1(ecl_grid, int)")
     _get_distance                 = EclPrototype("void   ecl_grid_get_distance(ecl_grid, int, int, double*, double*, double*)")
+    _get_distance_list            = EclPrototype("void   ecl_grid_get_distance_list(ecl_grid, int, int*, int*, double*, double*, double*, double*)")
     _fprintf_grdecl2              = EclPrototype("void   ecl_grid_fprintf_grdecl2(ecl_grid, FILE, ecl_unit_enum) ")
     _fwrite_GRID2                 = EclPrototype("void   ecl_grid_fwrite_GRID2(ecl_grid, char*, ecl_unit_enum)")
     _fwrite_EGRID2                = EclPrototype("void   ecl_grid_fwrite_EGRID2(ecl_grid, char*, ecl_unit_enum)")
@@ -272,6 +275,24 @@ class EclGrid(BaseCClass):
         """
         return self._get_global_size()
 
+    def memory_usage(self):
+        """
+        Returns a dict with an estimate of the memory held by the grid.
+
+        The key "total" is the full memory usage, the remaining keys
+        are the components: "cells", "index_maps", "geometry_arrays",
+        "lgr", "nnc", "coarse_cells" and "values".
+        """
+        components = {"total"           : EclGridMemoryEnum.ECL_GRID_MEMORY_TOTAL,
+                      "cells"           : EclGridMemoryEnum.ECL_GRID_MEMORY_CELLS,
+                      "index_maps"      : EclGridMemoryEnum.ECL_GRID_MEMORY_INDEX_MAPS,
+                      "geometry_arrays" : EclGridMemoryEnum.ECL_GRID_MEMORY_GEOMETRY_ARRAYS,
+                      "lgr"             : EclGridMemoryEnum.ECL_GRID_MEMORY_LGR,
+                      "nnc"             : EclGridMemoryEnum.ECL_GRID_MEMORY_NNC,
+                      "coarse_cells"    : EclGridMemoryEnum.ECL_GRID_MEMORY_COARSE_CELLS,
+                      "values"          : EclGridMemoryEnum.ECL_GRID_MEMORY_VALUES}
+        return {name: self._get_memory_usage(component) for name, component in components.items()}
+
     def equal(self, other, include_lgr=True, include_nnc=False, verbose=False):
         """
         Compare the current grid with the other grid.
@@ -728,6 +749,30 @@ class EclGrid(BaseCClass):
         self._get_distance(global_index1, global_index2, ctypes.byref(dx), ctypes.byref(dy), ctypes.byref(dz))
         return (dx.value, dy.value, dz.value)
 
+    def distance_list(self, global_index1, global_index2):
+        """
+        Returns the distance between the cells in the global index
+        lists @global_index1 and @global_index2 as a numpy array with
+        columns dx, dy, dz and distance; dx, dy and dz have the same
+        sign convention as distance().
+        """
+        index1 = numpy.array(global_index1, dtype=numpy.int32)
+        index2 = numpy.array(global_index2, dtype=numpy.int32)
+        if len(index1) != len(index2):
+            raise ValueError("The index lists must have equal length")
+
+        if len(index1) > 0:
+            if min(index1.min(), index2.min()) < 0 or max(index1.max(), index2.max()) >= self.getGlobalSize():
+                raise IndexError("Global index out of range")
+
+        data = numpy.zeros([4, len(index1)], dtype=numpy.float64)
+        ptr = [data[i].ctypes.data_as(ctypes.POINTER(ctypes.c_double)) for i in range(4)]
+        self._get_distance_list(len(index1),
+                                index1.ctypes.data_as(ctypes.POINTER(ctypes.c_int32)),
+                                index2.ctypes.data_as(ctypes.POINTER(ctypes.c_int32)),
+                                ptr[0], ptr[1], ptr[2], ptr[3])
+        return data.transpose()
+
 
     def depth(self, active_index=None, global_index=None, ijk=None):
         """
@@ -1106,6 +1151,39 @@ class EclGrid(BaseCClass):
         return self._in_coarse_group1(global_index)
 
 
+    def coarse_kw(self, ecl_kw, method=EclUpscaleEnum.ECL_UPSCALE_PORV_MEAN, porv_kw=None):
+        """
+        Upscales the fine scale property @ecl_kw to the coarse groups.
+
+        The @ecl_kw keyword, and the @porv_kw keyword used as weight for
+        the method ECL_UPSCALE_PORV_MEAN, must have one element for each
+        cell in the grid or one element for each active cell; for
+        keywords with one element for each active cell the inactive
+        cells are not included. The method is an EclUpscaleEnum value,
+        or one of the names "porv_mean", "sum", "harmonic_mean", "min"
+        and "max". The returned keyword has one element for each coarse
+        group.
+        """
+        if not isinstance(method, EclUpscaleEnum):
+            methods = {"porv_mean"     : EclUpscaleEnum.ECL_UPSCALE_PORV_MEAN,
+                       "sum"           : EclUpscaleEnum.ECL_UPSCALE_SUM,
+                       "harmonic_mean" : EclUpscaleEnum.ECL_UPSCALE_HARMONIC_MEAN,
+                       "min"           : EclUpscaleEnum.ECL_UPSCALE_MIN,
+                       "max"           : EclUpscaleEnum.ECL_UPSCALE_MAX}
+            if method not in methods:
+                raise ValueError("Unknown upscaling method: %s" % method)
+            method = methods[method]
+
+        for kw in (ecl_kw, porv_kw):
+            if kw is not None and len(kw) not in (self.get_global_size(), self.get_num_active()):
+                raise ValueError("Keyword %s must have %d or %d elements" % (kw.getName(), self.get_global_size(), self.get_num_active()))
+
+        if method == EclUpscaleEnum.ECL_UPSCALE_PORV_MEAN and porv_kw is None:
+            raise ValueError("The porv_mean method requires the porv_kw argument")
+
+        return self._alloc_coarse_kw(ecl_kw, porv_kw, method)
+
+
     def create_3d(self, ecl_kw, default = 0):
         """
         Creates a 3D numpy array object with the data from  @ecl_kw.
@@ -0,0 +1,39 @@
+#  Copyright (C) 2019  Equinor ASA, Norway.
+#
+#  The file 'ecl_grid_memory_enum.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+
+from cwrap import BaseCEnum
+
+
+class EclGridMemoryEnum(BaseCEnum):
+    TYPE_NAME = "ecl_grid_memory_enum"
+    ECL_GRID_MEMORY_TOTAL           = None
+    ECL_GRID_MEMORY_CELLS           = None
+    ECL_GRID_MEMORY_INDEX_MAPS      = None
+    ECL_GRID_MEMORY_GEOMETRY_ARRAYS = None
+    ECL_GRID_MEMORY_LGR             = None
+    ECL_GRID_MEMORY_NNC             = None
+    ECL_GRID_MEMORY_COARSE_CELLS    = None
+    ECL_GRID_MEMORY_VALUES          = None
+
+
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_TOTAL", 0)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_CELLS", 1)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_INDEX_MAPS", 2)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_GEOMETRY_ARRAYS", 3)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_LGR", 4)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_NNC", 5)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_COARSE_CELLS", 6)
+EclGridMemoryEnum.addEnum("ECL_GRID_MEMORY_VALUES", 7)
@@ -0,0 +1,33 @@
+#  Copyright (C) 2019  Equinor ASA, Norway.
+#
+#  The file 'ecl_upscale_enum.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+
+from cwrap import BaseCEnum
+
+
+class EclUpscaleEnum(BaseCEnum):
+    TYPE_NAME = "ecl_upscale_enum"
+    ECL_UPSCALE_PORV_MEAN     = None
+    ECL_UPSCALE_SUM           = None
+    ECL_UPSCALE_HARMONIC_MEAN = None
+    ECL_UPSCALE_MIN           = None
+    ECL_UPSCALE_MAX           = None
+
+
+EclUpscaleEnum.addEnum("ECL_UPSCALE_PORV_MEAN", 0)
+EclUpscaleEnum.addEnum("ECL_UPSCALE_SUM", 1)
+EclUpscaleEnum.addEnum("ECL_UPSCALE_HARMONIC_MEAN", 2)
+EclUpscaleEnum.addEnum("ECL_UPSCALE_MIN", 3)
+EclUpscaleEnum.addEnum("ECL_UPSCALE_MAX", 4)
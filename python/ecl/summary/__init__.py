@@ -25,11 +25,13 @@ import ecl.util.util
 import ecl.util.geometry
 
 from .ecl_sum_var_type import EclSumVarType
+from .ecl_sum_memory_enum import EclSumMemoryEnum
 from .ecl_sum_tstep import EclSumTStep
 from .ecl_sum import EclSum #, EclSumVector, EclSumNode, EclSMSPECNode
 from .ecl_sum_keyword_vector import EclSumKeyWordVector
 from .ecl_sum_node import EclSumNode
 from .ecl_sum_vector import EclSumVector
+from .ecl_sum_ensemble import EclSumEnsemble
 from .ecl_npv import EclNPV , NPVPriceVector
 from .ecl_cmp import EclCmp
 
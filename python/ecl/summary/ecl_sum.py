@@ -39,7 +39,7 @@ from ecl.util.util import monkey_the_camel
 from ecl.util.util import StringList, CTime, DoubleVector, TimeVector, IntVector
 
 from ecl.summary import EclSumTStep
-from ecl.summary import EclSumVarType
+from ecl.summary import EclSumVarType, EclSumMemoryEnum
 from ecl.summary.ecl_sum_vector import EclSumVector
 from ecl.summary.ecl_smspec_node import EclSMSPECNode
 from ecl import EclPrototype, EclUnitTypeEnum
@@ -113,6 +113,7 @@ class EclSum(BaseCClass):
     _get_last_report_step          = EclPrototype("int      ecl_sum_get_last_report_step(ecl_sum)")
     _get_first_report_step         = EclPrototype("int      ecl_sum_get_first_report_step(ecl_sum)")
     _select_matching_keys          = EclPrototype("void     ecl_sum_select_matching_general_var_list(ecl_sum, char*, stringlist)")
+    _select_matching_patterns      = EclPrototype("void     ecl_sum_select_matching_general_var_patterns(ecl_sum, stringlist, stringlist)")
     _has_key                       = EclPrototype("bool     ecl_sum_has_general_var(ecl_sum, char*)")
     _check_sim_time                = EclPrototype("bool     ecl_sum_check_sim_time(ecl_sum, time_t)")
     _check_sim_days                = EclPrototype("bool     ecl_sum_check_sim_days(ecl_sum, double)")
@@ -149,6 +150,10 @@ class EclSum(BaseCClass):
     _init_numpy_vector             = EclPrototype("void ecl_sum_init_double_vector(ecl_sum, char*, double*)")
     _init_numpy_vector_interp      = EclPrototype("void ecl_sum_init_double_vector_interp(ecl_sum, char*, time_t_vector, double*)")
     _init_numpy_datetime64         = EclPrototype("void ecl_sum_init_datetime64_vector(ecl_sum, int64*, int)")
+    _get_memory_usage              = EclPrototype("size_t ecl_sum_get_memory_usage(ecl_sum, ecl_sum_memory_enum)")
+    _fread_alloc_columnar          = EclPrototype("void*     ecl_sum_fread_alloc_columnar(char*, char*)", bind=False)
+    _fwrite_columnar               = EclPrototype("bool     ecl_sum_fwrite_columnar(ecl_sum, char*, bool)")
+    _get_vector_ptr                = EclPrototype("void*    ecl_sum_get_vector_ptr(ecl_sum, char*)")
 
 
     def __init__(self, load_case, join_string=":", include_restart=True, lazy_load=True, file_options=0):
@@ -207,6 +212,25 @@ class EclSum(BaseCClass):
         return ecl_sum
 
 
+    @classmethod
+    def load_columnar(cls, filename, join_string = ":"):
+        """Loads a case written with fwrite_columnar().
+
+        The file is memory mapped, and the vectors are read when they are
+        requested. The loaded case can not be written with fwrite().
+        """
+        if not os.path.isfile( filename ):
+            raise IOError("No such file: %s" % filename)
+
+        c_ptr = cls._fread_alloc_columnar(filename, join_string)
+        if c_ptr is None:
+            raise IOError("Failed to load columnar summary file: %s" % filename)
+
+        ecl_sum = cls.createPythonObject( c_ptr )
+        ecl_sum._load_case = filename
+        return ecl_sum
+
+
     @classmethod
     def createCReference(cls, c_pointer, parent=None):
         result = super(EclSum, cls).createCReference(c_pointer, parent)
@@ -438,6 +462,28 @@ class EclSum(BaseCClass):
            return np_vector
 
 
+    def numpy_vector_view(self, key):
+        """Will return a read only float32 numpy view of the values of @key.
+
+        The view refers directly to the loaded summary data, without a
+        copy, and is available for cases loaded with load_columnar() and
+        for lazy loaded unified cases. For other cases None is returned,
+        use numpy_vector() instead. The view keeps the case alive.
+        """
+        if key not in self:
+            raise KeyError("No such key:%s" % key)
+
+        ptr = self._get_vector_ptr(key)
+        if ptr is None:
+            return None
+
+        column = (ctypes.c_float * len(self)).from_address(ptr)
+        column._ecl_sum = self
+        view = numpy.frombuffer(column, dtype=numpy.float32)
+        view.flags.writeable = False
+        return view
+
+
     @property
     def numpy_dates(self):
         """
@@ -690,6 +736,21 @@ class EclSum(BaseCClass):
         return self._data_length()
 
 
+    def memory_usage(self):
+        """
+        Returns a dict with an estimate of the memory held by the case.
+
+        The components are "smspec" for the variable index, "data"
+        for the loaded summary data and "restart" for the cases this
+        case has been restarted from; "total" is the sum.
+        """
+        components = {"total"   : EclSumMemoryEnum.ECL_SUM_MEMORY_TOTAL,
+                      "smspec"  : EclSumMemoryEnum.ECL_SUM_MEMORY_SMSPEC,
+                      "data"    : EclSumMemoryEnum.ECL_SUM_MEMORY_DATA,
+                      "restart" : EclSumMemoryEnum.ECL_SUM_MEMORY_RESTART}
+        return {name: self._get_memory_usage(component) for name, component in components.items()}
+
+
     def __contains__(self, key):
         if self._has_key(key):
             return True
@@ -1448,10 +1509,15 @@ are advised to fetch vector as a numpy vector and then scale that yourself:
         all wells.
 
         If pattern is None you will get all the keys of summary
-        object.
+        object. The pattern can also be a list of patterns, then the keys
+        matching at least one of the patterns are returned; all the
+        patterns are matched in one pass over the keys.
         """
         s = StringList()
-        self._select_matching_keys(pattern, s)
+        if isinstance(pattern, (list, tuple)):
+            self._select_matching_patterns(StringList(initial=pattern), s)
+        else:
+            self._select_matching_keys(pattern, s)
         return s
 
 
@@ -1469,6 +1535,17 @@ are advised to fetch vector as a numpy vector and then scale that yourself:
         self._fwrite_sum()
 
 
+    def fwrite_columnar(self, filename, compress=False):
+        """Writes the case, including restart history, as one columnar file.
+
+        The file can be loaded with EclSum.load_columnar(). With
+        @compress the columns are compressed, which gives a smaller file
+        but the vectors must be inflated when they are read.
+        """
+        if not self._fwrite_columnar(filename, compress):
+            raise IOError("Failed to write columnar summary file: %s" % filename)
+
+
     def alloc_time_vector(self, report_only):
         return self._alloc_time_vector(report_only)
 
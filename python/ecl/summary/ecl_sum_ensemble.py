@@ -0,0 +1,103 @@
+#  Copyright (C) 2019  Equinor ASA, Norway.
+#
+#  The file 'ecl_sum_ensemble.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+
+import ctypes
+import numpy
+
+from cwrap import BaseCClass
+from ecl.util.util import StringList, TimeVector
+from ecl import EclPrototype
+
+
+class EclSumEnsemble(BaseCClass):
+    TYPE_NAME         = "ecl_sum_ensemble"
+    _fread_alloc      = EclPrototype("void* ecl_sum_ensemble_fread_alloc(stringlist, char*, bool, bool, int)", bind=False)
+    _free             = EclPrototype("void ecl_sum_ensemble_free(ecl_sum_ensemble)")
+    _get_size         = EclPrototype("int ecl_sum_ensemble_get_size(ecl_sum_ensemble)")
+    _iget             = EclPrototype("ecl_sum_ref ecl_sum_ensemble_iget(ecl_sum_ensemble, int)")
+    _get_num_smspec   = EclPrototype("int ecl_sum_ensemble_get_num_smspec(ecl_sum_ensemble)")
+    _common_time      = EclPrototype("time_t_vector_obj ecl_sum_ensemble_alloc_common_time(ecl_sum_ensemble)")
+    _init_cube        = EclPrototype("bool ecl_sum_ensemble_init_double_cube(ecl_sum_ensemble, stringlist, time_t_vector, double*)")
+
+    def __init__(self, cases, join_string=":", include_restart=True, lazy_load=True, file_options=0):
+        """Loads the summary results of many cases of the same model.
+
+        The cases are loaded in parallel, and cases with identical SMSPEC
+        files share one parsed copy of the SMSPEC file. Cases which can not
+        be loaded are kept as None entries, so the case index is the same
+        as the index in the @cases argument.
+        """
+        c_pointer = self._fread_alloc(StringList(initial=cases), join_string, include_restart, lazy_load, file_options)
+        super(EclSumEnsemble, self).__init__(c_pointer)
+
+    def __len__(self):
+        return self._get_size()
+
+    def __getitem__(self, index):
+        if index < 0:
+            index += len(self)
+
+        if not 0 <= index < len(self):
+            raise IndexError("Invalid index:%d" % index)
+
+        case = self._iget(index)
+        if case is None:
+            return None
+
+        # The case is owned by the ensemble, which must be kept alive as
+        # long as the case is in use.
+        return case.setParent(self)
+
+    @property
+    def num_smspec(self):
+        """The number of distinct SMSPEC instances held by the ensemble."""
+        return self._get_num_smspec()
+
+    def common_dates(self):
+        """The time axis shared by all the cases as a TimeVector, or None if the
+        cases have different time axes."""
+        return self._common_time()
+
+    def numpy_cube(self, keys, time_index=None):
+        """Will return the values of @keys for all cases as a numpy array of shape
+        [case, time, key].
+
+        Without a time_index argument all cases must share a common time axis,
+        otherwise ValueError is raised. With a list of datetime instances in
+        time_index all cases are resampled to these times, in the same way as
+        for EclSum.pandas_frame(). Keys which are missing in a case, and cases
+        which could not be loaded, get the value NaN.
+        """
+        time_points = None
+        if time_index is None:
+            num_times = len(self._common_time() or [])
+        else:
+            time_points = TimeVector()
+            for t in time_index:
+                time_points.append(t)
+            num_times = len(time_points)
+
+        data = numpy.zeros([len(self), num_times, len(keys)])
+        if not self._init_cube(StringList(initial=keys), time_points, data.ctypes.data_as(ctypes.POINTER(ctypes.c_double))):
+            raise ValueError("The cases do not have a common time axis - must supply time_index")
+
+        return data
+
+    def free(self):
+        self._free()
+
+    def __repr__(self):
+        return self._create_repr('len=%d' % len(self))
@@ -0,0 +1,31 @@
+#  Copyright (C) 2019  Equinor ASA, Norway.
+#
+#  The file 'ecl_sum_memory_enum.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+
+from cwrap import BaseCEnum
+
+
+class EclSumMemoryEnum(BaseCEnum):
+    TYPE_NAME = "ecl_sum_memory_enum"
+    ECL_SUM_MEMORY_TOTAL   = None
+    ECL_SUM_MEMORY_SMSPEC  = None
+    ECL_SUM_MEMORY_DATA    = None
+    ECL_SUM_MEMORY_RESTART = None
+
+
+EclSumMemoryEnum.addEnum("ECL_SUM_MEMORY_TOTAL", 0)
+EclSumMemoryEnum.addEnum("ECL_SUM_MEMORY_SMSPEC", 1)
+EclSumMemoryEnum.addEnum("ECL_SUM_MEMORY_DATA", 2)
+EclSumMemoryEnum.addEnum("ECL_SUM_MEMORY_RESTART", 3)
@@ -33,6 +33,7 @@ class WellInfo(BaseCClass):
     _iget_well_name   = EclPrototype("char* well_info_iget_well_name(well_info, int)")
     _has_well         = EclPrototype("bool  well_info_has_well(well_info, char*)")
     _get_ts           = EclPrototype("well_time_line_ref well_info_get_ts(well_info, char*)")
+    _get_memory_usage = EclPrototype("size_t well_info_get_memory_usage(well_info)")
 
 
     def __init__(self, grid, rst_file=None, load_segment_information=True):
@@ -119,5 +120,13 @@ class WellInfo(BaseCClass):
         return well_name in self
 
 
+    def memory_usage(self):
+        """
+        Returns an estimate of the number of bytes held by the well
+        information, including all loaded well states.
+        """
+        return self._get_memory_usage( )
+
+
     def free(self):
         self._free( )
@@ -158,6 +158,22 @@ class EclFileTest(EclTest):
             loaded_kw = ecl_file["MY_KEY"][0]
             self.assertTrue(kw.equal(loaded_kw))
 
+    def test_memory_usage(self):
+        with TestAreaContext("python/ecl_file/memory_usage"):
+            kw = EclKW("PRESSURE", 10000, EclDataType.ECL_FLOAT)
+            with openFortIO("FILE.UNRST", mode=FortIO.WRITE_MODE) as f:
+                kw.fwrite(f)
+
+            ecl_file = EclFile("FILE.UNRST")
+            usage = ecl_file.memory_usage()
+            self.assertEqual(set(usage.keys()), {"total", "index", "data"})
+            self.assertTrue(usage["total"] > 0)
+
+            ecl_file["PRESSURE"][0]
+            self.assertTrue(ecl_file.memory_usage()["data"] >= 10000 * 4)
+            ecl_file.close()
+
+
     def test_gc(self):
         kw1 = EclKW("KW1" , 100 , EclDataType.ECL_INT)
         kw2 = EclKW("KW2" , 100 , EclDataType.ECL_INT)
@@ -14,6 +14,7 @@
 #
 #  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
 #  for more details.
+import math
 import os.path
 import six
 from unittest import skipIf, skip
@@ -23,8 +24,8 @@ from numpy import linspace
 
 from ecl.util.util import IntVector
 from ecl import EclDataType, EclUnitTypeEnum
-from ecl.eclfile import EclKW, EclFile
-from ecl.grid import EclGrid
+from ecl.eclfile import EclKW, EclFile, openFortIO, FortIO
+from ecl.grid import EclGrid, EclUpscaleEnum
 from ecl.grid import EclGridGenerator as GridGen
 from ecl.grid.faults import Layer , FaultCollection
 from ecl.util.test import TestAreaContext
@@ -126,6 +127,69 @@ def average(points):
 # test_grid_equinor module.
 class GridTest(EclTest):
 
+    def test_memory_usage(self):
+        grid = GridGen.create_rectangular((10, 10, 10), (1, 1, 1))
+        usage = grid.memory_usage()
+        self.assertEqual(set(usage.keys()), {"total", "cells", "index_maps", "geometry_arrays",
+                                             "lgr", "nnc", "coarse_cells", "values"})
+        self.assertTrue(usage["total"] > 0)
+        self.assertTrue(usage["total"] >= usage["cells"] + usage["index_maps"])
+        self.assertEqual(usage["nnc"], 0)
+
+    def test_coarse_kw(self):
+        # Columns i in [0,1] and i in [2,3] for j in [0,1] form two coarse
+        # groups; the cell (0,0,0) in the first group is inactive.
+        actnum = IntVector(initial_size=32, default_value=1)
+        actnum[0] = 0
+        grid = EclGrid.create_rectangular((4, 4, 2), (1, 1, 1), actnum=actnum)
+        corsnum = EclKW("CORSNUM", 32, EclDataType.ECL_INT)
+        for k in range(2):
+            for j in range(2):
+                for i in range(4):
+                    corsnum[grid.get_global_index(ijk=(i, j, k))] = 1 + i // 2
+
+        with TestAreaContext("python/grid-test/coarse_kw"):
+            grid.save_EGRID("COARSE.EGRID")
+            with openFortIO("COARSE.EGRID", mode=FortIO.APPEND_MODE) as f:
+                corsnum.fwrite(f)
+            grid = EclGrid("COARSE.EGRID")
+
+        self.assertEqual(2, grid.coarse_groups())
+        self.assertEqual(2 + 16, grid.get_num_active())
+
+        perm = EclKW("PERMX", 32, EclDataType.ECL_DOUBLE)
+        for g in range(32):
+            perm[g] = g + 1
+        coarse = grid.coarse_kw(perm, method="sum")
+        self.assertEqual(2, len(coarse))
+        self.assertEqual(sum(g + 1 for g in range(32) if corsnum[g] == 1), coarse[0])
+        self.assertEqual(sum(g + 1 for g in range(32) if corsnum[g] == 2), coarse[1])
+        self.assertEqual(3, grid.coarse_kw(perm, method="min")[1])
+        self.assertEqual(3, grid.coarse_kw(perm, method=EclUpscaleEnum.ECL_UPSCALE_MIN)[1])
+        self.assertEqual(coarse[1], grid.coarse_kw(perm, method=EclUpscaleEnum.ECL_UPSCALE_SUM)[1])
+
+        # The first group only has one active index.
+        active = EclKW("PERMA", grid.get_num_active(), EclDataType.ECL_DOUBLE)
+        for a in range(grid.get_num_active()):
+            active[a] = 10 * a + 1
+        porv = EclKW("PORV", grid.get_num_active(), EclDataType.ECL_FLOAT)
+        porv.assign(2)
+        coarse = grid.coarse_kw(active, porv_kw=porv)
+        self.assertEqual(active[grid.get_active_index(ijk=(1, 0, 0))], coarse[0])
+        self.assertEqual(active[grid.get_active_index(ijk=(2, 0, 0))], coarse[1])
+
+        with self.assertRaises(ValueError):
+            grid.coarse_kw(perm, method="mode")
+
+        with self.assertRaises(ValueError):
+            grid.coarse_kw(perm, method=EclUpscaleEnum.ECL_UPSCALE_PORV_MEAN)
+
+        with self.assertRaises(ValueError):
+            grid.coarse_kw(EclKW("PERMX", 7, EclDataType.ECL_DOUBLE), method="sum")
+
+        with self.assertRaises(ValueError):
+            grid.coarse_kw(perm)
+
     def test_oom_grid(self):
         nx = 2000
         ny = 2000
@@ -344,6 +408,25 @@ class GridTest(EclTest):
         self.assertEqual( dy , 3 )
         self.assertEqual( dz , 4 )
 
+    def test_distance_list(self):
+        grid = GridGen.createRectangular( (10,10,10) , (2,3,4) )
+        index1 = [0, 5, 17, 999]
+        index2 = [1, 55, 17, 0]
+        data = grid.distance_list( index1 , index2 )
+        self.assertEqual( data.shape , (4,4) )
+        for (g1, g2, row) in zip(index1, index2, data):
+            (dx, dy, dz) = grid.distance( g1 , g2 )
+            self.assertFloatEqual( row[0] , dx )
+            self.assertFloatEqual( row[1] , dy )
+            self.assertFloatEqual( row[2] , dz )
+            self.assertFloatEqual( row[3] , math.sqrt(dx*dx + dy*dy + dz*dz) )
+
+        with self.assertRaises(ValueError):
+            grid.distance_list( [0, 1] , [2] )
+
+        with self.assertRaises(IndexError):
+            grid.distance_list( [0] , [1000] )
+
     def test_numpy3D(self):
         nx = 10
         ny = 7
@@ -16,6 +16,7 @@
 
 import os.path
 import os
+import gc
 import inspect
 import datetime
 import csv
@@ -23,6 +24,7 @@ import shutil
 import cwrap
 import stat
 import pandas
+import numpy
 
 def assert_frame_equal(a,b):
     if not a.equals(b):
@@ -39,7 +41,7 @@ from unittest import skipIf, skipUnless
 from ecl import EclUnitTypeEnum
 from ecl import EclDataType
 from ecl.eclfile import FortIO, openFortIO, EclKW, EclFile
-from ecl.summary import EclSum, EclSumVarType, EclSumKeyWordVector
+from ecl.summary import EclSum, EclSumVarType, EclSumKeyWordVector, EclSumEnsemble
 from ecl.util.test import TestAreaContext
 from tests import EclTest
 from ecl.util.test.ecl_mock import createEclSum
@@ -107,6 +109,13 @@ def create_case2(case = "CSV", restart_case = None, restart_step = -1, data_star
 class SumTest(EclTest):
 
 
+    def test_memory_usage(self):
+        case = createEclSum("CSV" , [("FOPT", None , 0, "SM3") , ("FOPR" , None , 0, "SM3/DAY")])
+        usage = case.memory_usage()
+        self.assertEqual(set(usage.keys()), {"total", "smspec", "data", "restart"})
+        self.assertTrue(usage["total"] > 0)
+        self.assertEqual(usage["restart"], 0)
+
     def test_mock(self):
         case = createEclSum("CSV" , [("FOPT", None , 0, "SM3") , ("FOPR" , None , 0, "SM3/DAY")])
         self.assertTrue("FOPT" in case)
@@ -126,6 +135,16 @@ class SumTest(EclTest):
         self.assertIn( "FOPR" , keys )
 
 
+    def test_keys_patterns(self):
+        case = createEclSum("CSV" , [("FOPT", None , 0, "SM3") , ("FOPR" , None , 0, "SM3/DAY"), ("WOPR" , "OP1" , 0, "SM3/DAY")])
+        keys = case.keys(pattern = ["*PT", "W*", "NO_MATCH"])
+        self.assertEqual( list(keys) , ["FOPT", "WOPR:OP1"] )
+
+        keys = case.keys(pattern = ["T*", "*"])
+        self.assertEqual( len(keys) , 4 )
+        self.assertIn( "TIME" , keys )
+
+
     def test_identify_var_type(self):
         self.assertEnumIsFullyDefined( EclSumVarType , "ecl_smspec_var_type" , "lib/include/ert/ecl/smspec_node.h")
         self.assertEqual( EclSum.varType( "WWCT:OP_X") , EclSumVarType.ECL_SMSPEC_WELL_VAR )
@@ -408,6 +427,62 @@ class SumTest(EclTest):
         self.assertEqual( time_vector_resample, time_vector)
 
 
+    def test_columnar(self):
+        case = create_case2()
+        with TestAreaContext("sum_columnar"):
+            for compress in (False, True):
+                case.fwrite_columnar("CASE.CSUM", compress=compress)
+                columnar = EclSum.load_columnar("CASE.CSUM")
+                self.assertEqual(len(case), len(columnar))
+                self.assertEqual(case.dates, columnar.dates)
+                self.assertEqual(sorted(case.keys()), sorted(columnar.keys()))
+                for key in case.keys():
+                    expected = case.numpy_vector(key)
+                    self.assertTrue(numpy.allclose(expected, columnar.numpy_vector(key)))
+                    self.assertTrue(numpy.allclose(expected, columnar.numpy_vector_view(key)))
+
+            with self.assertRaises(IOError):
+                EclSum.load_columnar("NO_SUCH_FILE.CSUM")
+
+
+    def test_ensemble(self):
+        with TestAreaContext("sum_ensemble"):
+            cases = []
+            for iens in range(3):
+                path = "REAL_%d" % iens
+                os.makedirs(path)
+                with pushd(path):
+                    create_case("CASE").fwrite()
+                cases.append(os.path.join(path, "CASE"))
+
+            ensemble = EclSumEnsemble(cases + ["MISSING/CASE"])
+            self.assertEqual(len(ensemble), 4)
+            self.assertIsNone(ensemble[3])
+            self.assertEqual(ensemble.num_smspec, 1)
+
+            case = ensemble[0]
+            keys = ["FOPT", "FGPT", "NO_SUCH_KEY"]
+            cube = ensemble.numpy_cube(keys)
+            self.assertEqual(cube.shape, (4, len(case), 3))
+            for iens in range(3):
+                self.assertTrue(numpy.allclose(cube[iens, :, 0], case.numpy_vector("FOPT")))
+                self.assertTrue(numpy.allclose(cube[iens, :, 1], case.numpy_vector("FGPT")))
+            self.assertTrue(numpy.isnan(cube[:, :, 2]).all())
+            self.assertTrue(numpy.isnan(cube[3]).all())
+
+            monthly = case.time_range(interval="1M")
+            cube = ensemble.numpy_cube(keys, time_index=monthly)
+            self.assertEqual(cube.shape, (4, len(monthly), 3))
+            self.assertTrue(numpy.allclose(cube[1, :, 0], case.numpy_vector("FOPT", time_index=monthly)))
+
+            # The case keeps the ensemble alive.
+            fopt = case.numpy_vector("FOPT")
+            case = EclSumEnsemble(cases)[1]
+            gc.collect()
+            self.assertTrue(numpy.allclose(case.numpy_vector("FOPT"), fopt))
+            self.assertEqual(len(case), len(fopt))
+
+
 
     # The purpose of this test is to reproduce a slightly contrived error situation.
     #
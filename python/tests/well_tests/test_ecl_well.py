@@ -67,6 +67,11 @@ class EclWellTest(EclTest):
         return EclWellTest.__well_info
 
 
+    def test_memory_usage(self):
+        well_info = self.getWellInfo()
+        self.assertTrue(well_info.memory_usage() > 0)
+
+
     def test_no_such_well(self):
         grid_path = self.createTestPath("Equinor/ECLIPSE/Gurbat/ECLIPSE.EGRID")
         rst_path1 = self.createTestPath("nosuch/path/ECLIPSE.X001")